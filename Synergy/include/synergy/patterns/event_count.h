@@ -0,0 +1,83 @@
+/// \file event_count.h
+/// \brief This header is part of the synergy synchronization primitives. It contains definition for event counts, used to park threads waiting on an arbitrary condition.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+
+namespace syntropy::synergy
+{
+
+    /************************************************************************/
+    /* EVENT COUNT                                                          */
+    /************************************************************************/
+
+    /// \brief Synchronization primitive used to park threads waiting for an arbitrary condition to become true, without any cost for the notifier when no thread is parked.
+    /// The event count keeps track of the number of waiters and of an epoch which is advanced by each notification reaching at least one waiter.
+    /// Waiters park on the epoch via std::atomic::wait where the standard library provides it, and on a condition variable otherwise.
+    ///
+    /// \example
+    ///
+    /// auto key = event_count.PrepareWait();                       // Register as a waiter.
+    ///
+    /// if (condition)                                              // Check the condition again: the notifier may have changed it before the registration.
+    ///     event_count.CancelWait();
+    /// else
+    ///     event_count.CommitWait(key);                            // Park until a notification is issued after PrepareWait().
+    ///
+    /// ...
+    ///
+    /// condition = true;                                           // Notifier.
+    /// event_count.Notify();                                       // Only pays for a wake-up if any thread is waiting.
+    ///
+    /// \author Raffaele D. Facendola - 2018
+    class EventCount
+    {
+    public:
+
+        /// \brief Identifies the epoch a waiter registered in.
+        using Key = uint32_t;
+
+        /// \brief Create a new event count.
+        EventCount() = default;
+
+        /// \brief No copy constructor.
+        EventCount(const EventCount&) = delete;
+
+        /// \brief No assignment operator.
+        EventCount& operator=(const EventCount&) = delete;
+
+        /// \brief Register the calling thread as a waiter.
+        /// The caller must check the condition it waits for after this call and either call CancelWait() or CommitWait().
+        /// \return Returns the key to pass to CommitWait().
+        Key PrepareWait();
+
+        /// \brief Unregister the calling thread as a waiter without parking.
+        void CancelWait();
+
+        /// \brief Park the calling thread until a notification is issued after the PrepareWait() call the key was returned by.
+        /// \param key Key returned by PrepareWait().
+        void CommitWait(Key key);
+
+        /// \brief Wake up each waiting thread, if any.
+        /// Any change to the condition waiters are waiting for must be performed before this call.
+        /// \return Returns true if at least one thread was waiting, returns false otherwise.
+        bool Notify();
+
+    private:
+
+        std::atomic<uint32_t> waiters_{ 0 };                ///< \brief Number of threads between PrepareWait() and the end of CancelWait() or CommitWait().
+
+        std::atomic<Key> epoch_{ 0 };                       ///< \brief Advanced by each notification reaching at least one waiter.
+
+        std::mutex mutex_;                                  ///< \brief Used to park waiters where std::atomic::wait is not available. Declared regardless, so that the layout doesn't depend on the language version of each translation unit.
+
+        std::condition_variable condition_;                 ///< \brief Condition variable used to park waiters where std::atomic::wait is not available.
+    };
+
+}
@@ -0,0 +1,626 @@
+
+/// \file parallel_algorithms.h
+/// \brief This header is part of the synergy parallel patterns. It contains parallel versions of common range algorithms built on top of the synergy task system.
+///
+/// Each algorithm splits the input range into contiguous chunks and processes them via a binary tree of tasks, joining the partial results of each split via continuations.
+/// Algorithms are asynchronous: they must be called from within a task and return a task which completes once the whole range was processed.
+/// The returned task can be used as a dependency of other tasks. Any range (and output) passed to an algorithm must stay valid until the returned task completes.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "syntropy/diagnostics/assert.h"
+#include "syntropy/math/math.h"
+
+#include "synergy/task/task.h"
+#include "synergy/task/scheduler.h"
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* PARALLEL ALGORITHMS                                                  */
+    /************************************************************************/
+
+    /// \brief Grain size used to let algorithms select the chunk size automatically, based on the number of workers.
+    inline constexpr size_t kAutoGrainSize = 0;
+
+    /// \brief Apply a function to each element in a range, in parallel.
+    /// Parallel equivalent of std::for_each.
+    /// \param first Iterator to the first element in the range. Must be a random access iterator.
+    /// \param last Iterator past the last element in the range.
+    /// \param function Function to apply to each element. Copied once for the whole algorithm and called concurrently.
+    /// \param grain_size Number of elements processed serially by each task. kAutoGrainSize selects it automatically.
+    /// \return Returns a task which completes after the function was applied to each element.
+    template <typename TIterator, typename TFunction>
+    TaskHandle ParallelFor(TIterator first, TIterator last, TFunction function, size_t grain_size = kAutoGrainSize);
+
+    /// \brief Apply a function to each element in a range, in parallel, splitting the range only when other workers run out of tasks.
+    /// Unlike ParallelFor, the range is not partitioned upfront: a single task walks the range one grain at a time and, whenever a worker is starving, hands the upper half of the remaining elements over to a new task.
+    /// The number of tasks spawned depends on the number of workers rather than on the size of the range, making this algorithm suitable for very large loops with cheap iterations.
+    /// \param first Iterator to the first element in the range. Must be a random access iterator.
+    /// \param last Iterator past the last element in the range.
+    /// \param function Function to apply to each element. Copied once for the whole algorithm and called concurrently.
+    /// \param grain_size Number of elements processed between two consecutive split checks. kAutoGrainSize selects it automatically.
+    /// \return Returns a task which completes after the function was applied to each element.
+    template <typename TIterator, typename TFunction>
+    TaskHandle LazyParallelFor(TIterator first, TIterator last, TFunction function, size_t grain_size = kAutoGrainSize);
+
+    /// \brief Apply an operation to each element in a range and store the result in another range, in parallel.
+    /// Parallel equivalent of std::transform.
+    /// \param first Iterator to the first element in the input range. Must be a random access iterator.
+    /// \param last Iterator past the last element in the input range.
+    /// \param destination Iterator to the first element in the output range. Must be a random access iterator. Can be equal to first.
+    /// \param operation Unary operation to apply to each element. Copied once for the whole algorithm and called concurrently.
+    /// \param grain_size Number of elements processed serially by each task. kAutoGrainSize selects it automatically.
+    /// \return Returns a task which completes after each element in the output range was written.
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    TaskHandle ParallelTransform(TInputIterator first, TInputIterator last, TOutputIterator destination, TOperation operation, size_t grain_size = kAutoGrainSize);
+
+    /// \brief Reduce a range of elements using an associative binary operation, in parallel.
+    /// Parallel equivalent of std::reduce. Elements are combined in order, therefore the operation is not required to be commutative.
+    /// \param first Iterator to the first element in the range. Must be a random access iterator.
+    /// \param last Iterator past the last element in the range.
+    /// \param init Initial value of the reduction.
+    /// \param operation Associative binary operation. Copied once for the whole algorithm and called concurrently.
+    /// \param result Receives the result of the reduction when the returned task completes.
+    /// \param grain_size Number of elements processed serially by each task. kAutoGrainSize selects it automatically.
+    /// \return Returns a task which completes after the result was written.
+    template <typename TIterator, typename TValue, typename TOperation>
+    TaskHandle ParallelReduce(TIterator first, TIterator last, TValue init, TOperation operation, TValue& result, size_t grain_size = kAutoGrainSize);
+
+    /// \brief Compute the inclusive prefix sum of a range of elements using an associative binary operation, in parallel.
+    /// Parallel equivalent of std::inclusive_scan. The range is traversed twice: once to reduce each chunk and once to scan each chunk using the reduction of the preceding chunks.
+    /// \param first Iterator to the first element in the input range. Must be a random access iterator.
+    /// \param last Iterator past the last element in the input range.
+    /// \param destination Iterator to the first element in the output range. Must be a random access iterator. Can be equal to first.
+    /// \param operation Associative binary operation. Copied once for the whole algorithm and called concurrently.
+    /// \param grain_size Number of elements processed serially by each task. kAutoGrainSize selects it automatically.
+    /// \return Returns a task which completes after each element in the output range was written.
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation = std::plus<>>
+    TaskHandle ParallelInclusiveScan(TInputIterator first, TInputIterator last, TOutputIterator destination, TOperation operation = TOperation(), size_t grain_size = kAutoGrainSize);
+
+    /// \brief Sort a range of elements, in parallel.
+    /// Parallel equivalent of std::sort. Each chunk is sorted independently, then sorted chunks are merged pairwise: the last merge is serial and bounds the attainable speedup.
+    /// \param first Iterator to the first element in the range. Must be a random access iterator.
+    /// \param last Iterator past the last element in the range.
+    /// \param compare Comparison function object. Copied once for the whole algorithm and called concurrently.
+    /// \param grain_size Number of elements sorted serially by each task. kAutoGrainSize selects it automatically.
+    /// \return Returns a task which completes after the range was sorted.
+    template <typename TIterator, typename TCompare = std::less<>>
+    TaskHandle ParallelSort(TIterator first, TIterator last, TCompare compare = TCompare(), size_t grain_size = kAutoGrainSize);
+
+    namespace details
+    {
+        /// \brief Number of chunks each worker is expected to process when the grain size is selected automatically.
+        /// Higher values improve load balancing at the cost of spawning more tasks.
+        inline constexpr size_t kChunksPerWorker = 8;
+
+        /// \brief Maximum number of elements processed between two consecutive split checks when the grain size of a lazy algorithm is selected automatically.
+        /// Lower values let starving workers be fed sooner at the cost of polling the scheduler more often.
+        inline constexpr size_t kMaxLazyGrainSize = 0x400;
+
+        /// \brief Partition of a range into contiguous chunks of equal size. The last chunk may be smaller than the others.
+        /// \author Raffaele D. Facendola - 2018
+        template <typename TIterator>
+        struct ChunkedRange
+        {
+            /// \brief Partition a range into chunks.
+            /// \param grain_size Number of elements in each chunk. kAutoGrainSize selects it automatically.
+            ChunkedRange(TIterator first, TIterator last, size_t grain_size);
+
+            /// \brief Get an iterator to the first element in a chunk.
+            TIterator GetChunkBegin(size_t chunk) const;
+
+            /// \brief Get an iterator past the last element in a chunk.
+            TIterator GetChunkEnd(size_t chunk) const;
+
+            TIterator first_;                                   ///< \brief Iterator to the first element in the range.
+
+            size_t count_;                                      ///< \brief Number of elements in the range.
+
+            size_t grain_size_;                                 ///< \brief Number of elements in each chunk.
+
+            size_t chunk_count_;                                ///< \brief Number of chunks in the range.
+        };
+
+        /// \brief Task recursively splitting a span of chunks in two halves until a single chunk is left.
+        /// Leaves are processed via TAlgorithm::Process(chunk), while each split is joined back via TAlgorithm::Join(begin, middle, end) after both halves completed.
+        /// \author Raffaele D. Facendola - 2018
+        template <typename TAlgorithm>
+        struct ChunkTask
+        {
+            /// \brief Create a new task processing the chunks [begin; end).
+            ChunkTask(TAlgorithm& algorithm, size_t begin, size_t end);
+
+            /// \brief Process the chunks or split them among new tasks.
+            void operator()();
+
+            TAlgorithm* algorithm_;                             ///< \brief Algorithm being executed.
+
+            size_t begin_;                                      ///< \brief First chunk to process.
+
+            size_t end_;                                        ///< \brief One past the last chunk to process.
+        };
+
+        /// \brief Task walking a span of elements one grain at a time, handing the upper half of the remaining elements over to a new task whenever a worker is starving.
+        /// Elements are processed via TAlgorithm::Process(begin, end). Upon splitting, the remaining elements are split among two continuations: new tasks can only be scheduled after the current one returns.
+        /// \author Raffaele D. Facendola - 2018
+        template <typename TAlgorithm>
+        struct LazyRangeTask
+        {
+            /// \brief Create a new task processing the elements [begin; end).
+            LazyRangeTask(TAlgorithm& algorithm, size_t begin, size_t end);
+
+            /// \brief Process the elements, splitting them on demand.
+            void operator()();
+
+            TAlgorithm* algorithm_;                             ///< \brief Algorithm being executed.
+
+            size_t begin_;                                      ///< \brief First element to process.
+
+            size_t end_;                                        ///< \brief One past the last element to process.
+        };
+
+        /// \brief Spawn the task tree processing each chunk of an algorithm, followed by a task finalizing the algorithm.
+        /// The finalization task keeps the algorithm alive until it completes and receives the algorithm as argument.
+        /// \return Returns the finalization task.
+        template <typename TAlgorithm, typename TFinalize>
+        TaskHandle LaunchChunkTasks(const std::shared_ptr<TAlgorithm>& algorithm, TFinalize finalize);
+
+        /// \brief State of a ParallelFor algorithm.
+        template <typename TIterator, typename TFunction>
+        struct ForAlgorithm
+        {
+            void Process(size_t chunk);
+
+            void Join(size_t begin, size_t middle, size_t end);
+
+            ChunkedRange<TIterator> range_;                     ///< \brief Input range.
+
+            TFunction function_;                                ///< \brief Function to apply to each element.
+        };
+
+        /// \brief State of a LazyParallelFor algorithm.
+        template <typename TIterator, typename TFunction>
+        struct LazyForAlgorithm
+        {
+            void Process(size_t begin, size_t end);
+
+            TIterator first_;                                   ///< \brief Iterator to the first element in the range.
+
+            size_t grain_size_;                                 ///< \brief Number of elements processed between two consecutive split checks.
+
+            TFunction function_;                                ///< \brief Function to apply to each element.
+        };
+
+        /// \brief State of a ParallelTransform algorithm.
+        template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+        struct TransformAlgorithm
+        {
+            void Process(size_t chunk);
+
+            void Join(size_t begin, size_t middle, size_t end);
+
+            ChunkedRange<TInputIterator> range_;                ///< \brief Input range.
+
+            TOutputIterator destination_;                       ///< \brief Output range.
+
+            TOperation operation_;                              ///< \brief Operation to apply to each element.
+        };
+
+        /// \brief State of a ParallelReduce algorithm.
+        /// The partial result of the chunks [begin; end) is stored in the slot of the chunk "begin".
+        template <typename TIterator, typename TValue, typename TOperation>
+        struct ReduceAlgorithm
+        {
+            void Process(size_t chunk);
+
+            void Join(size_t begin, size_t middle, size_t end);
+
+            ChunkedRange<TIterator> range_;                     ///< \brief Input range.
+
+            TOperation operation_;                              ///< \brief Reduction operation.
+
+            std::vector<TValue> partials_;                      ///< \brief Partial result of each chunk.
+        };
+
+        /// \brief State of a ParallelInclusiveScan algorithm.
+        template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+        struct InclusiveScanAlgorithm
+        {
+            using TValue = typename std::iterator_traits<TInputIterator>::value_type;
+
+            void Process(size_t chunk);
+
+            void Join(size_t begin, size_t middle, size_t end);
+
+            /// \brief Turn the reduction of each chunk into the reduction of every chunk up to it, and switch to the scan pass.
+            void Prefix();
+
+            ChunkedRange<TInputIterator> range_;                ///< \brief Input range.
+
+            TOutputIterator destination_;                       ///< \brief Output range.
+
+            TOperation operation_;                              ///< \brief Scan operation.
+
+            std::vector<TValue> partials_;                      ///< \brief Reduction of each chunk during the first pass, reduction up to each chunk during the second one.
+
+            bool scan_{ false };                                ///< \brief Whether the algorithm is performing the scan pass.
+        };
+
+        /// \brief State of a ParallelSort algorithm.
+        template <typename TIterator, typename TCompare>
+        struct SortAlgorithm
+        {
+            void Process(size_t chunk);
+
+            void Join(size_t begin, size_t middle, size_t end);
+
+            ChunkedRange<TIterator> range_;                     ///< \brief Range to sort.
+
+            TCompare compare_;                                  ///< \brief Comparison function object.
+        };
+    }
+
+}
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // Parallel algorithms.
+
+    template <typename TIterator, typename TFunction>
+    TaskHandle ParallelFor(TIterator first, TIterator last, TFunction function, size_t grain_size)
+    {
+        using TAlgorithm = details::ForAlgorithm<TIterator, TFunction>;
+
+        auto algorithm = std::make_shared<TAlgorithm>(TAlgorithm{ { first, last, grain_size }, std::move(function) });
+
+        return details::LaunchChunkTasks(algorithm, [](auto& /*algorithm*/) {});
+    }
+
+    template <typename TIterator, typename TFunction>
+    TaskHandle LazyParallelFor(TIterator first, TIterator last, TFunction function, size_t grain_size)
+    {
+        using TAlgorithm = details::LazyForAlgorithm<TIterator, TFunction>;
+
+        auto count = static_cast<size_t>(std::distance(first, last));
+
+        if (grain_size == kAutoGrainSize)
+        {
+            auto chunk_count = std::max(GetScheduler().GetWorkerCount(), size_t(1)) * details::kChunksPerWorker;
+
+            grain_size = std::clamp(DivCeil(count, chunk_count), size_t(1), details::kMaxLazyGrainSize);
+        }
+
+        auto algorithm = std::make_shared<TAlgorithm>(TAlgorithm{ first, grain_size, std::move(function) });
+
+        auto dependencies = TaskList{};
+
+        if (count > 0)
+        {
+            dependencies.emplace_back(EmplaceTask<details::LazyRangeTask<TAlgorithm>>({}, *algorithm, size_t(0), count));
+        }
+
+        return CreateTask(dependencies, [algorithm]() {});
+    }
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    TaskHandle ParallelTransform(TInputIterator first, TInputIterator last, TOutputIterator destination, TOperation operation, size_t grain_size)
+    {
+        using TAlgorithm = details::TransformAlgorithm<TInputIterator, TOutputIterator, TOperation>;
+
+        auto algorithm = std::make_shared<TAlgorithm>(TAlgorithm{ { first, last, grain_size }, destination, std::move(operation) });
+
+        return details::LaunchChunkTasks(algorithm, [](auto& /*algorithm*/) {});
+    }
+
+    template <typename TIterator, typename TValue, typename TOperation>
+    TaskHandle ParallelReduce(TIterator first, TIterator last, TValue init, TOperation operation, TValue& result, size_t grain_size)
+    {
+        using TAlgorithm = details::ReduceAlgorithm<TIterator, TValue, TOperation>;
+
+        auto algorithm = std::make_shared<TAlgorithm>(TAlgorithm{ { first, last, grain_size }, std::move(operation), {} });
+
+        algorithm->partials_.resize(algorithm->range_.chunk_count_, init);
+
+        return details::LaunchChunkTasks(algorithm, [init = std::move(init), &result](auto& algorithm)
+        {
+            result = algorithm->partials_.empty() ? init : algorithm->operation_(init, algorithm->partials_.front());
+        });
+    }
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    TaskHandle ParallelInclusiveScan(TInputIterator first, TInputIterator last, TOutputIterator destination, TOperation operation, size_t grain_size)
+    {
+        using TAlgorithm = details::InclusiveScanAlgorithm<TInputIterator, TOutputIterator, TOperation>;
+
+        auto algorithm = std::make_shared<TAlgorithm>(TAlgorithm{ { first, last, grain_size }, destination, std::move(operation), {} });
+
+        algorithm->partials_.resize(algorithm->range_.chunk_count_);
+
+        return details::LaunchChunkTasks(algorithm, [](auto& algorithm)
+        {
+            if (algorithm->range_.chunk_count_ > 0)
+            {
+                algorithm->Prefix();
+
+                // Second pass: the current task continues after each chunk was scanned.
+
+                auto scan = EmplaceTask<details::ChunkTask<TAlgorithm>>({}, *algorithm, size_t(0), algorithm->range_.chunk_count_);
+
+                CreateTaskContinuation({ scan }, [algorithm]() {});
+            }
+        });
+    }
+
+    template <typename TIterator, typename TCompare>
+    TaskHandle ParallelSort(TIterator first, TIterator last, TCompare compare, size_t grain_size)
+    {
+        using TAlgorithm = details::SortAlgorithm<TIterator, TCompare>;
+
+        auto algorithm = std::make_shared<TAlgorithm>(TAlgorithm{ { first, last, grain_size }, std::move(compare) });
+
+        return details::LaunchChunkTasks(algorithm, [](auto& /*algorithm*/) {});
+    }
+
+    // ChunkedRange<TIterator>.
+
+    template <typename TIterator>
+    details::ChunkedRange<TIterator>::ChunkedRange(TIterator first, TIterator last, size_t grain_size)
+        : first_(first)
+        , count_(static_cast<size_t>(std::distance(first, last)))
+        , grain_size_(grain_size)
+    {
+        if (grain_size_ == kAutoGrainSize)
+        {
+            auto chunk_count = std::max(GetScheduler().GetWorkerCount(), size_t(1)) * kChunksPerWorker;
+
+            grain_size_ = std::max(DivCeil(count_, chunk_count), size_t(1));
+        }
+
+        chunk_count_ = DivCeil(count_, grain_size_);
+    }
+
+    template <typename TIterator>
+    inline TIterator details::ChunkedRange<TIterator>::GetChunkBegin(size_t chunk) const
+    {
+        return std::next(first_, std::min(chunk * grain_size_, count_));
+    }
+
+    template <typename TIterator>
+    inline TIterator details::ChunkedRange<TIterator>::GetChunkEnd(size_t chunk) const
+    {
+        return GetChunkBegin(chunk + 1);
+    }
+
+    // ChunkTask<TAlgorithm>.
+
+    template <typename TAlgorithm>
+    details::ChunkTask<TAlgorithm>::ChunkTask(TAlgorithm& algorithm, size_t begin, size_t end)
+        : algorithm_(&algorithm)
+        , begin_(begin)
+        , end_(end)
+    {
+        SYNTROPY_ASSERT(begin_ < end_);
+    }
+
+    template <typename TAlgorithm>
+    void details::ChunkTask<TAlgorithm>::operator()()
+    {
+        if (end_ - begin_ == 1)
+        {
+            algorithm_->Process(begin_);
+            return;
+        }
+
+        auto middle = begin_ + ((end_ - begin_) >> 1);
+
+        auto left = EmplaceTask<ChunkTask>({}, *algorithm_, begin_, middle);
+        auto right = EmplaceTask<ChunkTask>({}, *algorithm_, middle, end_);
+
+        CreateTaskContinuation({ left, right }, [algorithm = algorithm_, begin = begin_, middle, end = end_]()
+        {
+            algorithm->Join(begin, middle, end);
+        });
+    }
+
+    // LazyRangeTask<TAlgorithm>.
+
+    template <typename TAlgorithm>
+    details::LazyRangeTask<TAlgorithm>::LazyRangeTask(TAlgorithm& algorithm, size_t begin, size_t end)
+        : algorithm_(&algorithm)
+        , begin_(begin)
+        , end_(end)
+    {
+        SYNTROPY_ASSERT(begin_ < end_);
+    }
+
+    template <typename TAlgorithm>
+    void details::LazyRangeTask<TAlgorithm>::operator()()
+    {
+        auto& scheduler = GetScheduler();
+
+        auto grain_size = algorithm_->grain_size_;
+
+        while (end_ - begin_ > grain_size)
+        {
+            if (scheduler.IsWorkDemanded())
+            {
+                // Split the remaining elements in two continuations: the lower half is executed next on this worker, the upper half is handed over.
+
+                auto middle = begin_ + ((end_ - begin_) >> 1);
+
+                EmplaceTaskContinuation<LazyRangeTask>({}, *algorithm_, begin_, middle);
+                EmplaceTaskContinuation<LazyRangeTask>({}, *algorithm_, middle, end_);
+
+                return;
+            }
+
+            algorithm_->Process(begin_, begin_ + grain_size);
+
+            begin_ += grain_size;
+        }
+
+        algorithm_->Process(begin_, end_);
+    }
+
+    // LaunchChunkTasks.
+
+    template <typename TAlgorithm, typename TFinalize>
+    TaskHandle details::LaunchChunkTasks(const std::shared_ptr<TAlgorithm>& algorithm, TFinalize finalize)
+    {
+        auto dependencies = TaskList{};
+
+        if (auto chunk_count = algorithm->range_.chunk_count_; chunk_count > 0)
+        {
+            dependencies.emplace_back(EmplaceTask<ChunkTask<TAlgorithm>>({}, *algorithm, size_t(0), chunk_count));
+        }
+
+        return CreateTask(dependencies, [algorithm, finalize = std::move(finalize)]()
+        {
+            finalize(algorithm);
+        });
+    }
+
+    // ForAlgorithm<TIterator, TFunction>.
+
+    template <typename TIterator, typename TFunction>
+    inline void details::ForAlgorithm<TIterator, TFunction>::Process(size_t chunk)
+    {
+        std::for_each(range_.GetChunkBegin(chunk), range_.GetChunkEnd(chunk), std::ref(function_));
+    }
+
+    template <typename TIterator, typename TFunction>
+    inline void details::ForAlgorithm<TIterator, TFunction>::Join(size_t /*begin*/, size_t /*middle*/, size_t /*end*/)
+    {
+
+    }
+
+    // LazyForAlgorithm<TIterator, TFunction>.
+
+    template <typename TIterator, typename TFunction>
+    inline void details::LazyForAlgorithm<TIterator, TFunction>::Process(size_t begin, size_t end)
+    {
+        std::for_each(std::next(first_, begin), std::next(first_, end), std::ref(function_));
+    }
+
+    // TransformAlgorithm<TInputIterator, TOutputIterator, TOperation>.
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    inline void details::TransformAlgorithm<TInputIterator, TOutputIterator, TOperation>::Process(size_t chunk)
+    {
+        auto destination = std::next(destination_, std::distance(range_.first_, range_.GetChunkBegin(chunk)));
+
+        std::transform(range_.GetChunkBegin(chunk), range_.GetChunkEnd(chunk), destination, std::ref(operation_));
+    }
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    inline void details::TransformAlgorithm<TInputIterator, TOutputIterator, TOperation>::Join(size_t /*begin*/, size_t /*middle*/, size_t /*end*/)
+    {
+
+    }
+
+    // ReduceAlgorithm<TIterator, TValue, TOperation>.
+
+    template <typename TIterator, typename TValue, typename TOperation>
+    inline void details::ReduceAlgorithm<TIterator, TValue, TOperation>::Process(size_t chunk)
+    {
+        auto first = range_.GetChunkBegin(chunk);
+        auto last = range_.GetChunkEnd(chunk);
+
+        auto partial = TValue(*first);
+
+        for (++first; first != last; ++first)
+        {
+            partial = operation_(std::move(partial), *first);
+        }
+
+        partials_[chunk] = std::move(partial);
+    }
+
+    template <typename TIterator, typename TValue, typename TOperation>
+    inline void details::ReduceAlgorithm<TIterator, TValue, TOperation>::Join(size_t begin, size_t middle, size_t /*end*/)
+    {
+        partials_[begin] = operation_(std::move(partials_[begin]), partials_[middle]);
+    }
+
+    // InclusiveScanAlgorithm<TInputIterator, TOutputIterator, TOperation>.
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    inline void details::InclusiveScanAlgorithm<TInputIterator, TOutputIterator, TOperation>::Process(size_t chunk)
+    {
+        auto first = range_.GetChunkBegin(chunk);
+        auto last = range_.GetChunkEnd(chunk);
+
+        if (!scan_)
+        {
+            if (chunk + 1 < range_.chunk_count_)                                                 // The reduction of the last chunk is never needed.
+            {
+                auto partial = TValue(*first);
+
+                for (++first; first != last; ++first)
+                {
+                    partial = operation_(std::move(partial), *first);
+                }
+
+                partials_[chunk] = std::move(partial);
+            }
+        }
+        else
+        {
+            auto destination = std::next(destination_, std::distance(range_.first_, first));
+
+            auto partial = (chunk > 0) ? operation_(partials_[chunk - 1], *first) : TValue(*first);
+
+            for (*destination = partial, ++first, ++destination; first != last; ++first, ++destination)
+            {
+                partial = operation_(std::move(partial), *first);
+
+                *destination = partial;
+            }
+        }
+    }
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    inline void details::InclusiveScanAlgorithm<TInputIterator, TOutputIterator, TOperation>::Join(size_t /*begin*/, size_t /*middle*/, size_t /*end*/)
+    {
+
+    }
+
+    template <typename TInputIterator, typename TOutputIterator, typename TOperation>
+    inline void details::InclusiveScanAlgorithm<TInputIterator, TOutputIterator, TOperation>::Prefix()
+    {
+        for (size_t chunk = 1; chunk + 1 < range_.chunk_count_; ++chunk)
+        {
+            partials_[chunk] = operation_(partials_[chunk - 1], partials_[chunk]);
+        }
+
+        scan_ = true;
+    }
+
+    // SortAlgorithm<TIterator, TCompare>.
+
+    template <typename TIterator, typename TCompare>
+    inline void details::SortAlgorithm<TIterator, TCompare>::Process(size_t chunk)
+    {
+        std::sort(range_.GetChunkBegin(chunk), range_.GetChunkEnd(chunk), std::ref(compare_));
+    }
+
+    template <typename TIterator, typename TCompare>
+    inline void details::SortAlgorithm<TIterator, TCompare>::Join(size_t begin, size_t middle, size_t end)
+    {
+        std::inplace_merge(range_.GetChunkBegin(begin), range_.GetChunkBegin(middle), range_.GetChunkBegin(end), std::ref(compare_));
+    }
+
+}
@@ -0,0 +1,349 @@
+
+/// \file coroutine.h
+/// \brief This header is part of the synergy task system. It contains definitions for stackless coroutines running on top of tasks.
+///
+/// Requires compiler support for coroutines: either C++20 coroutines or the Coroutines TS (/await on MSVC).
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define SYNERGY_COROUTINE_NAMESPACE std
+#elif __has_include(<experimental/coroutine>)
+#include <experimental/coroutine>
+#define SYNERGY_COROUTINE_NAMESPACE std::experimental
+#else
+#error "synergy coroutines require compiler support for coroutines."
+#endif
+
+#include "syntropy/diagnostics/assert.h"
+
+#include "synergy/task/task.h"
+#include "synergy/task/task_pool.h"
+#include "synergy/task/task_execution_context.h"
+#include "synergy/task/scheduler.h"
+
+namespace syntropy::synergy
+{
+    /// \brief Namespace of the coroutine library in use.
+    namespace coroutines = SYNERGY_COROUTINE_NAMESPACE;
+
+    /************************************************************************/
+    /* COROUTINE                                                            */
+    /************************************************************************/
+
+    /// \brief Return object of a coroutine executed by a task.
+    /// The coroutine starts suspended and is resumed by the task it is bound to (see CreateCoroutineTask), which is rescheduled whenever the coroutine awaits other tasks (see WhenAll).
+    /// Coroutine frames are allocated from the task pool of the worker the coroutine is started on.
+    /// \author Raffaele D. Facendola - 2018
+    class Coroutine
+    {
+    public:
+
+        struct promise_type;
+
+        /// \brief Type of the handle to the coroutine.
+        using Handle = coroutines::coroutine_handle<promise_type>;
+
+        /// \brief Create an empty coroutine.
+        Coroutine() noexcept = default;
+
+        /// \brief Create a coroutine from its handle.
+        explicit Coroutine(Handle handle) noexcept;
+
+        /// \brief No copy constructor.
+        Coroutine(const Coroutine&) = delete;
+
+        /// \brief Move constructor.
+        Coroutine(Coroutine&& rhs) noexcept;
+
+        /// \brief Destroy the coroutine frame, if any.
+        ~Coroutine();
+
+        /// \brief Move assignment operator.
+        Coroutine& operator=(Coroutine&& rhs) noexcept;
+
+        /// \brief Check whether the object refers to a coroutine.
+        explicit operator bool() const noexcept;
+
+        /// \brief Resume the coroutine until its next suspension point.
+        /// The coroutine must not be done.
+        void Resume();
+
+        /// \brief Check whether the coroutine ran to completion.
+        bool IsDone() const noexcept;
+
+    private:
+
+        Handle handle_;                                                 ///< \brief Handle to the coroutine.
+    };
+
+    /// \brief Promise of a coroutine executed by a task.
+    struct Coroutine::promise_type
+    {
+        /// \brief Allocate the coroutine frame from the task pool bound to the current thread.
+        static void* operator new(std::size_t size);
+
+        /// \brief Release a coroutine frame.
+        static void operator delete(void* frame);
+
+        /// \brief Get the object returned to the caller of the coroutine.
+        Coroutine get_return_object() noexcept;
+
+        /// \brief The coroutine is started lazily by the task it is bound to.
+        coroutines::suspend_always initial_suspend() const noexcept;
+
+        /// \brief The coroutine frame is destroyed along with the task it is bound to.
+        coroutines::suspend_always final_suspend() const noexcept;
+
+        /// \brief Complete the coroutine.
+        void return_void() const noexcept;
+
+        /// \brief Tasks are not expected to throw.
+        void unhandled_exception() const noexcept;
+    };
+
+    /************************************************************************/
+    /* WHEN ALL                                                             */
+    /************************************************************************/
+
+    /// \brief Awaitable object used to suspend a coroutine until a set of tasks completes.
+    /// The task executing the coroutine is yielded and the coroutine is resumed, on any worker, after each awaited task completed. See YieldTask.
+    /// \author Raffaele D. Facendola - 2018
+    class WhenAllAwaiter
+    {
+    public:
+
+        /// \brief Create a new awaiter.
+        /// \param tasks Tasks to wait for.
+        WhenAllAwaiter(TaskList tasks) noexcept;
+
+        /// \brief The coroutine is not suspended if there's nothing to wait for.
+        bool await_ready() const noexcept;
+
+        /// \brief Yield the task executing the coroutine.
+        void await_suspend(Coroutine::Handle handle);
+
+        /// \brief Nothing to do when resuming.
+        void await_resume() const noexcept;
+
+    private:
+
+        TaskList tasks_;                                                ///< \brief Tasks to wait for.
+    };
+
+    /// \brief Suspend the current coroutine until each of the provided tasks completes.
+    /// Since the coroutine is resumed as a continuation of the current task, the same restrictions of YieldTask apply to the awaited tasks.
+    /// \param tasks Tasks to wait for.
+    /// \return Returns an awaitable object.
+    WhenAllAwaiter WhenAll(TaskList tasks);
+
+    /************************************************************************/
+    /* COROUTINE TASK                                                       */
+    /************************************************************************/
+
+    namespace details
+    {
+        /// \brief Callable object binding a coroutine to the task executing it.
+        /// The first execution starts the coroutine, each subsequent one resumes it.
+        /// \tparam TCallable Type of the callable object returning the coroutine.
+        template <typename TCallable>
+        struct CoroutineTask
+        {
+            static_assert(std::is_same_v<std::invoke_result_t<TCallable&>, Coroutine>, "TCallable must be a coroutine returning synergy::Coroutine.");
+
+            /// \brief Create a new coroutine task.
+            template <typename TArgument>
+            CoroutineTask(TArgument&& callable);
+
+            /// \brief Start or resume the coroutine.
+            void operator()();
+
+            TCallable callable_;                                        ///< \brief Callable object the coroutine is started from. Outlives the coroutine, which may refer to its state.
+
+            Coroutine coroutine_;                                       ///< \brief Coroutine being executed.
+        };
+    }
+
+    /// \brief Create a new task executing a coroutine.
+    /// \param dependencies List of tasks the new task depends upon.
+    /// \param callable Callable object returning the coroutine to execute. Captured state is kept alive until the coroutine completes.
+    /// \return Returns the new task, which completes when the coroutine does.
+    template <typename TCallable>
+    TaskHandle CreateCoroutineTask(const TaskList& dependencies, TCallable&& callable);
+
+    /// \brief Create and schedule a new task executing a coroutine.
+    /// \param callable Callable object returning the coroutine to execute.
+    template <typename TCallable>
+    void DetachCoroutineTask(TCallable&& callable);
+
+}
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // Coroutine.
+
+    inline Coroutine::Coroutine(Handle handle) noexcept
+        : handle_(handle)
+    {
+
+    }
+
+    inline Coroutine::Coroutine(Coroutine&& rhs) noexcept
+        : handle_(std::exchange(rhs.handle_, nullptr))
+    {
+
+    }
+
+    inline Coroutine::~Coroutine()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    inline Coroutine& Coroutine::operator=(Coroutine&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+
+            handle_ = std::exchange(rhs.handle_, nullptr);
+        }
+
+        return *this;
+    }
+
+    inline Coroutine::operator bool() const noexcept
+    {
+        return !!handle_;
+    }
+
+    inline void Coroutine::Resume()
+    {
+        SYNTROPY_ASSERT(handle_ && !handle_.done());
+
+        handle_.resume();
+    }
+
+    inline bool Coroutine::IsDone() const noexcept
+    {
+        return handle_.done();
+    }
+
+    // Coroutine :: promise_type.
+
+    inline void* Coroutine::promise_type::operator new(std::size_t size)
+    {
+        return TaskPool::AllocateFrame(size);
+    }
+
+    inline void Coroutine::promise_type::operator delete(void* frame)
+    {
+        TaskPool::DeallocateFrame(frame);
+    }
+
+    inline Coroutine Coroutine::promise_type::get_return_object() noexcept
+    {
+        return Coroutine(Handle::from_promise(*this));
+    }
+
+    inline coroutines::suspend_always Coroutine::promise_type::initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    inline coroutines::suspend_always Coroutine::promise_type::final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    inline void Coroutine::promise_type::return_void() const noexcept
+    {
+
+    }
+
+    inline void Coroutine::promise_type::unhandled_exception() const noexcept
+    {
+        std::terminate();
+    }
+
+    // WhenAllAwaiter.
+
+    inline WhenAllAwaiter::WhenAllAwaiter(TaskList tasks) noexcept
+        : tasks_(std::move(tasks))
+    {
+
+    }
+
+    inline bool WhenAllAwaiter::await_ready() const noexcept
+    {
+        return tasks_.empty();
+    }
+
+    inline void WhenAllAwaiter::await_suspend(Coroutine::Handle /*handle*/)
+    {
+        YieldTask(tasks_);                                              // The coroutine is resumed when the task is executed again.
+    }
+
+    inline void WhenAllAwaiter::await_resume() const noexcept
+    {
+
+    }
+
+    inline WhenAllAwaiter WhenAll(TaskList tasks)
+    {
+        return WhenAllAwaiter(std::move(tasks));
+    }
+
+    // CoroutineTask<TCallable>.
+
+    template <typename TCallable>
+    template <typename TArgument>
+    inline details::CoroutineTask<TCallable>::CoroutineTask(TArgument&& callable)
+        : callable_(std::forward<TArgument>(callable))
+    {
+
+    }
+
+    template <typename TCallable>
+    inline void details::CoroutineTask<TCallable>::operator()()
+    {
+        if (!coroutine_)
+        {
+            coroutine_ = callable_();                                   // The frame is allocated from the pool of the worker executing the task.
+        }
+
+        coroutine_.Resume();
+    }
+
+    // Non-member functions.
+
+    template <typename TCallable>
+    inline TaskHandle CreateCoroutineTask(const TaskList& dependencies, TCallable&& callable)
+    {
+        return EmplaceTask<details::CoroutineTask<std::decay_t<TCallable>>>(dependencies, std::forward<TCallable>(callable));
+    }
+
+    template <typename TCallable>
+    inline void DetachCoroutineTask(TCallable&& callable)
+    {
+        DetachTask(details::CoroutineTask<std::decay_t<TCallable>>(std::forward<TCallable>(callable)));
+    }
+
+}
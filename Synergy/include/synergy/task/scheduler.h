@@ -8,8 +8,12 @@
 
 #include <thread>
 #include <vector>
+#include <array>
 #include <memory>
 #include <optional>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
 
 #include "syntropy/math/random.h"
 
@@ -18,11 +22,22 @@
 #include "synergy/patterns/sync_counter.h"
 
 #include "synergy/task/task.h"
+#include "synergy/task/task_pool.h"
+#include "synergy/task/task_queue.h"
 #include "synergy/task/worker.h"
 #include "synergy/task/task_execution_context.h"
 
 namespace syntropy::synergy
 {
+    /// \brief Strategy used by starving workers to look for tasks owned by other workers.
+    /// \author Raffaele D. Facendola - June 2017
+    enum class StealPolicy
+    {
+        kShared,            ///< \brief Starving workers scan every other worker and register into a shared list guarded by a global lock.
+        kRandom,            ///< \brief Starving workers probe randomly chosen victims lock-free, backing off exponentially before parking.
+        kTopology,          ///< \brief As kRandom, but victims sharing the same core are probed first, followed by those sharing the same last-level cache, the same NUMA node and finally any other.
+    };
+
     /// \brief Scheduler used to schedule and allocate tasks.
     /// \author Raffaele D. Facendola - June 2017
     class Scheduler
@@ -30,20 +45,45 @@ namespace syntropy::synergy
         template <typename TCallable>
         friend void DetachTask(TCallable&& callable);
 
+        template <typename TCallable>
+        friend void DetachTask(TaskPriority priority, TCallable&& callable);
+
+        template <typename TPredicate>
+        friend void RunUntil(TPredicate&& predicate);
+
     public:
 
+        /// \brief Maximum number of threads outside the scheduler owning a submission queue. Any other external thread hands its tasks over to the workers' mailboxes.
+        static constexpr size_t kMaxExternalThreads = 0x40;
+
         /// \brief Get the scheduler singleton instance.
         static Scheduler& GetInstance();
 
         /// \brief Default destructor. 
         /// Aborts any pending work and blocks the calling thread until each worker thread finishes its execution.
-        ~Scheduler() = default;
+        ~Scheduler();
 
         /// \brief Initialize the scheduler.
         /// Calling other methods on this class before calling "Initialize()" is undefined behaviour.
         /// \param cores Cores reserved for scheduler execution. If left unset all the available cores are taken into account.
+        /// \param steal_policy Strategy used by starving workers to steal tasks from other workers.
         /// \remarks Cores having no affinity for the current process are ignored and do not spawn any worker thread.
-        void Initialize(std::optional<platform::AffinityMask> cores = std::nullopt);
+        void Initialize(std::optional<platform::AffinityMask> cores = std::nullopt, StealPolicy steal_policy = StealPolicy::kShared);
+
+        /// \brief Abort any pending work and block the calling thread until each worker thread finishes its execution.
+        /// The scheduler can be initialized again afterwards.
+        void Shutdown();
+
+        /// \brief Get the number of workers in the scheduler.
+        size_t GetWorkerCount() const;
+
+        /// \brief Get the idle statistics of a worker.
+        /// \param index Index of the worker. Must be lower than GetWorkerCount().
+        WorkerStatistics GetWorkerStatistics(size_t index) const;
+
+        /// \brief Check whether any worker ran out of tasks while the worker running the calling thread has no queued task other workers could steal instead.
+        /// Long-running tasks can poll this method to split their work on demand. The result may be slightly out of date.
+        bool IsWorkDemanded() const;
 
     private:
 
@@ -51,9 +91,7 @@ namespace syntropy::synergy
         struct WorkerThread
         {
             /// \brief Create a new worker thread.
-            /// \param max_tasks Maximum number of tasks that can be allocated by the worker.
-
-            WorkerThread(size_t max_tasks = 0x400);
+            WorkerThread();
 
             WorkerThread(WorkerThread&& other) = default;
 
@@ -61,6 +99,12 @@ namespace syntropy::synergy
             /// Requests tasks termination and blocks the calling thread until the worker thread finishes its execution.
             ~WorkerThread();
 
+            /// \brief Request tasks termination without waiting for the worker thread to finish.
+            void Stop();
+
+            /// \brief Block the calling thread until the worker thread finishes its execution.
+            void Join();
+
             /// \brief Start the worker thread asynchronously.
             /// \param affinity Core affinity for the thread being started. If left unset the thread is started with default affinity.
             void StartAsync(std::optional<platform::AffinityMask> affinity = std::nullopt);
@@ -68,15 +112,80 @@ namespace syntropy::synergy
             /// \brief Get the worker object.
             Worker& GetWorker();
 
+            /// \brief Get the worker object.
+            const Worker& GetWorker() const;
+
+            /// \brief Get the random number generator used by the worker thread to pick steal victims.
+            /// This method should only be called by the worker thread.
+            Random& GetRandom();
+
+            /// \brief Get the victims the worker thread probes when starving, grouped by tier from the closest to the farthest. See StealPolicy::kTopology.
+            /// This method should only be called by the worker thread.
+            std::vector<std::vector<WorkerThread*>>& GetVictimTiers();
+
+            /// \brief Set the victims the worker thread probes when starving, grouped by tier from the closest to the farthest. See StealPolicy::kTopology.
+            /// This method must be called before the worker thread is started.
+            void SetVictimTiers(std::vector<std::vector<WorkerThread*>> victim_tiers);
+
+            /// \brief Flag the worker thread as starving or not.
+            /// This method should only be called by the worker thread.
+            /// \return Returns true if the flag changed, returns false otherwise.
+            bool SetStarving(bool is_starving);
+
         private:
 
             std::unique_ptr<Worker> worker_;                    ///< \brief Worker object used to execute tasks.
 
             std::thread thread_;                                ///< \brief Thread the worker object is spinning onto.
+
+            Random random_;                                     ///< \brief Per-worker random number generator. Avoids sharing any state between thieves.
+
+            std::vector<std::vector<WorkerThread*>> victim_tiers_;  ///< \brief Steal victims grouped by distance from the worker thread. See StealPolicy::kTopology.
+
+            bool is_starving_{ false };                         ///< \brief Whether the worker thread ran out of tasks. Accessed by the worker thread only.
         };
 
+        /// \brief State of a thread outside the scheduler, used to submit and execute tasks without contending with other threads.
+        /// Tasks submitted by an external thread are pushed on its own queues, where they can be stolen by workers or executed by the external thread itself. See RunUntil().
+        struct ExternalThread
+        {
+            /// \brief Create a new external thread state.
+            ExternalThread();
+
+            /// \brief Pop a task from the most urgent non-empty queue.
+            /// This method should only be called by the thread the state is bound to.
+            TaskHandle PopTask();
+
+            /// \brief Steal a task of a given priority class.
+            /// This method can be called by any thread.
+            TaskHandle DequeueTask(TaskPriority priority);
+
+            TaskPool task_pool_;                                ///< \brief Pool used to allocate the tasks created by the external thread.
+
+            TaskExecutionContext execution_context_;            ///< \brief Context used to submit and execute tasks on the external thread.
+
+            std::array<TaskQueue, kTaskPriorityCount> tasks_;   ///< \brief Tasks submitted by the external thread, one queue per priority class.
+
+            std::shared_ptr<Listener> on_task_ready_handle_;    ///< \brief Handle to the listener pushing ready tasks on the queues.
+        };
+
+        /// \brief Binds an external thread state to the current thread, giving it back to the scheduler when the thread exits.
+        /// Tasks left in the queues of a thread that exited can still be stolen by workers.
+        struct ExternalThreadBinding
+        {
+            /// \brief Release the bound state, if any.
+            ~ExternalThreadBinding();
+
+            ExternalThread* external_thread_{ nullptr };        ///< \brief State bound to the current thread.
+        };
+
+        /// \brief Maximum backoff, in yields, before a starving worker gives up stealing and parks.
+        static constexpr size_t kMaxStealBackoff = 0x40;
+
         static thread_local Worker* thread_worker_;             ///< \brief Worker associated to this thread.
 
+        static thread_local ExternalThreadBinding external_thread_;     ///< \brief External thread state associated to this thread, if it is not a worker.
+
         /// \brief Singleton. Prevents direct instantiation.
         Scheduler() = default;
 
@@ -86,28 +195,94 @@ namespace syntropy::synergy
         /// \brief No assignment operator.
         Scheduler& operator=(const Scheduler&) = delete;
 
-        /// \brief Called whenever a task is enqueued in one worker.
-        /// \param sender Worker the task was enqueued on.
-        void OnTaskEnqueued(Worker& sender);
+        /// \brief Called whenever tasks are enqueued in one worker.
+        /// \param sender Worker the tasks were enqueued on.
+        /// \param count Number of tasks enqueued.
+        void OnTaskEnqueued(WorkerThread& sender, size_t count);
 
         /// \brief Called whenever a worker ran out of tasks.
         /// \param sender Worker who ran out of tasks.
-        void OnWorkerStarving(Worker& sender);
+        void OnWorkerStarving(WorkerThread& sender);
+
+        /// \brief Called whenever a starving worker found a new task or was stopped.
+        /// \param sender Worker who's no longer starving.
+        void OnWorkerFed(WorkerThread& sender);
+
+        /// \brief Hand tasks over to starving workers registered in the shared list, if any. See StealPolicy::kShared.
+        /// \param count Maximum number of tasks to hand over, one per starving worker.
+        void ShareTask(Worker& sender, size_t count);
+
+        /// \brief Steal a task from any other worker, registering the sender in the shared list upon failure. See StealPolicy::kShared.
+        void StealSharedTask(Worker& sender);
+
+        /// \brief Wake up parked workers, if any. See StealPolicy::kRandom.
+        /// \param count Maximum number of workers to wake up, usually the number of tasks that became available.
+        void WakeIdleWorkers(size_t count);
+
+        /// \brief Probe random victims until a task is stolen, backing off exponentially between rounds. See StealPolicy::kRandom.
+        /// If every attempt fails the sender is flagged as idle and can be woken up by WakeIdleWorkers().
+        void StealRandomTask(WorkerThread& sender);
+
+        /// \brief Probe each worker once, in random order, attempting to steal a task.
+        /// Under StealPolicy::kTopology closer victim tiers are probed first and victims are picked in random order within each tier.
+        /// \return Returns true if a task was stolen and enqueued in the sender, returns false otherwise.
+        bool ProbeVictims(WorkerThread& sender);
+
+        /// \brief Attempt to steal a task from a victim.
+        /// \return Returns true if a task was stolen and enqueued in the sender, returns false otherwise.
+        bool StealTask(WorkerThread& sender, WorkerThread& victim);
+
+        /// \brief Group the victims of each worker thread by their distance in the CPU topology. See StealPolicy::kTopology.
+        /// \param cores Core each worker thread is bound to, by worker index.
+        void BuildVictimTiers(const std::vector<size_t>& cores);
+
+        /// \brief Called whenever tasks are submitted by an external thread.
+        /// \param sender External thread the tasks were pushed on.
+        /// \param count Number of tasks submitted.
+        void OnExternalTaskEnqueued(ExternalThread& sender, size_t count);
+
+        /// \brief Steal a task from the queues of any external thread.
+        /// \param priority Priority class of the task to steal.
+        /// \param sender External thread attempting to steal, if any. Its queues are skipped.
+        /// \return Returns the stolen task. If no task could be stolen returns nullptr.
+        TaskHandle StealExternalTask(TaskPriority priority, const ExternalThread* sender = nullptr);
+
+        /// \brief Get the state of the calling external thread, binding a new state if none.
+        /// \return Returns the state bound to the calling thread. If every state is already in use by other threads returns nullptr.
+        ExternalThread* GetExternalThread();
+
+        /// \brief Execute a task submitted by the calling external thread or steal one from any other thread, along with any task it leads to.
+        /// \return Returns true if a task was executed, returns false if no task was found.
+        bool RunExternalTask();
 
         /// \brief Called whenever a worker is ready for execution.
         /// \param sender Worker who's ready to execute tasks.
         void OnWorkerReady(Worker& sender);
 
         /// \brief Get a reference to any task execution context in the scheduler.
-        /// This function always prefer a thread-local context, if possible.
+        /// Workers and external threads use their own context. Only when no external thread state is available a context is picked at random among the workers'.
         /// \return Returns any task execution context.
         TaskExecutionContext& GetExecutionContext();
 
         std::vector<WorkerThread> workers_;                     ///< \brief Workers used to execute tasks concurrently.
 
-        mutable std::mutex mutex_;
+        StealPolicy steal_policy_{ StealPolicy::kShared };     ///< \brief Strategy used by starving workers to steal tasks.
+
+        mutable std::mutex mutex_;                              ///< \brief Guards the list of starving workers. See StealPolicy::kShared.
+
+        std::vector<Worker*> starving_workers_;                 ///< \brief Workers waiting for a task. See StealPolicy::kShared.
 
-        std::vector<Worker*> starving_workers_;
+        std::atomic<size_t> idle_workers_{ 0 };                 ///< \brief Number of workers flagged as idle. See StealPolicy::kRandom.
+
+        std::atomic<size_t> starving_workers_count_{ 0 };       ///< \brief Number of workers who ran out of tasks and didn't find a new one yet.
+
+        std::mutex external_mutex_;                             ///< \brief Guards the binding of external thread states and the random number generator.
+
+        std::array<std::unique_ptr<ExternalThread>, kMaxExternalThreads> external_threads_;    ///< \brief State of each external thread ever bound. States are never destroyed, since workers may be stealing from them.
+
+        std::atomic<size_t> external_threads_count_{ 0 };      ///< \brief Number of external thread states in external_threads_.
+
+        std::vector<ExternalThread*> free_external_threads_;    ///< \brief States released by external threads that exited.
 
         Random random_;                                         ///< \brief Internal random number generator.
 
@@ -123,6 +298,80 @@ namespace syntropy::synergy
     template <typename TCallable>
     void DetachTask(TCallable&& callable)
     {
-        return GetScheduler().GetExecutionContext().DetachTask(std::forward<TCallable>(callable));
+        return GetScheduler().GetExecutionContext().DetachTask(TaskPriority::kNormal, std::forward<TCallable>(callable));
+    }
+
+    /// \brief Create and schedule a new task with an explicit priority class from a callable object.
+    /// \tparam TCallable Type of the callable object to wrap inside the task.
+    /// \param priority Priority class of the new task.
+    /// \param callable Callable object to wrap inside the task.
+    template <typename TCallable>
+    void DetachTask(TaskPriority priority, TCallable&& callable)
+    {
+        return GetScheduler().GetExecutionContext().DetachTask(priority, std::forward<TCallable>(callable));
+    }
+
+    /// \brief Execute tasks on the calling thread until a predicate is satisfied.
+    /// The calling thread executes the tasks it submitted first and steals tasks from any other thread afterwards, yielding its time slice whenever no task is found.
+    /// This function is meant to be called by threads outside the scheduler, such as the main thread, and must not be called from within a task.
+    /// \param predicate Predicate checked before executing each task. Called on the calling thread only.
+    template <typename TPredicate>
+    void RunUntil(TPredicate&& predicate);
+
+    /// \brief Execute a callable object as a new task and execute tasks on the calling thread until the task completes.
+    /// This function is meant to be called by threads outside the scheduler, such as the main thread, and must not be called from within a task.
+    /// \param callable Callable object to execute. If it returns a TaskHandle, the wait lasts until the returned task completes as well.
+    template <typename TCallable>
+    void WaitFor(TCallable&& callable);
+}
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    template <typename TPredicate>
+    void RunUntil(TPredicate&& predicate)
+    {
+        SYNTROPY_ASSERT(!Scheduler::thread_worker_);                                            // Workers must use continuations instead of waiting.
+
+        auto& scheduler = GetScheduler();
+
+        while (!predicate())
+        {
+            if (!scheduler.RunExternalTask())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template <typename TCallable>
+    void WaitFor(TCallable&& callable)
+    {
+        std::atomic_bool is_done{ false };
+
+        DetachTask([&callable, &is_done]()
+        {
+            auto signal = [&is_done]()
+            {
+                is_done.store(true, std::memory_order_release);
+            };
+
+            if constexpr (std::is_same_v<std::invoke_result_t<TCallable&>, TaskHandle>)
+            {
+                CreateTask({ callable() }, signal);
+            }
+            else
+            {
+                CreateTask({ CreateTask({}, [&callable]() { callable(); }) }, signal);          // Wait for the task continuations as well.
+            }
+        });
+
+        RunUntil([&is_done]()
+        {
+            return is_done.load(std::memory_order_acquire);
+        });
     }
 }
@@ -10,24 +10,125 @@
 #include <memory>
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
 
 #include "syntropy/diagnostics/assert.h"
 
+#include "synergy/task/task_trace.h"
+
 namespace syntropy::synergy
 {
     class Task;
+    class TaskPool;
+
+    /// \brief Intrusive reference-counted handle to a task.
+    /// Tasks are destroyed and returned to the pool they were allocated from as soon as the last handle referring to them is released.
+    /// \author Raffaele D. Facendola - November 2017
+    class TaskHandle
+    {
+    public:
+
+        /// \brief Create an empty handle.
+        TaskHandle() noexcept = default;
+
+        /// \brief Create an empty handle.
+        TaskHandle(std::nullptr_t) noexcept;
+
+        /// \brief Create a new handle to a task.
+        /// \param task Task to refer to.
+        /// \param add_reference Whether to increase the task reference count. If false the handle adopts a reference that was previously detached via Detach().
+        explicit TaskHandle(Task* task, bool add_reference = true) noexcept;
+
+        /// \brief Copy constructor.
+        TaskHandle(const TaskHandle& rhs) noexcept;
+
+        /// \brief Move constructor.
+        TaskHandle(TaskHandle&& rhs) noexcept;
+
+        /// \brief Release the reference to the task, if any.
+        ~TaskHandle();
+
+        /// \brief Unified assignment operator.
+        TaskHandle& operator=(TaskHandle rhs) noexcept;
+
+        /// \brief Check whether the handle refers to a task.
+        explicit operator bool() const noexcept;
+
+        /// \brief Access the task.
+        Task* operator->() const noexcept;
+
+        /// \brief Access the task.
+        Task& operator*() const noexcept;
+
+        /// \brief Get the task this handle refers to.
+        Task* Get() const noexcept;
+
+        /// \brief Release the ownership of the task without decreasing its reference count.
+        /// The returned reference must be adopted by another handle later on. See TaskHandle(task, false).
+        /// \return Returns the task this handle referred to.
+        Task* Detach() noexcept;
+
+        /// \brief Swap this handle with the provided instance.
+        void Swap(TaskHandle& rhs) noexcept;
+
+    private:
+
+        Task* task_{ nullptr };                                 ///< \brief Task this handle refers to.
+    };
+
+    /// \brief Equality comparison for TaskHandle.
+    bool operator==(const TaskHandle& lhs, const TaskHandle& rhs) noexcept;
+
+    /// \brief Inequality comparison for TaskHandle.
+    bool operator!=(const TaskHandle& lhs, const TaskHandle& rhs) noexcept;
 
     /// \brief A list of tasks.
-    using TaskList = std::vector<std::shared_ptr<Task>>;
+    using TaskList = std::vector<TaskHandle>;
+
+    /// \brief Priority class of a task.
+    /// Workers execute tasks in the most urgent class first. Less urgent classes are aged to prevent starvation.
+    /// \author Raffaele D. Facendola - 2018
+    enum class TaskPriority : uint8_t
+    {
+        kHigh = 0u,                                             ///< \brief Latency-critical tasks.
+        kNormal = 1u,                                           ///< \brief Default priority.
+        kLow = 2u,                                              ///< \brief Background tasks.
+    };
+
+    /// \brief Number of task priority classes.
+    inline constexpr size_t kTaskPriorityCount = 3;
 
     /// \brief Represents the atomic unit of a parallel computation.
     /// Tasks are expected to perform a small, non-blocking computation.
-    /// #TODO Tasks should not share a cache line with other tasks, as it would create false sharing among different worker threads.
+    /// Tasks are aligned to cache-line boundaries to prevent false sharing among different worker threads.
+    /// Callable objects small enough are stored inline, without any additional allocation.
     /// \author Raffaele D. Facendola - November 2017
-    class Task : public std::enable_shared_from_this<Task>
+    class alignas(64) Task
     {
+        friend class TaskHandle;
+        friend class TaskPool;
+        friend class TaskGraph;
+
     public:
 
+        /// \brief Maximum size of a callable object that can be stored inline inside the task, including the bookkeeping of the executable.
+        static constexpr size_t kInlineStorageSize = 64;
+
+        /// \brief Create an empty task.
+        /// \param pool Pool the task was allocated from. If nullptr the task was allocated on the heap.
+        Task(TaskPool* pool = nullptr) noexcept;
+
+        /// \brief No copy constructor.
+        Task(const Task&) = delete;
+
+        /// \brief No assignment operator.
+        Task& operator=(const Task&) = delete;
+
+        /// \brief Destroy the task and the callable object inside it.
+        ~Task();
+
         /// \brief Construct the task from a callable object.
         /// \tparam TCallable Type of the callable object to wrap inside the task.
         /// \param dependencies List of tasks the new task depends upon.
@@ -35,9 +136,7 @@ namespace syntropy::synergy
         template <typename TCallable>
         void Construct(const TaskList& dependencies, TCallable&& callable)
         {
-            executable_ = std::make_unique<Executable<TCallable>>(std::forward<TCallable>(callable));               // #TODO Use proper allocator.
-
-            SetDependencies(dependencies);
+            Emplace<std::decay_t<TCallable>>(dependencies, std::forward<TCallable>(callable));
         }
 
         /// \brief Construct the task by creating a callable object in-place.
@@ -48,7 +147,18 @@ namespace syntropy::synergy
         template <typename TTask, typename... TArguments>
         void Emplace(const TaskList& dependencies, TArguments&&... arguments)
         {
-            executable_ = std::make_unique<Executable<TTask>>(std::forward<TArguments>(arguments)...);              // #TODO Use proper allocator.
+            SYNTROPY_ASSERT(!executable_);
+
+            using TExecutable = Executable<TTask>;
+
+            if constexpr (sizeof(TExecutable) <= kInlineStorageSize && alignof(TExecutable) <= alignof(std::max_align_t))
+            {
+                executable_ = new (&storage_) TExecutable(std::forward<TArguments>(arguments)...);            // Small object: no allocation.
+            }
+            else
+            {
+                executable_ = new TExecutable(std::forward<TArguments>(arguments)...);
+            }
 
             SetDependencies(dependencies);
         }
@@ -56,6 +166,13 @@ namespace syntropy::synergy
         /// \brief Execute this task.
         void Execute();
 
+        /// \brief Get the priority class of this task.
+        TaskPriority GetPriority() const;
+
+        /// \brief Get the unique id used to identify this task in the task trace.
+        /// \return Returns the id of the task. Returns 0 if tracing is disabled.
+        uint64_t GetTraceId() const;
+
         /// \brief Set task dependencies, replacing any existing one.
         /// This method can only be called if this task has no outstanding dependency.
         /// \tparam TDependencies Type of the collection containing the dependencies. Must be an iterable container of Tasks.
@@ -68,9 +185,10 @@ namespace syntropy::synergy
 
         /// \brief Move successors from this task to another task.
         /// \param task Task to move the successors to.
-        void ContinueWith(std::shared_ptr<Task> task);
+        void ContinueWith(const TaskHandle& task);
 
         /// \brief Move successors from this task to the provided collection.
+        /// Persistent successors are copied to the collection and retained by this task. See TaskGraph.
         /// \param collection Collection to move the successors to.
         void MoveSuccessors(TaskList& successors);
 
@@ -79,6 +197,9 @@ namespace syntropy::synergy
         /// \brief Interface for executable tasks.
         struct IExecutable
         {
+            /// \brief Virtual destructor.
+            virtual ~IExecutable() = default;
+
             /// \brief Execute this task.
             virtual void operator()() = 0;
         };
@@ -87,11 +208,29 @@ namespace syntropy::synergy
         template <typename TExecutable>
         struct Executable;
 
+        /// \brief Increase the reference count of the task by one.
+        void AddReference() noexcept;
+
+        /// \brief Decrease the reference count of the task by one, destroying the task if no other reference exists.
+        void RemoveReference() noexcept;
+
+        std::atomic_size_t reference_count_{ 0 };               ///< \brief Number of handles referring to this task.
+
         std::atomic_size_t dependency_count_{ 0 };              ///< \brief Number of tasks this task depends upon, plus one if the task wasn't scheduled yet.
 
         TaskList successors_;                                   ///< \brief List of tasks depending on this task.
 
-        std::unique_ptr<IExecutable> executable_;               ///< \brief Executable. #TODO Small object optimization.
+        TaskPool* pool_{ nullptr };                             ///< \brief Pool the task was allocated from.
+
+        uint64_t trace_id_{ 0 };                                ///< \brief Unique id of the task in the task trace. Declared regardless of SYNERGY_TRACE, so that the layout of the task doesn't depend on it.
+
+        TaskPriority priority_{ TaskPriority::kNormal };        ///< \brief Priority class of the task.
+
+        uint32_t persistent_successors_count_{ 0 };             ///< \brief Number of successors, at the front of successors_, retained by the task after each execution. See TaskGraph.
+
+        IExecutable* executable_{ nullptr };                    ///< \brief Executable. Either points to the inline storage or to a heap-allocated object.
+
+        std::aligned_storage_t<kInlineStorageSize> storage_;    ///< \brief Inline storage for small executable objects.
     };
 
     /// \brief Concrete class for executable tasks.
@@ -120,3 +259,111 @@ namespace syntropy::synergy
 
 }
 
+/// \brief Swaps two syntropy::synergy::TaskHandle instances.
+void swap(syntropy::synergy::TaskHandle& lhs, syntropy::synergy::TaskHandle& rhs) noexcept;
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // TaskHandle.
+
+    inline TaskHandle::TaskHandle(std::nullptr_t) noexcept
+    {
+
+    }
+
+    inline TaskHandle::TaskHandle(Task* task, bool add_reference) noexcept
+        : task_(task)
+    {
+        if (task_ && add_reference)
+        {
+            task_->AddReference();
+        }
+    }
+
+    inline TaskHandle::TaskHandle(const TaskHandle& rhs) noexcept
+        : TaskHandle(rhs.task_)
+    {
+
+    }
+
+    inline TaskHandle::TaskHandle(TaskHandle&& rhs) noexcept
+        : task_(rhs.Detach())
+    {
+
+    }
+
+    inline TaskHandle::~TaskHandle()
+    {
+        if (task_)
+        {
+            task_->RemoveReference();
+        }
+    }
+
+    inline TaskHandle& TaskHandle::operator=(TaskHandle rhs) noexcept
+    {
+        rhs.Swap(*this);
+        return *this;
+    }
+
+    inline TaskHandle::operator bool() const noexcept
+    {
+        return task_ != nullptr;
+    }
+
+    inline Task* TaskHandle::operator->() const noexcept
+    {
+        return task_;
+    }
+
+    inline Task& TaskHandle::operator*() const noexcept
+    {
+        return *task_;
+    }
+
+    inline Task* TaskHandle::Get() const noexcept
+    {
+        return task_;
+    }
+
+    inline Task* TaskHandle::Detach() noexcept
+    {
+        auto task = task_;
+
+        task_ = nullptr;
+
+        return task;
+    }
+
+    inline void TaskHandle::Swap(TaskHandle& rhs) noexcept
+    {
+        std::swap(task_, rhs.task_);
+    }
+
+    inline bool operator==(const TaskHandle& lhs, const TaskHandle& rhs) noexcept
+    {
+        return lhs.Get() == rhs.Get();
+    }
+
+    inline bool operator!=(const TaskHandle& lhs, const TaskHandle& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    // Task.
+
+    inline void Task::AddReference() noexcept
+    {
+        reference_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+}
+
+inline void swap(syntropy::synergy::TaskHandle& lhs, syntropy::synergy::TaskHandle& rhs) noexcept
+{
+    lhs.Swap(rhs);
+}
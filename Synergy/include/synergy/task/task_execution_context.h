@@ -9,6 +9,7 @@
 #include <memory>
 #include <algorithm>
 #include <vector>
+#include <type_traits>
 
 #include "syntropy/patterns/observable.h"
 
@@ -21,11 +22,16 @@ namespace syntropy::synergy
     /// \author Raffaele D. Facendola - November 2017
     class TaskExecutionContext
     {
+        friend class TaskGraph;
+
+        template <typename TTask, typename... TArguments>
+        friend TaskHandle EmplaceTask(const TaskList& dependencies, TArguments&&... arguments);
+
         template <typename TTask, typename... TArguments>
-        friend std::shared_ptr<Task> EmplaceTask(const TaskList& dependencies, TArguments&&... arguments);
+        friend TaskHandle EmplaceTask(TaskPriority priority, const TaskList& dependencies, TArguments&&... arguments);
 
         template <typename TTask, typename... TArguments>
-        friend std::shared_ptr<Task> EmplaceTaskContinuation(const TaskList& dependencies, TArguments&&... arguments);
+        friend TaskHandle EmplaceTaskContinuation(const TaskList& dependencies, TArguments&&... arguments);
 
         friend void RescheduleTask(const TaskList& dependencies);
 
@@ -33,39 +39,53 @@ namespace syntropy::synergy
 
     public:
 
-        /// \brief Arguments of the event called whenever a task became ready for execution.
+        /// \brief Create a new execution context.
+        /// \param task_pool Pool used to allocate new tasks. Must outlive any task allocated through this context.
+        TaskExecutionContext(TaskPool& task_pool);
+
+        /// \brief No copy constructor.
+        TaskExecutionContext(const TaskExecutionContext&) = delete;
+
+        /// \brief No assignment operator.
+        TaskExecutionContext& operator=(const TaskExecutionContext&) = delete;
+
+        /// \brief Arguments of the event called whenever tasks became ready for execution.
+        /// Tasks becoming ready together are notified in bulk, so that listeners can amortize the cost of scheduling them.
         struct OnTaskReadyEventArgs
         {
-            std::shared_ptr<Task> task_;                ///< \brief Task ready for execution.
+            TaskList& tasks_;                           ///< \brief Tasks ready for execution. Listeners are expected to take ownership of the tasks, leaving the list empty.
         };
 
         /// \brief Execute a task that runs without dependencies nor successors on this execution context.
         /// The task is scheduled immediately after creation.
         /// \tparam TCallable Type of the callable object to wrap inside the task.
+        /// \param priority Priority class of the new task.
         /// \param callable Callable object to wrap inside the task.
         template <typename TCallable>
-        void DetachTask(TCallable&& callable)
+        void DetachTask(TaskPriority priority, TCallable&& callable)
         {
-            auto task = task_pool_.CreateTask({}, std::forward<TCallable>(callable));
+            auto task = task_pool_.CreateTask(priority, {}, std::forward<TCallable>(callable));
 
             task->ScheduleConditional();            // The task has no dependencies: this call must yield true.
 
-            on_task_ready_.Notify(*this, OnTaskReadyEventArgs{ std::move(task) });
+            auto tasks = TaskList{ std::move(task) };
+
+            on_task_ready_.Notify(*this, OnTaskReadyEventArgs{ tasks });
         }
 
         /// \brief Execute the provided task.
         /// \return Returns the next task to execute.
-        std::shared_ptr<Task> ExecuteTask(std::shared_ptr<Task> task);
+        TaskHandle ExecuteTask(TaskHandle task);
 
-        /// \brief Observable event called whenever a new task is ready for execution.
+        /// \brief Observable event called whenever new tasks are ready for execution.
         Observable<TaskExecutionContext&, const OnTaskReadyEventArgs&>& OnTaskReady();
 
     private:
 
         template <typename TTask, typename... TArguments>
-        std::shared_ptr<Task> EmplaceTask(const TaskList& dependencies, TArguments&&... arguments)
+        TaskHandle EmplaceTask(TaskPriority priority, const TaskList& dependencies, TArguments&&... arguments)
         {
-            auto task = task_pool_.EmplaceTask<TTask>(dependencies, std::forward<TArguments>(arguments)...);
+            auto task = task_pool_.EmplaceTask<TTask>(priority, dependencies, std::forward<TArguments>(arguments)...);
 
             pending_tasks_.emplace_back(task);
 
@@ -73,9 +93,9 @@ namespace syntropy::synergy
         }
 
         template <typename TTask, typename... TArguments>
-        std::shared_ptr<Task> EmplaceTaskContinuation(const TaskList& dependencies, TArguments&&... arguments)
+        TaskHandle EmplaceTaskContinuation(const TaskList& dependencies, TArguments&&... arguments)
         {
-            auto task = task_pool_.EmplaceTask<TTask>(dependencies, std::forward<TArguments>(arguments)...);
+            auto task = task_pool_.EmplaceTask<TTask>(priority_, dependencies, std::forward<TArguments>(arguments)...);
 
             continuation_tasks_.emplace_back(task);
             pending_tasks_.emplace_back(task);
@@ -98,44 +118,65 @@ namespace syntropy::synergy
         /// \brief Get the continuation task for the task being executed.
         /// After calling this method, continuation_tasks_ content becomes valid but undefined.
         /// \return Returns the continuation task for the task being executed.
-        std::shared_ptr<Task> GetContinuation();
+        TaskHandle GetContinuation();
 
         /// \brief Schedule current pending tasks.
         /// After calling this method, pending_tasks_ content becomes valid but undefined.
         /// \return Returns the next task to be executed on this context. This task, if present, is not notified.
-        std::shared_ptr<Task> SchedulePendingTasks();
+        TaskHandle SchedulePendingTasks();
 
         static thread_local TaskExecutionContext* innermost_context_;                           ///< \brief Current task execution context.
 
-        TaskPool task_pool_;                                                                    ///< \brief Pool used to allocate new tasks.
+        TaskPool& task_pool_;                                                                   ///< \brief Pool used to allocate new tasks.
 
-        std::shared_ptr<Task> reschedulable_task_;                                              ///< \brief Task that can be rescheduled in this context. It can either contain the current task or nullptr if the task was already rescheduled.
+        TaskPriority priority_{ TaskPriority::kNormal };                                        ///< \brief Priority class of the task being executed. Inherited by any task spawned during its execution.
+
+        TaskHandle reschedulable_task_;                                                         ///< \brief Task that can be rescheduled in this context. It can either contain the current task or nullptr if the task was already rescheduled.
 
         TaskList pending_tasks_;                                                               ///< \brief Pending tasks waiting to be scheduled.
 
         TaskList continuation_tasks_;                                                          ///< \brief Continuations for the task being executed. Always a subset of pending_tasks_.
 
-        Event<TaskExecutionContext&, const OnTaskReadyEventArgs&> on_task_ready_;               ///< \brief Event called whenever a new task becomes ready for execution.
+        TaskList ready_tasks_;                                                                 ///< \brief Pending tasks that became ready for execution, notified in bulk.
+
+        Event<TaskExecutionContext&, const OnTaskReadyEventArgs&> on_task_ready_;               ///< \brief Event called whenever new tasks become ready for execution.
     };
 
     /// \brief Create a new task constructing the callable object in-place.
+    /// The new task inherits the priority class of the current task.
     /// \tparam TTask Type of the callable object to construct.
     /// \param arguments Arguments to pass to the task in-place creation. See Task::Emplace.
     /// \return Returns the new task.
     template <typename TTask, typename... TArguments>
-    std::shared_ptr<Task> EmplaceTask(const TaskList& dependencies, TArguments&&... arguments)
+    TaskHandle EmplaceTask(const TaskList& dependencies, TArguments&&... arguments)
     {
         SYNTROPY_ASSERT(TaskExecutionContext::innermost_context_);
 
-        return TaskExecutionContext::innermost_context_->EmplaceTask<TTask>(dependencies, std::forward<TArguments>(arguments)...);
+        auto& context = *TaskExecutionContext::innermost_context_;
+
+        return context.EmplaceTask<TTask>(context.priority_, dependencies, std::forward<TArguments>(arguments)...);
+    }
+
+    /// \brief Create a new task with an explicit priority class constructing the callable object in-place.
+    /// \tparam TTask Type of the callable object to construct.
+    /// \param priority Priority class of the new task.
+    /// \param arguments Arguments to pass to the task in-place creation. See Task::Emplace.
+    /// \return Returns the new task.
+    template <typename TTask, typename... TArguments>
+    TaskHandle EmplaceTask(TaskPriority priority, const TaskList& dependencies, TArguments&&... arguments)
+    {
+        SYNTROPY_ASSERT(TaskExecutionContext::innermost_context_);
+
+        return TaskExecutionContext::innermost_context_->EmplaceTask<TTask>(priority, dependencies, std::forward<TArguments>(arguments)...);
     }
 
     /// \brief Create a continuation for the current task constructing the callable object in-place.
+    /// Continuations always inherit the priority class of the current task.
     /// \tparam TTask Type of the callable object to construct.
     /// \param arguments Arguments to pass to the task in-place creation. See TaskPool::EmplaceTask.
     /// \return Returns the new task.
     template <typename TTask, typename... TArguments>
-    std::shared_ptr<Task> EmplaceTaskContinuation(const TaskList& dependencies, TArguments&&... arguments)
+    TaskHandle EmplaceTaskContinuation(const TaskList& dependencies, TArguments&&... arguments)
     {
         SYNTROPY_ASSERT(TaskExecutionContext::innermost_context_);
 
@@ -146,18 +187,28 @@ namespace syntropy::synergy
     /// \param arguments Arguments to pass to the task creation. See Task::Construct.
     /// \return Returns the new task.
     template <typename TCallable>
-    std::shared_ptr<Task> CreateTask(const TaskList& dependencies, TCallable&& callable)
+    TaskHandle CreateTask(const TaskList& dependencies, TCallable&& callable)
+    {
+        return EmplaceTask<std::decay_t<TCallable>>(dependencies, std::forward<TCallable>(callable));
+    }
+
+    /// \brief Create a new task with an explicit priority class from a callable object.
+    /// \param priority Priority class of the new task.
+    /// \param arguments Arguments to pass to the task creation. See Task::Construct.
+    /// \return Returns the new task.
+    template <typename TCallable>
+    TaskHandle CreateTask(TaskPriority priority, const TaskList& dependencies, TCallable&& callable)
     {
-        return EmplaceTask<TCallable>(dependencies, std::forward<TCallable>(callable));
+        return EmplaceTask<std::decay_t<TCallable>>(priority, dependencies, std::forward<TCallable>(callable));
     }
 
     /// \brief Create a continuation for the current task from a callable object.
     /// \param arguments Arguments to pass to the task creation. See TaskPool::CreateTask.
     /// \return Returns the new task.
     template <typename TCallable>
-    std::shared_ptr<Task> CreateTaskContinuation(const TaskList& dependencies, TCallable&& callable)
+    TaskHandle CreateTaskContinuation(const TaskList& dependencies, TCallable&& callable)
     {
-        return EmplaceTaskContinuation<TCallable>(dependencies, std::forward<TCallable>(callable));
+        return EmplaceTaskContinuation<std::decay_t<TCallable>>(dependencies, std::forward<TCallable>(callable));
     }
 
     /// \brief Set the current task to be rescheduled as a new task after its current execution.
@@ -0,0 +1,139 @@
+
+/// \file task_graph.h
+/// \brief This header is part of the synergy task system. It contains definitions for task graphs recorded once and launched many times.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+#include "syntropy/diagnostics/assert.h"
+
+#include "synergy/task/task.h"
+
+namespace syntropy::synergy
+{
+    /// \brief A graph of tasks whose shape is recorded once and that can be launched any number of times.
+    /// Tasks and dependencies are created when the graph is recorded: launching the graph only resets the dependency count of each task from a flat array, without allocating any task or successor list.
+    /// Tasks in the graph retain their successors after each execution. Additional tasks depending on a task in the graph are released after that execution, as usual.
+    /// \author Raffaele D. Facendola - 2018
+    class TaskGraph
+    {
+    public:
+
+        /// \brief Create an empty graph.
+        TaskGraph() = default;
+
+        /// \brief No copy constructor.
+        TaskGraph(const TaskGraph&) = delete;
+
+        /// \brief No assignment operator.
+        TaskGraph& operator=(const TaskGraph&) = delete;
+
+        /// \brief Destroy the graph.
+        /// The graph must not be running.
+        ~TaskGraph();
+
+        /// \brief Record a new task from a callable object.
+        /// The callable object is executed each time the graph is launched, hence it must be invocable more than once.
+        /// \param dependencies List of tasks the new task depends upon. Must be tasks previously recorded in this graph.
+        /// \param callable Callable object to wrap inside the task.
+        /// \return Returns the new task.
+        template <typename TCallable>
+        TaskHandle CreateTask(const TaskList& dependencies, TCallable&& callable);
+
+        /// \brief Record a new task with an explicit priority class from a callable object.
+        /// The callable object is executed each time the graph is launched, hence it must be invocable more than once.
+        /// \param priority Priority class of the new task.
+        /// \param dependencies List of tasks the new task depends upon. Must be tasks previously recorded in this graph.
+        /// \param callable Callable object to wrap inside the task.
+        /// \return Returns the new task.
+        template <typename TCallable>
+        TaskHandle CreateTask(TaskPriority priority, const TaskList& dependencies, TCallable&& callable);
+
+        /// \brief Record a new task constructing the callable object in-place.
+        /// \tparam TTask Type of the callable object to construct.
+        /// \param priority Priority class of the new task.
+        /// \param dependencies List of tasks the new task depends upon. Must be tasks previously recorded in this graph.
+        /// \param arguments Arguments to pass to the callable object constructor.
+        /// \return Returns the new task.
+        template <typename TTask, typename... TArguments>
+        TaskHandle EmplaceTask(TaskPriority priority, const TaskList& dependencies, TArguments&&... arguments);
+
+        /// \brief Get the number of tasks recorded in the graph.
+        size_t GetTaskCount() const;
+
+        /// \brief Launch the graph.
+        /// Tasks without dependencies are scheduled after the current task returns, as any other task created by it. No task can be recorded after the first launch.
+        /// This method must be called from within a task. Threads outside the scheduler can use WaitFor([&graph]() { return graph.Launch(); }).
+        /// \return Returns a task completing after every task in the graph. The graph can be launched again only after this task completed.
+        TaskHandle Launch();
+
+    private:
+
+        /// \brief Record a task in the graph.
+        /// \param task Task to record, whose dependencies were already set.
+        /// \param dependencies List of tasks the new task depends upon.
+        /// \return Returns the recorded task.
+        TaskHandle Record(TaskHandle task, const TaskList& dependencies);
+
+        /// \brief Close the graph, creating the task each leaf of the graph leads to.
+        void Seal();
+
+        /// \brief Re-arm the dependency count of each task in the graph.
+        void Reset();
+
+        TaskList tasks_;                                        ///< \brief Tasks in the graph, in recording order.
+
+        std::vector<size_t> dependency_counts_;                 ///< \brief Dependency count each task is armed with before launching the graph, by task index.
+
+        TaskList roots_;                                        ///< \brief Tasks in the graph without dependencies.
+
+        TaskHandle sink_;                                       ///< \brief Empty task depending on each leaf of the graph. Set when the graph is launched for the first time.
+    };
+
+}
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // TaskGraph.
+
+    template <typename TCallable>
+    inline TaskHandle TaskGraph::CreateTask(const TaskList& dependencies, TCallable&& callable)
+    {
+        return EmplaceTask<std::decay_t<TCallable>>(TaskPriority::kNormal, dependencies, std::forward<TCallable>(callable));
+    }
+
+    template <typename TCallable>
+    inline TaskHandle TaskGraph::CreateTask(TaskPriority priority, const TaskList& dependencies, TCallable&& callable)
+    {
+        return EmplaceTask<std::decay_t<TCallable>>(priority, dependencies, std::forward<TCallable>(callable));
+    }
+
+    template <typename TTask, typename... TArguments>
+    inline TaskHandle TaskGraph::EmplaceTask(TaskPriority priority, const TaskList& dependencies, TArguments&&... arguments)
+    {
+        SYNTROPY_ASSERT(!sink_);                                                // No task can be recorded after the graph was launched.
+
+        auto task = TaskHandle(new Task());                                     // Tasks in the graph outlive any pool.
+
+        task->priority_ = priority;
+
+        task->Emplace<TTask>(dependencies, std::forward<TArguments>(arguments)...);
+
+        return Record(std::move(task), dependencies);
+    }
+
+    inline size_t TaskGraph::GetTaskCount() const
+    {
+        return tasks_.size() - (sink_ ? 1 : 0);
+    }
+
+}
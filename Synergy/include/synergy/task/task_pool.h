@@ -6,25 +6,48 @@
 
 #pragma once
 
-#include <vector>
-#include <memory>
+#include <atomic>
+#include <thread>
+#include <cstddef>
 
 #include "syntropy/diagnostics/assert.h"
 
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/alignment.h"
+#include "syntropy/memory/memory_address.h"
+#include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/virtual_memory_buffer.h"
+#include "syntropy/memory/allocators/linear_allocator.h"
+#include "syntropy/memory/allocators/pool_allocator_policy.h"
+
 #include "synergy/task/task.h"
 
 namespace syntropy::synergy
 {
 
     /// \brief Handles allocation, pooling and construction of tasks.
-    /// This pool is not thread-safe.
+    /// Tasks are allocated from a pool of fixed-size blocks carved out of a virtual memory range which is committed on demand: creating a task never touches the global allocator.
+    /// The pool is meant to be used by a single owner thread (see Bind()): tasks created by any other thread are allocated on the heap instead.
+    /// Tasks can be destroyed by any thread: tasks released by threads other than the owner are handed back to the pool lock-free and recycled by the owner thread later on.
+    /// The same scheme serves the frames of coroutines started by the owner thread. See AllocateFrame().
     /// \author Raffaele D. Facendola - November 2017
     class TaskPool
     {
     public:
 
+        /// \brief Default amount of virtual memory reserved by each pool.
+        static constexpr Bytes kDefaultCapacity = Bytes(0x10000000);
+
+        /// \brief Default amount of virtual memory reserved by each pool for coroutine frames.
+        static constexpr Bytes kDefaultFrameCapacity = Bytes(0x4000000);
+
+        /// \brief Maximum size of a coroutine frame that can be allocated from the pool, including the bookkeeping of the pool.
+        static constexpr size_t kFrameBlockSize = 0x200;
+
         /// \brief Create a new task pool.
-        TaskPool() = default;
+        /// \param capacity Amount of virtual memory reserved for the pool. Tasks exceeding the capacity are allocated on the heap.
+        /// \param frame_capacity Amount of virtual memory reserved for coroutine frames. Frames exceeding the capacity are allocated on the heap.
+        TaskPool(Bytes capacity = kDefaultCapacity, Bytes frame_capacity = kDefaultFrameCapacity);
 
         /// \brief No copy constructor.
         TaskPool(const TaskPool&) = delete;
@@ -32,13 +55,30 @@ namespace syntropy::synergy
         /// \brief No assignment operator.
         TaskPool& operator=(const TaskPool&) = delete;
 
+        /// \brief Default destructor.
+        /// Each task allocated by this pool must have been destroyed before this call.
+        ~TaskPool() = default;
+
+        /// \brief Bind the pool to the calling thread.
+        /// Only the bound thread can allocate tasks from the pool and release them directly.
+        /// \remarks The pool must not be bound to any other thread. See Unbind().
+        void Bind();
+
+        /// \brief Unbind the pool from the calling thread, which must be its owner.
+        /// Blocks released while the pool is unbound are handed back to the pool as if they were released by a foreign thread.
+        /// The caller must synchronize with the thread the pool is bound to next.
+        void Unbind();
+
         /// \brief Construct a task from a callable object.
+        /// \param priority Priority class of the new task.
         /// \param callable Callable object to wrap inside the task.
         /// \param dependencies List of tasks the new task depends upon.
         template <typename TCallable>
-        std::shared_ptr<Task> CreateTask(const TaskList& dependencies, TCallable&& callable)
+        TaskHandle CreateTask(TaskPriority priority, const TaskList& dependencies, TCallable&& callable)
         {
-            auto task = std::make_shared<Task>();
+            auto task = AllocateTask();
+
+            task->priority_ = priority;
 
             task->Construct(dependencies, std::forward<TCallable>(callable));
 
@@ -46,16 +86,111 @@ namespace syntropy::synergy
         }
 
         /// \brief Construct a task by creating a callable object in-place.
+        /// \param priority Priority class of the new task.
         /// \param arguments Arguments to pass to the task constructor.
         /// \param dependencies List of tasks the new task depends upon.
         template <typename TTask, typename... TArguments>
-        std::shared_ptr<Task> EmplaceTask(const TaskList& dependencies, TArguments&&... arguments)
+        TaskHandle EmplaceTask(TaskPriority priority, const TaskList& dependencies, TArguments&&... arguments)
         {
-            auto task = std::make_shared<Task>();
+            auto task = AllocateTask();
+
+            task->priority_ = priority;
 
             task->Emplace<TTask>(dependencies, std::forward<TArguments>(arguments)...);
 
             return task;
         }
+
+        /// \brief Destroy a task and return its memory to the pool it was allocated from.
+        /// This method can be called by any thread.
+        static void DestroyTask(Task& task);
+
+        /// \brief Allocate a coroutine frame from the pool bound to the calling thread.
+        /// Frames requested by threads no pool is bound to, or too large to fit a block, are allocated on the heap.
+        /// \param size Size of the frame, in bytes.
+        /// \return Returns the new frame, aligned to the default new alignment.
+        static void* AllocateFrame(std::size_t size);
+
+        /// \brief Release a coroutine frame allocated via AllocateFrame().
+        /// This method can be called by any thread.
+        static void DeallocateFrame(void* frame);
+
+        /// \brief Get the number of coroutine frames currently allocated from any task pool.
+        /// Frames allocated on the heap are not accounted for. Meant for diagnostics only.
+        static std::size_t GetFrameCount() noexcept;
+
+    private:
+
+        /// \brief Block released by a thread other than the owner thread, waiting to be recycled.
+        struct RemoteBlock
+        {
+            RemoteBlock* next_;                                                 ///< \brief Next block in the list.
+        };
+
+        /// \brief Pool of fixed-size blocks carved out of a virtual memory range which is committed on demand.
+        /// Blocks are allocated by the owner thread only, while any thread can release them.
+        struct BlockPool
+        {
+            /// \brief Create a new block pool.
+            /// \param block_size Size of each block.
+            /// \param alignment Alignment of each block.
+            /// \param capacity Amount of virtual memory reserved for the pool.
+            BlockPool(Bytes block_size, Alignment alignment, Bytes capacity);
+
+            /// \brief Allocate a new block. This method can only be called by the owner thread.
+            /// \return Returns the new block. If the pool is exhausted or its memory could not be committed returns an empty range.
+            MemoryRange Allocate();
+
+            /// \brief Release a block. This method can only be called by the owner thread.
+            void Deallocate(void* block);
+
+            /// \brief Hand a block back to the pool from a thread other than the owner thread. The block is recycled by the owner thread later on.
+            void DeallocateRemote(void* block);
+
+            /// \brief Recycle the blocks released by threads other than the owner thread.
+            /// This method can only be called by the owner thread.
+            void RecycleRemoteBlocks();
+
+            Bytes block_size_;                                                  ///< \brief Size of each block.
+
+            Alignment alignment_;                                               ///< \brief Alignment of each block.
+
+            VirtualMemoryBuffer memory_buffer_;                                 ///< \brief Virtual memory range reserved by this pool.
+
+            MemoryRange memory_range_;                                          ///< \brief Memory range of the virtual memory buffer.
+
+            LinearAllocator allocator_;                                         ///< \brief Underlying allocator new blocks are allocated from.
+
+            DefaultPoolAllocatorPolicy free_blocks_;                            ///< \brief Blocks released by the owner thread, recycled before allocating new ones.
+
+            MemoryAddress commit_head_;                                         ///< \brief Address past the last committed byte in the pool.
+
+            alignas(64) std::atomic<RemoteBlock*> remote_blocks_{ nullptr };    ///< \brief Blocks released by threads other than the owner thread.
+        };
+
+        /// \brief Bookkeeping stored in front of each coroutine frame. Padded to preserve the default new alignment of the frame.
+        struct alignas(alignof(std::max_align_t)) FrameHeader
+        {
+            TaskPool* pool_;                                                    ///< \brief Pool the frame was allocated from. If nullptr the frame was allocated on the heap.
+        };
+
+        /// \brief Amount of memory committed each time a pool runs out of committed memory.
+        static constexpr Bytes kCommitGranularity = Bytes(0x10000);
+
+        /// \brief Allocate an empty task.
+        TaskHandle AllocateTask();
+
+        /// \brief Check whether the calling thread is the owner of this pool.
+        bool IsOwner() const;
+
+        static thread_local TaskPool* thread_pool_;                             ///< \brief Pool bound to the current thread, if any.
+
+        static std::atomic<std::size_t> frame_count_;                           ///< \brief Number of coroutine frames allocated from any pool and not released yet.
+
+        BlockPool tasks_;                                                       ///< \brief Blocks the tasks are allocated from.
+
+        BlockPool frames_;                                                      ///< \brief Blocks the coroutine frames are allocated from.
+
+        std::atomic<std::thread::id> owner_;                                    ///< \brief Thread the pool is bound to. Read by any thread releasing a block.
     };
 }
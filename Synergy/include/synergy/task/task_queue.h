@@ -6,22 +6,28 @@
 
 #pragma once
 
-#include <mutex>
+#include <atomic>
+#include <array>
 #include <memory>
+#include <cstdint>
 
 #include "synergy/task/task.h"
 
 namespace syntropy::synergy
 {
 
-    /// \brief Queue of tasks.
-    /// Tasks are expected to be pushed to \ popped from the back by a single worker thread. Tasks can be pushed\popped from the front concurrently.
-    /// #TODO: Make this queue lock-free.
+    /// \brief Lock-free work-stealing queue of tasks.
+    /// Tasks are pushed to \ popped from the back by a single owner thread (LIFO), while any other thread can steal tasks from the front concurrently (FIFO).
+    /// The queue grows on demand: retired buffers are kept alive until the queue is destroyed, since concurrent thieves may still be reading from them.
+    /// Based on "Dynamic Circular Work-Stealing Deque" by Chase and Lev, with the memory model described in "Correct and Efficient Work-Stealing for Weak Memory Models" by Le et al.
     /// \author Raffaele D. Facendola - June 2017
     class TaskQueue
     {
     public:
 
+        /// \brief Default initial capacity of the queue.
+        static constexpr size_t kDefaultCapacity = 0x40;
+
         /// \brief No copy constructor.
         TaskQueue(const TaskQueue&) = delete;
 
@@ -29,34 +35,85 @@ namespace syntropy::synergy
         TaskQueue& operator=(const TaskQueue&) = delete;
 
         /// \brief Create a new task queue.
-        /// \param capacity Maximum capacity for the queue.
-        TaskQueue(size_t capacity);
+        /// \param capacity Initial capacity for the queue. Rounded up to the next power of 2.
+        TaskQueue(size_t capacity = kDefaultCapacity);
+
+        /// \brief Destroy the queue, releasing any task still in it.
+        ~TaskQueue();
 
         /// \brief Pop an element from the back.
+        /// This method can only be called by the thread owning the queue.
         /// \return Returns the last element from the back. If the queue is empty returns nullptr.
-        std::shared_ptr<Task> PopBack();
+        TaskHandle PopBack();
 
-        /// \brief Push a new element on the head.
-        /// If the queue is full, the behavior is undefined.
+        /// \brief Push a new element on the back, growing the queue if necessary.
+        /// This method can only be called by the thread owning the queue.
         /// \param task Task to push.
-        void PushBack(std::shared_ptr<Task> task);
+        void PushBack(TaskHandle task);
+
+        /// \brief Push the elements of a priority class within a range on the back, preserving their order, growing the queue at most once and publishing them to thieves all at once.
+        /// This method can only be called by the thread owning the queue.
+        /// \param first Iterator to the first task in the range. Tasks being pushed are moved into the queue, other tasks are left untouched. Empty tasks are skipped.
+        /// \param last Iterator past the last task in the range.
+        /// \param priority Priority class of the tasks to push.
+        void PushBack(TaskList::iterator first, TaskList::iterator last, TaskPriority priority);
+
+        /// \brief Pop an element from the front.
+        /// This method can be called by any thread.
+        /// \return Returns the first element on the front. If the queue is empty or the element was stolen by another thread concurrently, returns nullptr.
+        TaskHandle PopFront();
 
-        /// \brief Pop an element from the tail.
-        /// \return Returns the last element on the tail. If the queue is empty returns nullptr.
-        std::shared_ptr<Task> PopFront();
+        /// \brief Check whether the queue is empty.
+        /// The result is only a snapshot when other threads access the queue concurrently.
+        bool IsEmpty() const;
 
         /// \brief Remove any existing task from the queue.
+        /// This method can only be called by the thread owning the queue.
         void Clear();
 
     private:
 
-        mutable std::mutex mutex_;                          ///< \brief Used for synchronization purposes.
+        /// \brief Size of a cache line, used to prevent false sharing between the owner and the thieves.
+        static constexpr size_t kCacheLineSize = 64;
+
+        /// \brief Circular buffer of tasks. Indices wrap around the buffer capacity which is always a power of 2.
+        struct Buffer
+        {
+            /// \brief Create a new buffer.
+            /// \param capacity Capacity of the buffer. Must be a power of 2.
+            /// \param previous Buffer this one is replacing. Kept alive for concurrent thieves.
+            Buffer(size_t capacity, std::unique_ptr<Buffer> previous);
+
+            /// \brief Access the slot associated to an index.
+            std::atomic<Task*>& operator[](int64_t index);
+
+            size_t mask_;                                   ///< \brief Capacity of the buffer minus one.
 
-        std::vector<std::shared_ptr<Task>> tasks_;          ///< \brief List of tasks in the queue. Circular buffer.
+            std::unique_ptr<std::atomic<Task*>[]> tasks_;   ///< \brief Task slots.
 
-        size_t begin_index_ = 0;                            ///< \brief Index of the first element in the range.
+            std::unique_ptr<Buffer> previous_;              ///< \brief Retired buffer replaced by this one.
+        };
 
-        size_t end_index_ = 0;                              ///< \brief One past the index of the last element index.
+        /// \brief Move the content of the current buffer to a new buffer twice as big.
+        /// \return Returns the new buffer.
+        Buffer* Grow(int64_t top, int64_t bottom);
+
+        /// \brief Adopt the reference held by the queue on a task that was successfully popped from it.
+        static TaskHandle Acquire(Task* task);
+
+        alignas(kCacheLineSize) std::atomic<int64_t> top_{ 0 };        ///< \brief Index of the first element in the queue. Advanced by thieves and by the owner when popping the last element.
+
+        alignas(kCacheLineSize) std::atomic<int64_t> bottom_{ 0 };     ///< \brief One past the index of the last element in the queue. Modified by the owner only.
+
+        std::atomic<Buffer*> buffer_{ nullptr };                        ///< \brief Current buffer.
+
+        std::unique_ptr<Buffer> storage_;                               ///< \brief Owns the current buffer and, transitively, every retired one.
     };
 
-}
\ No newline at end of file
+    /// \brief Push a list of tasks on the queues matching their priority class, with one bulk push per priority class.
+    /// This method can only be called by the thread owning the queues.
+    /// \param queues Queues to push the tasks onto, one per priority class.
+    /// \param tasks Tasks to push. The list is left empty.
+    void PushTasks(std::array<TaskQueue, kTaskPriorityCount>& queues, TaskList& tasks);
+
+}
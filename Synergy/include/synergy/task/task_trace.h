@@ -0,0 +1,189 @@
+
+/// \file task_trace.h
+/// \brief This header is part of the synergy task system. It contains definitions used to record the timeline of the task system and export it as a Chrome trace.
+///
+/// Tracing is opt-in: define SYNERGY_TRACE to enable it. When tracing is disabled any instrumentation point compiles to nothing.
+/// The macro is meant to be defined for every module linking synergy, as the synergy_trace CMake target does.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef SYNERGY_TRACE
+
+/// \brief Execute x only if tracing is enabled.
+#define SYNERGY_TRACE_ONLY(x) x
+
+#else
+
+/// \brief Execute x only if tracing is enabled.
+#define SYNERGY_TRACE_ONLY(x)
+
+#endif
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* TRACE EVENT                                                          */
+    /************************************************************************/
+
+    /// \brief Type of an event recorded by the task system.
+    enum class TraceEventType : uint8_t
+    {
+        kTaskBegin = 0u,                                                ///< \brief A task began executing. The subject is the task.
+        kTaskEnd = 1u,                                                  ///< \brief A task finished executing. The subject is the task.
+        kStealAttempt = 2u,                                             ///< \brief A worker attempted to steal a task.
+        kStealSuccess = 3u,                                             ///< \brief A worker stole a task. The subject is the stolen task.
+        kPark = 4u,                                                     ///< \brief A worker was parked.
+        kUnpark = 5u,                                                   ///< \brief A worker was woken up after being parked.
+        kDependency = 6u,                                               ///< \brief A dependency was created. The subject is the successor task, the object is the task it depends upon.
+    };
+
+    /// \brief An event recorded by the task system.
+    /// \author Raffaele D. Facendola - 2018
+    struct TraceEvent
+    {
+        uint64_t timestamp_;                                            ///< \brief Time of the event, in nanoseconds since the trace epoch.
+
+        uint64_t subject_;                                              ///< \brief Id of the task the event refers to, if any.
+
+        uint64_t object_;                                               ///< \brief Id of the secondary task the event refers to, if any.
+
+        TraceEventType type_;                                           ///< \brief Type of the event.
+    };
+
+    /************************************************************************/
+    /* TASK TRACE                                                           */
+    /************************************************************************/
+
+    /// \brief Records the timeline of the task system into per-thread ring buffers and exports it as a Chrome trace (chrome://tracing, Perfetto).
+    /// Each thread records events lock-free into its own ring buffer: when the buffer is full the oldest events are overwritten.
+    /// Buffers of threads that exited are recycled by new threads, hence each buffer is exported as a separate timeline.
+    /// \author Raffaele D. Facendola - 2018
+    class TaskTrace
+    {
+    public:
+
+        /// \brief Number of events each ring buffer can hold before the oldest ones are overwritten.
+        static constexpr size_t kBufferCapacity = 0x10000;
+
+        /// \brief Get the task trace singleton instance.
+        static TaskTrace& GetInstance();
+
+        /// \brief No copy constructor.
+        TaskTrace(const TaskTrace&) = delete;
+
+        /// \brief No assignment operator.
+        TaskTrace& operator=(const TaskTrace&) = delete;
+
+        /// \brief Record an event on the ring buffer of the calling thread.
+        /// \param type Type of the event.
+        /// \param subject Id of the task the event refers to, if any.
+        /// \param object Id of the secondary task the event refers to, if any.
+        void Record(TraceEventType type, uint64_t subject = 0, uint64_t object = 0);
+
+        /// \brief Get a new unique id for a task.
+        /// Ids are unique across threads and never 0.
+        uint64_t NextTaskId();
+
+        /// \brief Discard any event recorded so far.
+        /// This method must not be called while other threads are recording events.
+        void Clear();
+
+        /// \brief Export the events recorded so far as a Chrome trace in JSON format.
+        /// This method must not be called while other threads are recording events, for example after the scheduler was shut down.
+        /// \param stream Stream to write the trace to.
+        void ExportChromeTrace(std::ostream& stream) const;
+
+        /// \brief Export the events recorded so far as a Chrome trace in JSON format.
+        /// This method must not be called while other threads are recording events, for example after the scheduler was shut down.
+        /// \param path Path of the file to write the trace to.
+        /// \return Returns true if the trace could be written, returns false otherwise.
+        bool ExportChromeTrace(const std::string& path) const;
+
+    private:
+
+        /// \brief Ring buffer of events recorded by a single thread.
+        struct Buffer
+        {
+            /// \brief Create a new empty buffer.
+            Buffer();
+
+            /// \brief Append an event, overwriting the oldest one if the buffer is full.
+            void Push(const TraceEvent& event);
+
+            /// \brief Call a function for each event in the buffer, from the oldest to the newest.
+            template <typename TFunction>
+            void ForEach(TFunction&& function) const;
+
+            std::unique_ptr<TraceEvent[]> events_;                      ///< \brief Events storage.
+
+            uint64_t count_{ 0 };                                       ///< \brief Number of events ever pushed in the buffer.
+        };
+
+        /// \brief Binds a buffer to the current thread, giving it back to the trace when the thread exits.
+        struct ThreadBuffer
+        {
+            /// \brief Release the bound buffer, if any.
+            ~ThreadBuffer();
+
+            Buffer* buffer_{ nullptr };                                 ///< \brief Buffer bound to the current thread.
+        };
+
+        /// \brief Create a new trace.
+        TaskTrace();
+
+        /// \brief Get the buffer bound to the current thread, binding a new buffer if none.
+        Buffer& GetThreadBuffer();
+
+        /// \brief Get the current time, in nanoseconds since the trace epoch.
+        uint64_t GetTimestamp() const;
+
+        static thread_local ThreadBuffer thread_buffer_;                ///< \brief Buffer bound to the current thread.
+
+        std::chrono::steady_clock::time_point epoch_;                   ///< \brief Time all timestamps are relative to.
+
+        std::atomic<uint64_t> next_thread_id_{ 1 };                     ///< \brief Next unique id for a thread. Task ids are generated per-thread to avoid contention.
+
+        mutable std::mutex mutex_;                                      ///< \brief Guards the list of buffers.
+
+        std::vector<std::unique_ptr<Buffer>> buffers_;                  ///< \brief Buffers recorded so far.
+
+        std::vector<Buffer*> free_buffers_;                             ///< \brief Buffers released by threads that exited.
+    };
+
+    /// \brief Get a reference to the TaskTrace singleton.
+    TaskTrace& GetTaskTrace();
+
+}
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // TaskTrace::Buffer.
+
+    template <typename TFunction>
+    inline void TaskTrace::Buffer::ForEach(TFunction&& function) const
+    {
+        auto first = (count_ > kBufferCapacity) ? (count_ - kBufferCapacity) : 0;
+
+        for (auto index = first; index < count_; ++index)
+        {
+            function(events_[index % kBufferCapacity]);
+        }
+    }
+
+}
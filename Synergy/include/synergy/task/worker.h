@@ -7,12 +7,15 @@
 #pragma once
 
 #include <atomic>
+#include <array>
 #include <thread>
-#include <condition_variable>
 #include <mutex>
+#include <cstdint>
 
 #include "syntropy/patterns/observable.h"
 
+#include "synergy/patterns/event_count.h"
+
 #include "synergy/task/task.h"
 #include "synergy/task/task_pool.h"
 #include "synergy/task/task_queue.h"
@@ -20,16 +23,29 @@
 
 namespace syntropy::synergy
 {
+    /// \brief Statistics about the idle behavior of a worker, used to tune the idle protocol.
+    /// \author Raffaele D. Facendola - 2018
+    struct WorkerStatistics
+    {
+        uint64_t spins_{ 0 };                                                   ///< \brief Number of times the worker found new work while spinning.
+
+        uint64_t yields_{ 0 };                                                  ///< \brief Number of times the worker found new work while yielding its time slice.
+
+        uint64_t parks_{ 0 };                                                   ///< \brief Number of times the worker was parked.
+
+        uint64_t wakeups_{ 0 };                                                 ///< \brief Number of times another thread had to wake the worker up from a park.
+    };
+
     /// \brief Worker thread used to execute tasks.
-    /// A worker thread sleeps until there's at least one task to execute.
+    /// A worker thread idles until there's at least one task to execute: it spins for a bounded amount of time, then yields its time slice and finally parks.
+    /// Threads enqueueing tasks only pay for a wake-up when the worker is actually parked.
     /// \author Raffaele D. Facendola - June 2017
     class Worker
     {
     public:
 
         /// \brief Create a new worker thread.
-        /// \param max_tasks Maximum number of tasks allocated by the worker.
-        Worker(size_t max_tasks = 0x400);
+        Worker() = default;
 
         /// \brief No copy constructor.
         Worker(const Worker&) = delete;
@@ -56,46 +72,141 @@ namespace syntropy::synergy
         bool IsRunning() const;
 
         /// \brief Enqueue a new task for execution.
-        void EnqueueTask(std::shared_ptr<Task> task);
+        /// Tasks enqueued by the worker thread are pushed directly on the queue matching their priority class, tasks enqueued by any other thread are handed over via a mailbox.
+        void EnqueueTask(TaskHandle task);
+
+        /// \brief Enqueue many tasks for execution at once.
+        /// Tasks enqueued by the worker thread are pushed with a single bulk push per priority class, tasks enqueued by any other thread are mailed with a single wake-up.
+        /// \param tasks Tasks to enqueue. The list is left empty.
+        void EnqueueTasks(TaskList& tasks);
+
+        /// \brief Flag the worker as idle or not. Idle workers can be woken up by other threads via Wake().
+        /// \param is_idle Whether the worker is idle.
+        /// \return Returns the previous idle state.
+        bool SetIdle(bool is_idle);
+
+        /// \brief Wake the worker up if it is idle, clearing its idle state.
+        /// \return Returns true if the worker was idle, returns false otherwise.
+        bool Wake();
 
-        /// \brief Dequeue a task scheduled on this worker.
+        /// \brief Dequeue a task scheduled on this worker, favoring the most urgent priority class.
         /// \return Returns a task scheduled on this worker. If no such task exists, returns nullptr.
-        std::shared_ptr<Task> DequeueTask();
+        TaskHandle DequeueTask();
+
+        /// \brief Dequeue a task of a given priority class scheduled on this worker.
+        /// \param priority Priority class of the task to dequeue.
+        /// \return Returns a task scheduled on this worker. If no such task exists, returns nullptr.
+        TaskHandle DequeueTask(TaskPriority priority);
+
+        /// \brief Check whether the worker has any task waiting to be executed.
+        bool HasTasks() const;
+
+        /// \brief Get the idle statistics of this worker.
+        /// The statistics are updated concurrently by the worker thread and may be slightly out of date.
+        WorkerStatistics GetStatistics() const;
 
         /// \brief Get the execution context associated to this worker.
         /// \return Returns the execution context associated to this worker, if present. If the worker is not running returns nullptr.
         TaskExecutionContext* GetExecutionContext();
 
-        /// \brief Observable event called whenever a new task is enqueued in this worker.
-        Observable<Worker&>& OnTaskEnqueued();
+        /// \brief Observable event called whenever new tasks are enqueued in this worker by the worker thread.
+        /// The second argument is the number of tasks enqueued.
+        Observable<Worker&, size_t>& OnTaskEnqueued();
 
         /// \brief Observable event called whenever the worker ran out of tasks to execute.
+        /// The event is called repeatedly until the worker finds a new task.
         Observable<Worker&>& OnStarving();
 
+        /// \brief Observable event called whenever a starving worker found a new task to execute or was stopped.
+        /// The event is called exactly once after any sequence of OnStarving() events.
+        Observable<Worker&>& OnFed();
+
         ///\brief Observable event called whenever the worker becomes ready to accept tasks for execution.
         Observable<Worker&>& OnReady();
 
     private:
 
+        /// \brief Number of times an idle worker checks for new work before yielding.
+        static constexpr size_t kSpinCount = 0x400;
+
+        /// \brief Number of times an idle worker yields its time slice before parking.
+        static constexpr size_t kYieldCount = 0x10;
+
+        /// \brief Number of times a non-empty priority class can be passed over in favor of a more urgent one before being served.
+        static constexpr size_t kAgingThreshold = 0x20;
+
+        /// \brief Wait for new work: spin, then yield and finally park the worker until notified.
+        /// This method can only be called by the worker thread.
+        void Idle();
+
+        /// \brief Check whether the worker has any reason to stop idling.
+        bool IsIdleOver() const;
+
+        /// \brief Increment a statistic counter. Only the worker thread can increment its own counters.
+        static void Increment(std::atomic<uint64_t>& counter);
+
         /// \brief Fetch a new task for execution.
         /// This call blocks until a new task becomes ready for execution or termination was requested.
         /// \return Returns a pointer to the next task to execute if the thread is running, returns nullptr otherwise.
-        std::shared_ptr<Task> FetchTask();
+        TaskHandle FetchTask();
+
+        /// \brief Pop a task from the most urgent non-empty queue, moving any task in the mailbox to the queues first.
+        /// Less urgent queues that are passed over age and are eventually served once, to prevent starvation.
+        /// This method can only be called by the worker thread.
+        /// \return Returns a task ready for execution. If no such task exists, returns nullptr.
+        TaskHandle PopTask();
+
+        /// \brief Move any task in the mailbox to the queue matching its priority class.
+        /// This method can only be called by the worker thread.
+        void CollectMail();
+
+        /// \brief Check whether the worker has any task waiting to be executed which may be more urgent than the provided priority class.
+        /// This method can only be called by the worker thread.
+        bool HasUrgentTasks(TaskPriority priority) const;
+
+        /// \brief Get the queue associated to a priority class.
+        TaskQueue& GetQueue(TaskPriority priority);
 
         std::atomic<TaskExecutionContext*> execution_context_{ nullptr };       ///< \brief Execution context for this worker.
 
-        TaskQueue tasks_;                                                       ///< \brief Tasks that are scheduled in this worker ready for execution. Other tasks in the system are referenced via task dependencies.
+        TaskPool task_pool_;                                                    ///< \brief Pool used to allocate the tasks created by this worker. Outlives the worker loop, since tasks may be released after the worker stopped.
+
+        std::array<TaskQueue, kTaskPriorityCount> tasks_;                       ///< \brief Tasks that are scheduled in this worker ready for execution, one queue per priority class. Other tasks in the system are referenced via task dependencies.
+
+        std::array<size_t, kTaskPriorityCount> ages_{};                         ///< \brief Number of times each queue was passed over in favor of a more urgent one. Accessed by the worker thread only.
 
         std::atomic_bool is_running_{ false };                                  ///< \brief Whether the worker is running.
 
-        std::mutex mutex_;                                                      ///< \brief Used for synchronization purposes.
+        std::thread::id thread_id_;                                             ///< \brief Id of the thread running the worker loop.
+
+        mutable std::mutex mutex_;                                              ///< \brief Used for synchronization purposes. Guards the mailbox.
+
+        TaskList mailbox_;                                                      ///< \brief Tasks enqueued by threads other than the worker thread.
 
-        std::condition_variable wake_up_;                                       ///< \brief Condition variable used to wake up a sleeping thread.
+        TaskList collected_mail_;                                               ///< \brief Tasks moved out of the mailbox, swapped with it upon collection. Accessed by the worker thread only.
 
-        Event<Worker&> on_task_enqueued_;                                       ///< \brief Event called whenever a new task is enqueued in this worker.
+        std::atomic_bool has_mail_{ false };                                    ///< \brief Whether the mailbox contains any task.
+
+        std::atomic_bool is_idle_{ false };                                     ///< \brief Whether the worker is idle and can be woken up via Wake().
+
+        std::atomic_bool wake_requested_{ false };                              ///< \brief Whether another thread requested the worker to wake up.
+
+        EventCount wake_up_;                                                    ///< \brief Event count used to park and wake up the worker thread.
+
+        std::atomic<uint64_t> spins_{ 0 };                                      ///< \brief See WorkerStatistics::spins_.
+
+        std::atomic<uint64_t> yields_{ 0 };                                     ///< \brief See WorkerStatistics::yields_.
+
+        std::atomic<uint64_t> parks_{ 0 };                                      ///< \brief See WorkerStatistics::parks_.
+
+        std::atomic<uint64_t> wakeups_{ 0 };                                    ///< \brief See WorkerStatistics::wakeups_.
+
+        Event<Worker&, size_t> on_task_enqueued_;                               ///< \brief Event called whenever new tasks are enqueued in this worker.
 
         Event<Worker&> on_starving_;                                            ///< \brief Event called whenever the worker ran out of tasks to execute.
 
+        Event<Worker&> on_fed_;                                                 ///< \brief Event called whenever a starving worker found a new task to execute or was stopped.
+
         Event<Worker&> on_ready_;                                               ///< \brief Event called whenever the worker becomes ready to accept tasks for execution.
     };
 }
@@ -0,0 +1,80 @@
+#include "synergy/patterns/event_count.h"
+
+#include "syntropy/diagnostics/assert.h"
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* EVENT COUNT                                                          */
+    /************************************************************************/
+
+    EventCount::Key EventCount::PrepareWait()
+    {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);                                   // Pairs with the fence in Notify(): either the waiter sees the new condition or the notifier sees the waiter.
+
+        return epoch_.load(std::memory_order_acquire);                                      // If a notifier already advanced the epoch, its condition is visible as well.
+    }
+
+    void EventCount::CancelWait()
+    {
+        auto waiters = waiters_.fetch_sub(1, std::memory_order_relaxed);
+
+        SYNTROPY_ASSERT(waiters > 0);                                                       // Unbalanced call.
+    }
+
+    void EventCount::CommitWait(Key key)
+    {
+#if defined(__cpp_lib_atomic_wait)
+
+        while (epoch_.load(std::memory_order_acquire) == key)
+        {
+            epoch_.wait(key, std::memory_order_acquire);                                    // Kernel call, unless the epoch was advanced in the meantime.
+        }
+
+#else
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);                                      // The epoch is advanced while holding the lock: the notification cannot be lost.
+
+            condition_.wait(lock, [this, key]()
+            {
+                return epoch_.load(std::memory_order_acquire) != key;
+            });
+        }
+
+#endif
+
+        CancelWait();
+    }
+
+    bool EventCount::Notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);                                // Pairs with PrepareWait(). Makes the new condition visible before checking for waiters.
+
+        if (waiters_.load(std::memory_order_relaxed) == 0)
+        {
+            return false;                                                                   // Fast path: nobody is waiting.
+        }
+
+#if defined(__cpp_lib_atomic_wait)
+
+        epoch_.fetch_add(1, std::memory_order_release);
+
+        epoch_.notify_all();                                                                // Kernel call.
+
+#else
+
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+
+        condition_.notify_all();                                                            // Kernel call.
+
+#endif
+
+        return true;
+    }
+
+}
@@ -24,6 +24,8 @@ namespace syntropy::synergy
 
     void SyncCounter::Signal(bool wait)
     {
+        std::unique_lock<std::mutex> lock(mutex_);  // Waiters cannot observe the counter dropping to zero before being notified, nor destroy the counter while it is being notified.
+
         auto previous_count = count_.fetch_sub(1, std::memory_order_acq_rel);
 
         SYNTROPY_ASSERT(previous_count > 0);        // The counter was decremented too much!
@@ -34,7 +36,10 @@ namespace syntropy::synergy
         }
         else if(wait)
         {
-            Wait();                                 // Wait until the counter reaches zero.
+            wait_.wait(lock, [this]                 // Wait until the counter reaches zero.
+            {
+                return count_.load(std::memory_order_acquire) == 0;
+            });
         }
     }
 
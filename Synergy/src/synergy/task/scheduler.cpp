@@ -3,11 +3,14 @@
 #include "synergy/patterns/sync_counter.h"
 
 #include "syntropy/platform/threading.h"
+#include "syntropy/platform/system.h"
 #include "syntropy/diagnostics/assert.h"
 #include "syntropy/patterns/scope_guard.h"
 
 #include <thread>
 #include <atomic>
+#include <algorithm>
+#include <utility>
 
 namespace syntropy::synergy
 {
@@ -18,33 +21,63 @@ namespace syntropy::synergy
     
     thread_local Worker* Scheduler::thread_worker_ = nullptr;
 
+    thread_local Scheduler::ExternalThreadBinding Scheduler::external_thread_;
+
     Scheduler& Scheduler::GetInstance()
     {
         static Scheduler instance;
         return instance;
     }
 
-    void Scheduler::Initialize(std::optional<platform::AffinityMask> cores)
+    Scheduler::~Scheduler()
     {
-        auto affinity_mask = cores ? *cores : platform::AffinityMask(0).flip();                 // Either use the specified affinity mask or attempt to use each available core.
+        Shutdown();
+    }
+
+    void Scheduler::Initialize(std::optional<platform::AffinityMask> cores, StealPolicy steal_policy)
+    {
+        SYNTROPY_ASSERT(workers_.empty());                                                      // Initializing an initialized scheduler requires a Shutdown() first.
+
+        auto affinity_mask = platform::Threading::GetProcessAffinity();                         // Discard any core that has no affinity with the current process.
 
-        affinity_mask &= platform::Threading::GetProcessAffinity();                             // Discard any core that has no affinity with the current process.
+        if (cores)
+        {
+            affinity_mask &= *cores;                                                            // Either use the specified affinity mask or attempt to use each available core.
+        }
+
+        SYNTROPY_ASSERT(!affinity_mask.IsEmpty());                                              // Be sure to spawn at least one worker!
 
-        SYNTROPY_ASSERT(affinity_mask.any());                                                   // Be sure to spawn at least one worker!
+        steal_policy_ = steal_policy;
 
-        // Start the worker threads, one for each specified core.
+        // Create the worker threads, one for each specified core.
 
-        size_t worker_count = affinity_mask.count();
+        size_t worker_count = affinity_mask.GetCount();
 
         worker_thread_sync_.Reset(worker_count);
 
         workers_.reserve(worker_count);
 
-        for (size_t core_index = 0; workers_.size() < worker_count;)
+        std::vector<size_t> worker_cores;
+
+        for (size_t core_index = 0; workers_.size() < worker_count; ++core_index)
         {
-            while (!affinity_mask.test(core_index++));                                          // Advance to the next designated core.
+            if (affinity_mask.Test(core_index))
+            {
+                workers_.emplace_back();
+                worker_cores.emplace_back(core_index);
+            }
+        }
 
-            workers_.emplace_back().StartAsync(platform::AffinityMask().set(core_index - 1));   // #TODO Maximum tasks amount should be unbounded.
+        if (steal_policy_ == StealPolicy::kTopology)
+        {
+            BuildVictimTiers(worker_cores);
+        }
+
+        // Start the worker threads only after each one was created: workers may attempt to steal from each other as soon as they are started.
+
+        for (size_t worker_index = 0; worker_index < worker_count; ++worker_index)
+        {
+            workers_[worker_index].StartAsync(platform::AffinityMask().Set(worker_cores[worker_index]));
         }
 
         // Wait until each worker thread is ready to run. Without this, external callers would attempt to spawn tasks on workers that may not have had the opportunity to be initialized.
@@ -52,40 +85,157 @@ namespace syntropy::synergy
         worker_thread_sync_.Wait();
     }
 
-    void Scheduler::OnTaskEnqueued(Worker& sender)
+    void Scheduler::Shutdown()
     {
-        // #TODO Make this lock-free.
+        // Stop every worker before joining any: running workers may still be stealing from the ones being stopped.
+
+        for (auto&& worker : workers_)
+        {
+            worker.Stop();
+        }
+
+        for (auto&& worker : workers_)
+        {
+            worker.Join();
+        }
 
-        // Attempt to yield a task to a random starving worker.
+        workers_.clear();
 
-        std::scoped_lock<std::mutex> lock(mutex_);
+        starving_workers_.clear();
+
+        // Cancel any task left in the queues of external threads.
+
+        for (size_t index = 0; index < external_threads_count_.load(std::memory_order_acquire); ++index)
+        {
+            for (size_t priority = 0; priority < kTaskPriorityCount; ++priority)
+            {
+                while (external_threads_[index]->DequeueTask(static_cast<TaskPriority>(priority)));
+            }
+        }
+
+        idle_workers_.store(0, std::memory_order_relaxed);
+
+        starving_workers_count_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t Scheduler::GetWorkerCount() const
+    {
+        return workers_.size();
+    }
 
-        if (starving_workers_.empty())
+    WorkerStatistics Scheduler::GetWorkerStatistics(size_t index) const
+    {
+        SYNTROPY_ASSERT(index < workers_.size());
+
+        return workers_[index].GetWorker().GetStatistics();
+    }
+
+    bool Scheduler::IsWorkDemanded() const
+    {
+        if (starving_workers_count_.load(std::memory_order_relaxed) == 0)
+        {
+            return false;
+        }
+
+        return !Scheduler::thread_worker_ || !Scheduler::thread_worker_->HasTasks();        // Tasks split earlier and not stolen yet already satisfy the demand.
+    }
+
+    void Scheduler::OnTaskEnqueued(WorkerThread& sender, size_t count)
+    {
+        switch (steal_policy_)
+        {
+            case StealPolicy::kShared:
+            {
+                ShareTask(sender.GetWorker(), count);
+                break;
+            }
+
+            case StealPolicy::kRandom:
+            case StealPolicy::kTopology:
+            {
+                WakeIdleWorkers(count);
+                break;
+            }
+        }
+    }
+
+    void Scheduler::OnWorkerStarving(WorkerThread& sender)
+    {
+        if (sender.SetStarving(true))
         {
-            return;
+            starving_workers_count_.fetch_add(1, std::memory_order_relaxed);
         }
 
-        auto starving_worker = starving_workers_.back();
+        switch (steal_policy_)
+        {
+            case StealPolicy::kShared:
+            {
+                StealSharedTask(sender.GetWorker());
+                break;
+            }
+
+            case StealPolicy::kRandom:
+            case StealPolicy::kTopology:
+            {
+                StealRandomTask(sender);
+                break;
+            }
+        }
+    }
+
+    void Scheduler::OnWorkerFed(WorkerThread& sender)
+    {
+        if (sender.SetStarving(false))
+        {
+            starving_workers_count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Scheduler::ShareTask(Worker& sender, size_t count)
+    {
+        // Attempt to yield one task to each starving worker, within a single lock.
+
+        std::scoped_lock<std::mutex> lock(mutex_);
 
-        if (auto task = sender.DequeueTask())
+        for (; count > 0 && !starving_workers_.empty(); --count)
         {
-            starving_worker->EnqueueTask(task);
+            auto task = sender.DequeueTask();
+
+            if (!task)
+            {
+                return;
+            }
+
+            starving_workers_.back()->EnqueueTask(std::move(task));
             starving_workers_.pop_back();
         }
     }
 
-    void Scheduler::OnWorkerStarving(Worker& sender)
+    void Scheduler::StealSharedTask(Worker& sender)
     {
-        // #TODO Make this lock-free.
+        // Attempt to steal a task from a random non-starving worker, most urgent priority classes first.
 
-        // Attempt to steal a task from a random non-starving worker.
+        SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kStealAttempt));
 
         std::scoped_lock<std::mutex> lock(mutex_);
 
-        for (auto&& worker : workers_)
+        for (size_t priority = 0; priority < kTaskPriorityCount; ++priority)
         {
-            if (auto task = worker.GetWorker().DequeueTask())
+            for (auto&& worker : workers_)
+            {
+                if (auto task = worker.GetWorker().DequeueTask(static_cast<TaskPriority>(priority)))
+                {
+                    SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kStealSuccess, task->GetTraceId()));
+
+                    sender.EnqueueTask(task);
+                    return;
+                }
+            }
+
+            if (auto task = StealExternalTask(static_cast<TaskPriority>(priority)))
             {
+                SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kStealSuccess, task->GetTraceId()));
+
                 sender.EnqueueTask(task);
                 return;
             }
@@ -94,6 +244,313 @@ namespace syntropy::synergy
         starving_workers_.emplace_back(&sender);
     }
 
+    void Scheduler::WakeIdleWorkers(size_t count)
+    {
+        // The fence pairs with the one in StealRandomTask: either the idle worker sees the new tasks during its last sweep or the idle count is seen here.
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        count = std::min(count, idle_workers_.load(std::memory_order_relaxed));                 // No point in waking more workers than there are tasks.
+
+        for (auto worker_it = std::begin(workers_); count > 0 && worker_it != std::end(workers_); ++worker_it)
+        {
+            if (worker_it->GetWorker().Wake())
+            {
+                idle_workers_.fetch_sub(1, std::memory_order_relaxed);
+                --count;
+            }
+        }
+    }
+
+    void Scheduler::StealRandomTask(WorkerThread& sender)
+    {
+        auto& worker = sender.GetWorker();
+
+        if (worker.SetIdle(false))
+        {
+            idle_workers_.fetch_sub(1, std::memory_order_relaxed);                              // The worker woke up on its own (new task in its mailbox or spurious wake-up).
+        }
+
+        // Probe random victims, backing off exponentially between rounds to reduce the contention on busy victims.
+
+        for (size_t backoff = 1; backoff <= kMaxStealBackoff && worker.IsRunning(); backoff <<= 1)
+        {
+            if (ProbeVictims(sender))
+            {
+                return;
+            }
+
+            for (size_t yield_count = 0; yield_count < backoff; ++yield_count)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // The worker is about to park: flag it as idle before sweeping the victims one last time, otherwise a task enqueued in the meantime may never wake it up.
+
+        worker.SetIdle(true);
+
+        idle_workers_.fetch_add(1, std::memory_order_seq_cst);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (ProbeVictims(sender) && worker.SetIdle(false))
+        {
+            idle_workers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool Scheduler::ProbeVictims(WorkerThread& sender)
+    {
+        auto& random = sender.GetRandom();
+
+        if (steal_policy_ == StealPolicy::kTopology)
+        {
+            // Closer victims first: tasks stolen from them are more likely to find their data in a shared cache.
+
+            for (auto&& victim_tier : sender.GetVictimTiers())
+            {
+                random.Shuffle(std::begin(victim_tier), std::end(victim_tier));
+
+                for (auto&& victim : victim_tier)
+                {
+                    if (StealTask(sender, *victim))
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+        else
+        {
+            for (auto attempts = workers_.size(); attempts > 0; --attempts)
+            {
+                auto victim = random.Pick(std::begin(workers_), std::end(workers_));
+
+                if (&(*victim) != &sender && StealTask(sender, *victim))
+                {
+                    return true;
+                }
+            }
+        }
+
+        // Tasks submitted by external threads are probed last: external threads usually execute their own tasks while waiting.
+
+        for (size_t priority = 0; priority < kTaskPriorityCount; ++priority)
+        {
+            if (auto task = StealExternalTask(static_cast<TaskPriority>(priority)))
+            {
+                SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kStealSuccess, task->GetTraceId()));
+
+                sender.GetWorker().EnqueueTask(std::move(task));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool Scheduler::StealTask(WorkerThread& sender, WorkerThread& victim)
+    {
+        SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kStealAttempt));
+
+        if (auto task = victim.GetWorker().DequeueTask())
+        {
+            SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kStealSuccess, task->GetTraceId()));
+
+            sender.GetWorker().EnqueueTask(std::move(task));
+            return true;
+        }
+
+        return false;
+    }
+
+    void Scheduler::BuildVictimTiers(const std::vector<size_t>& cores)
+    {
+        auto topology = platform::System::GetCPUTopology();
+
+        // Locate the processor each worker is bound to. Workers bound to unknown processors are considered distant from any other worker.
+
+        auto unknown_processor = platform::ProcessorInfo{ 0, SIZE_MAX, SIZE_MAX, SIZE_MAX, SIZE_MAX };
+
+        std::vector<platform::ProcessorInfo> processors;
+
+        for (auto core : cores)
+        {
+            auto processor_it = std::find_if(std::begin(topology.processors_), std::end(topology.processors_), [core](auto& processor)
+            {
+                return processor.index_ == core;
+            });
+
+            processors.emplace_back((processor_it != std::end(topology.processors_)) ? *processor_it : unknown_processor);
+        }
+
+        // Tiers, from the closest to the farthest: SMT siblings, same last-level cache, same NUMA node, any other.
+
+        static constexpr size_t kTierCount = 4;
+
+        auto get_tier = [](const platform::ProcessorInfo& lhs, const platform::ProcessorInfo& rhs) -> size_t
+        {
+            auto is_known = (lhs.core_ != SIZE_MAX) && (rhs.core_ != SIZE_MAX);
+
+            if (is_known && lhs.core_ == rhs.core_) return 0;
+            if (is_known && lhs.cache_ == rhs.cache_) return 1;
+            if (is_known && lhs.node_ == rhs.node_) return 2;
+
+            return 3;
+        };
+
+        for (size_t worker_index = 0; worker_index < workers_.size(); ++worker_index)
+        {
+            std::vector<std::vector<WorkerThread*>> victim_tiers(kTierCount);
+
+            for (size_t victim_index = 0; victim_index < workers_.size(); ++victim_index)
+            {
+                if (victim_index != worker_index)
+                {
+                    victim_tiers[get_tier(processors[worker_index], processors[victim_index])].emplace_back(&workers_[victim_index]);
+                }
+            }
+
+            victim_tiers.erase(std::remove_if(std::begin(victim_tiers), std::end(victim_tiers), [](auto& victim_tier) { return victim_tier.empty(); }), std::end(victim_tiers));
+
+            workers_[worker_index].SetVictimTiers(std::move(victim_tiers));
+        }
+    }
+
+    void Scheduler::OnExternalTaskEnqueued(ExternalThread& sender, size_t count)
+    {
+        switch (steal_policy_)
+        {
+            case StealPolicy::kShared:
+            {
+                // Attempt to yield one task to each starving worker, within a single lock.
+
+                std::scoped_lock<std::mutex> lock(mutex_);
+
+                for (size_t priority = 0; count > 0 && priority < kTaskPriorityCount;)
+                {
+                    if (starving_workers_.empty())
+                    {
+                        return;
+                    }
+
+                    if (auto task = sender.DequeueTask(static_cast<TaskPriority>(priority)))
+                    {
+                        starving_workers_.back()->EnqueueTask(std::move(task));
+                        starving_workers_.pop_back();
+                        --count;
+                    }
+                    else
+                    {
+                        ++priority;
+                    }
+                }
+
+                break;
+            }
+
+            case StealPolicy::kRandom:
+            case StealPolicy::kTopology:
+            {
+                WakeIdleWorkers(count);
+                break;
+            }
+        }
+    }
+
+    TaskHandle Scheduler::StealExternalTask(TaskPriority priority, const ExternalThread* sender)
+    {
+        auto count = external_threads_count_.load(std::memory_order_acquire);
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            auto& external_thread = *external_threads_[index];
+
+            if (&external_thread != sender)
+            {
+                if (auto task = external_thread.DequeueTask(priority))
+                {
+                    return task;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    Scheduler::ExternalThread* Scheduler::GetExternalThread()
+    {
+        if (!external_thread_.external_thread_)
+        {
+            std::scoped_lock<std::mutex> lock(external_mutex_);
+
+            auto count = external_threads_count_.load(std::memory_order_relaxed);
+
+            if (!free_external_threads_.empty())
+            {
+                external_thread_.external_thread_ = free_external_threads_.back();              // Recycle the state of a thread that exited.
+
+                free_external_threads_.pop_back();
+            }
+            else if (count < kMaxExternalThreads)
+            {
+                external_threads_[count] = std::make_unique<ExternalThread>();
+
+                external_thread_.external_thread_ = external_threads_[count].get();
+
+                external_threads_count_.store(count + 1, std::memory_order_release);            // Publish the new state to the workers.
+            }
+            else
+            {
+                return nullptr;
+            }
+
+            external_thread_.external_thread_->task_pool_.Bind();
+        }
+
+        return external_thread_.external_thread_;
+    }
+
+    bool Scheduler::RunExternalTask()
+    {
+        auto external_thread = GetExternalThread();
+
+        if (!external_thread)
+        {
+            return false;
+        }
+
+        // Own tasks first, then any task stolen from workers and other external threads, most urgent priority classes first.
+
+        auto task = external_thread->PopTask();
+
+        for (size_t priority = 0; !task && priority < kTaskPriorityCount; ++priority)
+        {
+            for (auto worker_it = std::begin(workers_); !task && worker_it != std::end(workers_); ++worker_it)
+            {
+                task = worker_it->GetWorker().DequeueTask(static_cast<TaskPriority>(priority));
+            }
+
+            if (!task)
+            {
+                task = StealExternalTask(static_cast<TaskPriority>(priority), external_thread);
+            }
+        }
+
+        if (!task)
+        {
+            return false;
+        }
+
+        while (task)
+        {
+            task = external_thread->execution_context_.ExecuteTask(std::move(task));         // Depth-first execution, as workers do.
+        }
+
+        return true;
+    }
+
     void Scheduler::OnWorkerReady(Worker& /*sender*/)
     {
         worker_thread_sync_.Signal();                               // Decrement the counter and block until each other worker is ready to run.
@@ -107,10 +564,18 @@ namespace syntropy::synergy
 
             return *Scheduler::thread_worker_->GetExecutionContext();
         }
+        else if (auto external_thread = GetExternalThread())
+        {
+            // Use the external thread queues to avoid contending with other threads.
+
+            return external_thread->execution_context_;
+        }
         else
         {
             // Pick a random worker to improve load balancing.
 
+            std::scoped_lock<std::mutex> lock(external_mutex_);
+
             auto worker_it = random_.Pick(std::begin(workers_), std::end(workers_));
 
             return *worker_it->GetWorker().GetExecutionContext();
@@ -126,17 +591,30 @@ namespace syntropy::synergy
     /* SCHEDULER :: WORKER THREAD                                           */
     /************************************************************************/
 
-    Scheduler::WorkerThread::WorkerThread(size_t max_tasks)
-        : worker_(std::make_unique<Worker>(max_tasks))
+    Scheduler::WorkerThread::WorkerThread()
+        : worker_(std::make_unique<Worker>())
     {
 
     }
 
     Scheduler::WorkerThread::~WorkerThread()
     {
-        if (worker_->IsRunning())
+        Stop();
+        Join();
+    }
+
+    void Scheduler::WorkerThread::Stop()
+    {
+        if (worker_ && worker_->IsRunning())
         {
             worker_->Stop();
+        }
+    }
+
+    void Scheduler::WorkerThread::Join()
+    {
+        if (thread_.joinable())
+        {
             thread_.join();
         }
     }
@@ -156,14 +634,19 @@ namespace syntropy::synergy
 
             // Setup worker events.
 
-            auto on_enqueued_handle = worker_->OnTaskEnqueued().Subscribe([](auto&& sender)
+            auto on_enqueued_handle = worker_->OnTaskEnqueued().Subscribe([this](auto&& /*sender*/, auto count)
+            {
+                GetScheduler().OnTaskEnqueued(*this, count);
+            });
+
+            auto on_starving_handle = worker_->OnStarving().Subscribe([this](auto&& /*sender*/)
             {
-                GetScheduler().OnTaskEnqueued(sender);
+                GetScheduler().OnWorkerStarving(*this);
             });
 
-            auto on_starving_handle = worker_->OnStarving().Subscribe([](auto&& sender)
+            auto on_fed_handle = worker_->OnFed().Subscribe([this](auto&& /*sender*/)
             {
-                GetScheduler().OnWorkerStarving(sender);
+                GetScheduler().OnWorkerFed(*this);
             });
 
             auto on_ready_handle = worker_->OnReady().Subscribe([this](auto&& sender)
@@ -186,4 +669,84 @@ namespace syntropy::synergy
         return *worker_;
     }
 
+    const Worker& Scheduler::WorkerThread::GetWorker() const
+    {
+        return *worker_;
+    }
+
+    Random& Scheduler::WorkerThread::GetRandom()
+    {
+        return random_;
+    }
+
+    std::vector<std::vector<Scheduler::WorkerThread*>>& Scheduler::WorkerThread::GetVictimTiers()
+    {
+        return victim_tiers_;
+    }
+
+    void Scheduler::WorkerThread::SetVictimTiers(std::vector<std::vector<WorkerThread*>> victim_tiers)
+    {
+        SYNTROPY_ASSERT(!worker_->IsRunning());
+
+        victim_tiers_ = std::move(victim_tiers);
+    }
+
+    bool Scheduler::WorkerThread::SetStarving(bool is_starving)
+    {
+        return std::exchange(is_starving_, is_starving) != is_starving;
+    }
+
+    /************************************************************************/
+    /* SCHEDULER :: EXTERNAL THREAD                                         */
+    /************************************************************************/
+
+    Scheduler::ExternalThread::ExternalThread()
+        : execution_context_(task_pool_)
+    {
+        on_task_ready_handle_ = execution_context_.OnTaskReady().Subscribe([this](auto& /*sender*/, auto& args)
+        {
+            auto count = args.tasks_.size();
+
+            PushTasks(tasks_, args.tasks_);
+
+            GetScheduler().OnExternalTaskEnqueued(*this, count);
+        });
+    }
+
+    TaskHandle Scheduler::ExternalThread::PopTask()
+    {
+        for (auto&& tasks : tasks_)
+        {
+            if (auto task = tasks.PopBack())
+            {
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    TaskHandle Scheduler::ExternalThread::DequeueTask(TaskPriority priority)
+    {
+        return tasks_[static_cast<size_t>(priority)].PopFront();
+    }
+
+    /************************************************************************/
+    /* SCHEDULER :: EXTERNAL THREAD BINDING                                 */
+    /************************************************************************/
+
+    Scheduler::ExternalThreadBinding::~ExternalThreadBinding()
+    {
+        if (external_thread_)
+        {
+            auto& scheduler = GetScheduler();
+
+            external_thread_->task_pool_.Unbind();                                              // The next thread binding the state synchronizes via the mutex.
+
+            std::scoped_lock<std::mutex> lock(scheduler.external_mutex_);
+
+            scheduler.free_external_threads_.emplace_back(external_thread_);
+        }
+    }
+
 }
@@ -2,8 +2,7 @@
 
 #include <algorithm>
 
-#include "synergy/task/scheduler.h"
-#include "synergy/task/worker.h"
+#include "synergy/task/task_pool.h"
 
 namespace syntropy::synergy
 {
@@ -11,6 +10,26 @@ namespace syntropy::synergy
     /* TASK                                                                 */
     /************************************************************************/
 
+    Task::Task(TaskPool* pool) noexcept
+        : pool_(pool)
+    {
+        SYNERGY_TRACE_ONLY(trace_id_ = GetTaskTrace().NextTaskId());
+    }
+
+    Task::~Task()
+    {
+        auto executable = static_cast<void*>(executable_);
+
+        if (executable >= static_cast<void*>(&storage_) && executable < static_cast<void*>(&storage_ + 1))
+        {
+            executable_->~IExecutable();                                                    // Inline executable: the storage is released along with the task.
+        }
+        else
+        {
+            delete executable_;
+        }
+    }
+
     void Task::Execute()
     {
         if (executable_)
@@ -19,32 +38,44 @@ namespace syntropy::synergy
         }
     }
 
+    TaskPriority Task::GetPriority() const
+    {
+        return priority_;
+    }
+
+    uint64_t Task::GetTraceId() const
+    {
+        return trace_id_;
+    }
+
     void Task::SetDependencies(const TaskList& dependencies)
     {
         SYNTROPY_ASSERT(dependency_count_.load(std::memory_order_acquire) == 0);
 
-        auto shared_this = shared_from_this();
+        auto shared_this = TaskHandle(this);
 
         dependency_count_.store(dependencies.size() + 1, std::memory_order_release);        // Additional dependency needed to schedule the task manually after this call.
 
         for (auto&& dependency : dependencies)
         {
             dependency->successors_.emplace_back(shared_this);
+
+            SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kDependency, trace_id_, dependency->trace_id_));
         }
     }
 
     bool Task::ScheduleConditional()
     {
-        auto previous = dependency_count_.fetch_sub(1, std::memory_order_relaxed);
+        auto previous = dependency_count_.fetch_sub(1, std::memory_order_acq_rel);                 // Acquire the side-effects of every dependency before the task runs.
 
         SYNTROPY_ASSERT(previous >= 1);                                                     // Be sure this task was not "over-scheduled".
 
         return previous == 1;
     }
 
-    void Task::ContinueWith(std::shared_ptr<Task> task)
+    void Task::ContinueWith(const TaskHandle& task)
     {
-        if (task.get() != this)
+        if (task.Get() != this)
         {
             MoveSuccessors(task->successors_);
         }
@@ -52,7 +83,7 @@ namespace syntropy::synergy
 
     void Task::MoveSuccessors(TaskList& successors)
     {
-        if (successors.size() == 0)
+        if (successors.size() == 0 && persistent_successors_count_ == 0)
         {
             std::swap(successors_, successors);
         }
@@ -63,7 +94,15 @@ namespace syntropy::synergy
             std::copy(std::begin(successors_), std::end(successors_), std::back_inserter(successors));
         }
 
-        successors_.clear();
+        successors_.erase(std::begin(successors_) + persistent_successors_count_, std::end(successors_));      // Persistent successors are kept for the next execution.
+    }
+
+    void Task::RemoveReference() noexcept
+    {
+        if (reference_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            TaskPool::DestroyTask(*this);                                                   // Last reference: every other thread is done with this task.
+        }
     }
 
 
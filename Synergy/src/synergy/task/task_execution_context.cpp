@@ -10,7 +10,13 @@ namespace syntropy::synergy
 
     thread_local TaskExecutionContext* TaskExecutionContext::innermost_context_ = nullptr;
 
-    std::shared_ptr<Task> TaskExecutionContext::ExecuteTask(std::shared_ptr<Task> task)
+    TaskExecutionContext::TaskExecutionContext(TaskPool& task_pool)
+        : task_pool_(task_pool)
+    {
+
+    }
+
+    TaskHandle TaskExecutionContext::ExecuteTask(TaskHandle task)
     {
         // Push a new context on the stack.
 
@@ -18,6 +24,8 @@ namespace syntropy::synergy
         {
             TaskExecutionContext::innermost_context_ = outer_context;
 
+            priority_ = TaskPriority::kNormal;
+
             reschedulable_task_ = nullptr;
             pending_tasks_.clear();
             continuation_tasks_.clear();
@@ -27,10 +35,16 @@ namespace syntropy::synergy
 
         reschedulable_task_ = task;
 
+        priority_ = task->GetPriority();                                                    // Tasks spawned during the execution inherit the priority of the current task.
+
         // Task execution.
 
+        SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kTaskBegin, task->GetTraceId()));
+
         task->Execute();
 
+        SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kTaskEnd, task->GetTraceId()));
+
         if (auto continuation = GetContinuation())
         {
             task->ContinueWith(continuation);                                               // The task is not yet finished: continue with another task.
@@ -68,7 +82,7 @@ namespace syntropy::synergy
         reschedulable_task_ = nullptr;
     }
 
-    std::shared_ptr<Task> TaskExecutionContext::GetContinuation()
+    TaskHandle TaskExecutionContext::GetContinuation()
     {
         auto continuation_count = continuation_tasks_.size();
 
@@ -86,25 +100,40 @@ namespace syntropy::synergy
         }
     }
 
-    std::shared_ptr<Task> TaskExecutionContext::SchedulePendingTasks()
+    TaskHandle TaskExecutionContext::SchedulePendingTasks()
     {
-        std::shared_ptr<Task> next_task;                                                    // Next task to execute after this call. This task is not notified and is returned directly.
+        TaskHandle next_task;                                                               // Next task to execute after this call. This task is not notified and is returned directly.
 
         for (auto&& pending_task : pending_tasks_)
         {
             if (pending_task->ScheduleConditional())
             {
-                if (next_task)
+                if (!next_task)
+                {
+                    next_task = std::move(pending_task);
+                }
+                else if (pending_task->GetPriority() < next_task->GetPriority())
                 {
-                    on_task_ready_.Notify(*this, OnTaskReadyEventArgs{ std::move(pending_task) });
+                    std::swap(next_task, pending_task);                                     // Keep the most urgent task for this context and hand the other one over.
+
+                    ready_tasks_.emplace_back(std::move(pending_task));
                 }
                 else
                 {
-                    next_task = std::move(pending_task);
+                    ready_tasks_.emplace_back(std::move(pending_task));
                 }
             }
         }
 
+        // Hand every other ready task over at once.
+
+        if (!ready_tasks_.empty())
+        {
+            on_task_ready_.Notify(*this, OnTaskReadyEventArgs{ ready_tasks_ });
+
+            ready_tasks_.clear();
+        }
+
         return next_task;
     }
 
@@ -0,0 +1,93 @@
+#include "synergy/task/task_graph.h"
+
+#include "synergy/task/task_execution_context.h"
+
+#include <algorithm>
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* TASK GRAPH                                                           */
+    /************************************************************************/
+
+    TaskGraph::~TaskGraph()
+    {
+        SYNTROPY_ASSERT(!sink_ || sink_->dependency_count_.load(std::memory_order_acquire) == 0);      // The graph is still running.
+    }
+
+    TaskHandle TaskGraph::Launch()
+    {
+        SYNTROPY_ASSERT(TaskExecutionContext::innermost_context_);
+
+        if (!sink_)
+        {
+            Seal();
+        }
+        else
+        {
+            SYNTROPY_ASSERT(sink_->dependency_count_.load(std::memory_order_acquire) == 0);            // The previous launch didn't complete yet.
+        }
+
+        Reset();
+
+        // Roots are scheduled along with any other task created by the current task: no allocation happens once the pending list grew large enough.
+
+        auto& pending_tasks = TaskExecutionContext::innermost_context_->pending_tasks_;
+
+        pending_tasks.insert(std::end(pending_tasks), std::begin(roots_), std::end(roots_));
+
+        return sink_;
+    }
+
+    TaskHandle TaskGraph::Record(TaskHandle task, const TaskList& dependencies)
+    {
+        for (auto&& dependency : dependencies)
+        {
+            SYNTROPY_ASSERT(std::find(std::begin(tasks_), std::end(tasks_), dependency) != std::end(tasks_));        // Dependencies must belong to this graph.
+
+            SYNTROPY_ASSERT(dependency->successors_.size() == dependency->persistent_successors_count_ + 1);
+
+            ++dependency->persistent_successors_count_;                         // The successor was just appended by Task::SetDependencies.
+        }
+
+        if (dependencies.empty())
+        {
+            roots_.emplace_back(task);
+        }
+
+        dependency_counts_.emplace_back(std::max(dependencies.size(), size_t(1)));     // Roots are scheduled manually upon launch.
+
+        tasks_.emplace_back(task);
+
+        return task;
+    }
+
+    void TaskGraph::Seal()
+    {
+        TaskList leaves;
+
+        std::copy_if(std::begin(tasks_), std::end(tasks_), std::back_inserter(leaves), [](const TaskHandle& task)
+        {
+            return task->persistent_successors_count_ == 0;
+        });
+
+        // The sink has no executable: it only gathers the leaves so that the graph can be waited upon as a single task.
+
+        auto sink = TaskHandle(new Task());
+
+        sink->SetDependencies(leaves);
+
+        sink_ = Record(std::move(sink), leaves);
+    }
+
+    void TaskGraph::Reset()
+    {
+        auto count = tasks_.size();
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            tasks_[index]->dependency_count_.store(dependency_counts_[index], std::memory_order_relaxed);      // Published when the roots are pushed on a queue.
+        }
+    }
+
+}
@@ -1,5 +1,11 @@
 #include "synergy/task/task_pool.h"
 
+#include <algorithm>
+#include <new>
+
+#include "syntropy/memory/virtual_memory.h"
+#include "syntropy/memory/memory_range.h"
+
 namespace syntropy::synergy
 {
 
@@ -7,6 +13,218 @@ namespace syntropy::synergy
     /* TASK POOL                                                            */
     /************************************************************************/
 
+    thread_local TaskPool* TaskPool::thread_pool_ = nullptr;
+
+    std::atomic<std::size_t> TaskPool::frame_count_{ 0 };
+
+    TaskPool::TaskPool(Bytes capacity, Bytes frame_capacity)
+        : tasks_(Bytes(sizeof(Task)), Alignment(std::align_val_t(alignof(Task))), capacity)
+        , frames_(Bytes(kFrameBlockSize), Alignment(std::align_val_t(alignof(FrameHeader))), frame_capacity)
+    {
+
+    }
+
+    void TaskPool::Bind()
+    {
+        SYNTROPY_ASSERT(owner_.load(std::memory_order_relaxed) == std::thread::id());
+
+        owner_.store(std::this_thread::get_id(), std::memory_order_release);
+
+        thread_pool_ = this;
+    }
+
+    void TaskPool::Unbind()
+    {
+        SYNTROPY_ASSERT(IsOwner());
+
+        // From now on no thread, including one reusing the id of the calling thread, will ever release blocks directly.
+
+        owner_.store(std::thread::id(), std::memory_order_release);
+
+        if (thread_pool_ == this)
+        {
+            thread_pool_ = nullptr;
+        }
+    }
+
+    void TaskPool::DestroyTask(Task& task)
+    {
+        auto pool = task.pool_;
+
+        if (!pool)
+        {
+            delete &task;                                                                       // The task was allocated on the heap.
+            return;
+        }
+
+        task.~Task();
+
+        if (pool->IsOwner())
+        {
+            pool->tasks_.Deallocate(&task);
+        }
+        else
+        {
+            pool->tasks_.DeallocateRemote(&task);
+        }
+    }
+
+    void* TaskPool::AllocateFrame(std::size_t size)
+    {
+        auto pool = thread_pool_;
+
+        auto block = MemoryRange{};
+
+        if (pool && pool->IsOwner() && (size + sizeof(FrameHeader) <= kFrameBlockSize))
+        {
+            block = pool->frames_.Allocate();
+        }
+
+        if (!block)
+        {
+            pool = nullptr;                                                                     // Foreign thread, frame too large or pool exhausted.
+
+            auto storage = ::operator new(size + sizeof(FrameHeader));
+
+            block = MemoryRange(MemoryAddress(storage), MemoryAddress(storage) + Bytes(size + sizeof(FrameHeader)));
+        }
+        else
+        {
+            frame_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto header = new (block.Begin()) FrameHeader{ pool };
+
+        return header + 1;
+    }
+
+    void TaskPool::DeallocateFrame(void* frame)
+    {
+        auto header = static_cast<FrameHeader*>(frame) - 1;
+
+        auto pool = header->pool_;
+
+        header->~FrameHeader();
+
+        if (!pool)
+        {
+            ::operator delete(header);                                                          // The frame was allocated on the heap.
+
+            return;
+        }
+
+        if (pool->IsOwner())
+        {
+            pool->frames_.Deallocate(header);
+        }
+        else
+        {
+            pool->frames_.DeallocateRemote(header);
+        }
+
+        frame_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::size_t TaskPool::GetFrameCount() noexcept
+    {
+        return frame_count_.load(std::memory_order_relaxed);
+    }
+
+    TaskHandle TaskPool::AllocateTask()
+    {
+        if (!IsOwner())
+        {
+            return TaskHandle(new Task());                                                      // Foreign thread: the pool is not thread-safe.
+        }
+
+        auto block = tasks_.Allocate();
+
+        if (!block)
+        {
+            return TaskHandle(new Task());                                                      // The pool is exhausted.
+        }
+
+        return TaskHandle(new (block.Begin()) Task(this));
+    }
+
+    bool TaskPool::IsOwner() const
+    {
+        return owner_.load(std::memory_order_acquire) == std::this_thread::get_id();
+    }
+
+    /************************************************************************/
+    /* TASK POOL :: BLOCK POOL                                              */
+    /************************************************************************/
+
+    TaskPool::BlockPool::BlockPool(Bytes block_size, Alignment alignment, Bytes capacity)
+        : block_size_(block_size)
+        , alignment_(alignment)
+        , memory_buffer_(capacity)
+        , memory_range_(static_cast<const VirtualMemoryRange&>(memory_buffer_))
+        , allocator_(memory_range_)
+        , commit_head_(memory_range_.Begin())
+    {
+
+    }
+
+    MemoryRange TaskPool::BlockPool::Allocate()
+    {
+        RecycleRemoteBlocks();
+
+        if (auto block = free_blocks_.Recycle(block_size_))
+        {
+            return block;
+        }
+
+        auto block = allocator_.Allocate(block_size_, alignment_);
+
+        if (block && block.End() > commit_head_)
+        {
+            // Commit the next chunk of the pool: the underlying linear allocator returns new blocks at increasingly higher addresses.
+
+            auto commit_end = std::min(commit_head_ + kCommitGranularity, memory_range_.End());
+
+            if (!VirtualMemory::Commit(MemoryRange(commit_head_, commit_end)))                  // Kernel call.
+            {
+                allocator_.Deallocate(block, alignment_);                                       // Roll back: the block is the last one allocated and was never touched.
+                return {};
+            }
+
+            commit_head_ = commit_end;
+        }
+
+        return block;
+    }
+
+    void TaskPool::BlockPool::Deallocate(void* block)
+    {
+        free_blocks_.Trash(MemoryRange(MemoryAddress(block), MemoryAddress(block) + block_size_), block_size_);
+    }
+
+    void TaskPool::BlockPool::DeallocateRemote(void* block)
+    {
+        // Push the block on the remote list: the owner thread will recycle it later.
+
+        auto remote_block = new (block) RemoteBlock{ remote_blocks_.load(std::memory_order_relaxed) };
+
+        while (!remote_blocks_.compare_exchange_weak(remote_block->next_, remote_block, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void TaskPool::BlockPool::RecycleRemoteBlocks()
+    {
+        if (!remote_blocks_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        for (auto remote_block = remote_blocks_.exchange(nullptr, std::memory_order_acquire); remote_block;)
+        {
+            auto next = remote_block->next_;
+
+            Deallocate(remote_block);
 
+            remote_block = next;
+        }
+    }
 
 }
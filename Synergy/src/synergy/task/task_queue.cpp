@@ -12,67 +12,195 @@ namespace syntropy::synergy
     /************************************************************************/
 
     TaskQueue::TaskQueue(size_t capacity)
-        : tasks_(capacity)
     {
+        size_t buffer_capacity = 1;
 
+        while (buffer_capacity < capacity)
+        {
+            buffer_capacity <<= 1;                                                      // Round up to the next power of 2.
+        }
+
+        storage_ = std::make_unique<Buffer>(buffer_capacity, nullptr);
+
+        buffer_.store(storage_.get(), std::memory_order_relaxed);
     }
 
-    std::shared_ptr<Task> TaskQueue::PopBack()
+    TaskQueue::~TaskQueue()
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        Clear();
+    }
+
+    TaskHandle TaskQueue::PopBack()
+    {
+        auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        auto buffer = buffer_.load(std::memory_order_relaxed);
+
+        bottom_.store(bottom, std::memory_order_relaxed);                               // Reserve the last element before looking at the top.
 
-        if (begin_index_ != end_index_)
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        auto top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom)
         {
-            end_index_ = (end_index_ > 0) ? end_index_ - 1 : tasks_.size() - 1;         // Decrement and wrap around.
+            bottom_.store(bottom + 1, std::memory_order_relaxed);                       // The queue was empty: restore the bottom.
+
+            return nullptr;
+        }
 
-            auto task = tasks_[end_index_];
+        auto task = (*buffer)[bottom].load(std::memory_order_relaxed);
 
-            tasks_[end_index_] = nullptr;
+        if (top == bottom)
+        {
+            // Last element in the queue: race against thieves by advancing the top.
+
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                task = nullptr;                                                         // A thief got there first.
+            }
 
-            return task;
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
         }
 
-        return nullptr;
+        return Acquire(task);
     }
 
-    void TaskQueue::PushBack(std::shared_ptr<Task> task)
+    void TaskQueue::PushBack(TaskHandle task)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        SYNTROPY_ASSERT(task);
 
-        tasks_[end_index_] = task;
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        auto top = top_.load(std::memory_order_acquire);
+        auto buffer = buffer_.load(std::memory_order_relaxed);
 
-        end_index_ = (end_index_ + 1) % tasks_.size();                                  // Increment and wrap around.
+        if (bottom - top > static_cast<int64_t>(buffer->mask_))
+        {
+            buffer = Grow(top, bottom);                                                 // The queue is full.
+        }
 
-        SYNTROPY_ASSERT(begin_index_ != end_index_);                                    // Ensure the queue is not full.
+        (*buffer)[bottom].store(task.Detach(), std::memory_order_relaxed);             // The queue keeps the reference to the task until it is popped.
+
+        bottom_.store(bottom + 1, std::memory_order_release);                          // Publish the task to thieves.
     }
 
-    std::shared_ptr<Task> TaskQueue::PopFront()
+    void TaskQueue::PushBack(TaskList::iterator first, TaskList::iterator last, TaskPriority priority)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        auto has_priority = [priority](const TaskHandle& task)
+        {
+            return task && task->GetPriority() == priority;                              // Tasks moved into other queues are left empty.
+        };
+
+        auto count = static_cast<int64_t>(std::count_if(first, last, has_priority));
+
+        if (count == 0)
+        {
+            return;
+        }
 
-        if (begin_index_ != end_index_)
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        auto top = top_.load(std::memory_order_acquire);
+        auto buffer = buffer_.load(std::memory_order_relaxed);
+
+        while (bottom - top + count > static_cast<int64_t>(buffer->mask_) + 1)
         {
-            auto task = tasks_[begin_index_];
+            buffer = Grow(top, bottom);                                                 // Not enough room for each task.
+        }
+
+        for (auto index = bottom; first != last; ++first)
+        {
+            if (has_priority(*first))
+            {
+                (*buffer)[index++].store(first->Detach(), std::memory_order_relaxed);
+            }
+        }
+
+        bottom_.store(bottom + count, std::memory_order_release);                      // Publish every task to thieves at once.
+    }
+
+    TaskHandle TaskQueue::PopFront()
+    {
+        auto top = top_.load(std::memory_order_acquire);
 
-            tasks_[begin_index_] = nullptr;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
 
-            begin_index_ = (begin_index_ + 1) % tasks_.size();                          // Increment and wrap around.
+        auto bottom = bottom_.load(std::memory_order_acquire);
 
-            return task;
+        if (top < bottom)
+        {
+            auto buffer = buffer_.load(std::memory_order_acquire);
+
+            auto task = (*buffer)[top].load(std::memory_order_relaxed);
+
+            if (top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return Acquire(task);
+            }
         }
 
-        return nullptr;
+        return nullptr;                                                                 // Either the queue was empty or another thread won the race.
+    }
+
+    bool TaskQueue::IsEmpty() const
+    {
+        auto bottom = bottom_.load(std::memory_order_relaxed);
+        auto top = top_.load(std::memory_order_relaxed);
+
+        return top >= bottom;
     }
 
     void TaskQueue::Clear()
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        while (PopBack());
+    }
+
+    TaskQueue::Buffer* TaskQueue::Grow(int64_t top, int64_t bottom)
+    {
+        storage_ = std::make_unique<Buffer>((storage_->mask_ + 1) << 1, std::move(storage_));
 
-        while (begin_index_ != end_index_)
+        auto& buffer = *storage_;
+        auto& previous = *buffer.previous_;
+
+        for (auto index = top; index < bottom; ++index)
         {
-            tasks_[begin_index_] = nullptr;
+            buffer[index].store(previous[index].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
 
-            begin_index_ = (begin_index_ + 1) % tasks_.size();
+        buffer_.store(&buffer, std::memory_order_release);
+
+        return &buffer;
+    }
+
+    TaskHandle TaskQueue::Acquire(Task* task)
+    {
+        return TaskHandle(task, false);
+    }
+
+    void PushTasks(std::array<TaskQueue, kTaskPriorityCount>& queues, TaskList& tasks)
+    {
+        // One pass per priority class rather than sorting the list, which would allocate.
+
+        for (size_t priority = 0; priority < kTaskPriorityCount; ++priority)
+        {
+            queues[priority].PushBack(std::begin(tasks), std::end(tasks), static_cast<TaskPriority>(priority));
         }
+
+        tasks.clear();
+    }
+
+    /************************************************************************/
+    /* TASK QUEUE :: BUFFER                                                 */
+    /************************************************************************/
+
+    TaskQueue::Buffer::Buffer(size_t capacity, std::unique_ptr<Buffer> previous)
+        : mask_(capacity - 1)
+        , tasks_(std::make_unique<std::atomic<Task*>[]>(capacity))
+        , previous_(std::move(previous))
+    {
+        SYNTROPY_ASSERT((capacity & mask_) == 0);                                       // Capacity must be a power of 2.
+    }
+
+    std::atomic<Task*>& TaskQueue::Buffer::operator[](int64_t index)
+    {
+        return tasks_[static_cast<size_t>(index) & mask_];
     }
 }
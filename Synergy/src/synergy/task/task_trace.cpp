@@ -0,0 +1,259 @@
+#include "synergy/task/task_trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_map>
+
+namespace syntropy::synergy
+{
+    /************************************************************************/
+    /* TASK TRACE                                                           */
+    /************************************************************************/
+
+    thread_local TaskTrace::ThreadBuffer TaskTrace::thread_buffer_;
+
+    TaskTrace& TaskTrace::GetInstance()
+    {
+        static TaskTrace instance;
+        return instance;
+    }
+
+    TaskTrace::TaskTrace()
+        : epoch_(std::chrono::steady_clock::now())
+    {
+
+    }
+
+    void TaskTrace::Record(TraceEventType type, uint64_t subject, uint64_t object)
+    {
+        GetThreadBuffer().Push(TraceEvent{ GetTimestamp(), subject, object, type });
+    }
+
+    uint64_t TaskTrace::NextTaskId()
+    {
+        static constexpr auto kThreadIdShift = 40u;
+
+        static thread_local auto thread_id = next_thread_id_.fetch_add(1, std::memory_order_relaxed) << kThreadIdShift;
+        static thread_local auto task_id = uint64_t{ 0 };
+
+        return thread_id | (++task_id);
+    }
+
+    void TaskTrace::Clear()
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+
+        for (auto&& buffer : buffers_)
+        {
+            buffer->count_ = 0;
+        }
+    }
+
+    void TaskTrace::ExportChromeTrace(std::ostream& stream) const
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+
+        // Timeline of a task: dependency edges are resolved after each event was collected.
+
+        struct TaskTimeline
+        {
+            std::vector<std::pair<uint64_t, size_t>> begins_;           // Timestamp and buffer index of each execution begin.
+            std::vector<std::pair<uint64_t, size_t>> ends_;             // Timestamp and buffer index of each execution end.
+        };
+
+        std::unordered_map<uint64_t, TaskTimeline> timelines;
+
+        std::vector<TraceEvent> dependencies;
+
+        auto separator = "\n";
+
+        auto write_event = [&](const char* name, const char* phase, uint64_t timestamp, size_t tid)
+        {
+            stream << separator << "{\"name\":\"" << name << "\",\"cat\":\"synergy\",\"ph\":\"" << phase
+                   << "\",\"ts\":" << (timestamp / 1000) << "." << (timestamp % 1000 / 100) << (timestamp % 100 / 10) << (timestamp % 10)
+                   << ",\"pid\":0,\"tid\":" << tid;
+
+            separator = ",\n";
+        };
+
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+        for (size_t tid = 0; tid < buffers_.size(); ++tid)
+        {
+            buffers_[tid]->ForEach([&](const TraceEvent& event)
+            {
+                switch (event.type_)
+                {
+                    case TraceEventType::kTaskBegin:
+                    {
+                        write_event("task", "B", event.timestamp_, tid);
+                        stream << ",\"args\":{\"id\":" << event.subject_ << "}}";
+                        timelines[event.subject_].begins_.emplace_back(event.timestamp_, tid);
+                        break;
+                    }
+
+                    case TraceEventType::kTaskEnd:
+                    {
+                        write_event("task", "E", event.timestamp_, tid);
+                        stream << "}";
+                        timelines[event.subject_].ends_.emplace_back(event.timestamp_, tid);
+                        break;
+                    }
+
+                    case TraceEventType::kStealAttempt:
+                    {
+                        write_event("steal attempt", "i", event.timestamp_, tid);
+                        stream << ",\"s\":\"t\"}";
+                        break;
+                    }
+
+                    case TraceEventType::kStealSuccess:
+                    {
+                        write_event("steal", "i", event.timestamp_, tid);
+                        stream << ",\"s\":\"t\",\"args\":{\"id\":" << event.subject_ << "}}";
+                        break;
+                    }
+
+                    case TraceEventType::kPark:
+                    {
+                        write_event("park", "B", event.timestamp_, tid);
+                        stream << "}";
+                        break;
+                    }
+
+                    case TraceEventType::kUnpark:
+                    {
+                        write_event("park", "E", event.timestamp_, tid);
+                        stream << "}";
+                        break;
+                    }
+
+                    case TraceEventType::kDependency:
+                    {
+                        dependencies.emplace_back(event);
+                        break;
+                    }
+                }
+            });
+        }
+
+        // Dependency edges are exported as flow events from the end of the dependency to the beginning of the successor.
+
+        auto find_after = [](const std::vector<std::pair<uint64_t, size_t>>& events, uint64_t timestamp)
+        {
+            auto it = std::find_if(std::begin(events), std::end(events), [timestamp](auto& event) { return event.first >= timestamp; });
+
+            return (it != std::end(events)) ? &(*it) : nullptr;
+        };
+
+        auto flow_id = uint64_t{ 0 };
+
+        for (auto&& dependency : dependencies)
+        {
+            auto successor_it = timelines.find(dependency.subject_);
+            auto predecessor_it = timelines.find(dependency.object_);
+
+            if (successor_it == std::end(timelines) || predecessor_it == std::end(timelines))
+            {
+                continue;                                                       // Either task never ran or its events were overwritten.
+            }
+
+            auto end = find_after(predecessor_it->second.ends_, dependency.timestamp_);
+            auto begin = end ? find_after(successor_it->second.begins_, end->first) : nullptr;
+
+            if (begin)
+            {
+                ++flow_id;
+
+                write_event("dependency", "s", end->first, end->second);
+                stream << ",\"id\":" << flow_id << "}";
+
+                write_event("dependency", "f", begin->first, begin->second);
+                stream << ",\"bp\":\"e\",\"id\":" << flow_id << "}";
+            }
+        }
+
+        stream << "\n]}\n";
+    }
+
+    bool TaskTrace::ExportChromeTrace(const std::string& path) const
+    {
+        std::ofstream stream(path, std::ios::out | std::ios::trunc);
+
+        if (!stream)
+        {
+            return false;
+        }
+
+        ExportChromeTrace(stream);
+
+        return !!stream;
+    }
+
+    TaskTrace::Buffer& TaskTrace::GetThreadBuffer()
+    {
+        if (!thread_buffer_.buffer_)
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+
+            if (free_buffers_.empty())
+            {
+                buffers_.emplace_back(std::make_unique<Buffer>());
+
+                thread_buffer_.buffer_ = buffers_.back().get();
+            }
+            else
+            {
+                thread_buffer_.buffer_ = free_buffers_.back();                  // Recycle the buffer of a thread that exited.
+
+                free_buffers_.pop_back();
+            }
+        }
+
+        return *thread_buffer_.buffer_;
+    }
+
+    uint64_t TaskTrace::GetTimestamp() const
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count());
+    }
+
+    TaskTrace& GetTaskTrace()
+    {
+        return TaskTrace::GetInstance();
+    }
+
+    /************************************************************************/
+    /* TASK TRACE :: BUFFER                                                 */
+    /************************************************************************/
+
+    TaskTrace::Buffer::Buffer()
+        : events_(std::make_unique<TraceEvent[]>(kBufferCapacity))
+    {
+
+    }
+
+    void TaskTrace::Buffer::Push(const TraceEvent& event)
+    {
+        events_[count_ % kBufferCapacity] = event;
+
+        ++count_;
+    }
+
+    /************************************************************************/
+    /* TASK TRACE :: THREAD BUFFER                                          */
+    /************************************************************************/
+
+    TaskTrace::ThreadBuffer::~ThreadBuffer()
+    {
+        if (buffer_)
+        {
+            auto& trace = TaskTrace::GetInstance();
+
+            std::scoped_lock<std::mutex> lock(trace.mutex_);
+
+            trace.free_buffers_.emplace_back(buffer_);
+        }
+    }
+
+}
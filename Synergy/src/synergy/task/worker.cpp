@@ -2,6 +2,10 @@
 
 #include "syntropy/diagnostics/assert.h"
 #include "syntropy/patterns/scope_guard.h"
+#include "syntropy/platform/macros.h"
+
+#include <algorithm>
+#include <iterator>
 
 namespace syntropy::synergy
 {
@@ -9,29 +13,29 @@ namespace syntropy::synergy
     /* WORKER                                                               */
     /************************************************************************/
 
-    Worker::Worker(size_t max_tasks)
-        : tasks_(max_tasks)
-    {
-
-    }
-
     void Worker::Start()
     {
         auto cleanup = MakeScopeGuard([this]() { execution_context_ = nullptr; });          // Make sure to reset the execution context after leaving.
 
         // Setup.
 
-        TaskExecutionContext context;
+        task_pool_.Bind();
+
+        TaskExecutionContext context(task_pool_);
 
         execution_context_ = &context;
 
         auto handle = context.OnTaskReady().Subscribe([this](auto& /*sender*/, auto& args) 
         {
-            EnqueueTask(args.task_);                                                        // #TODO Avoid accessing the queue if the task is going to be stolen.
+            auto count = args.tasks_.size();
 
-            on_task_enqueued_.Notify(*this);
+            EnqueueTasks(args.tasks_);                                                      // #TODO Avoid accessing the queue if the task is going to be stolen.
+
+            on_task_enqueued_.Notify(*this, count);
         });
 
+        thread_id_ = std::this_thread::get_id();
+
         is_running_.store(true, std::memory_order_release);
 
         on_ready_.Notify(*this);                                                            // the worker is now ready to accept new tasks.
@@ -43,19 +47,37 @@ namespace syntropy::synergy
             while(task && IsRunning())
             {
                 task = context.ExecuteTask(std::move(task));                                // Inner loop: non-concurrent depth-first execution to improve scalability and cache locality.
+
+                if (task && HasUrgentTasks(task->GetPriority()))
+                {
+                    EnqueueTask(std::move(task));                                           // More urgent work is waiting: yield the depth-first chain to it.
+                }
             }
         }
 
         // Flush remaining tasks.
 
-        tasks_.Clear();
+        for (auto&& tasks : tasks_)
+        {
+            tasks.Clear();
+        }
+
+        std::scoped_lock<std::mutex> lock(mutex_);
+
+        mailbox_.clear();
+
+        has_mail_.store(false, std::memory_order_relaxed);
     }
 
     void Worker::Stop()
     {
-        is_running_.store(false, std::memory_order_release);
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);                                      // Synchronizes with EnqueueTask(): no task can be mailed to the worker after this point.
+
+            is_running_.store(false, std::memory_order_release);
+        }
 
-        wake_up_.notify_all();
+        wake_up_.Notify();
     }
 
     bool Worker::IsRunning() const
@@ -63,48 +85,315 @@ namespace syntropy::synergy
         return is_running_.load(std::memory_order_relaxed);
     }
 
-    void Worker::EnqueueTask(std::shared_ptr<Task> task)
+    void Worker::EnqueueTask(TaskHandle task)
     {
-        tasks_.PushBack(task);
+        if (std::this_thread::get_id() == thread_id_)
+        {
+            GetQueue(task->GetPriority()).PushBack(std::move(task));                        // The worker is awake by definition: no need to notify it.
+        }
+        else
+        {
+            {
+                std::scoped_lock<std::mutex> lock(mutex_);
+
+                if (!is_running_.load(std::memory_order_relaxed))
+                {
+                    return;                                                                 // The worker was stopped and its mailbox already flushed: the task is canceled.
+                }
 
-        wake_up_.notify_all();
+                mailbox_.emplace_back(std::move(task));
+
+                has_mail_.store(true, std::memory_order_release);
+            }
+
+            if (wake_up_.Notify())
+            {
+                wakeups_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
     }
 
-    std::shared_ptr<Task> Worker::DequeueTask()
+    void Worker::EnqueueTasks(TaskList& tasks)
     {
-        return tasks_.PopFront();
+        if (std::this_thread::get_id() == thread_id_)
+        {
+            PushTasks(tasks_, tasks);                                                       // The worker is awake by definition: no need to notify it.
+        }
+        else
+        {
+            {
+                std::scoped_lock<std::mutex> lock(mutex_);
+
+                if (!is_running_.load(std::memory_order_relaxed))
+                {
+                    tasks.clear();
+                    return;                                                                 // The worker was stopped and its mailbox already flushed: the tasks are canceled.
+                }
+
+                std::move(std::begin(tasks), std::end(tasks), std::back_inserter(mailbox_));
+
+                has_mail_.store(true, std::memory_order_release);
+            }
+
+            tasks.clear();
+
+            if (wake_up_.Notify())
+            {
+                wakeups_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
     }
 
-    std::shared_ptr<Task> Worker::FetchTask()
+    bool Worker::SetIdle(bool is_idle)
     {
-        std::shared_ptr<Task> task;
+        return is_idle_.exchange(is_idle, std::memory_order_seq_cst);
+    }
 
-        // Wait until there's a new task to execute or a termination was requested.
+    bool Worker::Wake()
+    {
+        if (!is_idle_.exchange(false, std::memory_order_seq_cst))
+        {
+            return false;
+        }
 
-        std::unique_lock<std::mutex> lock(mutex_);
+        wake_requested_.store(true, std::memory_order_release);
 
-        wake_up_.wait(lock, [this, &task]()
+        if (wake_up_.Notify())
         {
-            if (!IsRunning())
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    TaskHandle Worker::DequeueTask()
+    {
+        for (auto&& tasks : tasks_)
+        {
+            if (auto task = tasks.PopFront())
             {
-                return true;                        // Return immediately if termination was requested.
+                return task;
             }
+        }
 
-            task = tasks_.PopBack();                // Pop a new task.
+        return nullptr;
+    }
 
-            if (task == nullptr)
+    TaskHandle Worker::DequeueTask(TaskPriority priority)
+    {
+        return GetQueue(priority).PopFront();
+    }
+
+    TaskHandle Worker::FetchTask()
+    {
+        auto is_starving = false;
+
+        auto fed = MakeScopeGuard([this, &is_starving]()
+        {
+            if (is_starving)
+            {
+                on_fed_.Notify(*this);
+            }
+        });
+
+        while (IsRunning())
+        {
+            if (auto task = PopTask())
             {
-                // Notify the worker is about to starve and check if a new task shows up.
+                return task;
+            }
+
+            // Notify the worker is about to starve and check if a new task shows up.
+
+            is_starving = true;
 
-                on_starving_.Notify(*this);
+            on_starving_.Notify(*this);
 
-                task = tasks_.PopBack();
+            if (auto task = PopTask())
+            {
+                return task;
             }
 
-            return task != nullptr;
-        });
+            // Wait until there's a new task to execute or a termination was requested.
+
+            Idle();
 
-        return task;
+            wake_requested_.store(false, std::memory_order_relaxed);
+        }
+
+        return nullptr;
+    }
+
+    void Worker::Idle()
+    {
+        // Spin: cheapest way to catch new work arriving shortly, without giving up the core.
+
+        for (size_t spin_count = 0; spin_count < kSpinCount; ++spin_count)
+        {
+            if (IsIdleOver())
+            {
+                Increment(spins_);
+                return;
+            }
+
+            SYNTROPY_PAUSE;
+        }
+
+        // Yield: give other threads the chance to run while still polling.
+
+        for (size_t yield_count = 0; yield_count < kYieldCount; ++yield_count)
+        {
+            if (IsIdleOver())
+            {
+                Increment(yields_);
+                return;
+            }
+
+            std::this_thread::yield();
+        }
+
+        // Park: from now on any thread producing new work for this worker pays for a wake-up.
+
+        auto key = wake_up_.PrepareWait();
+
+        if (IsIdleOver())
+        {
+            wake_up_.CancelWait();                                                          // New work arrived before the worker was registered as a waiter.
+            return;
+        }
+
+        Increment(parks_);
+
+        SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kPark));
+
+        wake_up_.CommitWait(key);
+
+        SYNERGY_TRACE_ONLY(GetTaskTrace().Record(TraceEventType::kUnpark));
+    }
+
+    bool Worker::IsIdleOver() const
+    {
+        return !IsRunning() || HasTasks() || wake_requested_.load(std::memory_order_acquire);
+    }
+
+    void Worker::Increment(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);      // Single writer: no need for an atomic read-modify-write.
+    }
+
+    TaskHandle Worker::PopTask()
+    {
+        CollectMail();                                                                      // Mailed tasks may be more urgent than any queued one.
+
+        // Serve a starving queue first, if any.
+
+        for (size_t index = 0; index < kTaskPriorityCount; ++index)
+        {
+            if (ages_[index] >= kAgingThreshold)
+            {
+                ages_[index] = 0;
+
+                if (auto task = tasks_[index].PopBack())
+                {
+                    return task;
+                }
+            }
+        }
+
+        // Serve the most urgent queue, aging each non-empty queue that was passed over.
+
+        for (size_t index = 0; index < kTaskPriorityCount; ++index)
+        {
+            if (auto task = tasks_[index].PopBack())
+            {
+                for (auto passed_index = index + 1; passed_index < kTaskPriorityCount; ++passed_index)
+                {
+                    ages_[passed_index] += tasks_[passed_index].IsEmpty() ? 0 : 1;
+                }
+
+                ages_[index] = 0;
+
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Worker::CollectMail()
+    {
+        if (!has_mail_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+
+            std::swap(collected_mail_, mailbox_);                                           // Both lists retain their capacity: collecting mail doesn't allocate.
+
+            has_mail_.store(false, std::memory_order_relaxed);
+        }
+
+        for (auto&& task : collected_mail_)
+        {
+            GetQueue(task->GetPriority()).PushBack(std::move(task));                        // Tasks in the mailbox become stealable by other workers.
+        }
+
+        collected_mail_.clear();
+    }
+
+    bool Worker::HasTasks() const
+    {
+        if (has_mail_.load(std::memory_order_acquire))
+        {
+            return true;
+        }
+
+        for (auto&& tasks : tasks_)
+        {
+            if (!tasks.IsEmpty())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool Worker::HasUrgentTasks(TaskPriority priority) const
+    {
+        if (priority != TaskPriority::kHigh && has_mail_.load(std::memory_order_relaxed))
+        {
+            return true;                                                                    // Mailed tasks are not sorted yet: assume the worst.
+        }
+
+        for (size_t index = 0; index < static_cast<size_t>(priority); ++index)
+        {
+            if (!tasks_[index].IsEmpty())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    TaskQueue& Worker::GetQueue(TaskPriority priority)
+    {
+        return tasks_[static_cast<size_t>(priority)];
+    }
+
+    WorkerStatistics Worker::GetStatistics() const
+    {
+        auto statistics = WorkerStatistics{};
+
+        statistics.spins_ = spins_.load(std::memory_order_relaxed);
+        statistics.yields_ = yields_.load(std::memory_order_relaxed);
+        statistics.parks_ = parks_.load(std::memory_order_relaxed);
+        statistics.wakeups_ = wakeups_.load(std::memory_order_relaxed);
+
+        return statistics;
     }
 
     TaskExecutionContext* Worker::GetExecutionContext()
@@ -112,7 +401,7 @@ namespace syntropy::synergy
         return execution_context_.load(std::memory_order_relaxed);
     }
 
-    Observable<Worker&>& Worker::OnTaskEnqueued()
+    Observable<Worker&, size_t>& Worker::OnTaskEnqueued()
     {
         return on_task_enqueued_;
     }
@@ -122,6 +411,11 @@ namespace syntropy::synergy
         return on_starving_;
     }
 
+    Observable<Worker&>& Worker::OnFed()
+    {
+        return on_fed_;
+    }
+
     Observable<Worker&>& Worker::OnReady()
     {
         return on_ready_;
@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "syntropy/memory/bytes.h"
 #include "syntropy/memory/alignment.h"
+#include "syntropy/memory/memory_range.h"
 
 #include "syntropy/diagnostics/diagnostics.h"
 
@@ -42,6 +45,8 @@
 
 namespace syntropy
 {
+    struct AllocatorProfile;
+
     /************************************************************************/
     /* ALLOCATOR                                                            */
     /************************************************************************/
@@ -108,6 +113,10 @@ namespace syntropy
         /// \brief Get the biggest allocation that can be performed by this allocator.
         virtual Bytes GetMaxAllocationSize() const = 0;
 
+        /// \brief Get the range of addresses reserved by the allocator.
+        /// Every block owned by the allocator falls within this range. Allocators whose blocks are not confined to a single range return an empty range.
+        virtual MemoryRange GetRange() const;
+
         /// \brief Get a symbolic name for the allocator.
         /// \return Returns a symbolic name for the allocator.
         const HashedString& GetName() const;
@@ -117,12 +126,16 @@ namespace syntropy
 
     private:
 
+        friend class MemoryProfiler;
+
         class Register;
 
         HashedString name_;                 ///< \brief Name of the allocator.
 
         Context context_;                   ///< \brief Context associated to the allocator.
 
+        std::atomic<AllocatorProfile*> profile_{ nullptr };         ///< \brief Statistics collected by syntropy::MemoryProfiler. Created the first time an allocation is tracked.
+
     };
 
 }
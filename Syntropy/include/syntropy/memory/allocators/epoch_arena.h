@@ -0,0 +1,304 @@
+
+/// \file epoch_arena.h
+/// \brief This header is part of the syntropy memory management system. It contains allocators used to handle transient allocations whose lifetime is bound to a frame.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/alignment.h"
+#include "syntropy/memory/memory_address.h"
+#include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/virtual_memory_buffer.h"
+#include "syntropy/memory/allocators/linear_allocator.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* EPOCH ARENA                                                          */
+    /************************************************************************/
+
+    /// \brief N-buffered linear allocator used to handle transient allocations whose lifetime spans a bounded number of frames (epochs).
+    /// Memory allocated during epoch k belongs to one of N buffers and is recycled all at once when the arena advances to epoch k+N, provided that every consumer of epoch k signalled it is done with it.
+    /// Each thread allocates from its own sub-arena, hence allocations never contend: an allocation costs one pointer bump and memory is committed on demand.
+    /// Sub-arenas of threads that exited are handed over to new threads.
+    /// Memory committed by a buffer is decommitted once its usage stayed below the committed amount for a whole decommit window, so that a transient spike does not pin memory forever.
+    ///
+    /// Allocations belong to the epoch that was current when they were performed and can be performed by any thread concurrently with Advance().
+    /// Each allocation publishes the epoch it belongs to: Advance() waits for allocations still in flight on the buffer it is about to recycle.
+    /// Advance() must be called by a single thread at a time.
+    ///
+    /// \usage EpochArena arena(64_MiBytes, 2, 1);
+    ///        auto block = arena.Allocate(256_Bytes);          (block survives until epoch arena.GetEpoch() + 2)
+    ///        arena.Signal(arena.GetEpoch());                  (consumer done with the current epoch)
+    ///        arena.Advance();
+    ///
+    /// \author Raffaele D. Facendola - 2018
+    class EpochArena
+    {
+    public:
+
+        /// \brief Maximum number of buffers in an arena.
+        static constexpr std::size_t kMaxBufferCount = 8;
+
+        /// \brief Default number of recycles a buffer must go through before memory above its usage is decommitted.
+        static constexpr std::size_t kDefaultDecommitWindow = 64;
+
+        /// \brief Amount of memory committed each time a buffer runs out of committed memory.
+        static constexpr Bytes kCommitGranularity = Bytes(0x10000);
+
+        /// \brief Create a new arena.
+        /// \param capacity Maximum amount of memory each thread can allocate during an epoch, in bytes. Rounded up to kCommitGranularity.
+        /// \param buffer_count Number of buffers, that is the number of epochs each allocation survives. Must be in the range [2; kMaxBufferCount], since the current epoch never shares its buffer with the epoch being recycled.
+        /// \param consumer_count Number of consumers that must signal an epoch before its memory can be recycled. Zero recycles memory unconditionally.
+        /// \param decommit_window Number of recycles a buffer must go through before memory above its peak usage over the same recycles is decommitted.
+        EpochArena(Bytes capacity, std::size_t buffer_count, std::size_t consumer_count, std::size_t decommit_window = kDefaultDecommitWindow);
+
+        /// \brief No copy constructor.
+        EpochArena(const EpochArena&) = delete;
+
+        /// \brief No assignment operator.
+        EpochArena& operator=(const EpochArena&) = delete;
+
+        /// \brief Default destructor.
+        /// Memory of every sub-arena is released along with the arena.
+        ~EpochArena() = default;
+
+        /// \brief Allocate a new memory block in the current epoch.
+        /// \param size Size of the memory block to allocate.
+        /// \return Returns a range representing the requested memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size);
+
+        /// \brief Allocate a new aligned memory block in the current epoch.
+        /// \param size Size of the memory block to allocate.
+        /// \param alignment Block alignment.
+        /// \return Returns a range representing the requested aligned memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size, Alignment alignment);
+
+        /// \brief Deallocate a memory block. This method does nothing, since memory is recycled when the epoch the block was allocated in expires.
+        /// \param block Block to deallocate.
+        void Deallocate(const MemoryRange& block);
+
+        /// \brief Deallocate an aligned memory block. This method does nothing, since memory is recycled when the epoch the block was allocated in expires.
+        /// \param block Block to deallocate.
+        /// \param alignment Block alignment.
+        void Deallocate(const MemoryRange& block, Alignment alignment);
+
+        /// \brief Check whether this arena owns the provided memory block.
+        /// \param block Block to check the ownership of.
+        /// \return Returns true if the provided memory range was allocated by this arena, returns false otherwise.
+        bool Owns(const MemoryRange& block) const;
+
+        /// \brief Get the maximum allocation size that can be handled by this arena.
+        /// \return Returns the maximum allocation size that can be handled by this arena.
+        Bytes GetMaxAllocationSize() const;
+
+        /// \brief Get the current epoch.
+        /// \return Returns the current epoch. New allocations belong to this epoch.
+        std::size_t GetEpoch() const;
+
+        /// \brief Signal that a consumer is done with the memory allocated during an epoch.
+        /// Each consumer must signal each epoch exactly once.
+        /// \param epoch Epoch to signal. Must be one of the last buffer-count epochs.
+        void Signal(std::size_t epoch);
+
+        /// \brief Check whether the arena can advance to the next epoch, that is whether every consumer signalled the epoch whose memory would be recycled.
+        /// \return Returns true if the next call to Advance() would succeed, returns false otherwise.
+        bool CanAdvance() const;
+
+        /// \brief Advance to the next epoch, recycling the memory allocated buffer-count epochs before.
+        /// Threads still allocating from the epoch to recycle, having read the epoch before it expired, are waited for.
+        /// \return Returns true if the arena advanced to the next epoch, returns false if some consumer did not signal the epoch to recycle yet.
+        bool Advance();
+
+        /// \brief Get the amount of memory committed by every sub-arena.
+        /// \return Returns the amount of memory committed by every sub-arena, in bytes.
+        Bytes GetCommittedSize() const;
+
+    private:
+
+        /// \brief Memory used by a thread during the epochs sharing the same buffer.
+        struct Buffer
+        {
+            MemoryRange memory_range_;                                  ///< \brief Memory reserved for the buffer.
+
+            LinearAllocator allocator_;                                 ///< \brief Underlying allocator. Rewound when the buffer is recycled.
+
+            MemoryAddress commit_head_;                                 ///< \brief Pointer past the last committed address.
+
+            Bytes peak_size_;                                           ///< \brief Highest usage since the beginning of the current decommit window.
+
+            std::size_t recycle_count_{ 0 };                            ///< \brief Number of recycles since the beginning of the current decommit window.
+        };
+
+        /// \brief Buffers owned by a thread.
+        struct SubArena
+        {
+            EpochArena* arena_;                                         ///< \brief Arena the sub-arena belongs to.
+
+            VirtualMemoryBuffer memory_buffer_;                         ///< \brief Memory reserved for every buffer.
+
+            std::array<Buffer, kMaxBufferCount> buffers_;               ///< \brief Buffers, by epoch modulo buffer count.
+
+            std::atomic<std::size_t> epoch_{ kNoEpoch };                ///< \brief Epoch of the allocation in flight, if any. kNoEpoch otherwise.
+        };
+
+        /// \brief Sub-arenas bound to the current thread.
+        struct SubArenaBinding
+        {
+            /// \brief Maximum number of arenas a thread keeps track of. Older bindings are evicted first.
+            static constexpr std::size_t kMaxEntries = 8;
+
+            /// \brief A sub-arena bound to the current thread.
+            struct Entry
+            {
+                std::uint64_t arena_id_{ 0 };                           ///< \brief Unique id of the arena the sub-arena belongs to.
+
+                SubArena* sub_arena_{ nullptr };                        ///< \brief Sub-arena bound to the current thread.
+
+                std::weak_ptr<SubArena> handle_;                        ///< \brief Expires if the arena was destroyed before the thread exited.
+            };
+
+            /// \brief Return every sub-arena bound to the current thread to its arena.
+            ~SubArenaBinding();
+
+            /// \brief Return the sub-arena of an entry to its arena, if the arena still exists.
+            static void Release(Entry& entry);
+
+            std::array<Entry, kMaxEntries> entries_;                    ///< \brief Sub-arenas bound to the current thread.
+
+            std::size_t next_entry_{ 0 };                               ///< \brief Next entry to evict.
+        };
+
+        /// \brief Epoch of a sub-arena which is not allocating.
+        static constexpr std::size_t kNoEpoch = std::size_t(-1);
+
+        /// \brief Publish the epoch a sub-arena is about to allocate from, making sure the epoch was not advanced meanwhile.
+        /// \return Returns the current epoch.
+        std::size_t EnterEpoch(SubArena& sub_arena) const;
+
+        /// \brief Get the sub-arena of the calling thread, creating it if needed.
+        SubArena& GetSubArena();
+
+        /// \brief Bind a sub-arena to the calling thread, recycling one released by another thread if possible.
+        SubArena& BindSubArena();
+
+        /// \brief Return a sub-arena that is no longer bound to any thread.
+        void ReleaseSubArena(SubArena& sub_arena);
+
+        /// \brief Commit the memory of a buffer up to the end of a block.
+        /// \return Returns true if the memory could be committed, returns false otherwise.
+        static bool Commit(Buffer& buffer, const MemoryRange& block);
+
+        /// \brief Rewind a buffer and decommit memory past its usage if the decommit window expired.
+        void Recycle(Buffer& buffer);
+
+        static thread_local SubArenaBinding thread_binding_;            ///< \brief Sub-arenas bound to the current thread.
+
+        static std::atomic<std::uint64_t> next_arena_id_;               ///< \brief Id of the next arena to create. Ids are never reused, hence stale bindings never alias a new arena.
+
+        std::uint64_t id_;                                              ///< \brief Unique id of the arena.
+
+        Bytes capacity_;                                                ///< \brief Capacity of each buffer.
+
+        std::size_t buffer_count_;                                      ///< \brief Number of buffers.
+
+        std::size_t consumer_count_;                                    ///< \brief Number of consumers that must signal each epoch.
+
+        std::size_t decommit_window_;                                   ///< \brief Number of recycles before memory past the peak usage is decommitted.
+
+        std::atomic<std::size_t> epoch_{ 0 };                           ///< \brief Current epoch.
+
+        std::array<std::atomic<std::size_t>, kMaxBufferCount> pending_signals_;     ///< \brief Number of consumers that did not signal the last epoch of each buffer yet.
+
+        mutable std::mutex mutex_;                                      ///< \brief Guards sub-arenas binding and recycling.
+
+        std::vector<std::shared_ptr<SubArena>> sub_arenas_;             ///< \brief Sub-arenas ever bound. Sub-arenas are never destroyed before the arena, since their buffers may still be in use.
+
+        std::vector<SubArena*> free_sub_arenas_;                        ///< \brief Sub-arenas released by threads that exited.
+    };
+
+}
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // EpochArena.
+
+    inline MemoryRange EpochArena::Allocate(Bytes size)
+    {
+        return Allocate(size, Alignment());
+    }
+
+    inline MemoryRange EpochArena::Allocate(Bytes size, Alignment alignment)
+    {
+        auto& sub_arena = GetSubArena();
+
+        auto& buffer = sub_arena.buffers_[EnterEpoch(sub_arena) % buffer_count_];
+
+        auto block = buffer.allocator_.Allocate(size, alignment);
+
+        if (block && block.End() > buffer.commit_head_ && !Commit(buffer, block))
+        {
+            buffer.allocator_.Deallocate(block, alignment);
+            block = {};
+        }
+
+        sub_arena.epoch_.store(kNoEpoch, std::memory_order_release);          // The buffer can be recycled.
+
+        return block;
+    }
+
+    inline void EpochArena::Deallocate(const MemoryRange& /*block*/)
+    {
+
+    }
+
+    inline void EpochArena::Deallocate(const MemoryRange& /*block*/, Alignment /*alignment*/)
+    {
+
+    }
+
+    inline Bytes EpochArena::GetMaxAllocationSize() const
+    {
+        return capacity_;
+    }
+
+    inline std::size_t EpochArena::GetEpoch() const
+    {
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    inline std::size_t EpochArena::EnterEpoch(SubArena& sub_arena) const
+    {
+        // Sequentially-consistent store-load pair: either Advance() sees the published epoch or the allocation sees the new epoch. See Advance().
+
+        auto epoch = epoch_.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            sub_arena.epoch_.store(epoch, std::memory_order_seq_cst);
+
+            auto current_epoch = epoch_.load(std::memory_order_seq_cst);
+
+            if (current_epoch == epoch)
+            {
+                return epoch;
+            }
+
+            epoch = current_epoch;
+        }
+    }
+
+}
@@ -7,14 +7,20 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
 
 #include "syntropy/memory/bytes.h"
 #include "syntropy/memory/alignment.h"
 #include "syntropy/memory/memory_address.h"
 #include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/virtual_memory.h"
+#include "syntropy/memory/virtual_memory_buffer.h"
 
 #include "syntropy/diagnostics/assert.h"
 
+#include "syntropy/math/math.h"
+
 namespace syntropy
 {
     /************************************************************************/
@@ -102,10 +108,201 @@ namespace syntropy
         MemoryAddress head_;                ///< \brief Pointer past the last allocated address.
     };
 
+    /************************************************************************/
+    /* CONCURRENT LINEAR ALLOCATOR                                          */
+    /************************************************************************/
+
+    /// \brief Allocator used to allocate memory over a contiguous range of memory addresses from many threads concurrently, without locks.
+    /// Memory is allocated sequentially on demand by advancing the head pointer atomically. Pointer-level deallocations are not supported.
+    /// This allocator is meant to back allocators that never return memory to the underlying allocator, such as syntropy::PoolAllocator.
+    /// \author Raffaele D. Facendola - 2018
+    class ConcurrentLinearAllocator
+    {
+    public:
+
+        /// \brief Default constructor.
+        ConcurrentLinearAllocator() noexcept = default;
+
+        /// \brief Create a new allocator.
+        /// \param memory_range Memory range the allocator will operate on.
+        ConcurrentLinearAllocator(const MemoryRange& memory_range) noexcept;
+
+        /// \brief No copy constructor.
+        ConcurrentLinearAllocator(const ConcurrentLinearAllocator&) = delete;
+
+        /// \brief Move constructor. Not thread-safe.
+        ConcurrentLinearAllocator(ConcurrentLinearAllocator&& rhs) noexcept;
+
+        /// \brief Default destructor.
+        ~ConcurrentLinearAllocator() = default;
+
+        /// \brief Unified assignment operator. Not thread-safe.
+        ConcurrentLinearAllocator& operator=(ConcurrentLinearAllocator rhs) noexcept;
+
+        /// \brief Allocate a new memory block.
+        /// \param size Size of the memory block to allocate.
+        /// \return Returns a range representing the requested memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size) noexcept;
+
+        /// \brief Allocate a new aligned memory block.
+        /// \param size Size of the memory block to allocate.
+        /// \param alignment Block alignment.
+        /// \return Returns a range representing the requested aligned memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size, Alignment alignment) noexcept;
+
+        /// \brief Deallocate a memory block. This method does nothing, since other threads may have allocated past the block in the meantime.
+        /// \param block Block to deallocate.
+        void Deallocate(const MemoryRange& block) noexcept;
+
+        /// \brief Deallocate an aligned memory block. This method does nothing, since other threads may have allocated past the block in the meantime.
+        /// \param block Block to deallocate.
+        /// \param alignment Block alignment.
+        void Deallocate(const MemoryRange& block, Alignment alignment) noexcept;
+
+        /// \brief Deallocate every allocation performed so far on this allocator. Not thread-safe.
+        void DeallocateAll() noexcept;
+
+        /// \brief Check whether this allocator owns the provided memory block.
+        /// \param block Block to check the ownership of.
+        /// \return Returns true if the provided memory range was allocated by this allocator, returns false otherwise.
+        bool Owns(const MemoryRange& block) const noexcept;
+
+        /// \brief Get the maximum allocation size that can be handled by this allocator.
+        /// The returned value shall not be used to determine whether a call to "Allocate" will fail.
+        /// \return Returns the maximum allocation size that can be handled by this allocator.
+        Bytes GetMaxAllocationSize() const noexcept;
+
+        /// \brief Swap this allocator with the provided instance. Not thread-safe.
+        void Swap(ConcurrentLinearAllocator& rhs) noexcept;
+
+    private:
+
+        MemoryRange memory_range_;                          ///< \brief Memory range managed by this allocator.
+
+        std::atomic<MemoryAddress> head_;                   ///< \brief Pointer past the last allocated address.
+    };
+
+    /************************************************************************/
+    /* VIRTUAL LINEAR ALLOCATOR                                             */
+    /************************************************************************/
+
+    /// \brief Linear allocator operating on a reserved range of virtual memory addresses, which is committed lazily as the allocator grows.
+    /// Memory is committed in chunks as the head pointer advances, hence the allocator can reserve the worst-case amount of memory while committing only the memory it actually uses.
+    /// Memory committed past the head pointer can be optionally decommitted when the allocator is rewound, once it exceeds a threshold: the threshold acts as hysteresis against allocators oscillating around a chunk boundary.
+    /// \author Raffaele D. Facendola - 2018
+    class VirtualLinearAllocator
+    {
+    public:
+
+        /// \brief Default amount of memory committed each time the allocator runs out of committed memory.
+        static constexpr Bytes kDefaultCommitGranularity = Bytes(0x10000);
+
+        /// \brief Decommit threshold used to never decommit memory.
+        static constexpr Bytes kNoDecommit = Bytes(std::numeric_limits<std::size_t>::max());
+
+        /// \brief Default constructor.
+        VirtualLinearAllocator() noexcept = default;
+
+        /// \brief Create a new allocator.
+        /// \param capacity Amount of memory to reserve, in bytes. This is the maximum amount of memory the allocator can ever allocate.
+        /// \param commit_granularity Amount of memory committed each time the allocator runs out of committed memory. Rounded up to the size of the pages backing the allocator.
+        /// \param decommit_threshold Amount of committed memory past the head pointer that causes the allocator to decommit it when rewound. kNoDecommit never decommits memory.
+        /// \param page_mode Size of the pages backing the allocator.
+        VirtualLinearAllocator(Bytes capacity, Bytes commit_granularity = kDefaultCommitGranularity, Bytes decommit_threshold = kNoDecommit, VirtualMemoryPageMode page_mode = VirtualMemoryPageMode::kRegular);
+
+        /// \brief No copy constructor.
+        VirtualLinearAllocator(const VirtualLinearAllocator&) = delete;
+
+        /// \brief Move constructor.
+        VirtualLinearAllocator(VirtualLinearAllocator&& rhs) noexcept;
+
+        /// \brief Default destructor.
+        /// Releases the reserved memory.
+        ~VirtualLinearAllocator() = default;
+
+        /// \brief Unified assignment operator.
+        VirtualLinearAllocator& operator=(VirtualLinearAllocator rhs) noexcept;
+
+        /// \brief Allocate a new memory block.
+        /// \param size Size of the memory block to allocate.
+        /// \return Returns a range representing the requested memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size) noexcept;
+
+        /// \brief Allocate a new aligned memory block.
+        /// \param size Size of the memory block to allocate.
+        /// \param alignment Block alignment.
+        /// \return Returns a range representing the requested aligned memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size, Alignment alignment) noexcept;
+
+        /// \brief Deallocate a memory block.
+        /// \param block Block to deallocate.
+        /// \remarks The behavior of this function is undefined unless the provided block was returned by a previous call to ::Allocate(size).
+        void Deallocate(const MemoryRange& block) noexcept;
+
+        /// \brief Deallocate an aligned memory block.
+        /// \param block Block to deallocate. Must refer to any allocation performed via Allocate(size, alignment).
+        /// \param alignment Block alignment.
+        /// \remarks The behavior of this function is undefined unless the provided block was returned by a previous call to ::Allocate(size, alignment).
+        void Deallocate(const MemoryRange& block, Alignment alignment) noexcept;
+
+        /// \brief Deallocate every allocation performed so far on this allocator.
+        void DeallocateAll() noexcept;
+
+        /// \brief Check whether this allocator owns the provided memory block.
+        /// \param block Block to check the ownership of.
+        /// \return Returns true if the provided memory range was allocated by this allocator, returns false otherwise.
+        bool Owns(const MemoryRange& block) const noexcept;
+
+        /// \brief Get the maximum allocation size that can be handled by this allocator.
+        /// The returned value shall not be used to determine whether a call to "Allocate" will fail.
+        /// \return Returns the maximum allocation size that can be handled by this allocator.
+        Bytes GetMaxAllocationSize() const noexcept;
+
+        /// \brief Get the amount of memory currently committed by this allocator.
+        /// \return Returns the amount of memory currently committed by this allocator, in bytes.
+        Bytes GetCommittedSize() const noexcept;
+
+        /// \brief Restore the allocator to a previous state, decommitting memory past the head pointer if it exceeds the decommit threshold.
+        /// \param state State to restore the allocator to. Must match any value returned by SaveState() otherwise the behaviour is undefined.
+        void RestoreState(MemoryAddress state);
+
+        /// \brief Get the current state of the allocator.
+        /// The returned value can be used to restore the allocator to a previous state via the method RestoreState(state);
+        /// \return Returns the current state of the allocator.
+        MemoryAddress SaveState() const noexcept;
+
+        /// \brief Swap this allocator with the provided instance.
+        void Swap(VirtualLinearAllocator& rhs) noexcept;
+
+    private:
+
+        /// \brief Commit the memory up to the provided address.
+        /// \return Returns true if the memory could be committed, returns false otherwise.
+        bool Commit(MemoryAddress head) noexcept;
+
+        VirtualMemoryBuffer memory_buffer_;                 ///< \brief Reserved memory.
+
+        MemoryRange memory_range_;                          ///< \brief Memory range managed by this allocator.
+
+        MemoryAddress head_;                                ///< \brief Pointer past the last allocated address.
+
+        MemoryAddress commit_head_;                         ///< \brief Pointer past the last committed address.
+
+        Bytes commit_granularity_;                          ///< \brief Amount of memory committed each time the allocator runs out of committed memory.
+
+        Bytes decommit_threshold_{ kNoDecommit };           ///< \brief Amount of committed memory past the head pointer that causes the allocator to decommit it when rewound.
+    };
+
 }
 
 /// \brief Swaps two syntropy::LinearAllocator instances.
 void swap(syntropy::LinearAllocator& lhs, syntropy::LinearAllocator& rhs) noexcept;
+
+/// \brief Swaps two syntropy::ConcurrentLinearAllocator instances.
+void swap(syntropy::ConcurrentLinearAllocator& lhs, syntropy::ConcurrentLinearAllocator& rhs) noexcept;
+
+/// \brief Swaps two syntropy::VirtualLinearAllocator instances.
+void swap(syntropy::VirtualLinearAllocator& lhs, syntropy::VirtualLinearAllocator& rhs) noexcept;
  
 namespace syntropy
 {
@@ -209,9 +406,246 @@ namespace syntropy
         swap(head_, rhs.head_);
     }
 
+    // ConcurrentLinearAllocator.
+
+    inline ConcurrentLinearAllocator::ConcurrentLinearAllocator(const MemoryRange& memory_range) noexcept
+        : memory_range_(memory_range)
+        , head_(memory_range_.Begin())
+    {
+
+    }
+
+    inline ConcurrentLinearAllocator::ConcurrentLinearAllocator(ConcurrentLinearAllocator&& rhs) noexcept
+        : memory_range_(rhs.memory_range_)
+        , head_(rhs.head_.load(std::memory_order_relaxed))
+    {
+
+    }
+
+    inline ConcurrentLinearAllocator& ConcurrentLinearAllocator::operator=(ConcurrentLinearAllocator rhs) noexcept
+    {
+        rhs.Swap(*this);
+        return *this;
+    }
+
+    inline MemoryRange ConcurrentLinearAllocator::Allocate(Bytes size) noexcept
+    {
+        return Allocate(size, Alignment());
+    }
+
+    inline MemoryRange ConcurrentLinearAllocator::Allocate(Bytes size, Alignment alignment) noexcept
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+
+        for(;;)
+        {
+            auto block = head.GetAligned(alignment);
+
+            auto next_head = block + size;
+
+            if (next_head > memory_range_.End())
+            {
+                return {};
+            }
+
+            if (head_.compare_exchange_weak(head, next_head, std::memory_order_relaxed))                // Blocks are published by the allocator using them.
+            {
+                return { block, next_head };
+            }
+        }
+    }
+
+    inline void ConcurrentLinearAllocator::Deallocate(const MemoryRange& block) noexcept
+    {
+        SYNTROPY_ASSERT(memory_range_.Contains(block));
+    }
+
+    inline void ConcurrentLinearAllocator::Deallocate(const MemoryRange& block, Alignment /*alignment*/) noexcept
+    {
+        Deallocate(block);
+    }
+
+    inline void ConcurrentLinearAllocator::DeallocateAll() noexcept
+    {
+        head_.store(memory_range_.Begin(), std::memory_order_relaxed);
+    }
+
+    inline bool ConcurrentLinearAllocator::Owns(const MemoryRange& block) const noexcept
+    {
+        return block.Begin() >= memory_range_.Begin() && block.End() <= head_.load(std::memory_order_relaxed);
+    }
+
+    inline Bytes ConcurrentLinearAllocator::GetMaxAllocationSize() const noexcept
+    {
+        return Bytes(memory_range_.End() - head_.load(std::memory_order_relaxed));
+    }
+
+    inline void ConcurrentLinearAllocator::Swap(ConcurrentLinearAllocator& rhs) noexcept
+    {
+        using std::swap;
+
+        swap(memory_range_, rhs.memory_range_);
+
+        head_.store(rhs.head_.exchange(head_.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // VirtualLinearAllocator.
+
+    inline VirtualLinearAllocator::VirtualLinearAllocator(Bytes capacity, Bytes commit_granularity, Bytes decommit_threshold, VirtualMemoryPageMode page_mode)
+        : memory_buffer_(capacity, page_mode)
+        , memory_range_(memory_buffer_)
+        , head_(memory_range_.Begin())
+        , commit_head_(memory_range_.Begin())
+        , decommit_threshold_(decommit_threshold)
+    {
+        auto page_size = (page_mode == VirtualMemoryPageMode::kLarge) ? VirtualMemory::GetLargePageSize() : VirtualMemory::GetPageSize();
+
+        commit_granularity_ = Bytes(Ceil(std::max(std::size_t(commit_granularity), std::size_t(1)), std::size_t(page_size)));
+    }
+
+    inline VirtualLinearAllocator::VirtualLinearAllocator(VirtualLinearAllocator&& rhs) noexcept
+        : memory_buffer_(std::move(rhs.memory_buffer_))
+        , memory_range_(rhs.memory_range_)
+        , head_(rhs.head_)
+        , commit_head_(rhs.commit_head_)
+        , commit_granularity_(rhs.commit_granularity_)
+        , decommit_threshold_(rhs.decommit_threshold_)
+    {
+        rhs.memory_range_ = MemoryRange();
+        rhs.head_ = MemoryAddress();
+        rhs.commit_head_ = MemoryAddress();
+    }
+
+    inline VirtualLinearAllocator& VirtualLinearAllocator::operator=(VirtualLinearAllocator rhs) noexcept
+    {
+        rhs.Swap(*this);
+        return *this;
+    }
+
+    inline MemoryRange VirtualLinearAllocator::Allocate(Bytes size) noexcept
+    {
+        return Allocate(size, Alignment());
+    }
+
+    inline MemoryRange VirtualLinearAllocator::Allocate(Bytes size, Alignment alignment) noexcept
+    {
+        auto block = head_.GetAligned(alignment);
+
+        auto head = block + size;
+
+        if (head <= memory_range_.End() && (head <= commit_head_ || Commit(head)))
+        {
+            head_ = head;
+
+            return { block, head_ };
+        }
+
+        return {};
+    }
+
+    inline void VirtualLinearAllocator::Deallocate(const MemoryRange& block) noexcept
+    {
+        SYNTROPY_ASSERT(memory_range_.Contains(block));
+
+        // Only the last block can be deallocated.
+
+        if (block.End() == head_)
+        {
+            head_ = block.Begin();
+        }
+    }
+
+    inline void VirtualLinearAllocator::Deallocate(const MemoryRange& block, Alignment /*alignment*/) noexcept
+    {
+        Deallocate(block);
+    }
+
+    inline void VirtualLinearAllocator::DeallocateAll() noexcept
+    {
+        RestoreState(memory_range_.Begin());
+    }
+
+    inline bool VirtualLinearAllocator::Owns(const MemoryRange& block) const noexcept
+    {
+        return block.Begin() >= memory_range_.Begin() && block.End() <= head_;
+    }
+
+    inline Bytes VirtualLinearAllocator::GetMaxAllocationSize() const noexcept
+    {
+        return Bytes(memory_range_.End() - head_);
+    }
+
+    inline Bytes VirtualLinearAllocator::GetCommittedSize() const noexcept
+    {
+        return Bytes(commit_head_ - memory_range_.Begin());
+    }
+
+    inline void VirtualLinearAllocator::RestoreState(MemoryAddress head)
+    {
+        SYNTROPY_ASSERT(head >= memory_range_.Begin() && head <= memory_range_.End());
+
+        head_ = head;
+
+        // Keep the chunk containing the head pointer committed.
+
+        auto commit_head = memory_range_.Begin() + Bytes(Ceil(std::size_t(head_ - memory_range_.Begin()), std::size_t(commit_granularity_)));
+
+        if (commit_head < commit_head_ && Bytes(commit_head_ - commit_head) > decommit_threshold_)
+        {
+            if (VirtualMemory::Decommit(MemoryRange(commit_head, commit_head_)))        // Kernel call.
+            {
+                commit_head_ = commit_head;
+            }
+        }
+    }
+
+    inline MemoryAddress VirtualLinearAllocator::SaveState() const noexcept
+    {
+        return head_;
+    }
+
+    inline void VirtualLinearAllocator::Swap(VirtualLinearAllocator& rhs) noexcept
+    {
+        using std::swap;
+
+        memory_buffer_.Swap(rhs.memory_buffer_);
+
+        swap(memory_range_, rhs.memory_range_);
+        swap(head_, rhs.head_);
+        swap(commit_head_, rhs.commit_head_);
+        swap(commit_granularity_, rhs.commit_granularity_);
+        swap(decommit_threshold_, rhs.decommit_threshold_);
+    }
+
+    inline bool VirtualLinearAllocator::Commit(MemoryAddress head) noexcept
+    {
+        // Commit whole chunks up to the new head pointer, without exceeding the reserved memory.
+
+        auto commit_head = std::min(commit_head_ + Bytes(Ceil(std::size_t(head - commit_head_), std::size_t(commit_granularity_))), memory_range_.End());
+
+        if (!VirtualMemory::Commit(MemoryRange(commit_head_, commit_head)))                // Kernel call.
+        {
+            return false;
+        }
+
+        commit_head_ = commit_head;
+
+        return true;
+    }
+
 }
 
 inline void swap(syntropy::LinearAllocator& lhs, syntropy::LinearAllocator& rhs) noexcept
 {
     lhs.Swap(rhs);
 }
+
+inline void swap(syntropy::ConcurrentLinearAllocator& lhs, syntropy::ConcurrentLinearAllocator& rhs) noexcept
+{
+    lhs.Swap(rhs);
+}
+
+inline void swap(syntropy::VirtualLinearAllocator& lhs, syntropy::VirtualLinearAllocator& rhs) noexcept
+{
+    lhs.Swap(rhs);
+}
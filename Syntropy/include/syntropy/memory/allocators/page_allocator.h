@@ -22,6 +22,8 @@
 #include "syntropy/memory/allocators/linear_allocator.h"
 #include "syntropy/memory/allocators/pool_allocator.h"
 
+#include "syntropy/math/math.h"
+
 #include "syntropy/diagnostics/assert.h"
 
 namespace syntropy
@@ -31,7 +33,7 @@ namespace syntropy
     /************************************************************************/
 
     /// \brief Allocator used to allocate memory blocks using system virtual memory.
-    /// Allocation sizes are rounded up and aligned to page boundaries.
+    /// Allocation sizes are rounded up and aligned to page boundaries. Pages are large pages if the policy requests them and the system supports them.
     /// Memory pages are committed and decommitted automatically.
     /// \tparam TPolicy Policy to be used to free and recycle previous memory pages.
     /// \author Raffaele D. Facendola - August 2018
@@ -94,6 +96,9 @@ namespace syntropy
 
     private:
 
+        /// \brief Get the granularity memory pages are rounded up to, depending on the policy.
+        static Bytes GetPageGranularity() noexcept;
+
         VirtualMemoryBuffer memory_buffer_;                                                         ///< \brief Virtual memory buffer reserved by this allocator.
 
         PoolAllocator<LinearAllocator, typename TPolicy::TPoolAllocatorPolicy> allocator_;          ///< \brief Underlying pool allocator used to handle memory pages.
@@ -115,8 +120,8 @@ namespace syntropy
 
     template <typename TPolicy>
     inline PageAllocator<TPolicy>::PageAllocator(Bytes capacity, Bytes page_size) noexcept
-        : memory_buffer_(capacity)
-        , allocator_(Ceil(page_size, VirtualMemory::GetPageSize()), VirtualMemory::GetPageAlignment(), memory_buffer_)
+        : memory_buffer_(capacity, TPolicy::kPageMode)
+        , allocator_(Bytes(Ceil(std::size_t(page_size), std::size_t(GetPageGranularity()))), VirtualMemory::GetPageAlignment(), memory_buffer_)
     {
 
     }
@@ -193,6 +198,19 @@ namespace syntropy
         return allocator_.GetMaxAllocationSize();
     }
 
+    template <typename TPolicy>
+    inline Bytes PageAllocator<TPolicy>::GetPageGranularity() noexcept
+    {
+        auto large_page_size = VirtualMemory::GetLargePageSize();
+
+        if (TPolicy::kPageMode == VirtualMemoryPageMode::kLarge && large_page_size > 0_Bytes)
+        {
+            return large_page_size;                                         // Large pages are aligned to their size, as is the underlying buffer.
+        }
+
+        return VirtualMemory::GetPageSize();
+    }
+
     template <typename TPolicy>
     inline void PageAllocator<TPolicy>::Swap(PageAllocator& rhs) noexcept
     {
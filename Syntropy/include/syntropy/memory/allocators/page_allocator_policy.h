@@ -33,6 +33,9 @@ namespace syntropy
         /// \brief Policy of the underlying pool allocator: intrusive free-list can be used since memory pages are kept committed at any given time.
         using TPoolAllocatorPolicy = DefaultPoolAllocatorPolicy;
 
+        /// \brief Size of the pages backing the allocator.
+        static constexpr VirtualMemoryPageMode kPageMode = VirtualMemoryPageMode::kRegular;
+
         /// \brief Commit a memory block.
         /// \param block Block to commit.
         /// \param page_size Size of the memory page.
@@ -62,6 +65,9 @@ namespace syntropy
         /// \brief Policy of the underlying pool allocator: since memory pages are decommitted the allocator cannot intrusively store information inside the free blocks.
         using TPoolAllocatorPolicy = NonIntrusivePoolAllocatorPolicy;
 
+        /// \brief Size of the pages backing the allocator.
+        static constexpr VirtualMemoryPageMode kPageMode = VirtualMemoryPageMode::kRegular;
+
         /// \brief Commit a memory block.
         /// \param block Block to commit.
         /// \param page_size Size of the memory page.
@@ -73,6 +79,21 @@ namespace syntropy
         void Decommit(const MemoryRange& block, Bytes page_size);
     };
 
+    /************************************************************************/
+    /* LARGE PAGE ALLOCATOR POLICY                                          */
+    /************************************************************************/
+
+    /// \brief Represents a syntropy::PageAllocator policy that backs memory pages with large pages, to reduce TLB misses on large arenas.
+    /// Memory pages are rounded up to the large page size and committed once, as syntropy::FastPageAllocatorPolicy does: decommitting part of a large page would split it back into regular pages.
+    /// If the system cannot provide large pages, this policy behaves exactly as syntropy::FastPageAllocatorPolicy. See VirtualMemory::GetLargePageCounters().
+    /// This policy is best suited for few, large and long-lived allocations.
+    /// \author Raffaele D. Facendola - 2018
+    struct LargePageAllocatorPolicy : FastPageAllocatorPolicy
+    {
+        /// \brief Size of the pages backing the allocator.
+        static constexpr VirtualMemoryPageMode kPageMode = VirtualMemoryPageMode::kLarge;
+    };
+
 }
 
 namespace syntropy
@@ -24,6 +24,7 @@ namespace syntropy
     /************************************************************************/
 
     /// \brief Allocator used to allocate fixed-sized memory blocks. Deallocated blocks are kept around and recycled when possible.
+    /// The allocator can be used by many threads concurrently if both the policy and the underlying allocator are thread-safe, such as syntropy::ConcurrentPoolAllocatorPolicy and syntropy::ConcurrentLinearAllocator.
     /// \tparam TAllocator Type of the underlying allocator.
     /// \tparam TPolicy Policy to be used when freeing and recycling previous allocations.
     /// \author Raffaele D. Facendola - August 2018
@@ -207,7 +208,7 @@ namespace syntropy
 }
 
 template <typename TAllocator, typename TPolicy>
-void swap(syntropy::PoolAllocator<TAllocator, TPolicy>& lhs, syntropy::PoolAllocator<TAllocator, typename TPolicy>& rhs) noexcept
+void swap(syntropy::PoolAllocator<TAllocator, TPolicy>& lhs, syntropy::PoolAllocator<TAllocator, TPolicy>& rhs) noexcept
 {
     lhs.Swap(rhs);
 }
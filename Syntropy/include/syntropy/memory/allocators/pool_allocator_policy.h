@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+
 #include "syntropy/memory/bytes.h"
 #include "syntropy/memory/alignment.h"
 #include "syntropy/memory/memory_address.h"
@@ -14,6 +17,8 @@
 #include "syntropy/memory/virtual_memory.h"
 #include "syntropy/memory/virtual_memory_range.h"
 
+#include "syntropy/diagnostics/assert.h"
+
 namespace syntropy
 {
     /************************************************************************/
@@ -85,6 +90,60 @@ namespace syntropy
         FreeList* free_{ nullptr };                     ///< \brief Current free list.
     };
 
+    /************************************************************************/
+    /* CONCURRENT POOL ALLOCATOR POLICY                                     */
+    /************************************************************************/
+
+    /// \brief Represents a syntropy::PoolAllocator policy that is used to recycle allocated memory blocks intrusively from many threads concurrently, without locks.
+    /// Free blocks form a Treiber stack whose head is tagged with a counter incremented upon each pop, hence a pop cannot succeed if the head was popped and pushed back in the meantime (ABA problem).
+    /// The tag is stored in the upper bits of the head, which are unused by user-space addresses: a pop may be fooled only if it is preempted for 65536 pops of the same stack.
+    /// Popping a block may read the link of a block that was popped and is being used by another thread: the value read is discarded when the tag check fails. For this reason blocks must never be released to the system.
+    /// The pool is lock-free only if its underlying allocator is thread-safe as well, such as syntropy::ConcurrentLinearAllocator.
+    /// \author Raffaele D. Facendola - 2018
+    struct ConcurrentPoolAllocatorPolicy
+    {
+        /// \brief Create an empty policy.
+        ConcurrentPoolAllocatorPolicy() noexcept = default;
+
+        /// \brief Move constructor. Not thread-safe.
+        ConcurrentPoolAllocatorPolicy(ConcurrentPoolAllocatorPolicy&& rhs) noexcept;
+
+        /// \brief Move assignment operator. Not thread-safe.
+        ConcurrentPoolAllocatorPolicy& operator=(ConcurrentPoolAllocatorPolicy&& rhs) noexcept;
+
+        /// \brief Attempts to recycle a previously deallocated memory block.
+        /// \param size Size of the block to recycle.
+        /// \return Returns a memory range representing a free block. If no such block exists returns an empty range.
+        MemoryRange Recycle(Bytes size) noexcept;
+
+        /// \brief Deallocate a memory block making it free for recycling.
+        /// \param block Block to free.
+        /// \param max_size Maximum size for a block in the allocator.
+        void Trash(const MemoryRange& block, Bytes max_size);
+
+    private:
+
+        /// \brief Represents a free block: the memory block itself is used to store a pointer to the next free block in the stack.
+        struct FreeBlock
+        {
+            std::atomic<FreeBlock*> next_{ nullptr };       ///< \brief Next free block in the pool. Atomic since it may be read while the block is being popped by another thread.
+        };
+
+        /// \brief Number of bits of a tagged head storing the address of the free block.
+        static constexpr std::size_t kAddressBits = 48;
+
+        /// \brief Mask of the bits of a tagged head storing the address of the free block.
+        static constexpr uint64_t kAddressMask = (uint64_t(1) << kAddressBits) - 1;
+
+        /// \brief Get the free block referenced by a tagged head.
+        static FreeBlock* GetFreeBlock(uint64_t head) noexcept;
+
+        /// \brief Get a tagged head referencing a free block.
+        static uint64_t GetHead(FreeBlock* free_block, uint64_t tag) noexcept;
+
+        alignas(64) std::atomic<uint64_t> free_{ 0 };      ///< \brief Tagged pointer to the next free block in the pool. The address is 0 if no previous block was freed.
+    };
+
 }
 
 namespace syntropy
@@ -124,7 +183,7 @@ namespace syntropy
 
     }
 
-    MemoryRange NonIntrusivePoolAllocatorPolicy::Recycle(Bytes size) noexcept
+    inline MemoryRange NonIntrusivePoolAllocatorPolicy::Recycle(Bytes size) noexcept
     {
         if (free_)
         {
@@ -149,7 +208,7 @@ namespace syntropy
         return {};                                                                              // No block to recycle.
     }
 
-    void NonIntrusivePoolAllocatorPolicy::Trash(const MemoryRange& block, Bytes max_size)
+    inline void NonIntrusivePoolAllocatorPolicy::Trash(const MemoryRange& block, Bytes max_size)
     {
         auto next_free_block = free_->free_block_ + 1;
 
@@ -171,5 +230,65 @@ namespace syntropy
         }
     }
 
-}
+    // ConcurrentPoolAllocatorPolicy.
+
+    inline ConcurrentPoolAllocatorPolicy::ConcurrentPoolAllocatorPolicy(ConcurrentPoolAllocatorPolicy&& rhs) noexcept
+        : free_(rhs.free_.exchange(0, std::memory_order_relaxed))
+    {
 
+    }
+
+    inline ConcurrentPoolAllocatorPolicy& ConcurrentPoolAllocatorPolicy::operator=(ConcurrentPoolAllocatorPolicy&& rhs) noexcept
+    {
+        free_.store(rhs.free_.exchange(free_.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+
+        return *this;
+    }
+
+    inline MemoryRange ConcurrentPoolAllocatorPolicy::Recycle(Bytes size) noexcept
+    {
+        auto head = free_.load(std::memory_order_acquire);
+
+        while (auto free_block = GetFreeBlock(head))
+        {
+            auto next = free_block->next_.load(std::memory_order_relaxed);                          // May be stale if the block was popped in the meantime: the tag check below will fail.
+
+            if (free_.compare_exchange_weak(head, GetHead(next, (head >> kAddressBits) + 1), std::memory_order_acquire, std::memory_order_acquire))
+            {
+                auto block = MemoryAddress(free_block);
+
+                return { block, block + size };
+            }
+        }
+
+        return {};
+    }
+
+    inline void ConcurrentPoolAllocatorPolicy::Trash(const MemoryRange& block, Bytes /*max_size*/)
+    {
+        auto free_block = block.Begin().As<FreeBlock>();
+
+        SYNTROPY_ASSERT((reinterpret_cast<uintptr_t>(free_block) & ~kAddressMask) == 0);           // The address doesn't leave room for the tag.
+
+        new (free_block) FreeBlock();
+
+        auto head = free_.load(std::memory_order_relaxed);
+
+        do
+        {
+            free_block->next_.store(GetFreeBlock(head), std::memory_order_relaxed);
+        }
+        while (!free_.compare_exchange_weak(head, GetHead(free_block, head >> kAddressBits), std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    inline ConcurrentPoolAllocatorPolicy::FreeBlock* ConcurrentPoolAllocatorPolicy::GetFreeBlock(uint64_t head) noexcept
+    {
+        return reinterpret_cast<FreeBlock*>(static_cast<uintptr_t>(head & kAddressMask));
+    }
+
+    inline uint64_t ConcurrentPoolAllocatorPolicy::GetHead(FreeBlock* free_block, uint64_t tag) noexcept
+    {
+        return (tag << kAddressBits) | static_cast<uint64_t>(reinterpret_cast<uintptr_t>(free_block));
+    }
+
+}
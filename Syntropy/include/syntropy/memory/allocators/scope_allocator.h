@@ -169,7 +169,7 @@ namespace syntropy
         {
             auto finalizer_size = Bytes(sizeof(Finalizer));
 
-            auto finalizer = allocator_.Allocate(object_size + finalizer_size).As<Finalizer>();
+            auto finalizer = allocator_.Allocate(object_size + finalizer_size).template As<Finalizer>();
 
             ConstructFinalizer<TObject>(*finalizer);
 
@@ -194,7 +194,7 @@ namespace syntropy
 
             auto buffer = allocator_.Allocate(object_size + finalizer_size + padding_size);
 
-            auto finalizer = ((buffer + finalizer_size).GetAligned(alignment) - finalizer_size).As<Finalizer>();
+            auto finalizer = ((buffer + finalizer_size).GetAligned(alignment) - finalizer_size).template As<Finalizer>();
 
             ConstructFinalizer<TObject>(*finalizer);
 
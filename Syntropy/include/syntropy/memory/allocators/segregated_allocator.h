@@ -9,10 +9,14 @@
 #include <array>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 
 #include "syntropy/memory/bytes.h"
 #include "syntropy/memory/memory_address.h"
-#include "syntropy/memory/virtual_memory_range.h"
+#include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/virtual_memory_buffer.h"
 #include "syntropy/memory/allocators/linear_allocator.h"
 #include "syntropy/memory/allocators/allocator.h"
 
@@ -21,6 +25,9 @@ namespace syntropy
     /// \brief High-performances, low-fragmentation allocator to handle allocation of any size.
     /// The allocator allocates pages on demand but uses a no-deallocation policy to avoid kernel calls.
     ///
+    /// Small allocations are served by a per-thread cache, in the style of tcmalloc and mimalloc: each thread owns one free list per size class, refilled from and drained to the shared allocator in batches.
+    /// Small blocks freed by threads other than the one whose cache allocated them are handed back to that cache via a lock-free list, hence the shared allocator lock is only taken once per batch.
+    ///
     /// Based on: http://www.gii.upv.es/tlsf/files/jrts2008.pdf
     ///
     /// \author Raffaele D. Facendola - January 2017
@@ -36,7 +43,7 @@ namespace syntropy
 
         /// \brief Create a new allocator.
         /// \param name Name of the allocator.
-        /// \param memory_range Memory range used by the allocator.
+        /// \param memory_range Memory range used by the allocator. Must be committed.
         /// \param second_level_index Number of classes for each first level index. The actual number of classes is 2^second_level_index.
         TwoLevelSegregatedFitAllocator(const HashedString& name, const MemoryRange& memory_range, size_t second_level_index);
 
@@ -50,6 +57,7 @@ namespace syntropy
         TwoLevelSegregatedFitAllocator& operator=(const TwoLevelSegregatedFitAllocator&) = delete;
 
         /// \brief Virtual destructor.
+        /// Blocks cached by any thread are discarded along with the allocator.
         virtual ~TwoLevelSegregatedFitAllocator() = default;
 
         virtual void* Allocate(Bytes size) override;
@@ -62,15 +70,35 @@ namespace syntropy
 
         virtual Bytes GetMaxAllocationSize() const override;
 
-        /// \brief Get the memory range managed by this allocator.
-        /// \return Returns the memory range managed by this allocator.
-        const MemoryRange& GetRange() const;
+        virtual MemoryRange GetRange() const override;
+
+        /// \brief Return every block cached by the calling thread to the shared allocator, so that they can be coalesced.
+        /// Blocks are returned automatically when the thread exits.
+        void FlushThreadCache();
+
+        /// \brief Size of each size class served by the per-thread caches, in bytes. Size classes are multiples of this size.
+        static constexpr Bytes kThreadCacheGranularity = Bytes(16);
+
+        /// \brief Number of size classes served by the per-thread caches. Larger allocations are served by the shared allocator directly.
+        static constexpr size_t kThreadCacheClassCount = 16;
+
+        /// \brief Number of blocks moved between a per-thread cache and the shared allocator at once.
+        static constexpr size_t kThreadCacheBatchSize = 32;
 
     private:
 
         /// \brief Minimum size for each memory block.
         static const Bytes kMinimumBlockSize;
 
+        /// \brief Flag set on the base pointer of blocks allocated by a per-thread cache. Block headers are aligned to the header size, hence the bit is always free.
+        static constexpr uintptr_t kCachedBlockFlag = 0x1;
+
+        /// \brief Used to mask away the size class from the owner of a cached block. Per-thread caches are aligned to a cache line, hence the low bits are always free.
+        static constexpr uintptr_t kSizeClassMask = 0x3F;
+
+        /// \brief Amount of memory committed each time the allocator runs out of committed memory.
+        static constexpr Bytes kCommitGranularity = Bytes(0x10000);
+
         /// \brief Header for an allocated block (either free or busy).
         struct BlockHeader
         {
@@ -138,10 +166,96 @@ namespace syntropy
             void* end();
         };
 
+        /// \brief A free block in a per-thread cache. Overlaps the payload of the block.
+        struct CachedBlock
+        {
+            CachedBlock* next_;                 ///< \brief Next free block in the list.
+        };
+
+        /// \brief Remote list of a per-thread cache which is not bound to any thread.
+        static CachedBlock* const kReleasedCache;
+
+        /// \brief Free lists owned by a single thread, one per size class.
+        /// Cached blocks are busy from the point of view of the shared allocator. Their layout is: || HEADER | OWNER | BASE_POINTER | ... BLOCK ... ||, where the owner stores the size class in its lowest bits and the base pointer is flagged via kCachedBlockFlag.
+        struct alignas(64) ThreadCache
+        {
+            TwoLevelSegregatedFitAllocator* allocator_;                     ///< \brief Allocator the cache belongs to.
+
+            std::array<CachedBlock*, kThreadCacheClassCount> free_lists_{};         ///< \brief Free blocks for each size class. Accessed by the owner thread only.
+
+            std::array<size_t, kThreadCacheClassCount> free_counts_{};              ///< \brief Number of free blocks for each size class. Accessed by the owner thread only.
+
+            alignas(64) std::atomic<CachedBlock*> remote_blocks_{ nullptr };        ///< \brief Blocks of this cache freed by other threads, waiting to be collected by the owner thread. kReleasedCache if the cache is not bound to any thread.
+        };
+
+        /// \brief Per-thread caches bound to the current thread, returning their blocks to the respective allocators when the thread exits.
+        struct ThreadCacheBinding
+        {
+            /// \brief A per-thread cache bound to the current thread.
+            struct Entry
+            {
+                uint64_t allocator_id_;                                     ///< \brief Unique id of the allocator owning the cache.
+
+                ThreadCache* cache_;                                        ///< \brief Cache bound to the current thread.
+
+                std::weak_ptr<ThreadCache> handle_;                         ///< \brief Expires if the allocator was destroyed before the thread exited.
+            };
+
+            /// \brief Release every cache bound to the current thread.
+            ~ThreadCacheBinding();
+
+            std::vector<Entry> entries_;                                    ///< \brief Caches bound to the current thread, one per allocator.
+        };
+
         /// \brief Initialize the allocator.
         void Initialize(size_t second_level_count);
 
+        /// \brief Get the cache bound to the calling thread.
+        /// \return Returns the cache bound to the calling thread, if any. Returns nullptr otherwise.
+        ThreadCache* FindThreadCache();
+
+        /// \brief Get the cache bound to the calling thread, binding a new one if none.
+        ThreadCache& GetThreadCache();
+
+        /// \brief Allocate a small block from the cache bound to the calling thread.
+        /// \param size_class Size class of the block to allocate.
+        void* AllocateCached(size_t size_class);
+
+        /// \brief Free a small block allocated by any per-thread cache.
+        /// \param block Pointer to the block to free.
+        /// \param owner Cache the block was allocated from.
+        /// \param size_class Size class of the block.
+        void FreeCached(void* block, ThreadCache& owner, size_t size_class);
+
+        /// \brief Move a batch of new blocks from the shared allocator to a per-thread cache.
+        void RefillThreadCache(ThreadCache& cache, size_t size_class);
+
+        /// \brief Move free blocks of a size class from a per-thread cache to the shared allocator.
+        /// \param count Maximum number of blocks to move.
+        void DrainThreadCache(ThreadCache& cache, size_t size_class, size_t count);
+
+        /// \brief Return a free block of a per-thread cache to the shared allocator.
+        /// This method must be called while holding the allocator lock.
+        void ReturnCachedBlock(CachedBlock* block);
+
+        /// \brief Move every block freed by other threads to the free lists of a per-thread cache.
+        /// This method can only be called by the thread the cache is bound to.
+        void CollectRemoteBlocks(ThreadCache& cache);
+
+        /// \brief Return every block in a per-thread cache to the shared allocator and make the cache available to other threads.
+        /// Blocks of the cache freed while it is not bound to any thread are returned to the shared allocator directly.
+        void ReleaseThreadCache(ThreadCache& cache);
+
+        /// \brief Push a free block on the proper free list of a per-thread cache.
+        /// This method can only be called by the thread the cache is bound to.
+        static void PushCachedBlock(ThreadCache& cache, void* block, size_t size_class);
+
+        /// \brief Get the owner word of a block allocated by a per-thread cache.
+        /// \param block Pointer to the block, as returned to the user.
+        static uintptr_t& GetCachedBlockOwner(void* block);
+
         /// \brief Get a pointer to the smallest free block that can fit an allocation of a given size.
+        /// This method must be called while holding the allocator lock.
         /// \param block_size Size of the block to fit.
         /// \return Returns a pointer to the smallest free block that can fit an allocation of size size.
         BlockHeader* GetFreeBlockBySize(Bytes size);
@@ -193,6 +307,18 @@ namespace syntropy
         /// \return Returns the index of the free list associated with the given first-level and second-level index.
         size_t GetFreeListIndex(size_t first_level_index, size_t second_level_index) const;
         
+        static thread_local ThreadCacheBinding thread_binding_;  ///< \brief Per-thread caches bound to the current thread.
+
+        static std::atomic<uint64_t> next_allocator_id_;    ///< \brief Next unique id for an allocator. Ids are never recycled, unlike addresses.
+
+        uint64_t id_;                                       ///< \brief Unique id of the allocator.
+
+        VirtualMemoryBuffer memory_buffer_;                 ///< \brief Virtual memory reserved by the allocator, if no memory range was provided.
+
+        MemoryRange memory_range_;                          ///< \brief Memory range managed by the allocator.
+
+        MemoryAddress commit_head_;                         ///< \brief Address past the last committed byte in the memory range.
+
         LinearAllocator allocator_;                         ///< \brief Underlying allocator used by this one.
 
         BlockHeader* last_block_;                           ///< \brief Pointer to the block currently on the head of the pool.
@@ -207,7 +333,11 @@ namespace syntropy
 
         std::vector<FreeBlockHeader*> free_lists_;          ///< \brief Pointer to the free lists. Flattened to a mono-dimensional array.
 
-        std::mutex mutex_;                                  ///< \brief Used for thread-safety purposes.
+        std::mutex mutex_;                                  ///< \brief Used for thread-safety purposes. Guards the shared allocator and the list of per-thread caches.
+
+        std::vector<std::shared_ptr<ThreadCache>> thread_caches_list_;      ///< \brief Per-thread caches ever bound. Caches are never destroyed before the allocator, since other threads may free blocks into them.
+
+        std::vector<ThreadCache*> free_thread_caches_;      ///< \brief Per-thread caches released by threads that exited.
     };
 
 }
@@ -0,0 +1,392 @@
+
+/// \file slab_allocator.h
+/// \brief This header is part of the syntropy memory management system. It contains fixed-size allocators whose blocks are packed inside slabs.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/alignment.h"
+#include "syntropy/memory/memory_address.h"
+#include "syntropy/memory/memory_range.h"
+
+#include "syntropy/math/math.h"
+
+#include "syntropy/platform/builtin.h"
+
+#include "syntropy/diagnostics/assert.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* SLAB ALLOCATOR                                                       */
+    /************************************************************************/
+
+    /// \brief Allocator used to allocate fixed-sized memory blocks packed inside slabs.
+    /// Each slab is allocated from the underlying allocator and starts with a header containing a bitmap of its free slots: free blocks are never accessed, hence
+    /// allocations don't chase pointers scattered across the slabs and the lowest free slot is always recycled first, keeping live blocks dense.
+    /// Slabs are returned to the underlying allocator as soon as they become empty, except for the last available one.
+    /// Slabs are aligned to their own size, which must be a power of two not greater than the maximum alignment supported by the underlying allocator (such as a memory page for syntropy::PageAllocator).
+    /// \tparam TAllocator Type of the underlying allocator.
+    /// \author Raffaele D. Facendola - 2018
+    template <typename TAllocator>
+    class SlabAllocator
+    {
+    public:
+
+        /// \brief Create a new allocator.
+        /// \param slab_size Size of each slab.
+        /// \param max_size Maximum size for each allocation.
+        /// \param max_alignment Maximum alignment for each allocation.
+        /// \param Arguments used to construct the underlying allocator.
+        template <typename... TArguments>
+        SlabAllocator(Bytes slab_size, Bytes max_size, Alignment max_alignment, TArguments&&... arguments) noexcept;
+
+        /// \brief No copy constructor.
+        SlabAllocator(const SlabAllocator&) = delete;
+
+        /// \brief Move constructor.
+        SlabAllocator(SlabAllocator&& rhs) noexcept;
+
+        /// \brief Default destructor.
+        ~SlabAllocator() = default;
+
+        /// \brief Unified assignment operator.
+        SlabAllocator& operator=(SlabAllocator rhs) noexcept;
+
+        /// \brief Allocate a new memory block.
+        /// \param size Size of the memory block to allocate.
+        /// \return Returns a range representing the requested memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size) noexcept;
+
+        /// \brief Allocate a new aligned memory block.
+        /// \param size Size of the memory block to allocate.
+        /// \param alignment Block alignment.
+        /// \return Returns a range representing the requested aligned memory block. If no allocation could be performed returns an empty range.
+        MemoryRange Allocate(Bytes size, Alignment alignment) noexcept;
+
+        /// \brief Deallocate a memory block.
+        /// \param block Block to deallocate.
+        /// \remarks The behavior of this function is undefined unless the provided block was returned by a previous call to ::Allocate(size).
+        void Deallocate(const MemoryRange& block);
+
+        /// \brief Deallocate an aligned memory block.
+        /// \param block Block to deallocate. Must refer to any allocation performed via Allocate(size, alignment).
+        /// \param alignment Block alignment.
+        /// \remarks The behavior of this function is undefined unless the provided block was returned by a previous call to ::Allocate(size, alignment).
+        void Deallocate(const MemoryRange& block, Alignment alignment);
+
+        /// \brief Check whether this allocator owns the provided memory block.
+        /// \param block Block to check the ownership of.
+        /// \return Returns true if the provided memory range was allocated by this allocator, returns false otherwise.
+        bool Owns(const MemoryRange& block) const noexcept;
+
+        /// \brief Get the maximum allocation size that can be handled by this allocator.
+        /// The returned value shall not be used to determine whether a call to "Allocate" will fail.
+        /// \return Returns the maximum allocation size that can be handled by this allocator.
+        Bytes GetMaxAllocationSize() const noexcept;
+
+        /// \brief Swap this allocator with the provided instance.
+        void Swap(SlabAllocator& rhs) noexcept;
+
+    private:
+
+        /// \brief Header of a slab. The header is followed by the bitmap of the free slots in the slab, where each set bit marks a free slot.
+        struct Slab
+        {
+            Slab* previous_{ nullptr };                 ///< \brief Previous slab with at least one free slot.
+
+            Slab* next_{ nullptr };                     ///< \brief Next slab with at least one free slot.
+
+            std::size_t free_count_{ 0u };              ///< \brief Number of free slots in the slab.
+        };
+
+        /// \brief Number of slots tracked by each word of a slab bitmap.
+        static constexpr std::size_t kSlotsPerWord = sizeof(uint64_t) * 8u;
+
+        /// \brief Get the bitmap of the free slots in a slab.
+        static uint64_t* GetFreeSlots(Slab* slab) noexcept;
+
+        /// \brief Allocate a new slab from the underlying allocator and link it to the available slabs.
+        /// \return Returns the new slab. If the underlying allocator is exhausted returns nullptr.
+        Slab* AllocateSlab() noexcept;
+
+        /// \brief Unlink a slab from the available slabs.
+        void Unlink(Slab* slab) noexcept;
+
+        TAllocator allocator_;              ///< \brief Allocator the slabs are allocated from.
+
+        Bytes slab_size_;                   ///< \brief Size of each slab.
+
+        Bytes max_size_;                    ///< \brief Maximum size for each allocated block.
+
+        Alignment max_alignment_;           ///< \brief Maximum alignment for each allocated block.
+
+        Bytes stride_;                      ///< \brief Distance between two consecutive slots in a slab.
+
+        Bytes slots_offset_;                ///< \brief Offset of the first slot from the beginning of a slab, past the slab header and bitmap.
+
+        std::size_t slot_count_{ 0u };      ///< \brief Number of slots in each slab.
+
+        Slab* available_{ nullptr };        ///< \brief Slabs with at least one free slot. Blocks are allocated from the first slab.
+    };
+
+}
+
+/// \brief Swaps two syntropy::SlabAllocator<> instances.
+template <typename TAllocator>
+void swap(syntropy::SlabAllocator<TAllocator>& lhs, syntropy::SlabAllocator<TAllocator>& rhs) noexcept;
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    template <typename TAllocator>
+    template <typename... TArguments>
+    inline SlabAllocator<TAllocator>::SlabAllocator(Bytes slab_size, Bytes max_size, Alignment max_alignment, TArguments&&... arguments) noexcept
+        : allocator_(std::forward<TArguments>(arguments)...)
+        , slab_size_(slab_size)
+        , max_size_(max_size)
+        , max_alignment_(max_alignment)
+        , stride_(Ceil(std::size_t(max_size), std::size_t(max_alignment)))
+    {
+        SYNTROPY_ASSERT(IsPow2(std::size_t(slab_size)));
+
+        // The bitmap is sized after the slots that would fit in a slab without the header: a few bits may be left unused.
+
+        auto bitmap_size = DivCeil(slab_size / stride_, kSlotsPerWord) * sizeof(uint64_t);
+
+        slots_offset_ = Bytes(Ceil(sizeof(Slab) + bitmap_size, std::size_t(max_alignment)));
+
+        SYNTROPY_ASSERT(slots_offset_ + stride_ <= slab_size_);
+
+        slot_count_ = (slab_size_ - slots_offset_) / stride_;
+    }
+
+    template <typename TAllocator>
+    inline SlabAllocator<TAllocator>::SlabAllocator(SlabAllocator&& rhs) noexcept
+        : allocator_(std::move(rhs.allocator_))
+        , slab_size_(rhs.slab_size_)
+        , max_size_(rhs.max_size_)
+        , max_alignment_(rhs.max_alignment_)
+        , stride_(rhs.stride_)
+        , slots_offset_(rhs.slots_offset_)
+        , slot_count_(rhs.slot_count_)
+        , available_(rhs.available_)
+    {
+        rhs.available_ = nullptr;
+    }
+
+    template <typename TAllocator>
+    inline SlabAllocator<TAllocator>& SlabAllocator<TAllocator>::operator=(SlabAllocator rhs) noexcept
+    {
+        rhs.Swap(*this);
+        return *this;
+    }
+
+    template <typename TAllocator>
+    inline MemoryRange SlabAllocator<TAllocator>::Allocate(Bytes size) noexcept
+    {
+        if (size > max_size_)
+        {
+            return {};
+        }
+
+        auto slab = available_ ? available_ : AllocateSlab();
+
+        if (!slab)
+        {
+            return {};
+        }
+
+        // Find the lowest free slot: available slabs have at least one.
+
+        auto free_slots = GetFreeSlots(slab);
+
+        auto word = std::size_t(0u);
+
+        for (; free_slots[word] == 0u; ++word);
+
+        auto slot_index = word * kSlotsPerWord + platform::BuiltIn::GetLeastSignificantBit(free_slots[word]);
+
+        free_slots[word] &= (free_slots[word] - 1u);                                            // Clear the lowest bit set.
+
+        if (--slab->free_count_ == 0u)
+        {
+            Unlink(slab);                                                                       // The slab is full.
+        }
+
+        auto block = MemoryAddress(slab) + slots_offset_ + stride_ * slot_index;
+
+        return { block, block + size };
+    }
+
+    template <typename TAllocator>
+    inline MemoryRange SlabAllocator<TAllocator>::Allocate(Bytes size, Alignment alignment) noexcept
+    {
+        if (alignment <= max_alignment_)
+        {
+            return Allocate(size);
+        }
+
+        return {};
+    }
+
+    template <typename TAllocator>
+    inline void SlabAllocator<TAllocator>::Deallocate(const MemoryRange& block)
+    {
+        SYNTROPY_ASSERT(allocator_.Owns(block));
+
+        auto slab_begin = block.Begin().GetAlignedDown(Alignment(slab_size_));
+
+        auto slab = slab_begin.As<Slab>();
+
+        auto slot_index = std::size_t(block.Begin() - (slab_begin + slots_offset_)) / std::size_t(stride_);
+
+        auto& free_slots = GetFreeSlots(slab)[slot_index / kSlotsPerWord];
+
+        auto slot_mask = uint64_t(1u) << (slot_index % kSlotsPerWord);
+
+        SYNTROPY_ASSERT((free_slots & slot_mask) == 0u);                                        // Double free.
+
+        free_slots |= slot_mask;
+
+        if (slab->free_count_++ == 0u)                                                          // The slab was full: make it available again.
+        {
+            slab->previous_ = nullptr;
+            slab->next_ = available_;
+
+            if (available_)
+            {
+                available_->previous_ = slab;
+            }
+
+            available_ = slab;
+        }
+
+        if (slab->free_count_ == slot_count_ && (slab->previous_ || slab->next_))                // Release empty slabs, unless no other slab is available.
+        {
+            Unlink(slab);
+
+            allocator_.Deallocate({ slab_begin, slab_begin + slab_size_ }, Alignment(slab_size_));
+        }
+    }
+
+    template <typename TAllocator>
+    inline void SlabAllocator<TAllocator>::Deallocate(const MemoryRange& block, Alignment alignment)
+    {
+        SYNTROPY_ASSERT(alignment <= max_alignment_);
+
+        Deallocate(block);
+    }
+
+    template <typename TAllocator>
+    inline bool SlabAllocator<TAllocator>::Owns(const MemoryRange& block) const noexcept
+    {
+        return allocator_.Owns(block);
+    }
+
+    template <typename TAllocator>
+    inline Bytes SlabAllocator<TAllocator>::GetMaxAllocationSize() const noexcept
+    {
+        return max_size_;
+    }
+
+    template <typename TAllocator>
+    inline void SlabAllocator<TAllocator>::Swap(SlabAllocator& rhs) noexcept
+    {
+        using std::swap;
+
+        swap(allocator_, rhs.allocator_);
+        swap(slab_size_, rhs.slab_size_);
+        swap(max_size_, rhs.max_size_);
+        swap(max_alignment_, rhs.max_alignment_);
+        swap(stride_, rhs.stride_);
+        swap(slots_offset_, rhs.slots_offset_);
+        swap(slot_count_, rhs.slot_count_);
+        swap(available_, rhs.available_);
+    }
+
+    template <typename TAllocator>
+    inline uint64_t* SlabAllocator<TAllocator>::GetFreeSlots(Slab* slab) noexcept
+    {
+        return (MemoryAddress(slab) + Bytes(sizeof(Slab))).template As<uint64_t>();
+    }
+
+    template <typename TAllocator>
+    inline typename SlabAllocator<TAllocator>::Slab* SlabAllocator<TAllocator>::AllocateSlab() noexcept
+    {
+        auto block = allocator_.Allocate(slab_size_, Alignment(slab_size_));
+
+        if (!block)
+        {
+            return nullptr;
+        }
+
+        SYNTROPY_ASSERT(block.Begin().IsAlignedTo(Alignment(slab_size_)));
+
+        auto slab = block.Begin().template As<Slab>();
+
+        new (slab) Slab();
+
+        slab->free_count_ = slot_count_;
+
+        // Mark each slot as free, leaving the bits past the last slot cleared.
+
+        auto free_slots = GetFreeSlots(slab);
+
+        auto words = DivCeil(slot_count_, kSlotsPerWord);
+
+        std::fill(free_slots, free_slots + words, ~uint64_t(0u));
+
+        if (auto trailing_slots = slot_count_ % kSlotsPerWord)
+        {
+            free_slots[words - 1u] = (uint64_t(1u) << trailing_slots) - 1u;
+        }
+
+        slab->next_ = available_;
+
+        if (available_)
+        {
+            available_->previous_ = slab;
+        }
+
+        available_ = slab;
+
+        return slab;
+    }
+
+    template <typename TAllocator>
+    inline void SlabAllocator<TAllocator>::Unlink(Slab* slab) noexcept
+    {
+        if (slab->previous_)
+        {
+            slab->previous_->next_ = slab->next_;
+        }
+        else
+        {
+            available_ = slab->next_;
+        }
+
+        if (slab->next_)
+        {
+            slab->next_->previous_ = slab->previous_;
+        }
+
+        slab->previous_ = nullptr;
+        slab->next_ = nullptr;
+    }
+
+}
+
+template <typename TAllocator>
+void swap(syntropy::SlabAllocator<TAllocator>& lhs, syntropy::SlabAllocator<TAllocator>& rhs) noexcept
+{
+    lhs.Swap(rhs);
+}
@@ -94,7 +94,7 @@ namespace syntropy
 
     /// \brief User-defined literal used to convert a number to a bit value.
     /// \param number Number to convert.
-    constexpr Bit operator "" _Bit(std::size_t lhs);
+    constexpr Bit operator "" _Bit(unsigned long long lhs);
 
     /// \brief Template specialization for Bit.
     template <>
@@ -221,7 +221,7 @@ namespace syntropy
         return Bit(lhs) ^= rhs;
     }
 
-    constexpr Bit operator "" _Bit(std::size_t lhs)
+    constexpr Bit operator "" _Bit(unsigned long long lhs)
     {
         return Bit(lhs);
     }
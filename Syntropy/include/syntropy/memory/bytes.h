@@ -192,23 +192,23 @@ namespace syntropy
     /// \brief User-defined literal used to convert a number from Bytes to Bytes.
     /// This method is only used for clarity: Foo(78_Bytes) is better than Foo(78).
     /// \param number Number to convert.
-    constexpr Bytes operator "" _Bytes(std::size_t lhs);
+    constexpr Bytes operator "" _Bytes(unsigned long long lhs);
 
     /// \brief User-defined literal used to convert a number from KibiBytes to Bytes.
     /// \param number Number to convert.
-    constexpr Bytes operator "" _KiBytes(std::size_t lhs);
+    constexpr Bytes operator "" _KiBytes(unsigned long long lhs);
 
     /// \brief User-defined literal used to convert a number from MebiBytes to Bytes.
     /// \param number Number to convert.
-    constexpr Bytes operator "" _MiBytes(std::size_t lhs);
+    constexpr Bytes operator "" _MiBytes(unsigned long long lhs);
 
     /// \brief User-defined literal used to convert a number from GibiBytes to Bytes.
     /// \param number Number to convert.
-    constexpr Bytes operator "" _GiBytes(std::size_t lhs);
+    constexpr Bytes operator "" _GiBytes(unsigned long long lhs);
 
     /// \brief User-defined literal used to convert a number from TebiBytes to Bytes.
     /// \param number Number to convert.
-    constexpr Bytes operator "" _TiBytes(std::size_t lhs);
+    constexpr Bytes operator "" _TiBytes(unsigned long long lhs);
 
     /// \brief Get the size of rhs, in bytes.
     template <typename TType>
@@ -384,7 +384,7 @@ namespace syntropy
 
     /// \brief User-defined literal used to convert a number to Bits.
     /// \param number Number to convert.
-    constexpr Bits operator "" _Bits(std::size_t lhs);
+    constexpr Bits operator "" _Bits(unsigned long long lhs);
 
     /// \brief Get the number of bytes in an amount of bits, rounded up.
     /// \param rhs Amount of bits to convert.
@@ -588,27 +588,27 @@ namespace syntropy
         return lhs << std::size_t(rhs);
     }
 
-    constexpr Bytes operator "" _Bytes(std::size_t lhs)
+    constexpr Bytes operator "" _Bytes(unsigned long long lhs)
     {
         return Bytes(lhs * Bytes::kByte);
     }
 
-    constexpr Bytes operator "" _KiBytes(std::size_t lhs)
+    constexpr Bytes operator "" _KiBytes(unsigned long long lhs)
     {
         return Bytes(lhs * Bytes::kKibiByte);
     }
 
-    constexpr Bytes operator "" _MiBytes(std::size_t lhs)
+    constexpr Bytes operator "" _MiBytes(unsigned long long lhs)
     {
         return Bytes(lhs * Bytes::kMebiByte);
     }
 
-    constexpr Bytes operator "" _GiBytes(std::size_t lhs)
+    constexpr Bytes operator "" _GiBytes(unsigned long long lhs)
     {
         return Bytes(lhs * Bytes::kGibiByte);
     }
 
-    constexpr Bytes operator "" _TiBytes(std::size_t lhs)
+    constexpr Bytes operator "" _TiBytes(unsigned long long lhs)
     {
         return Bytes(lhs * Bytes::kTebiByte);
     }
@@ -811,7 +811,7 @@ namespace syntropy
         return lhs << std::size_t(rhs);
     }
 
-    constexpr Bits operator "" _Bits(std::size_t lhs)
+    constexpr Bits operator "" _Bits(unsigned long long lhs)
     {
         return Bits(lhs);
     }
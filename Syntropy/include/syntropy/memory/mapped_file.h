@@ -0,0 +1,230 @@
+
+/// \file mapped_file.h
+/// \brief This header is part of the syntropy memory management system. It contains classes and functionalities used to access files as memory ranges.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <utility>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/memory_range.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* MAPPED FILE MODE                                                     */
+    /************************************************************************/
+
+    /// \brief Access rights granted on the memory a file is mapped to.
+    enum class MappedFileMode : uint8_t
+    {
+        kReadOnly,          ///< \brief The memory can only be read. Writing to it is an access violation.
+        kCopyOnWrite        ///< \brief The memory can be read and written. Written pages are copied privately and never reach the file.
+    };
+
+    /************************************************************************/
+    /* MAPPED FILE ACCESS                                                   */
+    /************************************************************************/
+
+    /// \brief Expected access pattern for the memory a file is mapped to. Used by the system to tune read-ahead.
+    enum class MappedFileAccess : uint8_t
+    {
+        kNormal,            ///< \brief No particular access pattern.
+        kSequential,        ///< \brief Pages are accessed in increasing order: pages are read ahead aggressively and may be discarded soon after being accessed.
+        kRandom             ///< \brief Pages are accessed in random order: read-ahead is disabled.
+    };
+
+    /************************************************************************/
+    /* MAPPED FILE                                                          */
+    /************************************************************************/
+
+    /// \brief Wraps the low-level calls used to map files to memory.
+    /// Pages of a mapped file are read from the file upon first access, hence large read-mostly files can be accessed in place without being loaded upfront.
+    /// \author Raffaele D. Facendola - 2018
+    class MappedFile
+    {
+    public:
+
+        /// \brief Map a whole file to memory.
+        /// \param path Path of the file to map.
+        /// \param mode Access rights granted on the mapped memory.
+        /// \return Returns the memory range the file was mapped to, whose size is equal to the file size. If the method fails or the file is empty returns an empty range.
+        static MemoryRange Map(const std::string& path, MappedFileMode mode);
+
+        /// \brief Unmap a file from memory.
+        /// \param memory_range Memory range to unmap. Must match any return value of a previous Map(), otherwise the behaviour is unspecified.
+        /// \return Returns true if the range could be unmapped, returns false otherwise.
+        static bool Unmap(const MemoryRange& memory_range);
+
+        /// \brief Start reading the pages containing at least one byte in a mapped memory range, without waiting for them.
+        /// \param memory_range Memory range to read.
+        /// \return Returns true if the request was issued, returns false otherwise.
+        static bool Prefetch(const MemoryRange& memory_range);
+
+        /// \brief Declare the expected access pattern for a mapped memory range.
+        /// Some systems ignore the hint.
+        /// \param memory_range Memory range the hint refers to.
+        /// \param access Expected access pattern.
+        /// \return Returns true if the hint was accepted, returns false otherwise.
+        static bool Advise(const MemoryRange& memory_range, MappedFileAccess access);
+
+        /// \brief Get the amount of memory in a mapped memory range that is resident in physical memory, that is the amount of memory that can be accessed without reading the file.
+        /// \param memory_range Memory range to query.
+        /// \return Returns the amount of memory in the provided range that is currently resident, in bytes. Partially-covered pages are accounted for entirely.
+        static Bytes GetResidentSize(const MemoryRange& memory_range);
+
+    };
+
+    /************************************************************************/
+    /* MAPPED MEMORY BUFFER                                                 */
+    /************************************************************************/
+
+    /// \brief Represents a file mapped to memory during construction and unmapped upon destruction via RAII paradigm.
+    /// Since the buffer exposes a plain memory range, allocators such as syntropy::LinearAllocator can operate in place on the file content: copy-on-write buffers can be modified without affecting the file.
+    /// \author Raffaele D. Facendola - 2018
+    class MappedMemoryBuffer
+    {
+    public:
+
+        /// \brief Create a new empty buffer.
+        MappedMemoryBuffer() = default;
+
+        /// \brief Map a file to memory.
+        /// \param path Path of the file to map.
+        /// \param mode Access rights granted on the mapped memory.
+        MappedMemoryBuffer(const std::string& path, MappedFileMode mode = MappedFileMode::kReadOnly);
+
+        /// \brief No copy constructor.
+        MappedMemoryBuffer(const MappedMemoryBuffer&) = delete;
+
+        /// \brief Move constructor.
+        MappedMemoryBuffer(MappedMemoryBuffer&& rhs) noexcept;
+
+        /// \brief Destructor.
+        /// Unmaps the file.
+        ~MappedMemoryBuffer();
+
+        /// \brief Unified assignment operator.
+        MappedMemoryBuffer& operator=(MappedMemoryBuffer rhs) noexcept;
+
+        /// \brief Check whether the file was mapped successfully.
+        /// \return Returns true if the buffer refers to a mapped file, returns false otherwise.
+        operator bool() const noexcept;
+
+        /// \brief Get the underlying memory range.
+        operator MemoryRange() const noexcept;
+
+        /// \brief Get the size of the buffer, that is the size of the file, in bytes.
+        /// \return Returns the size of the buffer, in bytes.
+        Bytes GetSize() const noexcept;
+
+        /// \brief Get the access rights granted on the buffer.
+        MappedFileMode GetMode() const noexcept;
+
+        /// \brief Start reading the whole file, without waiting for it.
+        /// \return Returns true if the request was issued, returns false otherwise.
+        bool Prefetch() const;
+
+        /// \brief Declare the expected access pattern for the buffer.
+        /// \return Returns true if the hint was accepted, returns false otherwise.
+        bool Advise(MappedFileAccess access) const;
+
+        /// \brief Get the amount of memory in the buffer that is resident in physical memory.
+        /// \return Returns the amount of memory in the buffer that is currently resident, in bytes.
+        Bytes GetResidentSize() const;
+
+        /// \brief Swap the content of this buffer with another one.
+        void Swap(MappedMemoryBuffer& rhs) noexcept;
+
+    private:
+
+        MemoryRange memory_range_;                              ///< \brief Memory range the file is mapped to.
+
+        MappedFileMode mode_{ MappedFileMode::kReadOnly };      ///< \brief Access rights granted on the buffer.
+
+    };
+
+}
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // MappedMemoryBuffer.
+
+    inline MappedMemoryBuffer::MappedMemoryBuffer(const std::string& path, MappedFileMode mode)
+        : memory_range_(MappedFile::Map(path, mode))
+        , mode_(mode)
+    {
+
+    }
+
+    inline MappedMemoryBuffer::MappedMemoryBuffer(MappedMemoryBuffer&& rhs) noexcept
+        : memory_range_(rhs.memory_range_)
+        , mode_(rhs.mode_)
+    {
+        rhs.memory_range_ = MemoryRange();
+    }
+
+    inline MappedMemoryBuffer::~MappedMemoryBuffer()
+    {
+        if (memory_range_)
+        {
+            MappedFile::Unmap(memory_range_);
+        }
+    }
+
+    inline MappedMemoryBuffer& MappedMemoryBuffer::operator=(MappedMemoryBuffer rhs) noexcept
+    {
+        rhs.Swap(*this);
+        return *this;
+    }
+
+    inline MappedMemoryBuffer::operator bool() const noexcept
+    {
+        return !!memory_range_;
+    }
+
+    inline MappedMemoryBuffer::operator MemoryRange() const noexcept
+    {
+        return memory_range_;
+    }
+
+    inline Bytes MappedMemoryBuffer::GetSize() const noexcept
+    {
+        return memory_range_.GetSize();
+    }
+
+    inline MappedFileMode MappedMemoryBuffer::GetMode() const noexcept
+    {
+        return mode_;
+    }
+
+    inline bool MappedMemoryBuffer::Prefetch() const
+    {
+        return MappedFile::Prefetch(memory_range_);
+    }
+
+    inline bool MappedMemoryBuffer::Advise(MappedFileAccess access) const
+    {
+        return MappedFile::Advise(memory_range_, access);
+    }
+
+    inline Bytes MappedMemoryBuffer::GetResidentSize() const
+    {
+        return MappedFile::GetResidentSize(memory_range_);
+    }
+
+    inline void MappedMemoryBuffer::Swap(MappedMemoryBuffer& rhs) noexcept
+    {
+        std::swap(memory_range_, rhs.memory_range_);
+        std::swap(mode_, rhs.mode_);
+    }
+
+}
@@ -12,6 +12,7 @@
 #include <type_traits>
 
 #include "syntropy/memory/allocators/allocator.h"
+#include "syntropy/memory/page_map.h"
 
 #include "syntropy/diagnostics/assert.h"
 
@@ -67,11 +68,21 @@ namespace syntropy
         ~MemoryManager() = default;
 
         /// \brief Add an allocator to the memory manager.
-        /// The memory manager takes ownership of the allocator.
+        /// The memory manager takes ownership of the allocator and maps the range it reserved, if any. See Allocator::GetRange().
         /// \return Returns a reference to the allocator.
         template <typename TAllocator>
         TAllocator& AcquireAllocator(std::unique_ptr<TAllocator> allocator);
 
+        /// \brief Map a memory range reserved by an allocator owned by the manager, so that blocks inside it are resolved in constant time. See GetAllocator(void*).
+        /// Allocators reserving memory after being acquired, or reserving more than one range, map each new range via this method.
+        /// \param memory_range Memory range reserved by the allocator.
+        /// \param allocator Allocator the range belongs to. Must be owned by the manager.
+        void MapRange(const MemoryRange& memory_range, Allocator& allocator);
+
+        /// \brief Unmap a memory range previously mapped via MapRange(), before its allocator releases it.
+        /// \param memory_range Memory range to unmap.
+        void UnmapRange(const MemoryRange& memory_range);
+
         /// \brief Set the default allocator.
         /// The default allocator is the allocator that is used when the allocator stack is empty.
         /// \param allocator_name Name of the new default allocator.
@@ -90,6 +101,7 @@ namespace syntropy
         /// \brief Get the allocator owning a memory block.
         /// \return Returns the allocator owning the specified memory block. If no such allocator exists, returns nullptr.
         /// \remarks This method searches only inside the allocators owned by the MemoryManager.
+        /// \remarks Blocks inside the range reserved by an allocator are resolved in constant time, any other block requires a linear search.
         Allocator* GetAllocator(void* block);
 
     private:
@@ -110,6 +122,8 @@ namespace syntropy
 
         std::vector<std::unique_ptr<Allocator>> allocators_;                ///< \brief List of allocators in this manager. The first element is the default allocator.
 
+        PageMap<Allocator> page_map_;                                       ///< \brief Maps the ranges reserved by the allocators in this manager to the allocators themselves.
+
         static thread_local std::vector<Allocator*> allocator_stack_;       ///< \brief Current stack of allocators.
 
     };
@@ -173,7 +187,11 @@ namespace syntropy
 
         allocators_.push_back(std::move(allocator));                    // Acquire allocator's ownership.
 
-        return *static_cast<TAllocator*>(allocators_.back().get());
+        auto& acquired_allocator = *static_cast<TAllocator*>(allocators_.back().get());
+
+        MapRange(acquired_allocator.GetRange(), acquired_allocator);    // Allocators are never released: the mapping lasts until the application is closed.
+
+        return acquired_allocator;
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,289 @@
+
+/// \file memory_profiler.h
+/// \brief This header is part of the syntropy memory management system. It contains classes used to track live memory and allocation rates per allocator and per context.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/allocators/allocator.h"
+
+#include "syntropy/diagnostics/diagnostics.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* ALLOCATION STATISTICS                                                */
+    /************************************************************************/
+
+    /// \brief Statistics about the allocations performed by an allocator or within a context.
+    /// Quantities are signed, so that the difference between two snapshots can be represented as well.
+    /// \author Raffaele D. Facendola - 2018
+    struct AllocationStatistics
+    {
+        /// \brief Number of entries in the size histogram.
+        /// Entry 0 counts empty allocations, entry i counts allocations whose size is in the range [2^(i-1), 2^i). The last entry counts any bigger allocation as well.
+        static constexpr std::size_t kHistogramSize = 40;
+
+        std::int64_t live_bytes_{ 0 };                              ///< \brief Bytes currently allocated.
+
+        std::int64_t peak_live_bytes_{ 0 };                         ///< \brief Highest amount of bytes allocated at any given time. Not affected by differences between snapshots.
+
+        std::int64_t live_count_{ 0 };                              ///< \brief Number of blocks currently allocated.
+
+        std::int64_t allocated_bytes_{ 0 };                         ///< \brief Total amount of bytes allocated.
+
+        std::int64_t allocation_count_{ 0 };                        ///< \brief Total number of allocations.
+
+        std::int64_t deallocation_count_{ 0 };                      ///< \brief Total number of deallocations.
+
+        std::array<std::int64_t, kHistogramSize> size_histogram_{};        ///< \brief Number of allocations, by size. See kHistogramSize.
+    };
+
+    /************************************************************************/
+    /* CALL SITE STATISTICS                                                 */
+    /************************************************************************/
+
+    /// \brief Statistics about the sampled allocations performed by a line of code.
+    /// Each sample stands for all the bytes allocated since the previous one, hence estimates are unbiased regardless of the allocation size.
+    /// \author Raffaele D. Facendola - 2018
+    struct CallSiteStatistics
+    {
+        diagnostics::StackTraceElement call_site_;                  ///< \brief Line of code performing the allocations.
+
+        std::int64_t sample_count_{ 0 };                            ///< \brief Number of sampled allocations.
+
+        std::int64_t estimated_bytes_{ 0 };                         ///< \brief Estimated amount of bytes allocated.
+
+        std::int64_t live_sample_count_{ 0 };                       ///< \brief Number of sampled allocations that were not deallocated yet.
+
+        std::int64_t estimated_live_bytes_{ 0 };                    ///< \brief Estimated amount of bytes allocated and not deallocated yet. Sites with a growing value are leak candidates.
+    };
+
+    /************************************************************************/
+    /* MEMORY SNAPSHOT                                                      */
+    /************************************************************************/
+
+    /// \brief Statistics collected by syntropy::MemoryProfiler at a given time.
+    /// \author Raffaele D. Facendola - 2018
+    struct MemorySnapshot
+    {
+        /// \brief Get the difference between this snapshot and a previous one.
+        /// \param baseline Snapshot taken before this one.
+        /// \return Returns a snapshot whose statistics refer to the allocations performed between the two snapshots.
+        MemorySnapshot Diff(const MemorySnapshot& baseline) const;
+
+        std::chrono::nanoseconds duration_{ 0 };                    ///< \brief Time the statistics were collected over: the time since the profiler was enabled or, for differences, the time between the two snapshots.
+
+        std::map<std::string, AllocationStatistics> allocators_;    ///< \brief Statistics by allocator name. Anonymous allocators are gathered under an empty name.
+
+        std::map<std::string, AllocationStatistics> contexts_;      ///< \brief Statistics by allocator context. Each context includes the statistics of its sub-contexts.
+
+        std::vector<CallSiteStatistics> call_sites_;                ///< \brief Statistics by sampled call site, sorted by estimated allocated bytes, from the highest.
+    };
+
+    /************************************************************************/
+    /* MEMORY PROFILER                                                      */
+    /************************************************************************/
+
+    /// \brief Opt-in tracking layer for the allocations performed via SYNTROPY_NEW, SYNTROPY_ALLOC and their deallocation counterparts.
+    /// Each allocation updates the statistics of its allocator and of the allocator context along with any of its ancestors.
+    /// Call sites are sampled about once every few bytes (exponentially distributed), so that allocation hotspots and leaks can be tracked with a bounded overhead.
+    /// When disabled, the only overhead is a relaxed atomic load per allocation and per deallocation.
+    /// When enabled, live blocks are tracked by a preallocated lock-free table: allocations and deallocations take no lock unless the table is crowded.
+    /// Blocks allocated while the profiler is disabled are not tracked. Blocks allocated while the profiler is enabled are tracked until deallocated, even after the profiler is disabled, so that recycled addresses are never attributed to stale blocks.
+    /// \author Raffaele D. Facendola - 2018
+    class MemoryProfiler
+    {
+    public:
+
+        /// \brief Default mean amount of bytes allocated between two sampled call sites.
+        static constexpr Bytes kDefaultSamplingInterval = Bytes(512u * 1024u);
+
+        /// \brief Get the singleton instance.
+        /// \return Returns the singleton instance.
+        static MemoryProfiler& GetInstance();
+
+        /// \brief Check whether the profiler is tracking new allocations.
+        static bool IsEnabled() noexcept;
+
+        /// \brief Track a new allocation if the profiler is enabled.
+        /// This is the hook called by allocations performed via SYNTROPY_NEW and SYNTROPY_ALLOC.
+        /// \param allocator Allocator the block was allocated from.
+        /// \param block Allocated block. nullptr if the allocation failed.
+        /// \param size Size of the block.
+        /// \param stack_trace Stack trace of the code performing the allocation.
+        static void TrackAllocation(Allocator& allocator, void* block, Bytes size, const diagnostics::StackTrace& stack_trace);
+
+        /// \brief Track a deallocation if the block may be tracked, that is if any tracked block is still live.
+        /// This is the hook called by deallocations performed via SYNTROPY_DELETE and SYNTROPY_FREE, before the block is returned to its allocator.
+        /// \param block Block being deallocated.
+        static void TrackDeallocation(void* block);
+
+        /// \brief No copy constructor.
+        MemoryProfiler(const MemoryProfiler&) = delete;
+
+        /// \brief No assignment operator.
+        MemoryProfiler& operator=(const MemoryProfiler&) = delete;
+
+        /// \brief Default destructor.
+        ~MemoryProfiler() = default;
+
+        /// \brief Start tracking new allocations.
+        /// \param sampling_interval Mean amount of bytes allocated between two sampled call sites. Zero samples every allocation.
+        void Enable(Bytes sampling_interval = kDefaultSamplingInterval);
+
+        /// \brief Stop tracking new allocations.
+        void Disable();
+
+        /// \brief Discard every statistics and live block collected so far.
+        /// \remarks This method must not be called while allocations are being tracked by other threads.
+        void Reset();
+
+        /// \brief Get the statistics collected so far.
+        MemorySnapshot GetSnapshot() const;
+
+        /// \brief Track a new allocation.
+        /// \param allocator Allocator the block was allocated from.
+        /// \param block Allocated block. nullptr if the allocation failed.
+        /// \param size Size of the block.
+        /// \param stack_trace Stack trace of the code performing the allocation.
+        void OnAllocate(Allocator& allocator, void* block, Bytes size, const diagnostics::StackTrace& stack_trace);
+
+        /// \brief Track a deallocation. Must be called before the block is returned to the allocator, since it may be recycled by other threads right away.
+        /// \param block Block being deallocated.
+        void OnFree(void* block);
+
+    private:
+
+        friend struct AllocatorProfile;
+
+        /// \brief Statistics updated atomically by the threads performing the allocations.
+        struct Counters;
+
+        /// \brief Statistics about a call site.
+        struct CallSite;
+
+        /// \brief Tracks a block that was allocated and not deallocated yet.
+        struct LiveBlock
+        {
+            std::int64_t size_;                                     ///< \brief Size of the block.
+
+            AllocatorProfile* allocator_;                           ///< \brief Profile of the allocator the block was allocated from.
+
+            CallSite* call_site_;                                   ///< \brief Call site the block was sampled at. nullptr if the block was not sampled.
+
+            std::int64_t weight_;                                   ///< \brief Bytes the sample stands for.
+        };
+
+        /// \brief Entry of the live block table.
+        struct LiveBlockSlot
+        {
+            std::atomic<void*> block_{ nullptr };                   ///< \brief Tracked block. nullptr if the slot was never used, kBusySlot while the slot is being written, kFreeSlot after the block was deallocated.
+
+            LiveBlock live_block_;                                  ///< \brief Tracking data. Published by the release store of block_.
+        };
+
+        /// \brief Number of slots in the live block table. Must be a power of two.
+        static constexpr std::size_t kSlotCount = std::size_t(1) << 17;
+
+        /// \brief Maximum number of slots probed before a block overflows to the locked table.
+        static constexpr std::size_t kMaxProbeCount = 32;
+
+        /// \brief Private constructor.
+        MemoryProfiler();
+
+        /// \brief Get the profile of an allocator, creating it if needed.
+        AllocatorProfile& GetProfile(Allocator& allocator);
+
+        /// \brief Get the statistics of a context, creating them if needed. Must be called with mutex_ held.
+        Counters& GetContextCounters(const std::string& context);
+
+        /// \brief Get a call site, creating it if needed.
+        CallSite& GetCallSite(const diagnostics::StackTrace& stack_trace);
+
+        /// \brief Track a live block.
+        void InsertLiveBlock(void* block, const LiveBlock& live_block);
+
+        /// \brief Stop tracking a live block.
+        /// \return Returns true if the block was tracked, returns false otherwise.
+        bool EraseLiveBlock(void* block, LiveBlock& live_block);
+
+        static std::atomic<bool> enabled_;                          ///< \brief Whether new allocations are tracked.
+
+        static std::atomic<std::size_t> live_count_;                ///< \brief Number of tracked blocks that were not deallocated yet, regardless of whether the profiler is enabled.
+
+        std::atomic<std::int64_t> sampling_interval_{ 0 };          ///< \brief Mean amount of bytes allocated between two sampled call sites.
+
+        std::chrono::steady_clock::time_point start_time_;          ///< \brief Time the profiler was last enabled or reset.
+
+        mutable std::mutex mutex_;                                  ///< \brief Guards profiles, contexts and call sites creation.
+
+        std::vector<std::unique_ptr<AllocatorProfile>> profiles_;   ///< \brief Allocator profiles. Profiles are never destroyed, since allocators reference them.
+
+        std::map<std::string, std::unique_ptr<Counters>> contexts_;     ///< \brief Statistics by context.
+
+        std::map<std::pair<std::string, std::size_t>, std::unique_ptr<CallSite>> call_sites_;      ///< \brief Call sites, by file and line.
+
+        std::unique_ptr<LiveBlockSlot[]> live_blocks_;              ///< \brief Blocks allocated and not deallocated yet: open-addressing table, updated without locks.
+
+        std::mutex overflow_mutex_;                                 ///< \brief Guards overflow_blocks_.
+
+        std::unordered_map<void*, LiveBlock> overflow_blocks_;      ///< \brief Live blocks that could not find a slot in live_blocks_ within kMaxProbeCount probes.
+
+        std::atomic<std::size_t> overflow_count_{ 0 };              ///< \brief Number of blocks in overflow_blocks_. Spares the lock to deallocations when no block overflowed.
+    };
+
+    /// \brief Get a reference to the MemoryProfiler singleton.
+    MemoryProfiler& GetMemoryProfiler();
+
+    /// \brief Export a memory snapshot to JSON file.
+    /// \param snapshot Snapshot to export.
+    /// \param path Path of the file to write.
+    /// \return Returns true if the snapshot could be exported successfully, returns false otherwise.
+    bool ExportMemorySnapshotToJSON(const MemorySnapshot& snapshot, const std::string& path);
+
+}
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // MemoryProfiler.
+
+    inline bool MemoryProfiler::IsEnabled() noexcept
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    inline void MemoryProfiler::TrackAllocation(Allocator& allocator, void* block, Bytes size, const diagnostics::StackTrace& stack_trace)
+    {
+        if (IsEnabled())
+        {
+            GetInstance().OnAllocate(allocator, block, size, stack_trace);
+        }
+    }
+
+    inline void MemoryProfiler::TrackDeallocation(void* block)
+    {
+        if (live_count_.load(std::memory_order_relaxed) > 0)
+        {
+            GetInstance().OnFree(block);                            // Regardless of IsEnabled(): a block allocated before the profiler was disabled must still be erased, or its address would be misattributed once recycled.
+        }
+    }
+
+}
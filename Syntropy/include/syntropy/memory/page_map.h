@@ -0,0 +1,225 @@
+
+/// \file page_map.h
+/// \brief This header is part of the syntropy memory management system. It contains classes used to associate ranges of memory addresses to objects.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/memory_address.h"
+#include "syntropy/memory/memory_range.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* PAGE MAP                                                             */
+    /************************************************************************/
+
+    /// \brief Radix tree associating chunks of the address space to objects, such as the allocator owning them.
+    /// The map has three levels: the root is indexed by the highest bits of an address and leads to interior nodes and leaves indexed by the following bits, hence a lookup costs three dependent loads.
+    /// The root is small and embedded in the map, while nodes are allocated the first time a range touching them is inserted and are never released until the map is destroyed.
+    /// Only chunks entirely covered by a range are mapped: chunks shared by two ranges are left empty.
+    /// Lookups are lock-free and can be performed concurrently with insertions and removals. Insertions and removals must be serialized by the caller.
+    /// \tparam TValue Type of the objects associated to each chunk.
+    /// \author Raffaele D. Facendola - 2018
+    template <typename TValue>
+    class PageMap
+    {
+    public:
+
+        /// \brief Number of bits in an address below the chunk granularity.
+        static constexpr std::size_t kChunkBits = 16;
+
+        /// \brief Number of bits in an address that can be mapped. Addresses past this limit are never mapped.
+        static constexpr std::size_t kAddressBits = 47;
+
+        /// \brief Number of bits used to index a leaf. Each leaf addresses 64 MiB.
+        static constexpr std::size_t kLeafBits = 10;
+
+        /// \brief Number of bits used to index an interior node. Each interior node addresses 64 GiB.
+        static constexpr std::size_t kInteriorBits = 10;
+
+        /// \brief Number of bits used to index the root.
+        static constexpr std::size_t kRootBits = kAddressBits - kChunkBits - kInteriorBits - kLeafBits;
+
+        /// \brief Size of each chunk.
+        static constexpr Bytes kChunkSize = Bytes(std::size_t(1) << kChunkBits);
+
+        /// \brief Create an empty map.
+        PageMap();
+
+        /// \brief No copy constructor.
+        PageMap(const PageMap&) = delete;
+
+        /// \brief No assignment operator.
+        PageMap& operator=(const PageMap&) = delete;
+
+        /// \brief Destroy the map along with its nodes.
+        ~PageMap();
+
+        /// \brief Associate each chunk entirely contained in a memory range to an object.
+        /// \param memory_range Memory range to map.
+        /// \param value Object to associate to the range.
+        void Insert(const MemoryRange& memory_range, TValue* value);
+
+        /// \brief Remove the association of each chunk entirely contained in a memory range.
+        /// \param memory_range Memory range to unmap.
+        void Erase(const MemoryRange& memory_range);
+
+        /// \brief Get the object associated to the chunk containing an address.
+        /// \param address Address to look up.
+        /// \return Returns the object associated to the chunk containing the provided address. Returns nullptr if no object is associated to it.
+        TValue* Get(MemoryAddress address) const;
+
+    private:
+
+        /// \brief Number of entries in the root.
+        static constexpr std::size_t kRootSize = std::size_t(1) << kRootBits;
+
+        /// \brief Number of entries in each interior node.
+        static constexpr std::size_t kInteriorSize = std::size_t(1) << kInteriorBits;
+
+        /// \brief Number of entries in each leaf.
+        static constexpr std::size_t kLeafSize = std::size_t(1) << kLeafBits;
+
+        /// \brief Number of chunks addressed by an interior node.
+        static constexpr std::size_t kInteriorSpan = kInteriorSize * kLeafSize;
+
+        /// \brief Objects associated to the chunks addressed by a leaf.
+        struct Leaf
+        {
+            std::atomic<TValue*> values_[kLeafSize];                    ///< \brief Object associated to each chunk.
+        };
+
+        /// \brief Leaves addressed by an interior node.
+        struct Interior
+        {
+            std::atomic<Leaf*> leaves_[kInteriorSize];                  ///< \brief Leaves, by the middle bits of the chunks they address.
+        };
+
+        /// \brief Set the object associated to each chunk entirely contained in a memory range.
+        void Assign(const MemoryRange& memory_range, TValue* value);
+
+        std::atomic<Interior*> root_[kRootSize];                        ///< \brief Interior nodes, by the highest bits of the chunks they address.
+    };
+
+}
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* IMPLEMENTATION                                                       */
+    /************************************************************************/
+
+    // PageMap<TValue>.
+
+    template <typename TValue>
+    inline PageMap<TValue>::PageMap()
+    {
+        for (auto&& root_entry : root_)
+        {
+            root_entry.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename TValue>
+    inline PageMap<TValue>::~PageMap()
+    {
+        for (auto&& root_entry : root_)
+        {
+            if (auto interior = root_entry.load(std::memory_order_relaxed))
+            {
+                for (auto&& leaf : interior->leaves_)
+                {
+                    delete leaf.load(std::memory_order_relaxed);
+                }
+
+                delete interior;
+            }
+        }
+    }
+
+    template <typename TValue>
+    inline void PageMap<TValue>::Insert(const MemoryRange& memory_range, TValue* value)
+    {
+        Assign(memory_range, value);
+    }
+
+    template <typename TValue>
+    inline void PageMap<TValue>::Erase(const MemoryRange& memory_range)
+    {
+        Assign(memory_range, nullptr);
+    }
+
+    template <typename TValue>
+    inline TValue* PageMap<TValue>::Get(MemoryAddress address) const
+    {
+        auto chunk = uintptr_t(address) >> kChunkBits;
+
+        if ((chunk / kInteriorSpan) >= kRootSize)
+        {
+            return nullptr;                                                                 // Past the mapped address space.
+        }
+
+        auto interior = root_[chunk / kInteriorSpan].load(std::memory_order_acquire);
+
+        auto leaf = interior ? interior->leaves_[(chunk / kLeafSize) % kInteriorSize].load(std::memory_order_acquire) : nullptr;
+
+        return leaf ? leaf->values_[chunk % kLeafSize].load(std::memory_order_acquire) : nullptr;
+    }
+
+    template <typename TValue>
+    inline void PageMap<TValue>::Assign(const MemoryRange& memory_range, TValue* value)
+    {
+        // Chunks partially covered by the range may be shared with other ranges: leave them alone.
+
+        auto first_chunk = (uintptr_t(memory_range.Begin()) + std::size_t(kChunkSize) - 1) >> kChunkBits;
+        auto last_chunk = std::min(uintptr_t(memory_range.End()) >> kChunkBits, uintptr_t(kRootSize * kInteriorSpan));
+
+        for (auto chunk = first_chunk; chunk < last_chunk; ++chunk)
+        {
+            auto& root_entry = root_[chunk / kInteriorSpan];
+
+            auto interior = root_entry.load(std::memory_order_relaxed);
+
+            if (!interior)
+            {
+                if (!value)
+                {
+                    chunk |= (kInteriorSpan - 1);                                           // Nothing to erase in this interior node.
+                    continue;
+                }
+
+                interior = new Interior();
+
+                root_entry.store(interior, std::memory_order_release);                      // Publish the empty node to concurrent lookups.
+            }
+
+            auto& interior_entry = interior->leaves_[(chunk / kLeafSize) % kInteriorSize];
+
+            auto leaf = interior_entry.load(std::memory_order_relaxed);
+
+            if (!leaf)
+            {
+                if (!value)
+                {
+                    chunk |= (kLeafSize - 1);                                               // Nothing to erase in this leaf.
+                    continue;
+                }
+
+                leaf = new Leaf();
+
+                interior_entry.store(leaf, std::memory_order_release);                      // Publish the empty leaf to concurrent lookups.
+            }
+
+            leaf->values_[chunk % kLeafSize].store(value, std::memory_order_release);
+        }
+    }
+
+}
@@ -6,12 +6,39 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "syntropy/memory/bytes.h"
 #include "syntropy/memory/alignment.h"
 #include "syntropy/memory/memory_range.h"
 
 namespace syntropy
 {
+    /************************************************************************/
+    /* VIRTUAL MEMORY PAGE MODE                                             */
+    /************************************************************************/
+
+    /// \brief Size of the pages backing a range of virtual memory addresses.
+    enum class VirtualMemoryPageMode : uint8_t
+    {
+        kRegular,           ///< \brief Regular pages, whose size is VirtualMemory::GetPageSize().
+        kLarge              ///< \brief Large pages, whose size is VirtualMemory::GetLargePageSize(). Fall back to regular pages if the system cannot provide them.
+    };
+
+    /************************************************************************/
+    /* LARGE PAGE COUNTERS                                                  */
+    /************************************************************************/
+
+    /// \brief Counters for the large pages requested by the application.
+    /// Some systems treat large pages as a hint which is honored, if ever, when memory is first touched: a page being accepted doesn't imply it is backed by a large page. See VirtualMemory::GetLargePageResidentSize().
+    /// \author Raffaele D. Facendola - 2018
+    struct LargePageCounters
+    {
+        std::size_t requested_pages_{ 0 };             ///< \brief Number of large pages requested via VirtualMemory::ReserveLarge().
+
+        std::size_t accepted_pages_{ 0 };               ///< \brief Number of large pages whose request the system accepted. The remaining ones fell back to regular pages.
+    };
+
     /************************************************************************/
     /* VIRTUAL MEMORY                                                       */
     /************************************************************************/
@@ -59,6 +86,32 @@ namespace syntropy
          /// \param memory_range Memory range to decommit.
          static bool Decommit(const MemoryRange& memory_range);
 
+         /// \brief Get the large page size.
+         /// \return Returns the large page size, in bytes. Returns 0 if the system doesn't support large pages.
+         static Bytes GetLargePageSize();
+
+         /// \brief Reserve a range of virtual memory addresses backed by large pages, to reduce TLB misses on large ranges.
+         /// If the system cannot provide large pages, the range is backed by regular pages instead.
+         /// Depending on the system, large pages may be committed upon reservation and may not be decommitted. Reserved memory region must be committed via Commit() before accessing it in any case.
+         /// \param size Size of the range to reserve, in bytes. Rounded up to a multiple of the large page size.
+         /// \return Returns the reserved memory range, aligned to the large page size unless it fell back to regular pages. If the method fails returns an empty range.
+         static MemoryRange ReserveLarge(Bytes size);
+
+         /// \brief Reserve a range of virtual memory addresses.
+         /// \param size Size of the range to reserve, in bytes.
+         /// \param page_mode Size of the pages backing the range.
+         /// \return Returns the reserved memory range. If the method fails returns an empty range.
+         static MemoryRange Reserve(Bytes size, VirtualMemoryPageMode page_mode);
+
+         /// \brief Get the amount of memory in a range that is actually backed by large pages.
+         /// Some systems treat large pages as a hint, this method can be used to determine whether the hint was honored.
+         /// \param memory_range Memory range to query.
+         /// \return Returns the amount of memory in the provided range that is currently backed by large pages, in bytes.
+         static Bytes GetLargePageResidentSize(const MemoryRange& memory_range);
+
+         /// \brief Get the counters for the large pages requested so far.
+         static LargePageCounters GetLargePageCounters();
+
     };
 
 }
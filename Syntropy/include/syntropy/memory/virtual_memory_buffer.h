@@ -29,6 +29,11 @@ namespace syntropy
         /// \param size Size of the buffer, in bytes. Must be a multiple of the system virtual page size.
         VirtualMemoryBuffer(Bytes size);
 
+        /// \brief Create a new virtual memory buffer.
+        /// \param size Size of the buffer, in bytes. Must be a multiple of the system virtual page size. Rounded up to a multiple of the large page size if large pages are requested.
+        /// \param page_mode Size of the pages backing the buffer.
+        VirtualMemoryBuffer(Bytes size, VirtualMemoryPageMode page_mode);
+
         /// \brief No copy constructor.
         VirtualMemoryBuffer(const VirtualMemoryBuffer&) = delete;
 
@@ -48,7 +53,7 @@ namespace syntropy
         operator const VirtualMemoryRange&() noexcept;
 
         /// \brief Get the underlying memory range.
-        operator const MemoryRange&() const noexcept;
+        operator MemoryRange() const noexcept;
 
         /// \brief Check whether a memory range is contained entirely inside this buffer.
         /// \param memory_range Memory range to check.
@@ -78,6 +83,12 @@ namespace syntropy
 
     }
 
+    inline VirtualMemoryBuffer::VirtualMemoryBuffer(Bytes size, VirtualMemoryPageMode page_mode)
+        : virtual_memory_range_(VirtualMemory::Reserve(size, page_mode))
+    {
+
+    }
+
     inline VirtualMemoryBuffer::VirtualMemoryBuffer(VirtualMemoryBuffer&& rhs)
         : virtual_memory_range_(rhs.virtual_memory_range_)
     {
@@ -100,7 +111,7 @@ namespace syntropy
         return virtual_memory_range_;
     }
 
-    inline VirtualMemoryBuffer::operator const MemoryRange&() const noexcept
+    inline VirtualMemoryBuffer::operator MemoryRange() const noexcept
     {
         return virtual_memory_range_;
     }
@@ -102,7 +102,7 @@ namespace syntropy
 
     /// \brief Get the difference of two memory pages.
     /// \return Returns a the signed difference between lhs and rhs, in pages.
-    constexpr ptrdiff_t operator-(const VirtualMemoryPage& lhs, const VirtualMemoryPage& rhs) noexcept;
+    ptrdiff_t operator-(const VirtualMemoryPage& lhs, const VirtualMemoryPage& rhs) noexcept;
 
     /************************************************************************/
     /* IMPLEMENTATION                                                       */
@@ -148,7 +148,7 @@ namespace syntropy
 
     constexpr bool operator==(const VirtualMemoryPage& lhs, const VirtualMemoryPage& rhs) noexcept
     {
-        return MemoryRange(lhs) = MemoryRange(rhs);
+        return MemoryRange(lhs) == MemoryRange(rhs);
     }
 
     constexpr bool operator!=(const VirtualMemoryPage& lhs, const VirtualMemoryPage& rhs) noexcept
@@ -186,7 +186,7 @@ namespace syntropy
         return VirtualMemoryPage(lhs) -= rhs;
     }
 
-    constexpr ptrdiff_t operator-(const VirtualMemoryPage& lhs, const VirtualMemoryPage& rhs) noexcept
+    inline ptrdiff_t operator-(const VirtualMemoryPage& lhs, const VirtualMemoryPage& rhs) noexcept
     {
         auto difference = MemoryRange(rhs).Begin() - MemoryRange(lhs).Begin();
 
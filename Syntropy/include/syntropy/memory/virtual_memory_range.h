@@ -38,7 +38,7 @@ namespace syntropy
 
         /// \brief Create a virtual memory range from a memory range.
         /// \param memory_range Memory range, must represent a full range of virtual memory pages.
-        constexpr VirtualMemoryRange(const MemoryRange& memory_range);
+        VirtualMemoryRange(const MemoryRange& memory_range);
 
         /// \brief Default assignment operator.
         constexpr VirtualMemoryRange& operator=(const VirtualMemoryRange&) = default;
@@ -54,7 +54,7 @@ namespace syntropy
         /// \brief Access a page in the range.
         /// \param offset Offset with respect to the first page of the range.
         /// \return Returns the offset-th page after the first one in this range.
-        constexpr const VirtualMemoryPage& operator[](std::size_t offset) const;
+        VirtualMemoryPage operator[](std::size_t offset) const;
 
         /// \brief Advance the virtual memory range forward.
         /// \param rhs Number of pages to move the range forward to.
@@ -76,7 +76,7 @@ namespace syntropy
 
         /// \brief Get the number of pages in this range.
         /// \return Returns the total number of pages in this range.
-        constexpr std::size_t GetSize() const noexcept;
+        std::size_t GetSize() const noexcept;
 
         /// \brief Check whether a memory range is contained entirely inside this range.
         /// \param memory_range Memory range to check.
@@ -126,7 +126,7 @@ namespace syntropy
         SYNTROPY_ASSERT(begin <= end);
     }
 
-    constexpr VirtualMemoryRange::VirtualMemoryRange(const MemoryRange& memory_range)
+    inline VirtualMemoryRange::VirtualMemoryRange(const MemoryRange& memory_range)
         : VirtualMemoryRange(memory_range.Begin(), memory_range.End())
     {
 
@@ -139,10 +139,10 @@ namespace syntropy
 
     constexpr VirtualMemoryRange::operator MemoryRange() const noexcept
     {
-        return MemoryRange(begin_.Begin(), end_.End());
+        return MemoryRange(begin_.Begin(), end_.Begin());
     }
 
-    constexpr const VirtualMemoryPage& VirtualMemoryRange::operator[](std::size_t offset) const
+    inline VirtualMemoryPage VirtualMemoryRange::operator[](std::size_t offset) const
     {
         auto page = begin_ + offset;
 
@@ -175,14 +175,14 @@ namespace syntropy
         return end_;
     }
 
-    constexpr std::size_t VirtualMemoryRange::GetSize() const noexcept
+    inline std::size_t VirtualMemoryRange::GetSize() const noexcept
     {
         return end_ - begin_;
     }
 
     constexpr bool VirtualMemoryRange::Contains(const MemoryRange& memory_range) const noexcept
     {
-        return begin_ <= memory_range.Begin() && memory_range.End() <= end_;
+        return begin_.Begin() <= memory_range.Begin() && memory_range.End() <= end_.Begin();
     }
 
     inline bool VirtualMemoryRange::Commit() const
@@ -63,7 +63,7 @@ namespace syntropy
         template <typename TInterface>
         TInterface* GetInterface()
         {
-            return const_cast<TInterface*>(const_cast<const decltype(this)>(this)->GetInterface<TInterface>());
+            return const_cast<TInterface*>(static_cast<const MultiInterfaceMixin*>(this)->template GetInterface<TInterface>());
         }
 
         /// \brief Get an interface by type.
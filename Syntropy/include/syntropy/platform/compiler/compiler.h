@@ -12,10 +12,14 @@
 
 #define SYNTROPY_COMPILER_INCLUDE_GUARD
 
-#ifdef _MSC_VER
+#if defined(_MSC_VER)
 
 #include "msvc.h"
 
+#elif defined(__GNUC__)
+
+#include "gcc.h"
+
 #endif
 
 #undef SYNTROPY_COMPILER_INCLUDE_GUARD
\ No newline at end of file
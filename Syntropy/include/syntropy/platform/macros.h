@@ -28,6 +28,44 @@
 #define SYNTROPY_TRAP \
     __debugbreak()
 
+/// \brief Hints the processor that the calling thread is busy-waiting.
+#define SYNTROPY_PAUSE \
+    _mm_pause()
+
+// GCC and Clang-specific macros
+
+#elif defined(__GNUC__)
+
+#include <csignal>
+
+/// \brief Expands to the current function name.
+#define SYNTROPY_FUNCTION \
+    __FUNCTION__
+
+/// \brief Causes the debugger to break.
+#define SYNTROPY_TRAP \
+    std::raise(SIGTRAP)
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/// \brief Hints the processor that the calling thread is busy-waiting.
+#define SYNTROPY_PAUSE \
+    __builtin_ia32_pause()
+
+#elif defined(__aarch64__) || defined(__arm__)
+
+/// \brief Hints the processor that the calling thread is busy-waiting.
+#define SYNTROPY_PAUSE \
+    __asm__ __volatile__("yield")
+
+#else
+
+/// \brief Hints the processor that the calling thread is busy-waiting.
+#define SYNTROPY_PAUSE \
+    ((void)0)
+
+#endif
+
 #else
 
 #error "Please define compiler-specific macros!"
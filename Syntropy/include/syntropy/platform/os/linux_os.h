@@ -0,0 +1,226 @@
+
+/// \file linux_os.h
+/// \brief This header is part of the syntropy HAL (hardware abstraction layer) system. It contains Linux-specific functionalities.
+///
+/// Do not include this header directly. Use os.h instead.
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#ifndef SYNTROPY_OS_INCLUDE_GUARD
+#error "You may not include this header directly. Use os.h instead."
+#endif
+
+#ifdef __linux__
+
+#include "syntropy/diagnostics/diagnostics.h"
+
+#include "syntropy/platform/system.h"
+#include "syntropy/platform/threading.h"
+
+#include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/mapped_file.h"
+
+#include <thread>
+#include <string>
+
+namespace syntropy::platform
+{
+    /************************************************************************/
+    /* PLATFORM DEBUGGER                                                    */
+    /************************************************************************/
+
+    /// \brief Exposes debugging functionalities under Linux OS.
+    /// \author Raffaele D. Facendola - 2018
+    class PlatformDebugger
+    {
+    public:
+
+        /// \brief Check whether the debugger is attached.
+        /// Any tracer attached to the process, as reported by /proc/self/status, is considered a debugger.
+        /// \return Returns true if a debugger is attached to the application, returns false otherwise.
+        static bool IsDebuggerAttached();
+
+        /// \brief Get the stack trace of the current thread.
+        /// Function names are resolved from the dynamic symbol table, hence the application should be linked with -rdynamic. Files and lines are not available.
+        /// \param caller Stack trace element representing the code that called this method.
+        /// \return Returns the stack trace whose head is caller.
+        static diagnostics::StackTrace GetStackTrace(diagnostics::StackTraceElement caller);
+    };
+
+    /************************************************************************/
+    /* PLATFORM SYSTEM                                                      */
+    /************************************************************************/
+
+    /// \brief Exposes methods to query system's capabilities under Linux OS.
+    /// \author Raffaele D. Facendola - 2018
+    class PlatformSystem
+    {
+    public:
+
+        /// \brief Get the current CPU infos.
+        /// \return Returns the current CPU infos.
+        static CPUInfo GetCPUInfo();
+
+        /// \brief Get the topology of the logical processors in the system, as exposed by /sys/devices/system/cpu.
+        /// \return Returns the current CPU topology.
+        static CPUTopology GetCPUTopology();
+
+        /// \brief Get the current storage infos.
+        /// \return Returns the current storage infos.
+        static StorageInfo GetStorageInfo();
+
+        /// \brief Get the current memory infos.
+        /// \return Returns the current memory infos.
+        static MemoryInfo GetMemoryInfo();
+
+        /// \brief Get the current desktop infos.
+        /// \return Returns the current desktop infos.
+        static DisplayInfo GetDisplayInfo();
+
+        /// \brief Get the current platform infos.
+        /// \return Returns the current platform infos.
+        static PlatformInfo GetPlatformInfo();
+    };
+
+    /************************************************************************/
+    /* PLATFORM THREADING                                                   */
+    /************************************************************************/
+
+    /// \brief Exposes threading and scheduler's functionalities under Linux OS.
+    /// \author Raffaele D. Facendola - 2018
+    class PlatformThreading
+    {
+    public:
+
+        /// \brief Get the index of the CPU on which the calling thread is running.
+        /// \return Returns the index of the CPU on which the calling thread is running.
+        static size_t GetCPUIndex();
+
+        /// \brief Get the cores the calling process is allowed to run on.
+        /// This method returns the cores a process can specify an affinity for. To get the actual affinity use GetProcessAffinity().
+        /// \return Returns the cores the calling process is allowed to run on.
+        static AffinityMask GetSystemAffinity();
+
+        /// \brief Set the cores the calling process can be run on.
+        /// The affinity is applied to each thread in the process.
+        /// \param affinity_mask New process affinity. Must be a subset of the affinity returned by GetSystemAffinity().
+        /// \return Returns true if the method succeeded, returns false otherwise.
+        static bool SetProcessAffinity(const AffinityMask& affinity_mask);
+
+        /// \brief Get the cores the calling process can be run on.
+        /// \return Returns the cores the calling process can be run on.
+        static AffinityMask GetProcessAffinity();
+
+        /// \brief Set the cores a thread can be run on.
+        /// \param affinity_mask New thread affinity. Must be a subset of the affinity returned by GetProcessAffinity().
+        /// \param thread Thread to change the affinity of. If this parameter is nullptr, the calling thread will be used.
+        /// \return Returns true if the method succeeded, returns false otherwise.
+        static bool SetThreadAffinity(const AffinityMask& affinity_mask, std::thread* thread = nullptr);
+
+        /// \brief Get the cores a thread can be run on.
+        /// \param thread Thread to get the affinity of. If this parameter is nullptr, the calling thread will be used.
+        /// \return Return the cores the specified thread can be run on.
+        static AffinityMask GetThreadAffinity(std::thread* thread = nullptr);
+
+        /// \brief Set the priority of a thread.
+        /// Linux exposes per-thread niceness for the calling thread only: changing the priority of any other thread fails.
+        /// \param priority New priority for the thread.
+        /// \param thread Thread to change the priority of. If this parameter is nullptr, the calling thread will be used.
+        /// \return Returns true if the method succeeded, returns false otherwise.
+        static bool SetThreadPriority(ThreadPriority priority, std::thread* thread = nullptr);
+
+        /// \brief Get the priority of a thread.
+        /// \param thread Thread to get the priority of. If this parameter is nullptr, the calling thread will be used.
+        /// \return Return the priority of the specified thread.
+        static ThreadPriority GetThreadPriority(std::thread* thread = nullptr);
+    };
+
+    /************************************************************************/
+    /* PLATFORM MEMORY                                                      */
+    /************************************************************************/
+
+    /// \brief Wraps the low-level calls used to handle virtual memory allocation under Linux OS.
+    /// Reserved pages are mapped without any access right and without reserving swap space: committing a page grants access to it, while decommitting a page releases its physical storage and revokes the access again.
+    /// \author Raffaele D. Facendola - 2018
+    class PlatformMemory
+    {
+    public:
+
+        /// \brief Get the virtual memory page size.
+        /// \return Returns the virtual memory page size, in bytes.
+        static Bytes GetPageSize();
+
+        /// \brief Get the virtual memory page alignment.
+        /// \return Returns the virtual memory page alignment, in bytes.
+        static Alignment GetPageAlignment();
+
+        /// \brief Reserve a range of virtual memory addresses.
+        /// Reserved memory region must be committed via Commit() before accessing it.
+        /// \param size Size of the range to reserve, in bytes.
+        /// \return Returns the reserved memory range. If the method fails returns an empty range.
+        static MemoryRange Reserve(Bytes size);
+
+        /// \brief Allocate a range of virtual memory addresses.
+        /// This method has the same effect as a Reserve() followed by a Commit().
+        /// \param size Size of the range to reserve, in bytes.
+        /// \return Returns the reserved virtual memory range. If the method fails returns an empty range.
+        static MemoryRange Allocate(Bytes size);
+
+        /// \brief Release a range of virtual memory addresses.
+        /// \param address First address of the range to release. Must match any return value of a previous Reserve() / Allocate(), otherwise the behaviour is unspecified.
+        /// \return Returns true if the range could be released, returns false otherwise.
+        static bool Release(const MemoryRange& memory_range);
+
+        /// \brief Commit a reserved virtual memory block.
+        /// This method makes all the pages containing at least one byte in the provided range accessible by the application. Physical pages are allocated upon first access.
+        /// \param memory_range Memory range to commit.
+        /// \return Returns true if the memory could be committed, returns false otherwise.
+        /// \remarks The provided memory range must refer to a memory region that was previously reserved via Reserve().
+        static bool Commit(const MemoryRange& memory_range);
+
+        /// \brief Decommit a virtual memory block.
+        /// This method decommits all the pages containing at least one byte in the provided range.
+        /// \param memory_range Memory range to decommit.
+        static bool Decommit(const MemoryRange& memory_range);
+
+        /// \brief Get the large page size.
+        /// This is the size of transparent huge pages.
+        /// \return Returns the large page size, in bytes. Returns 0 if transparent huge pages are disabled.
+        static Bytes GetLargePageSize();
+
+        /// \brief Reserve a range of virtual memory addresses backed by large pages.
+        /// The range is advised to be backed by transparent huge pages: the kernel allocates huge pages upon first access whenever possible, hence the range can be committed and decommitted as any other range.
+        /// \param size Size of the range to reserve, in bytes. Must be a multiple of the large page size.
+        /// \return Returns the reserved memory range, aligned to the large page size. If the method fails returns an empty range.
+        static MemoryRange ReserveLarge(Bytes size);
+
+        /// \brief Get the amount of memory in a range that is actually backed by large pages, as reported by /proc/self/smaps.
+        static Bytes GetLargePageResidentSize(const MemoryRange& memory_range);
+
+        /// \brief Map a whole file to memory.
+        /// The file is mapped privately, hence copy-on-write pages never reach the file. The file descriptor is closed right away, since the mapping keeps the file alive.
+        /// \param path Path of the file to map.
+        /// \param mode Access rights granted on the mapped memory.
+        /// \return Returns the memory range the file was mapped to. If the method fails or the file is empty returns an empty range.
+        static MemoryRange MapFile(const std::string& path, MappedFileMode mode);
+
+        /// \brief Unmap a file from memory.
+        /// \param memory_range Memory range returned by a previous call to MapFile().
+        /// \return Returns true if the range could be unmapped, returns false otherwise.
+        static bool UnmapFile(const MemoryRange& memory_range);
+
+        /// \brief Start reading the pages containing at least one byte in a mapped memory range, via MADV_WILLNEED.
+        static bool Prefetch(const MemoryRange& memory_range);
+
+        /// \brief Declare the expected access pattern for a mapped memory range, via madvise.
+        static bool Advise(const MemoryRange& memory_range, MappedFileAccess access);
+
+        /// \brief Get the amount of memory in a range that is resident in physical memory, as reported by mincore.
+        static Bytes GetResidentSize(const MemoryRange& memory_range);
+
+    };
+}
+
+#endif
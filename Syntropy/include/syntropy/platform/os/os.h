@@ -17,4 +17,10 @@
 
 #endif
 
+#ifdef __linux__
+
+#include "syntropy/platform/os/linux_os.h"
+
+#endif
+
 #undef SYNTROPY_OS_INCLUDE_GUARD
\ No newline at end of file
@@ -19,8 +19,10 @@
 #include "syntropy/platform/threading.h"
 
 #include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/mapped_file.h"
 
 #include <thread>
+#include <string>
 
 namespace syntropy::platform
 {
@@ -58,6 +60,10 @@ namespace syntropy::platform
         /// \return Returns the current CPU infos.
         static CPUInfo GetCPUInfo();
 
+        /// \brief Get the topology of the logical processors in the system.
+        /// \return Returns the current CPU topology.
+        static CPUTopology GetCPUTopology();
+
         /// \brief Get the current storage infos.
         /// \return Returns the current storage infos.
         static StorageInfo GetStorageInfo();
@@ -173,6 +179,41 @@ namespace syntropy::platform
         /// \param memory_range Memory range to decommit.
         static bool Decommit(const MemoryRange& memory_range);
 
+        /// \brief Get the large page size.
+        /// \return Returns the large page size, in bytes. Returns 0 if the system doesn't support large pages.
+        static Bytes GetLargePageSize();
+
+        /// \brief Reserve a range of virtual memory addresses backed by large pages.
+        /// Large pages are committed upon reservation and cannot be decommitted. The process must hold the SeLockMemoryPrivilege.
+        /// \param size Size of the range to reserve, in bytes. Must be a multiple of the large page size.
+        /// \return Returns the reserved memory range. If the method fails returns an empty range.
+        static MemoryRange ReserveLarge(Bytes size);
+
+        /// \brief Get the amount of memory in a range that is actually backed by large pages, as reported by the process working set.
+        static Bytes GetLargePageResidentSize(const MemoryRange& memory_range);
+
+        /// \brief Map a whole file to memory.
+        /// The file and the file mapping handles are closed right away, since the view keeps them alive.
+        /// \param path Path of the file to map.
+        /// \param mode Access rights granted on the mapped memory.
+        /// \return Returns the memory range the file was mapped to. If the method fails or the file is empty returns an empty range.
+        static MemoryRange MapFile(const std::string& path, MappedFileMode mode);
+
+        /// \brief Unmap a file from memory.
+        /// \param memory_range Memory range returned by a previous call to MapFile().
+        /// \return Returns true if the range could be unmapped, returns false otherwise.
+        static bool UnmapFile(const MemoryRange& memory_range);
+
+        /// \brief Start reading the pages containing at least one byte in a mapped memory range, via PrefetchVirtualMemory.
+        static bool Prefetch(const MemoryRange& memory_range);
+
+        /// \brief Declare the expected access pattern for a mapped memory range.
+        /// Windows exposes no such hint for mapped views: the method does nothing and returns false.
+        static bool Advise(const MemoryRange& memory_range, MappedFileAccess access);
+
+        /// \brief Get the amount of memory in a range that is resident in physical memory, as reported by the process working set.
+        static Bytes GetResidentSize(const MemoryRange& memory_range);
+
     };
 }
 
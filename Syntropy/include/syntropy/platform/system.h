@@ -8,6 +8,8 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstddef>
 
 namespace syntropy::platform
 {
@@ -31,6 +33,25 @@ namespace syntropy::platform
         CPUArchitecture architecture_;      ///< \brief CPU architecture.
     };
 
+    /// \brief Describes the position of a logical processor within the CPU topology.
+    /// Indices of cores, caches, nodes and packages are dense and unique system-wide.
+    /// \author Raffaele D. Facendola - 2018
+    struct ProcessorInfo
+    {
+        size_t index_;                      ///< \brief Index of the logical processor, as used by AffinityMask.
+        size_t core_;                       ///< \brief Physical core the processor belongs to. Processors sharing the same core are SMT siblings.
+        size_t cache_;                      ///< \brief Last-level cache domain the processor belongs to.
+        size_t node_;                       ///< \brief NUMA node the processor belongs to.
+        size_t package_;                    ///< \brief Physical package (socket) the processor belongs to.
+    };
+
+    /// \brief Describes how logical processors are laid out in cores, caches, NUMA nodes and packages.
+    /// \author Raffaele D. Facendola - 2018
+    struct CPUTopology
+    {
+        std::vector<ProcessorInfo> processors_;     ///< \brief Online logical processors, sorted by index.
+    };
+
     /// \brief Describes a particular drive.
     /// \author Raffaele D. Facendola
     struct DriveInfo 
@@ -82,7 +103,8 @@ namespace syntropy::platform
     /// \author Raffaele D. Facendola
     enum class OperatingSystem 
     {
-        kWindows                                ///< Windows OS
+        kWindows,                               ///< Windows OS
+        kLinux                                  ///< Linux OS
     };
 
     /// \brief Describes the platform capabilities.
@@ -106,6 +128,10 @@ namespace syntropy::platform
         /// \return Returns the current CPU infos.
         static CPUInfo GetCPUInfo();
 
+        /// \brief Get the topology of the logical processors in the system.
+        /// \return Returns the current CPU topology.
+        static CPUTopology GetCPUTopology();
+
         /// \brief Get the current storage infos.
         /// \return Returns the current storage infos.
         static StorageInfo GetStorageInfo();
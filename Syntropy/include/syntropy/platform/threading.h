@@ -7,7 +7,9 @@
 #pragma once
 
 #include <thread>
-#include <bitset>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
 
 namespace syntropy::platform
 {
@@ -25,9 +27,74 @@ namespace syntropy::platform
         kHighest            ///< \brief Highest priority. May interfere with basic OS threads (input, disk, ...).
     };
 
+    /************************************************************************/
+    /* AFFINITY MASK                                                        */
+    /************************************************************************/
+
     /// \brief Type used to specify an affinity mask for both threads and processes.
-    /// Each bit represents the affinity for a particular core.
-    using AffinityMask = std::bitset<64>;
+    /// Each bit represents the affinity for a particular logical processor. The mask grows on demand, hence it can address any number of processors.
+    /// \author Raffaele D. Facendola - 2018
+    class AffinityMask
+    {
+    public:
+
+        /// \brief Number of processors stored in each word of the mask.
+        static constexpr size_t kWordSize = 64;
+
+        /// \brief Create an empty mask.
+        AffinityMask() = default;
+
+        /// \brief Create a mask from the affinity of the first 64 processors.
+        /// \param word Affinity of the first 64 processors, one bit per processor.
+        explicit AffinityMask(uint64_t word);
+
+        /// \brief Set the affinity for a processor.
+        /// \param index Index of the processor.
+        /// \param value Whether the processor is part of the mask.
+        /// \return Returns a reference to this mask.
+        AffinityMask& Set(size_t index, bool value = true);
+
+        /// \brief Check whether a processor is part of the mask.
+        bool Test(size_t index) const;
+
+        /// \brief Get the number of processors in the mask.
+        size_t GetCount() const;
+
+        /// \brief Check whether the mask contains no processor.
+        bool IsEmpty() const;
+
+        /// \brief Get the number of processors the mask can address without growing. Processors whose index is equal or greater are not part of the mask.
+        size_t GetSize() const;
+
+        /// \brief Get the affinity of a group of 64 consecutive processors.
+        /// \param index Index of the group. Processors from index * kWordSize up to (index + 1) * kWordSize, excluded, belong to the group.
+        uint64_t GetWord(size_t index) const;
+
+        /// \brief Set the affinity of a group of 64 consecutive processors. See GetWord().
+        AffinityMask& SetWord(size_t index, uint64_t word);
+
+        /// \brief Intersect this mask with another one.
+        AffinityMask& operator&=(const AffinityMask& rhs);
+
+        /// \brief Merge this mask with another one.
+        AffinityMask& operator|=(const AffinityMask& rhs);
+
+        /// \brief Check whether two masks contain the same processors.
+        bool operator==(const AffinityMask& rhs) const;
+
+        /// \brief Check whether two masks contain different processors.
+        bool operator!=(const AffinityMask& rhs) const;
+
+    private:
+
+        std::vector<uint64_t> words_;                       ///< \brief Affinity bits, kWordSize processors per word.
+    };
+
+    /// \brief Get the intersection of two masks.
+    AffinityMask operator&(AffinityMask lhs, const AffinityMask& rhs);
+
+    /// \brief Get the union of two masks.
+    AffinityMask operator|(AffinityMask lhs, const AffinityMask& rhs);
 
     /************************************************************************/
     /* THREADING                                                            */
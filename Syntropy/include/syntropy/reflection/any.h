@@ -7,6 +7,10 @@
 
 #include <initializer_list>
 #include <typeinfo>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <new>
 
 #include "syntropy/type_traits.h"
 
@@ -14,10 +18,17 @@
 
 #include "syntropy/reflection/type.h"
 
+namespace syntropy
+{
+    class Allocator;
+}
+
 namespace syntropy::reflection
 {
     /// The class any describes a type-safe container for single values of any type.
     /// This class is similar to std::any, but takes advantage of syntropy reflection system to allow polymorphic conversions of values.
+    /// Small values that can be moved without throwing, such as fundamental types and pointers, are stored in an inline buffer and never cause an allocation.
+    /// Larger values are allocated via the allocator set with SetAllocator(), if any, or via the global operator new otherwise.
     /// \author Raffaele D. Facendola - April 2017
     class Any
     {
@@ -31,9 +42,13 @@ namespace syntropy::reflection
         template <typename T>
         struct is_in_place_type<std::in_place_type_t<T> > : std::true_type {};
 
+        /// \brief Size of the buffer used to store small values without allocating, in bytes.
+        static constexpr std::size_t kInlineSize = 3 * sizeof(void*);
+
         /// \brief Constructs an empty object.
         constexpr Any() noexcept
             : holder_(nullptr)
+            , storage_{}
         {
 
         }
@@ -54,7 +69,7 @@ namespace syntropy::reflection
         /// This overload only participates in overload resolution if std::decay_t<TValue> is not the same type as any nor a specialization of std::in_place_type_t.
         template <typename TValue, typename = std::enable_if_t<!std::is_same<std::decay_t<TValue>, Any>::value && !is_in_place_type<std::decay_t<TValue>>::value>>
         Any(TValue&& value)
-            : holder_(new HolderT<std::decay_t<TValue>>(std::forward<TValue>(value)))
+            : holder_(MakeHolder<std::decay_t<TValue>>(storage_, std::forward<TValue>(value)))
         {
             static_assert(std::is_copy_constructible<std::decay_t<TValue>>::value, "std::decay<TValue> must be copy-constructible.");
         }
@@ -63,7 +78,7 @@ namespace syntropy::reflection
         /// Constructs an object with initial content an object of type std::decay_t<TValue>, direct-non-list-initialized from std::forward<TArguments>(arguments).... 
         template <typename TValue, typename... TArguments>
         explicit Any(std::in_place_type_t<TValue>, TArguments&&... arguments)
-            : holder_(new HolderT<std::decay_t<TValue>>(std::in_place_type_t<TValue>{}, std::forward<TArguments>(arguments)...))
+            : holder_(MakeHolder<std::decay_t<TValue>>(storage_, std::in_place_type_t<TValue>{}, std::forward<TArguments>(arguments)...))
         {
             static_assert(std::is_constructible<std::decay_t<TValue>, TArguments...>::value, "std::decay<TValue> must be constructible from TArguments... .");
             static_assert(std::is_copy_constructible<std::decay_t<TValue>>::value, "std::decay<TValue> must be copy-constructible.");
@@ -73,7 +88,7 @@ namespace syntropy::reflection
         /// Constructs an object with initial content an object of type std::decay_t<TValue>, direct-non-list-initialized from initializer_list, std::forward<TArguments>(arguments)... .
         template< typename TValue, typename TInitializerList, typename... TArguments >
         explicit Any(std::in_place_type_t<TValue>, std::initializer_list<TInitializerList> initializer_list, TArguments&&... arguments)
-            : holder_(new HolderT<std::decay_t<TValue>>(std::in_place_type_t<TValue>{}, initializer_list, std::forward<TArguments>(arguments)...))
+            : holder_(MakeHolder<std::decay_t<TValue>>(storage_, std::in_place_type_t<TValue>{}, initializer_list, std::forward<TArguments>(arguments)...))
         {
             static_assert(std::is_constructible<std::decay_t<TValue>, std::initializer_list<TInitializerList>&, TArguments...>::value, "std::decay<TValue> must be constructible from std::initializer_list<TInitializerList>& and TArguments... .");
             static_assert(std::is_copy_constructible<std::decay_t<TValue>>::value, "std::decay<TValue> must be copy-constructible.");
@@ -88,13 +103,14 @@ namespace syntropy::reflection
         Any& operator=(Any&& other) noexcept;
 
         /// \brief Assign a new value to the object.
-        /// \param other Object to assign.
+        /// The new value is constructed in place. See Replace() for the exception guarantees.
+        /// \param other Object to assign. Must not refer to the value currently held, unless it is stored out of line.
         template<typename TValue, typename = std::enable_if_t<!std::is_same<std::decay_t<TValue>, Any>::value>>
         Any& operator=(TValue&& other)
         {
             static_assert(std::is_copy_constructible<std::decay_t<TValue>>::value, "std::decay<TValue> must be copy-constructible.");
 
-            Any(std::forward<TValue>(other)).Swap(*this);
+            Replace<std::decay_t<TValue>>(std::forward<TValue>(other));
 
             return *this;
         }
@@ -103,31 +119,23 @@ namespace syntropy::reflection
         ~Any();
 
         /// \brief Constructs an object of type std::decay_t<TValue>, direct-non-list-initialized from std::forward<TArguments>(arguments)... . 
+        /// The new value is constructed in place. See Replace() for the exception guarantees.
         template<typename TValue, typename... TArguments>
         std::decay_t<TValue>& Emplace(TArguments&&... arguments)
         {
-            Reset();
-
-            Any(std::in_place_type_t<TValue>{}, std::forward<TArguments>(arguments)...).Swap(*this);
-
-            SYNTROPY_ASSERT(holder_);
-            SYNTROPY_ASSERT(holder_->GetTypeInfo() == typeid(std::decay_t<TValue>));
+            static_assert(std::is_copy_constructible<std::decay_t<TValue>>::value, "std::decay<TValue> must be copy-constructible.");
 
-            return static_cast<Any::HolderT<std::decay_t<TValue>>*>(holder_)->value_;
+            return Replace<std::decay_t<TValue>>(std::in_place_type_t<TValue>{}, std::forward<TArguments>(arguments)...);
         }
 
         /// \brief Constructs an object of type std::decay_t<TValue>, direct-non-list-initialized from initializer_list, std::forward<TArguments>(arguments)... .
+        /// The new value is constructed in place. See Replace() for the exception guarantees.
         template< typename TValue, typename TInitializerList, typename... TArguments >
         std::decay_t<TValue>& Emplace(std::initializer_list<TInitializerList> initializer_list, TArguments&&... arguments)
         {
-            Reset();
-
-            Any(std::in_place_type_t<TValue>{}, initializer_list, std::forward<TArguments>(arguments)...).Swap(*this);
-
-            SYNTROPY_ASSERT(holder_);
-            SYNTROPY_ASSERT(holder_->GetTypeInfo() == typeid(std::decay_t<TValue>));
+            static_assert(std::is_copy_constructible<std::decay_t<TValue>>::value, "std::decay<TValue> must be copy-constructible.");
 
-            return static_cast<Any::HolderT<std::decay_t<TValue>>*>(holder_)->value_;
+            return Replace<std::decay_t<TValue>>(std::in_place_type_t<TValue>{}, initializer_list, std::forward<TArguments>(arguments)...);
         }
 
         /// \brief Destroys the contained object.
@@ -147,7 +155,24 @@ namespace syntropy::reflection
 
         /// \brief Get the typeid of the held object, if any.
         /// \return Returns the type of the contained value if non-empty. Returns the type of void, otherwise.
-        const type_info& GetTypeInfo() const noexcept;
+        const std::type_info& GetTypeInfo() const noexcept;
+
+        /// \brief Check whether values of a given type are stored in the inline buffer, without allocating.
+        /// \return Returns true if values of type TValue are stored inline, returns false otherwise.
+        template <typename TValue>
+        static constexpr bool IsInline() noexcept
+        {
+            return sizeof(HolderT<TValue>) <= sizeof(Storage) && alignof(HolderT<TValue>) <= alignof(Storage) && std::is_nothrow_move_constructible<TValue>::value;
+        }
+
+        /// \brief Set the allocator used to allocate values that do not fit the inline buffer.
+        /// Values allocated before the call are deallocated by the allocator they were allocated with.
+        /// \param allocator Allocator to use. nullptr uses the global operator new.
+        static void SetAllocator(Allocator* allocator) noexcept;
+
+        /// \brief Get the allocator used to allocate values that do not fit the inline buffer.
+        /// \return Returns the allocator used to allocate values that do not fit the inline buffer. Returns nullptr if values are allocated via the global operator new.
+        static Allocator* GetAllocator() noexcept;
 
     private:
 
@@ -166,6 +191,14 @@ namespace syntropy::reflection
         template<class TValue>
         friend TValue* AnyCast(Any* operand) noexcept;
 
+        /// \brief Storage for the holder of a small value or for the allocator of a larger one.
+        union Storage
+        {
+            alignas(void*) unsigned char buffer_[sizeof(void*) + kInlineSize];      ///< \brief Holder of a value stored inline, including its virtual table pointer.
+
+            Allocator* allocator_;                                                  ///< \brief Allocator a value stored out of line was allocated with. nullptr for the global operator new.
+        };
+
         struct Holder
         {
 
@@ -173,9 +206,20 @@ namespace syntropy::reflection
 
             virtual const Type& GetType() const noexcept = 0;
 
-            virtual const type_info& GetTypeInfo() const noexcept = 0;
+            virtual const std::type_info& GetTypeInfo() const noexcept = 0;
 
-            virtual Holder* Clone() const noexcept = 0;
+            /// \brief Copy the holder and its value.
+            /// \param storage Storage of the object receiving the copy.
+            virtual Holder* Clone(Storage& storage) const = 0;
+
+            /// \brief Move the holder to another object. Inline values are move-constructed, values stored out of line are not moved at all.
+            /// \param storage Storage of the object receiving the holder.
+            /// \param source Storage of the object this holder belongs to.
+            virtual Holder* Move(Storage& storage, Storage& source) noexcept = 0;
+
+            /// \brief Destroy the holder and its value, deallocating it if it was stored out of line.
+            /// \param storage Storage of the object this holder belongs to.
+            virtual void Destroy(Storage& storage) noexcept = 0;
 
         };
 
@@ -191,39 +235,147 @@ namespace syntropy::reflection
 
             template <typename TValue, typename... TArguments>
             HolderT(std::in_place_type_t<TValue>, TArguments&&... arguments)
-                : value_(std::forward<TValue>(arguments)...)
+                : value_(std::forward<TArguments>(arguments)...)
             {
 
             }
 
             template< typename TValue, typename TInitializerList, typename... TArguments>
             HolderT(std::in_place_type_t<TValue>, std::initializer_list<TInitializerList> initializer_list, TArguments&&... arguments)
-                : value_(std::move(initializer_list), std::forward<TValue>(arguments)...)
+                : value_(std::move(initializer_list), std::forward<TArguments>(arguments)...)
             {
 
             }
 
-            const Type& Any::HolderT<TContent>::GetType() const noexcept
+            const Type& GetType() const noexcept
             {
                 return TypeOf<TContent>();
             }
 
-            const type_info& Any::HolderT<TContent>::GetTypeInfo() const noexcept
+            const std::type_info& GetTypeInfo() const noexcept
             {
                 return typeid(TContent);
             }
 
-            Any::Holder* Any::HolderT<TContent>::Clone() const noexcept
+            Any::Holder* Clone(Storage& storage) const
+            {
+                return MakeHolder<TContent>(storage, value_);
+            }
+
+            Any::Holder* Move(Storage& storage, Storage& source) noexcept
+            {
+                if constexpr (IsInline<TContent>())
+                {
+                    auto holder = new (storage.buffer_) HolderT<TContent>(std::move(value_));
+
+                    this->~HolderT();
+
+                    return holder;
+                }
+                else
+                {
+                    storage.allocator_ = source.allocator_;                 // Steal the value.
+
+                    return this;
+                }
+            }
+
+            void Destroy(Storage& storage) noexcept
             {
-                return new HolderT<TContent>(value_);
+                if constexpr (IsInline<TContent>())
+                {
+                    this->~HolderT();
+                }
+                else if (auto allocator = storage.allocator_)
+                {
+                    this->~HolderT();
+
+                    FreeHolder(*allocator, this);
+                }
+                else
+                {
+                    delete this;
+                }
             }
 
             TContent value_;
 
         };
 
+        /// \brief Create the holder of a new value, either inline or out of line.
+        /// \param storage Storage of the object receiving the value.
+        template <typename TContent, typename... TArguments>
+        static Holder* MakeHolder(Storage& storage, TArguments&&... arguments)
+        {
+            if constexpr (IsInline<TContent>())
+            {
+                return new (storage.buffer_) HolderT<TContent>(std::forward<TArguments>(arguments)...);
+            }
+            else if (auto allocator = GetAllocator())
+            {
+                auto block = AllocateHolder(*allocator, sizeof(HolderT<TContent>), alignof(HolderT<TContent>));
+
+                try
+                {
+                    auto holder = new (block) HolderT<TContent>(std::forward<TArguments>(arguments)...);
+
+                    storage.allocator_ = allocator;
+
+                    return holder;
+                }
+                catch (...)
+                {
+                    FreeHolder(*allocator, block);
+                    throw;
+                }
+            }
+            else
+            {
+                storage.allocator_ = nullptr;
+
+                return new HolderT<TContent>(std::forward<TArguments>(arguments)...);
+            }
+        }
+
+        /// \brief Replace the contained value with a new one, constructed in place.
+        /// Values stored out of line are constructed before the current value is destroyed: if the construction throws, the object is left unchanged.
+        /// Values stored inline are constructed after the current value is destroyed: if the construction throws, the object is left empty.
+        /// \return Returns a reference to the new value.
+        template <typename TContent, typename... TArguments>
+        TContent& Replace(TArguments&&... arguments)
+        {
+            if constexpr (IsInline<TContent>())
+            {
+                Reset();
+
+                holder_ = MakeHolder<TContent>(storage_, std::forward<TArguments>(arguments)...);
+            }
+            else
+            {
+                auto storage = Storage{};
+
+                auto holder = MakeHolder<TContent>(storage, std::forward<TArguments>(arguments)...);
+
+                Reset();
+
+                storage_ = storage;
+                holder_ = holder;
+            }
+
+            return static_cast<HolderT<TContent>*>(holder_)->value_;
+        }
+
+        /// \brief Allocate a holder via a custom allocator.
+        /// \remarks Throws std::bad_alloc if the allocator could not satisfy the request.
+        static void* AllocateHolder(Allocator& allocator, std::size_t size, std::size_t alignment);
+
+        /// \brief Deallocate a holder allocated via a custom allocator.
+        static void FreeHolder(Allocator& allocator, void* holder);
+
         Holder* holder_;        ///< \brief Holds the contained value. May be nullptr.
 
+        Storage storage_;       ///< \brief Holder of small values, or allocator of larger ones.
+
     };
 
     // Any cast
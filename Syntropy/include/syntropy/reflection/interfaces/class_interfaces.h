@@ -136,7 +136,7 @@ namespace syntropy::reflection
         /// \param class_definition Definition of the class the interface will be added to.
         void operator()(reflection::ClassT<TEnum>& class_t) const
         {
-            class_t.AddInterface<Enumeration>(values_);
+            class_t.template AddInterface<Enumeration>(values_);
         }
 
     private:
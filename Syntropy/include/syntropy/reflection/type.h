@@ -10,6 +10,7 @@
 #include <ostream>
 #include <array>
 #include <sstream>
+#include <vector>
 
 #include "syntropy/type_traits.h"
 
@@ -54,7 +55,7 @@ namespace syntropy::reflection
         /// \brief Get the type associated to TType.
         /// \return Returns a reference to the singleton describing TType.
         template <typename TType>
-        static constexpr const Type& GetType()
+        static const Type& GetType()
         {
             static Type type(tag<TType>);
             return type;
@@ -115,7 +116,7 @@ namespace syntropy::reflection
 
         /// \brief Create a new type.
         template <typename TType>
-        constexpr Type(tag_t<TType>)
+        Type(tag_t<TType>)
             : class_(ClassOf<TType>())
             , array_size_(std::begin(array_extents<TType>::value), std::end(array_extents<TType>::value))
             , indirection_levels_(static_cast<int8_t>(indirection_levels_v<TType>))
@@ -255,7 +255,7 @@ namespace syntropy::serialization
         {
             if (auto object_property = reflection::ClassOf<TType>().GetProperty(json_property.key()))       // Find a property by name.
             {
-                auto deserializable = object_property->GetInterface<JSONDeserializable>();
+                auto deserializable = object_property->template GetInterface<JSONDeserializable>();
 
                 if (deserializable && (*deserializable)(std::addressof(object), json_property.value()))     // Recursive deserialization.
                 {
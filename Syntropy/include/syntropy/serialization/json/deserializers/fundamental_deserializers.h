@@ -27,7 +27,7 @@ namespace syntropy::serialization
         {
             if (auto concrete_class = GetClassFromJSON(json, &reflection::ClassOf<TType>()))            // Concrete class type.
             {
-                if (auto json_constructible = concrete_class->GetInterface<JSONConstructible>())        // Double dispatch to ensure the concrete type is instantiated and deserialized.
+                if (auto json_constructible = concrete_class->template GetInterface<JSONConstructible>())        // Double dispatch to ensure the concrete type is instantiated and deserialized.
                 {
                     if (auto instance = (*json_constructible)(json); instance.HasValue())
                     {
@@ -88,9 +88,9 @@ namespace syntropy::serialization
         {
             if (json.is_string())
             {
-                if (auto enum_interface = reflection::ClassOf<TType>().GetInterface<reflection::Enumeration>())
+                if (auto enum_interface = reflection::ClassOf<TType>().template GetInterface<reflection::Enumeration>())
                 {
-                    return enum_interface->GetValueByName<TType>(json.get<std::string>());
+                    return enum_interface->template GetValueByName<TType>(json.get<std::string>());
                 }
             }
             return std::nullopt;
@@ -69,7 +69,7 @@ namespace syntropy::serialization
 
                 for (auto array_index = 0u; array_index < json.size(); ++array_index)
                 {
-                    if (auto item = JSONDeserializer<TSet::value_type>(json[array_index]))
+                    if (auto item = JSONDeserializer<typename TSet::value_type>(json[array_index]))
                     {
                         set->emplace(std::move(*item));
                     }
@@ -30,8 +30,8 @@ namespace syntropy::serialization
         template <typename TClass, typename TField, typename... TAccessors>
         void operator()(reflection::PropertyDefinitionT<TAccessors...>& property, TField(TClass::* field))
         {
-            property.AddInterface<JSONDeserializable>(field);
-            property.AddInterface<JSONSerializable>(field);
+            property.template AddInterface<JSONDeserializable>(field);
+            property.template AddInterface<JSONSerializable>(field);
         }
 
         /// \brief Add a JSONDeserializable interface to the provided property.
@@ -41,8 +41,8 @@ namespace syntropy::serialization
         template <typename TClass, typename TPropertyGetter, typename TPropertySetter, typename... TAccessors>
         void operator()(reflection::PropertyDefinitionT<TAccessors...>& property, TPropertyGetter(TClass::* getter)() const, void (TClass::* setter)(TPropertySetter))
         {
-            property.AddInterface<JSONDeserializable>(setter);
-            property.AddInterface<JSONSerializable>(getter);
+            property.template AddInterface<JSONDeserializable>(setter);
+            property.template AddInterface<JSONSerializable>(getter);
         }
 
         /// \brief Add a JSONDeserializable interface to the provided property.
@@ -52,8 +52,8 @@ namespace syntropy::serialization
         template <typename TClass, typename TProperty, typename... TAccessors>
         void operator()(reflection::PropertyDefinitionT<TAccessors...>& property, const TProperty&(TClass::* getter)() const, TProperty& (TClass::* setter)())
         {
-            property.AddInterface<JSONDeserializable>(setter);
-            property.AddInterface<JSONSerializable>(getter);
+            property.template AddInterface<JSONDeserializable>(setter);
+            property.template AddInterface<JSONSerializable>(getter);
         }
     };
 
@@ -70,7 +70,7 @@ namespace syntropy::serialization
         template <typename TClass>
         void operator()(reflection::ClassT<TClass>& class_definition) const
         {
-            class_definition.AddInterface<JSONConstructible>(tag_t<TClass>{});
+            class_definition.template AddInterface<JSONConstructible>(tag_t<TClass>{});
             //class_definition.AddInterface<JSONConvertible>(tag_t<TClass>{});
         }
     };
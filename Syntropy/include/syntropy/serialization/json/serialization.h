@@ -136,7 +136,7 @@ namespace syntropy::serialization
             nlohmann::json json;
             for (auto it = Class->GetProperties().begin(); it != Class->GetProperties().end(); ++it)
             {
-                auto SerializableInterface = (*it).GetInterface<JSONSerializable>();
+                auto SerializableInterface = (*it).template GetInterface<JSONSerializable>();
                 if (SerializableInterface)
                 {
                     (*SerializableInterface)(*it, instance, json);
@@ -165,8 +165,8 @@ namespace syntropy::serialization
     struct JSONSerializerT
     {
         /// \brief Base specialization of JSONSerializerT for object types.
-        template<typename TType>
-        void operator()(nlohmann::json& json, const TType& instance) const
+        template<typename TValue>
+        void operator()(nlohmann::json& json, const TValue& instance) const
         {
             /// \brief Compile time error if there is not a specialization of to_json in the same namespace of TType or the global namespace for TType.
             json = instance; 
@@ -189,7 +189,7 @@ namespace syntropy::serialization
     template<typename TType>
     std::optional<nlohmann::json> SerializeObjectToJSON(const TType& object)
     {
-        if (auto ConvertibleInterface = reflection::ClassOf<TType>().GetInterface<JSONConvertible>())
+        if (auto ConvertibleInterface = reflection::ClassOf<TType>().template GetInterface<JSONConvertible>())
         {
             return (*ConvertibleInterface)(object);
         }
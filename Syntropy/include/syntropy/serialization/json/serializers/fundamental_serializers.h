@@ -45,7 +45,7 @@ namespace syntropy::serialization
 	{
 		void operator()(nlohmann::json& json, const TType& value) const
 		{
-			if (auto enum_interface = reflection::ClassOf<TType>().GetInterface<reflection::Enumeration>())
+			if (auto enum_interface = reflection::ClassOf<TType>().template GetInterface<reflection::Enumeration>())
 			{				
 				if(auto name = enum_interface->GetNameByValue(value); name.has_value())
 				{
@@ -18,7 +18,6 @@ namespace syntropy::serialization
 	template<typename TType>
 	struct JSONSerializerT<std::shared_ptr<TType>>
 	{
-		template<typename TType>
 		void operator()(nlohmann::json& json, std::shared_ptr<TType> instance) const
 		{
 			JSONSerialize(json, instance.get());
@@ -30,7 +29,6 @@ namespace syntropy::serialization
 	template<typename TType>
 	struct JSONSerializerT<std::weak_ptr<TType>>
 	{
-		template<typename TType>
 		void operator()(nlohmann::json& json, std::weak_ptr<TType> instance) const
 		{
 			JSONSerialize(json, instance.lock());
@@ -41,7 +39,6 @@ namespace syntropy::serialization
 	template <typename TKey, typename TValue>
 	struct JSONSerializerT<std::map<TKey, TValue>>
 	{
-		template <typename TKey, typename TValue>
 		void operator()(nlohmann::json& json, const std::map<TKey, TValue>& map) const
 		{			
 			for (auto&& pair : map)
@@ -8,6 +8,7 @@
 
 #include <type_traits>
 #include <typeinfo>
+#include <cstddef>
 
 #include <set>
 #include <map>
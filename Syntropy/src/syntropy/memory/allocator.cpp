@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "syntropy/memory/memory_profiler.h"
+
 #include "syntropy/contexts.h"
 
 #include "syntropy/diagnostics/log.h"
@@ -128,6 +130,7 @@ namespace syntropy
     Allocator::Allocator(Allocator&& other)
         : name_(std::move(other.name_))
         , context_(std::move(other.context_))
+        , profile_(other.profile_.exchange(nullptr))
     {
         if (name_)
         {
@@ -148,6 +151,11 @@ namespace syntropy
         return name_;
     }
 
+    MemoryRange Allocator::GetRange() const
+    {
+        return MemoryRange();
+    }
+
     Allocator::operator Context() const
     {
         return context_;
@@ -163,6 +171,8 @@ void* operator new (std::size_t size, syntropy::Allocator& allocator, const synt
 {
     auto ptr = allocator.Allocate(syntropy::Bytes(size));
 
+    syntropy::MemoryProfiler::TrackAllocation(allocator, ptr, syntropy::Bytes(size), stack_trace);
+
     SYNTROPY_LOG((allocator), "Allocating ", size, " bytes. Address: ", ptr, ". Caller: ", stack_trace);
 
     return ptr;
@@ -170,6 +180,8 @@ void* operator new (std::size_t size, syntropy::Allocator& allocator, const synt
 
 void operator delete (void* ptr, syntropy::Allocator& allocator, const syntropy::diagnostics::StackTrace& stack_trace)
 {
+    syntropy::MemoryProfiler::TrackDeallocation(ptr);               // Before the block can be recycled by another thread.
+
     allocator.Free(ptr);
 
     SYNTROPY_LOG((allocator), "Deallocating memory. Address: ", ptr, ". Caller: ", stack_trace);
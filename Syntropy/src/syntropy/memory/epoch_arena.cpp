@@ -0,0 +1,263 @@
+#include "syntropy/memory/allocators/epoch_arena.h"
+
+#include <algorithm>
+
+#include "syntropy/memory/virtual_memory.h"
+
+#include "syntropy/diagnostics/assert.h"
+
+#include "syntropy/platform/macros.h"
+
+#include "syntropy/math/math.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* EPOCH ARENA :: SUB ARENA BINDING                                     */
+    /************************************************************************/
+
+    EpochArena::SubArenaBinding::~SubArenaBinding()
+    {
+        for (auto&& entry : entries_)
+        {
+            Release(entry);
+        }
+    }
+
+    void EpochArena::SubArenaBinding::Release(Entry& entry)
+    {
+        if (auto handle = entry.handle_.lock())
+        {
+            handle->arena_->ReleaseSubArena(*handle);
+        }
+
+        entry = Entry{};
+    }
+
+    /************************************************************************/
+    /* EPOCH ARENA                                                          */
+    /************************************************************************/
+
+    thread_local EpochArena::SubArenaBinding EpochArena::thread_binding_;
+
+    std::atomic<std::uint64_t> EpochArena::next_arena_id_{ 1 };
+
+    EpochArena::EpochArena(Bytes capacity, std::size_t buffer_count, std::size_t consumer_count, std::size_t decommit_window)
+        : id_(next_arena_id_.fetch_add(1, std::memory_order_relaxed))
+        , capacity_(Ceil(std::size_t(capacity), std::size_t(kCommitGranularity)))
+        , buffer_count_(buffer_count)
+        , consumer_count_(consumer_count)
+        , decommit_window_(std::max(decommit_window, std::size_t(1)))
+    {
+        SYNTROPY_ASSERT(buffer_count_ > 1 && buffer_count_ <= kMaxBufferCount);
+
+        for (auto&& pending_signals : pending_signals_)
+        {
+            pending_signals.store(0, std::memory_order_relaxed);
+        }
+
+        pending_signals_[0].store(consumer_count_, std::memory_order_relaxed);         // Epoch 0 is open.
+    }
+
+    bool EpochArena::Owns(const MemoryRange& block) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        return std::any_of(std::begin(sub_arenas_), std::end(sub_arenas_), [&block](const std::shared_ptr<SubArena>& sub_arena)
+        {
+            return MemoryRange(sub_arena->memory_buffer_).Contains(block);
+        });
+    }
+
+    void EpochArena::Signal(std::size_t epoch)
+    {
+        SYNTROPY_ASSERT(epoch <= GetEpoch() && epoch + buffer_count_ > GetEpoch());     // The epoch was recycled already or was not opened yet.
+
+        auto pending_signals = pending_signals_[epoch % buffer_count_].fetch_sub(1, std::memory_order_acq_rel);
+
+        SYNTROPY_ASSERT(pending_signals > 0);                                           // Too many signals.
+    }
+
+    bool EpochArena::CanAdvance() const
+    {
+        auto next_buffer = (epoch_.load(std::memory_order_relaxed) + 1) % buffer_count_;
+
+        return pending_signals_[next_buffer].load(std::memory_order_acquire) == 0;
+    }
+
+    bool EpochArena::Advance()
+    {
+        if (!CanAdvance())
+        {
+            return false;
+        }
+
+        auto epoch = epoch_.load(std::memory_order_relaxed) + 1;
+
+        auto buffer_index = epoch % buffer_count_;
+
+        auto expired_epoch = epoch - buffer_count_;                                     // Last epoch the buffer was used by. Meaningless during the first epochs.
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            for (auto&& sub_arena : sub_arenas_)
+            {
+                // A thread may have read the expired epoch before it was advanced: wait for its allocation to complete.
+                // Threads reading the epoch from now on get a different buffer, since the current epoch is never the expired one.
+
+                while (epoch >= buffer_count_ && sub_arena->epoch_.load(std::memory_order_seq_cst) == expired_epoch)
+                {
+                    SYNTROPY_PAUSE;
+                }
+
+                Recycle(sub_arena->buffers_[buffer_index]);
+            }
+        }
+
+        pending_signals_[buffer_index].store(consumer_count_, std::memory_order_relaxed);
+
+        epoch_.store(epoch, std::memory_order_seq_cst);                                 // Publish the recycled buffers to the allocating threads. See EnterEpoch().
+
+        return true;
+    }
+
+    Bytes EpochArena::GetCommittedSize() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto committed_size = 0_Bytes;
+
+        for (auto&& sub_arena : sub_arenas_)
+        {
+            for (std::size_t buffer_index = 0; buffer_index < buffer_count_; ++buffer_index)
+            {
+                auto& buffer = sub_arena->buffers_[buffer_index];
+
+                committed_size += Bytes(buffer.commit_head_ - buffer.memory_range_.Begin());
+            }
+        }
+
+        return committed_size;
+    }
+
+    EpochArena::SubArena& EpochArena::GetSubArena()
+    {
+        for (auto&& entry : thread_binding_.entries_)
+        {
+            if (entry.arena_id_ == id_)
+            {
+                return *entry.sub_arena_;
+            }
+        }
+
+        return BindSubArena();
+    }
+
+    EpochArena::SubArena& EpochArena::BindSubArena()
+    {
+        std::shared_ptr<SubArena> handle;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+
+            if (free_sub_arenas_.empty())
+            {
+                // Reserve the memory for every buffer at once, buffers are committed on demand.
+
+                auto sub_arena = std::make_shared<SubArena>();
+
+                sub_arena->arena_ = this;
+                sub_arena->memory_buffer_ = VirtualMemoryBuffer(capacity_ * buffer_count_);
+
+                auto base = MemoryRange(sub_arena->memory_buffer_).Begin();
+
+                for (std::size_t buffer_index = 0; buffer_index < buffer_count_; ++buffer_index)
+                {
+                    auto& buffer = sub_arena->buffers_[buffer_index];
+
+                    buffer.memory_range_ = MemoryRange(base + capacity_ * buffer_index, base + capacity_ * (buffer_index + 1));
+                    buffer.allocator_ = LinearAllocator(buffer.memory_range_);
+                    buffer.commit_head_ = buffer.memory_range_.Begin();
+                }
+
+                sub_arenas_.emplace_back(std::move(sub_arena));
+
+                handle = sub_arenas_.back();
+            }
+            else
+            {
+                auto sub_arena = free_sub_arenas_.back();
+
+                free_sub_arenas_.pop_back();
+
+                handle = *std::find_if(std::begin(sub_arenas_), std::end(sub_arenas_), [sub_arena](const std::shared_ptr<SubArena>& entry)
+                {
+                    return entry.get() == sub_arena;
+                });
+            }
+        }
+
+        // Evict the oldest binding, returning its sub-arena to its arena.
+
+        auto& entry = thread_binding_.entries_[thread_binding_.next_entry_];
+
+        thread_binding_.next_entry_ = (thread_binding_.next_entry_ + 1) % SubArenaBinding::kMaxEntries;
+
+        SubArenaBinding::Release(entry);
+
+        entry = SubArenaBinding::Entry{ id_, handle.get(), handle };
+
+        return *handle;
+    }
+
+    void EpochArena::ReleaseSubArena(SubArena& sub_arena)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        free_sub_arenas_.emplace_back(&sub_arena);
+    }
+
+    bool EpochArena::Commit(Buffer& buffer, const MemoryRange& block)
+    {
+        // The underlying linear allocator returns new blocks at increasingly higher addresses.
+
+        auto commit_end = std::min(buffer.commit_head_ + Bytes(Ceil(std::size_t(block.End() - buffer.commit_head_), std::size_t(kCommitGranularity))), buffer.memory_range_.End());
+
+        if (!VirtualMemory::Commit(MemoryRange(buffer.commit_head_, commit_end)))         // Kernel call.
+        {
+            return false;
+        }
+
+        buffer.commit_head_ = commit_end;
+
+        return true;
+    }
+
+    void EpochArena::Recycle(Buffer& buffer)
+    {
+        buffer.peak_size_ = std::max(buffer.peak_size_, Bytes(buffer.allocator_.SaveState() - buffer.memory_range_.Begin()));
+
+        buffer.allocator_.DeallocateAll();
+
+        if (++buffer.recycle_count_ < decommit_window_)
+        {
+            return;
+        }
+
+        // Decommit the memory that was not used during the whole window.
+
+        auto commit_end = buffer.memory_range_.Begin() + Bytes(Ceil(std::size_t(buffer.peak_size_), std::size_t(kCommitGranularity)));
+
+        if (commit_end < buffer.commit_head_)
+        {
+            VirtualMemory::Decommit(MemoryRange(commit_end, buffer.commit_head_));        // Kernel call.
+
+            buffer.commit_head_ = commit_end;
+        }
+
+        buffer.peak_size_ = 0_Bytes;
+        buffer.recycle_count_ = 0;
+    }
+
+}
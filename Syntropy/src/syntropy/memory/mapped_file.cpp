@@ -0,0 +1,36 @@
+#include "syntropy/memory/mapped_file.h"
+
+#include "syntropy/platform/os/os.h"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* MAPPED FILE                                                          */
+    /************************************************************************/
+
+    MemoryRange MappedFile::Map(const std::string& path, MappedFileMode mode)
+    {
+        return platform::PlatformMemory::MapFile(path, mode);
+    }
+
+    bool MappedFile::Unmap(const MemoryRange& memory_range)
+    {
+        return platform::PlatformMemory::UnmapFile(memory_range);
+    }
+
+    bool MappedFile::Prefetch(const MemoryRange& memory_range)
+    {
+        return platform::PlatformMemory::Prefetch(memory_range);
+    }
+
+    bool MappedFile::Advise(const MemoryRange& memory_range, MappedFileAccess access)
+    {
+        return platform::PlatformMemory::Advise(memory_range, access);
+    }
+
+    Bytes MappedFile::GetResidentSize(const MemoryRange& memory_range)
+    {
+        return platform::PlatformMemory::GetResidentSize(memory_range);
+    }
+
+}
@@ -83,6 +83,18 @@ namespace syntropy
         return *allocators_.front();        // First registered allocator.
     }
 
+    void MemoryManager::MapRange(const MemoryRange& memory_range, Allocator& allocator)
+    {
+        SYNTROPY_ASSERT(std::any_of(allocators_.begin(), allocators_.end(), [&allocator](const std::unique_ptr<Allocator>& owned_allocator) { return owned_allocator.get() == &allocator; }));
+
+        page_map_.Insert(memory_range, &allocator);
+    }
+
+    void MemoryManager::UnmapRange(const MemoryRange& memory_range)
+    {
+        page_map_.Erase(memory_range);
+    }
+
     Allocator& MemoryManager::GetAllocator()
     {
         return !allocator_stack_.empty() ?
@@ -92,6 +104,13 @@ namespace syntropy
 
     Allocator* MemoryManager::GetAllocator(void* block)
     {
+        if (auto allocator = page_map_.Get(MemoryAddress(block)))
+        {
+            return allocator;
+        }
+
+        // Blocks outside any mapped chunk: either the owner reserves no range or the block lies on a chunk shared by two allocators.
+
         auto it = std::find_if
         (
             allocators_.begin(),
@@ -118,6 +137,11 @@ namespace syntropy
 
         std::ifstream file(path);
 
+        if (!file)
+        {
+            return false;
+        }
+
         nlohmann::json json;
 
         file >> json;
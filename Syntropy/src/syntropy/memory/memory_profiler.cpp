@@ -0,0 +1,665 @@
+#include "syntropy/memory/memory_profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <cmath>
+
+#include "syntropy/platform/builtin.h"
+
+#include "nlohmann/json/src/json.hpp"
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* MEMORY PROFILER :: COUNTERS                                          */
+    /************************************************************************/
+
+    struct MemoryProfiler::Counters
+    {
+        /// \brief Track a new allocation.
+        void Allocate(std::int64_t size, std::size_t size_class);
+
+        /// \brief Track a deallocation.
+        void Free(std::int64_t size);
+
+        /// \brief Discard the statistics collected so far.
+        void Clear();
+
+        /// \brief Accumulate the statistics collected so far.
+        void Gather(AllocationStatistics& statistics) const;
+
+        std::atomic<std::int64_t> live_bytes_{ 0 };                                     ///< \brief Bytes currently allocated.
+
+        std::atomic<std::int64_t> peak_live_bytes_{ 0 };                                ///< \brief Highest amount of bytes allocated at any given time.
+
+        std::atomic<std::int64_t> live_count_{ 0 };                                     ///< \brief Number of blocks currently allocated.
+
+        std::atomic<std::int64_t> allocated_bytes_{ 0 };                                ///< \brief Total amount of bytes allocated.
+
+        std::atomic<std::int64_t> allocation_count_{ 0 };                               ///< \brief Total number of allocations.
+
+        std::atomic<std::int64_t> deallocation_count_{ 0 };                             ///< \brief Total number of deallocations.
+
+        std::array<std::atomic<std::int64_t>, AllocationStatistics::kHistogramSize> size_histogram_{};        ///< \brief Number of allocations, by size.
+    };
+
+    void MemoryProfiler::Counters::Allocate(std::int64_t size, std::size_t size_class)
+    {
+        auto live_bytes = live_bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+
+        auto peak_live_bytes = peak_live_bytes_.load(std::memory_order_relaxed);
+
+        while (live_bytes > peak_live_bytes && !peak_live_bytes_.compare_exchange_weak(peak_live_bytes, live_bytes, std::memory_order_relaxed));
+
+        live_count_.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes_.fetch_add(size, std::memory_order_relaxed);
+        allocation_count_.fetch_add(1, std::memory_order_relaxed);
+        size_histogram_[size_class].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryProfiler::Counters::Free(std::int64_t size)
+    {
+        live_bytes_.fetch_sub(size, std::memory_order_relaxed);
+        live_count_.fetch_sub(1, std::memory_order_relaxed);
+        deallocation_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void MemoryProfiler::Counters::Clear()
+    {
+        live_bytes_.store(0, std::memory_order_relaxed);
+        peak_live_bytes_.store(0, std::memory_order_relaxed);
+        live_count_.store(0, std::memory_order_relaxed);
+        allocated_bytes_.store(0, std::memory_order_relaxed);
+        allocation_count_.store(0, std::memory_order_relaxed);
+        deallocation_count_.store(0, std::memory_order_relaxed);
+
+        for (auto&& entry : size_histogram_)
+        {
+            entry.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void MemoryProfiler::Counters::Gather(AllocationStatistics& statistics) const
+    {
+        statistics.live_bytes_ += live_bytes_.load(std::memory_order_relaxed);
+        statistics.peak_live_bytes_ += peak_live_bytes_.load(std::memory_order_relaxed);
+        statistics.live_count_ += live_count_.load(std::memory_order_relaxed);
+        statistics.allocated_bytes_ += allocated_bytes_.load(std::memory_order_relaxed);
+        statistics.allocation_count_ += allocation_count_.load(std::memory_order_relaxed);
+        statistics.deallocation_count_ += deallocation_count_.load(std::memory_order_relaxed);
+
+        for (auto index = 0u; index < AllocationStatistics::kHistogramSize; ++index)
+        {
+            statistics.size_histogram_[index] += size_histogram_[index].load(std::memory_order_relaxed);
+        }
+    }
+
+    /************************************************************************/
+    /* MEMORY PROFILER :: CALL SITE                                         */
+    /************************************************************************/
+
+    struct MemoryProfiler::CallSite
+    {
+        diagnostics::StackTraceElement call_site_;                                      ///< \brief Line of code performing the allocations.
+
+        std::atomic<std::int64_t> sample_count_{ 0 };                                   ///< \brief Number of sampled allocations.
+
+        std::atomic<std::int64_t> estimated_bytes_{ 0 };                                ///< \brief Estimated amount of bytes allocated.
+
+        std::atomic<std::int64_t> live_sample_count_{ 0 };                              ///< \brief Number of sampled allocations not deallocated yet.
+
+        std::atomic<std::int64_t> estimated_live_bytes_{ 0 };                           ///< \brief Estimated amount of bytes not deallocated yet.
+    };
+
+    /************************************************************************/
+    /* ALLOCATOR PROFILE                                                    */
+    /************************************************************************/
+
+    /// \brief Statistics collected by syntropy::MemoryProfiler about an allocator.
+    struct AllocatorProfile
+    {
+        std::string name_;                                                              ///< \brief Name of the allocator.
+
+        MemoryProfiler::Counters counters_;                                             ///< \brief Statistics about the allocator.
+
+        std::vector<MemoryProfiler::Counters*> contexts_;                               ///< \brief Statistics about the allocator context and each of its ancestors.
+    };
+
+}
+
+namespace
+{
+    /// \brief Sampling state of the current thread.
+    struct ThreadSampler
+    {
+        std::int64_t bytes_until_sample_{ -1 };                                         ///< \brief Bytes left before the next sample. Negative if the sampler was never initialized.
+
+        std::minstd_rand random_engine_{ std::random_device()() };                      ///< \brief Engine used to randomize the sampling interval.
+    };
+
+    thread_local ThreadSampler thread_sampler_;
+
+    /// \brief Marks a live block slot being written by the thread that claimed it.
+    void* const kBusySlot = reinterpret_cast<void*>(std::uintptr_t(1));
+
+    /// \brief Marks a live block slot whose block was deallocated. The slot can be claimed again.
+    void* const kFreeSlot = reinterpret_cast<void*>(std::uintptr_t(2));
+
+    /// \brief Get the first slot probed for a block in a table of slot_count slots (a power of two).
+    std::size_t GetSlotIndex(void* block, std::size_t slot_count)
+    {
+        // Blocks are at least 16 bytes apart: discard the lowest bits and scramble the remaining ones (Fibonacci hashing), so that neighbouring blocks spread over the table.
+
+        return std::size_t(((reinterpret_cast<std::uintptr_t>(block) >> 4) * 0x9E3779B97F4A7C15ull) >> 32) & (slot_count - 1);
+    }
+
+    /// \brief Get the histogram entry counting allocations of a given size.
+    std::size_t GetSizeClass(std::int64_t size)
+    {
+        if (size == 0)
+        {
+            return 0u;
+        }
+
+        auto size_class = std::size_t(syntropy::platform::BuiltIn::GetMostSignificantBit(uint64_t(size))) + 1u;
+
+        return std::min(size_class, syntropy::AllocationStatistics::kHistogramSize - 1u);
+    }
+
+    /// \brief Get the amount of bytes a sample of a given size stands for, when samples are taken every sampling_interval bytes on average.
+    std::int64_t GetSampleWeight(std::int64_t size, std::int64_t sampling_interval)
+    {
+        if (sampling_interval == 0)
+        {
+            return size;                                                                // Every allocation is sampled.
+        }
+
+        if (size == 0)
+        {
+            return sampling_interval;
+        }
+
+        // Bigger allocations are more likely to be sampled: scale each sample by the inverse of its probability.
+
+        auto probability = 1.0 - std::exp(-double(size) / double(sampling_interval));
+
+        return std::int64_t(double(size) / probability);
+    }
+
+    /// \brief Subtract the statistics of a baseline.
+    void Subtract(syntropy::AllocationStatistics& statistics, const syntropy::AllocationStatistics& baseline)
+    {
+        statistics.live_bytes_ -= baseline.live_bytes_;
+        statistics.live_count_ -= baseline.live_count_;
+        statistics.allocated_bytes_ -= baseline.allocated_bytes_;
+        statistics.allocation_count_ -= baseline.allocation_count_;
+        statistics.deallocation_count_ -= baseline.deallocation_count_;
+
+        for (auto index = 0u; index < syntropy::AllocationStatistics::kHistogramSize; ++index)
+        {
+            statistics.size_histogram_[index] -= baseline.size_histogram_[index];
+        }
+    }
+
+    /// \brief Subtract the statistics of each entry in a baseline.
+    void Subtract(std::map<std::string, syntropy::AllocationStatistics>& statistics, const std::map<std::string, syntropy::AllocationStatistics>& baseline)
+    {
+        for (auto&& entry : baseline)
+        {
+            Subtract(statistics[entry.first], entry.second);
+        }
+    }
+
+    /// \brief Convert statistics to JSON.
+    nlohmann::json ToJSON(const syntropy::AllocationStatistics& statistics, std::chrono::nanoseconds duration)
+    {
+        auto seconds = std::chrono::duration<double>(duration).count();
+
+        nlohmann::json json;
+
+        json["live_bytes"] = statistics.live_bytes_;
+        json["peak_live_bytes"] = statistics.peak_live_bytes_;
+        json["live_count"] = statistics.live_count_;
+        json["allocated_bytes"] = statistics.allocated_bytes_;
+        json["allocation_count"] = statistics.allocation_count_;
+        json["deallocation_count"] = statistics.deallocation_count_;
+        json["allocations_per_second"] = (seconds > 0.0) ? (statistics.allocation_count_ / seconds) : 0.0;
+        json["bytes_per_second"] = (seconds > 0.0) ? (statistics.allocated_bytes_ / seconds) : 0.0;
+        json["size_histogram"] = statistics.size_histogram_;
+
+        return json;
+    }
+}
+
+namespace syntropy
+{
+    /************************************************************************/
+    /* MEMORY SNAPSHOT                                                      */
+    /************************************************************************/
+
+    MemorySnapshot MemorySnapshot::Diff(const MemorySnapshot& baseline) const
+    {
+        auto diff = *this;
+
+        diff.duration_ = duration_ - baseline.duration_;
+
+        Subtract(diff.allocators_, baseline.allocators_);
+        Subtract(diff.contexts_, baseline.contexts_);
+
+        for (auto&& call_site : diff.call_sites_)
+        {
+            auto it = std::find_if(std::begin(baseline.call_sites_), std::end(baseline.call_sites_), [&call_site](const CallSiteStatistics& baseline_call_site)
+            {
+                return baseline_call_site.call_site_.file_ == call_site.call_site_.file_ && baseline_call_site.call_site_.line_ == call_site.call_site_.line_;
+            });
+
+            if (it != std::end(baseline.call_sites_))
+            {
+                call_site.sample_count_ -= it->sample_count_;
+                call_site.estimated_bytes_ -= it->estimated_bytes_;
+                call_site.live_sample_count_ -= it->live_sample_count_;
+                call_site.estimated_live_bytes_ -= it->estimated_live_bytes_;
+            }
+        }
+
+        std::sort(std::begin(diff.call_sites_), std::end(diff.call_sites_), [](const CallSiteStatistics& lhs, const CallSiteStatistics& rhs)
+        {
+            return lhs.estimated_bytes_ > rhs.estimated_bytes_;
+        });
+
+        return diff;
+    }
+
+    /************************************************************************/
+    /* MEMORY PROFILER                                                      */
+    /************************************************************************/
+
+    std::atomic<bool> MemoryProfiler::enabled_{ false };
+
+    std::atomic<std::size_t> MemoryProfiler::live_count_{ 0 };
+
+    MemoryProfiler& MemoryProfiler::GetInstance()
+    {
+        static MemoryProfiler instance;
+        return instance;
+    }
+
+    MemoryProfiler::MemoryProfiler()
+        : start_time_(std::chrono::steady_clock::now())
+        , live_blocks_(std::make_unique<LiveBlockSlot[]>(kSlotCount))
+    {
+
+    }
+
+    void MemoryProfiler::Enable(Bytes sampling_interval)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        sampling_interval_.store(std::int64_t(std::size_t(sampling_interval)), std::memory_order_relaxed);
+
+        if (!enabled_.exchange(true, std::memory_order_relaxed))
+        {
+            start_time_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    void MemoryProfiler::Disable()
+    {
+        enabled_.store(false, std::memory_order_relaxed);
+    }
+
+    void MemoryProfiler::Reset()
+    {
+        // Profiles, contexts and call sites are referenced by allocators and live blocks: clear them rather than destroying them.
+
+        for (auto index = std::size_t(0); index < kSlotCount; ++index)
+        {
+            live_blocks_[index].block_.store(nullptr, std::memory_order_relaxed);
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(overflow_mutex_);
+
+            overflow_blocks_.clear();
+
+            overflow_count_.store(0, std::memory_order_relaxed);
+        }
+
+        live_count_.store(0, std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for (auto&& profile : profiles_)
+        {
+            profile->counters_.Clear();
+        }
+
+        for (auto&& context : contexts_)
+        {
+            context.second->Clear();
+        }
+
+        for (auto&& call_site : call_sites_)
+        {
+            call_site.second->sample_count_.store(0, std::memory_order_relaxed);
+            call_site.second->estimated_bytes_.store(0, std::memory_order_relaxed);
+            call_site.second->live_sample_count_.store(0, std::memory_order_relaxed);
+            call_site.second->estimated_live_bytes_.store(0, std::memory_order_relaxed);
+        }
+
+        start_time_ = std::chrono::steady_clock::now();
+    }
+
+    MemorySnapshot MemoryProfiler::GetSnapshot() const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        MemorySnapshot snapshot;
+
+        snapshot.duration_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_);
+
+        for (auto&& profile : profiles_)
+        {
+            profile->counters_.Gather(snapshot.allocators_[profile->name_]);
+        }
+
+        for (auto&& context : contexts_)
+        {
+            context.second->Gather(snapshot.contexts_[context.first]);
+        }
+
+        for (auto&& call_site : call_sites_)
+        {
+            auto& source = *call_site.second;
+
+            if (auto sample_count = source.sample_count_.load(std::memory_order_relaxed))
+            {
+                CallSiteStatistics statistics;
+
+                statistics.call_site_ = source.call_site_;
+                statistics.sample_count_ = sample_count;
+                statistics.estimated_bytes_ = source.estimated_bytes_.load(std::memory_order_relaxed);
+                statistics.live_sample_count_ = source.live_sample_count_.load(std::memory_order_relaxed);
+                statistics.estimated_live_bytes_ = source.estimated_live_bytes_.load(std::memory_order_relaxed);
+
+                snapshot.call_sites_.emplace_back(std::move(statistics));
+            }
+        }
+
+        std::sort(std::begin(snapshot.call_sites_), std::end(snapshot.call_sites_), [](const CallSiteStatistics& lhs, const CallSiteStatistics& rhs)
+        {
+            return lhs.estimated_bytes_ > rhs.estimated_bytes_;
+        });
+
+        return snapshot;
+    }
+
+    void MemoryProfiler::OnAllocate(Allocator& allocator, void* block, Bytes size, const diagnostics::StackTrace& stack_trace)
+    {
+        if (!block)
+        {
+            return;
+        }
+
+        auto& profile = GetProfile(allocator);
+
+        auto live_block = LiveBlock{ std::int64_t(std::size_t(size)), &profile, nullptr, 0 };
+
+        auto size_class = GetSizeClass(live_block.size_);
+
+        profile.counters_.Allocate(live_block.size_, size_class);
+
+        for (auto&& context : profile.contexts_)
+        {
+            context->Allocate(live_block.size_, size_class);
+        }
+
+        // Sample the call site once every few bytes, with exponentially-distributed intervals so that periodic allocation patterns cannot skew the samples.
+
+        auto sampling_interval = sampling_interval_.load(std::memory_order_relaxed);
+
+        if (thread_sampler_.bytes_until_sample_ < 0)
+        {
+            thread_sampler_.bytes_until_sample_ = std::int64_t(std::exponential_distribution<double>(1.0 / std::max(sampling_interval, std::int64_t(1)))(thread_sampler_.random_engine_));
+        }
+
+        thread_sampler_.bytes_until_sample_ -= live_block.size_;
+
+        if (thread_sampler_.bytes_until_sample_ < 0 || sampling_interval == 0)
+        {
+            live_block.call_site_ = &GetCallSite(stack_trace);
+            live_block.weight_ = GetSampleWeight(live_block.size_, sampling_interval);
+
+            live_block.call_site_->sample_count_.fetch_add(1, std::memory_order_relaxed);
+            live_block.call_site_->estimated_bytes_.fetch_add(live_block.weight_, std::memory_order_relaxed);
+            live_block.call_site_->live_sample_count_.fetch_add(1, std::memory_order_relaxed);
+            live_block.call_site_->estimated_live_bytes_.fetch_add(live_block.weight_, std::memory_order_relaxed);
+
+            thread_sampler_.bytes_until_sample_ = -1;                                   // Draw a new interval upon next allocation.
+        }
+
+        live_count_.fetch_add(1, std::memory_order_relaxed);                            // Before the block is published: any deallocation follows this point.
+
+        InsertLiveBlock(block, live_block);
+    }
+
+    void MemoryProfiler::OnFree(void* block)
+    {
+        if (!block)
+        {
+            return;
+        }
+
+        LiveBlock live_block;
+
+        if (!EraseLiveBlock(block, live_block))
+        {
+            return;                                                                     // The block was allocated before the profiler was enabled or reset.
+        }
+
+        live_count_.fetch_sub(1, std::memory_order_relaxed);
+
+        live_block.allocator_->counters_.Free(live_block.size_);
+
+        for (auto&& context : live_block.allocator_->contexts_)
+        {
+            context->Free(live_block.size_);
+        }
+
+        if (live_block.call_site_)
+        {
+            live_block.call_site_->live_sample_count_.fetch_sub(1, std::memory_order_relaxed);
+            live_block.call_site_->estimated_live_bytes_.fetch_sub(live_block.weight_, std::memory_order_relaxed);
+        }
+    }
+
+    AllocatorProfile& MemoryProfiler::GetProfile(Allocator& allocator)
+    {
+        if (auto profile = allocator.profile_.load(std::memory_order_acquire))
+        {
+            return *profile;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (auto profile = allocator.profile_.load(std::memory_order_relaxed))
+        {
+            return *profile;                                                            // Created by another thread in the meantime.
+        }
+
+        auto profile = std::make_unique<AllocatorProfile>();
+
+        profile->name_ = allocator.GetName().GetString();
+
+        // Each context contributes to the statistics of its ancestors as well: "Memory|Foo" updates both "Memory|Foo" and "Memory".
+
+        auto context = Context(allocator).GetName().GetString();
+
+        for (auto separator = context.size(); separator != std::string::npos; separator = (separator > 0) ? context.rfind(Context::kSeparator, separator - 1) : std::string::npos)
+        {
+            profile->contexts_.emplace_back(&GetContextCounters(context.substr(0, separator)));
+        }
+
+        allocator.profile_.store(profile.get(), std::memory_order_release);
+
+        profiles_.emplace_back(std::move(profile));
+
+        return *profiles_.back();
+    }
+
+    MemoryProfiler::Counters& MemoryProfiler::GetContextCounters(const std::string& context)
+    {
+        auto& counters = contexts_[context];
+
+        if (!counters)
+        {
+            counters = std::make_unique<Counters>();
+        }
+
+        return *counters;
+    }
+
+    MemoryProfiler::CallSite& MemoryProfiler::GetCallSite(const diagnostics::StackTrace& stack_trace)
+    {
+        static const diagnostics::StackTraceElement kUnknownCallSite{};
+
+        auto& element = stack_trace.elements_.empty() ? kUnknownCallSite : stack_trace.elements_.front();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        auto& call_site = call_sites_[std::make_pair(element.file_, element.line_)];
+
+        if (!call_site)
+        {
+            call_site = std::make_unique<CallSite>();
+
+            call_site->call_site_ = element;
+        }
+
+        return *call_site;
+    }
+
+    void MemoryProfiler::InsertLiveBlock(void* block, const LiveBlock& live_block)
+    {
+        // Claim the first slot that was never used or whose block was deallocated. Slots never go back to unused (except on Reset), hence a lookup can stop at the first unused slot.
+
+        for (auto probe = std::size_t(0), index = GetSlotIndex(block, kSlotCount); probe < kMaxProbeCount; ++probe, index = (index + 1) & (kSlotCount - 1))
+        {
+            auto& slot = live_blocks_[index];
+
+            auto current = slot.block_.load(std::memory_order_relaxed);
+
+            if ((current == nullptr || current == kFreeSlot) && slot.block_.compare_exchange_strong(current, kBusySlot, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                slot.live_block_ = live_block;
+
+                slot.block_.store(block, std::memory_order_release);
+                return;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(overflow_mutex_);
+
+        overflow_blocks_[block] = live_block;
+
+        overflow_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool MemoryProfiler::EraseLiveBlock(void* block, LiveBlock& live_block)
+    {
+        for (auto probe = std::size_t(0), index = GetSlotIndex(block, kSlotCount); probe < kMaxProbeCount; ++probe, index = (index + 1) & (kSlotCount - 1))
+        {
+            auto& slot = live_blocks_[index];
+
+            auto current = slot.block_.load(std::memory_order_acquire);
+
+            if (current == block)
+            {
+                live_block = slot.live_block_;
+
+                slot.block_.store(kFreeSlot, std::memory_order_release);               // The owner of the block is the only thread that can free it: no other thread competes for the slot.
+                return true;
+            }
+
+            if (current == nullptr)
+            {
+                break;
+            }
+        }
+
+        if (overflow_count_.load(std::memory_order_relaxed) == 0)
+        {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(overflow_mutex_);
+
+        auto it = overflow_blocks_.find(block);
+
+        if (it == overflow_blocks_.end())
+        {
+            return false;
+        }
+
+        live_block = it->second;
+
+        overflow_blocks_.erase(it);
+
+        overflow_count_.fetch_sub(1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    MemoryProfiler& GetMemoryProfiler()
+    {
+        return MemoryProfiler::GetInstance();
+    }
+
+    bool ExportMemorySnapshotToJSON(const MemorySnapshot& snapshot, const std::string& path)
+    {
+        nlohmann::json json;
+
+        json["duration_ns"] = snapshot.duration_.count();
+
+        for (auto&& allocator : snapshot.allocators_)
+        {
+            auto entry = ToJSON(allocator.second, snapshot.duration_);
+
+            entry["name"] = allocator.first;
+
+            json["allocators"].push_back(std::move(entry));
+        }
+
+        for (auto&& context : snapshot.contexts_)
+        {
+            auto entry = ToJSON(context.second, snapshot.duration_);
+
+            entry["context"] = context.first;
+
+            json["contexts"].push_back(std::move(entry));
+        }
+
+        for (auto&& call_site : snapshot.call_sites_)
+        {
+            nlohmann::json entry;
+
+            entry["file"] = call_site.call_site_.file_;
+            entry["function"] = call_site.call_site_.function_;
+            entry["line"] = call_site.call_site_.line_;
+            entry["sample_count"] = call_site.sample_count_;
+            entry["estimated_bytes"] = call_site.estimated_bytes_;
+            entry["live_sample_count"] = call_site.live_sample_count_;
+            entry["estimated_live_bytes"] = call_site.estimated_live_bytes_;
+
+            json["call_sites"].push_back(std::move(entry));
+        }
+
+        std::ofstream file(path);
+
+        file << json.dump(4);
+
+        return !!file;
+    }
+
+}
@@ -44,7 +44,7 @@ namespace syntropy
         }
         else
         {
-            size_ = size_ & Bytes(kBusyBlockFlag);
+            size_ = size_ & Bytes(~kBusyBlockFlag);
         }
     }
 
@@ -89,28 +89,60 @@ namespace syntropy
         return MemoryAddress(this) + GetSize();
     }
 
+    /************************************************************************/
+    /* TWO LEVEL SEGREGATED FIT ALLOCATOR :: THREAD CACHE BINDING           */
+    /************************************************************************/
+
+    TwoLevelSegregatedFitAllocator::ThreadCacheBinding::~ThreadCacheBinding()
+    {
+        for (auto&& entry : entries_)
+        {
+            if (auto handle = entry.handle_.lock())
+            {
+                handle->allocator_->ReleaseThreadCache(*handle);
+            }
+        }
+    }
+
     /************************************************************************/
     /* TWO LEVEL SEGREGATED FIT ALLOCATOR                                   */
     /************************************************************************/
     
     const Bytes TwoLevelSegregatedFitAllocator::kMinimumBlockSize(32);
 
+    TwoLevelSegregatedFitAllocator::CachedBlock* const TwoLevelSegregatedFitAllocator::kReleasedCache = reinterpret_cast<CachedBlock*>(uintptr_t(1));
+
+    thread_local TwoLevelSegregatedFitAllocator::ThreadCacheBinding TwoLevelSegregatedFitAllocator::thread_binding_;
+
+    std::atomic<uint64_t> TwoLevelSegregatedFitAllocator::next_allocator_id_{ 0 };
+
     TwoLevelSegregatedFitAllocator::TwoLevelSegregatedFitAllocator(const HashedString& name, Bytes capacity, size_t second_level_index)
         : Allocator(name)
-        , allocator_(capacity, Alignment(VirtualMemory::GetPageSize()))
+        , id_(next_allocator_id_.fetch_add(1, std::memory_order_relaxed))
+        , memory_buffer_(capacity)
+        , memory_range_(static_cast<const VirtualMemoryRange&>(memory_buffer_))
+        , commit_head_(memory_range_.Begin())
+        , allocator_(memory_range_)
     {
         Initialize(second_level_index);
     }
 
     TwoLevelSegregatedFitAllocator::TwoLevelSegregatedFitAllocator(const HashedString& name, const MemoryRange& memory_range, size_t second_level_index)
         : Allocator(name)
-        , allocator_(memory_range, Alignment(VirtualMemory::GetPageSize()))
+        , id_(next_allocator_id_.fetch_add(1, std::memory_order_relaxed))
+        , memory_range_(memory_range)
+        , commit_head_(memory_range_.End())
+        , allocator_(memory_range_)
     {
         Initialize(second_level_index);
     }
 
     TwoLevelSegregatedFitAllocator::TwoLevelSegregatedFitAllocator(TwoLevelSegregatedFitAllocator&& other)
         : Allocator(std::move(other))
+        , id_(other.id_)
+        , memory_buffer_(std::move(other.memory_buffer_))
+        , memory_range_(other.memory_range_)
+        , commit_head_(other.commit_head_)
         , allocator_(std::move(other.allocator_))
         , last_block_(std::move(other.last_block_))
         , first_level_count_(other.first_level_count_)
@@ -118,17 +150,38 @@ namespace syntropy
         , first_level_bitmap_(other.first_level_bitmap_)
         , second_level_bitmap_(std::move(other.second_level_bitmap_))
         , free_lists_(std::move(other.free_lists_))
+        , thread_caches_list_(std::move(other.thread_caches_list_))
+        , free_thread_caches_(std::move(other.free_thread_caches_))
     {
+        // Threads find their caches by allocator id, which is moved along with the caches: the moved-from allocator must not match them anymore.
 
+        other.id_ = next_allocator_id_.fetch_add(1, std::memory_order_relaxed);
+
+        for (auto&& cache : thread_caches_list_)
+        {
+            cache->allocator_ = this;
+        }
     }
 
     void* TwoLevelSegregatedFitAllocator::Allocate(Bytes size)
     {
+        if (size > 0_Bytes && size <= kThreadCacheGranularity * kThreadCacheClassCount)
+        {
+            return AllocateCached((std::size_t(size) - 1) / std::size_t(kThreadCacheGranularity));
+        }
+
         // Structure of the block:
         // || HEADER | BASE_POINTER | ... BLOCK ... ||
 
+        std::lock_guard<std::mutex> lock(mutex_);
+
         auto block = GetFreeBlockBySize(size + Bytes(sizeof(uintptr_t)));           // Reserve enough space for the block and the base pointer.
 
+        if (!block)
+        {
+            return nullptr;
+        }
+
         *reinterpret_cast<BlockHeader**>(block->begin()) = block;                   // The base pointer points to the header.
 
         return MemoryAddress(block->begin()) + Bytes(sizeof(uintptr_t));
@@ -139,9 +192,16 @@ namespace syntropy
         // Structure of the block:
         // || HEADER | PADDING | BASE_POINTER | ... ALIGNED BLOCK ... ||
 
-        auto block = GetFreeBlockBySize(size + alignment - 1_Bytes + Bytes(sizeof(uintptr_t)));                         // Reserve enough space for the block, the base pointer and the eventual padding.
+        std::lock_guard<std::mutex> lock(mutex_);
 
-        auto aligned_begin = MemoryAddress(block->begin() + Bytes(sizeof(uintptr_t))).GetAligned(alignment);            // First address of the requested aligned block.
+        auto block = GetFreeBlockBySize(size + Bytes(std::size_t(alignment)) - 1_Bytes + Bytes(sizeof(uintptr_t)));     // Reserve enough space for the block, the base pointer and the eventual padding.
+
+        if (!block)
+        {
+            return nullptr;
+        }
+
+        auto aligned_begin = (MemoryAddress(block->begin()) + Bytes(sizeof(uintptr_t))).GetAligned(alignment);         // First address of the requested aligned block.
 
         *(aligned_begin - Bytes(sizeof(uintptr_t))).As<BlockHeader*>() = block;                                         // The base pointer points to the header.
 
@@ -150,18 +210,27 @@ namespace syntropy
 
     void TwoLevelSegregatedFitAllocator::Free(void* block)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-
         // The base pointer is guaranteed to be adjacent to the allocated block.
 
-        auto base_pointer = (MemoryAddress(block) - Bytes(sizeof(uintptr_t))).As<BlockHeader*>();
+        auto base_pointer = *(MemoryAddress(block) - Bytes(sizeof(uintptr_t))).As<uintptr_t>();
+
+        if (base_pointer & kCachedBlockFlag)
+        {
+            auto owner = GetCachedBlockOwner(block);
+
+            FreeCached(block, *reinterpret_cast<ThreadCache*>(owner & ~kSizeClassMask), owner & kSizeClassMask);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
 
-        PushBlock(*base_pointer);
+            PushBlock(reinterpret_cast<BlockHeader*>(base_pointer));
+        }
     }
 
     bool TwoLevelSegregatedFitAllocator::Owns(void* block) const
     {
-        return GetRange().Contains(block);
+        return GetRange().Contains(MemoryAddress(block));
     }
 
     Bytes TwoLevelSegregatedFitAllocator::GetMaxAllocationSize() const
@@ -169,16 +238,29 @@ namespace syntropy
         return GetRange().GetSize();
     }
 
-    const MemoryRange& TwoLevelSegregatedFitAllocator::GetRange() const
+    MemoryRange TwoLevelSegregatedFitAllocator::GetRange() const
+    {
+        return memory_range_;
+    }
+
+    void TwoLevelSegregatedFitAllocator::FlushThreadCache()
     {
-        return allocator_.GetRange();
+        if (auto cache = FindThreadCache())
+        {
+            CollectRemoteBlocks(*cache);
+
+            for (size_t size_class = 0; size_class < kThreadCacheClassCount; ++size_class)
+            {
+                DrainThreadCache(*cache, size_class, cache->free_counts_[size_class]);
+            }
+        }
     }
 
     void TwoLevelSegregatedFitAllocator::Initialize(size_t second_level_count)
     {
         last_block_ = nullptr;
 
-        first_level_count_ = Math::FloorLog2(std::size_t(allocator_.GetRange().GetSize())) + 1u;
+        first_level_count_ = FloorLog2(std::size_t(memory_range_.GetSize())) + 1u;
         second_level_count_ = second_level_count;
 
         // Ensure that the bitmaps can store at least one bit per first or second class.
@@ -192,19 +274,251 @@ namespace syntropy
         second_level_bitmap_.resize(first_level_count_);
     }
 
+    TwoLevelSegregatedFitAllocator::ThreadCache* TwoLevelSegregatedFitAllocator::FindThreadCache()
+    {
+        for (auto&& entry : thread_binding_.entries_)
+        {
+            if (entry.allocator_id_ == id_)
+            {
+                return entry.cache_;
+            }
+        }
+
+        return nullptr;
+    }
+
+    TwoLevelSegregatedFitAllocator::ThreadCache& TwoLevelSegregatedFitAllocator::GetThreadCache()
+    {
+        if (auto cache = FindThreadCache())
+        {
+            return *cache;
+        }
+
+        auto& entries = thread_binding_.entries_;
+
+        // Drop the entries whose allocator was destroyed in the meantime.
+
+        entries.erase(std::remove_if(std::begin(entries), std::end(entries), [](const ThreadCacheBinding::Entry& entry)
+        {
+            return entry.handle_.expired();
+        }), std::end(entries));
+
+        // Recycle a cache released by a thread that exited, if any.
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (free_thread_caches_.empty())
+        {
+            thread_caches_list_.emplace_back(std::make_shared<ThreadCache>());
+
+            thread_caches_list_.back()->allocator_ = this;
+
+            free_thread_caches_.emplace_back(thread_caches_list_.back().get());
+        }
+
+        auto cache = free_thread_caches_.back();
+
+        free_thread_caches_.pop_back();
+
+        cache->remote_blocks_.store(nullptr, std::memory_order_relaxed);           // Remote frees go through the remote list again. See FreeCached().
+
+        auto handle = std::find_if(std::begin(thread_caches_list_), std::end(thread_caches_list_), [cache](const std::shared_ptr<ThreadCache>& thread_cache)
+        {
+            return thread_cache.get() == cache;
+        });
+
+        entries.emplace_back(ThreadCacheBinding::Entry{ id_, cache, *handle });
+
+        return *cache;
+    }
+
+    void* TwoLevelSegregatedFitAllocator::AllocateCached(size_t size_class)
+    {
+        auto& cache = GetThreadCache();
+
+        if (!cache.free_lists_[size_class])
+        {
+            CollectRemoteBlocks(cache);
+        }
+
+        if (!cache.free_lists_[size_class])
+        {
+            RefillThreadCache(cache, size_class);
+        }
+
+        auto block = cache.free_lists_[size_class];
+
+        if (block)
+        {
+            cache.free_lists_[size_class] = block->next_;
+
+            --cache.free_counts_[size_class];
+        }
+
+        return block;
+    }
+
+    void TwoLevelSegregatedFitAllocator::FreeCached(void* block, ThreadCache& owner, size_t size_class)
+    {
+        if (&owner == FindThreadCache())
+        {
+            PushCachedBlock(owner, block, size_class);
+
+            if (owner.free_counts_[size_class] > 2 * kThreadCacheBatchSize)
+            {
+                DrainThreadCache(owner, size_class, kThreadCacheBatchSize);         // Bound the memory retained by each thread.
+            }
+        }
+        else
+        {
+            // Push the block on the remote list of the owner: the owner thread will collect it later.
+
+            auto remote_block = new (block) CachedBlock{ owner.remote_blocks_.load(std::memory_order_relaxed) };
+
+            while (remote_block->next_ != kReleasedCache && !owner.remote_blocks_.compare_exchange_weak(remote_block->next_, remote_block, std::memory_order_release, std::memory_order_relaxed));
+
+            if (remote_block->next_ == kReleasedCache)
+            {
+                // The owner thread exited: nobody would ever collect the block, hence return it to the shared allocator, unless the cache was bound again meanwhile.
+
+                std::lock_guard<std::mutex> lock(mutex_);
+
+                if (owner.remote_blocks_.load(std::memory_order_relaxed) == kReleasedCache)
+                {
+                    ReturnCachedBlock(remote_block);
+                }
+                else
+                {
+                    remote_block->next_ = owner.remote_blocks_.load(std::memory_order_relaxed);
+
+                    while (!owner.remote_blocks_.compare_exchange_weak(remote_block->next_, remote_block, std::memory_order_release, std::memory_order_relaxed));
+                }
+            }
+        }
+    }
+
+    void TwoLevelSegregatedFitAllocator::RefillThreadCache(ThreadCache& cache, size_t size_class)
+    {
+        // Structure of the block:
+        // || HEADER | OWNER | BASE_POINTER | ... BLOCK ... ||
+
+        auto size = kThreadCacheGranularity * (size_class + 1) + Bytes(2 * sizeof(uintptr_t));        // Reserve enough space for the block, the owner and the base pointer.
+
+        auto owner = reinterpret_cast<uintptr_t>(&cache) | size_class;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (size_t index = 0; index < kThreadCacheBatchSize; ++index)
+        {
+            auto block = GetFreeBlockBySize(size);
+
+            if (!block)
+            {
+                break;
+            }
+
+            auto payload = MemoryAddress(block->begin());
+
+            *payload.As<uintptr_t>() = owner;
+            *(payload + Bytes(sizeof(uintptr_t))).As<uintptr_t>() = reinterpret_cast<uintptr_t>(block) | kCachedBlockFlag;
+
+            PushCachedBlock(cache, payload + Bytes(2 * sizeof(uintptr_t)), size_class);
+        }
+    }
+
+    void TwoLevelSegregatedFitAllocator::DrainThreadCache(ThreadCache& cache, size_t size_class, size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (; count > 0 && cache.free_lists_[size_class]; --count)
+        {
+            auto block = cache.free_lists_[size_class];
+
+            cache.free_lists_[size_class] = block->next_;
+
+            --cache.free_counts_[size_class];
+
+            ReturnCachedBlock(block);
+        }
+    }
+
+    void TwoLevelSegregatedFitAllocator::ReturnCachedBlock(CachedBlock* block)
+    {
+        PushBlock(reinterpret_cast<BlockHeader*>(*(MemoryAddress(block) - Bytes(sizeof(uintptr_t))).As<uintptr_t>() & ~kCachedBlockFlag));
+    }
+
+    void TwoLevelSegregatedFitAllocator::CollectRemoteBlocks(ThreadCache& cache)
+    {
+        if (!cache.remote_blocks_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        auto block = cache.remote_blocks_.exchange(nullptr, std::memory_order_acquire);
+
+        while (block)
+        {
+            auto next = block->next_;
+
+            PushCachedBlock(cache, block, GetCachedBlockOwner(block) & kSizeClassMask);
+
+            block = next;
+        }
+    }
+
+    void TwoLevelSegregatedFitAllocator::ReleaseThreadCache(ThreadCache& cache)
+    {
+        CollectRemoteBlocks(cache);
+
+        for (size_t size_class = 0; size_class < kThreadCacheClassCount; ++size_class)
+        {
+            DrainThreadCache(cache, size_class, cache.free_counts_[size_class]);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Blocks freed remotely after the collection above are returned to the shared allocator as well: from now on remote frees do the same.
+
+        for (auto block = cache.remote_blocks_.exchange(kReleasedCache, std::memory_order_acquire); block;)
+        {
+            auto next = block->next_;
+
+            ReturnCachedBlock(block);
+
+            block = next;
+        }
+
+        free_thread_caches_.emplace_back(&cache);
+    }
+
+    void TwoLevelSegregatedFitAllocator::PushCachedBlock(ThreadCache& cache, void* block, size_t size_class)
+    {
+        cache.free_lists_[size_class] = new (block) CachedBlock{ cache.free_lists_[size_class] };
+
+        ++cache.free_counts_[size_class];
+    }
+
+    uintptr_t& TwoLevelSegregatedFitAllocator::GetCachedBlockOwner(void* block)
+    {
+        return *(MemoryAddress(block) - Bytes(2 * sizeof(uintptr_t))).As<uintptr_t>();
+    }
+
     TwoLevelSegregatedFitAllocator::BlockHeader* TwoLevelSegregatedFitAllocator::GetFreeBlockBySize(Bytes size)
     {
         SYNTROPY_PRECONDITION(size > 0_Bytes);
 
         size += Bytes(sizeof(BlockHeader));                                         // Reserve space for the header.
         size = std::max(size, kMinimumBlockSize);                                   // The size must be at least as big as the minimum size allowed.
-        size = Math::Ceil(size, Bytes(BlockHeader::kSizeMask) + 1_Bytes);           // The size must not interfere with the status bits of the block.
+        size = Bytes(Ceil(std::size_t(size), sizeof(BlockHeader)));                 // Keep headers aligned. The size doesn't interfere with the status bits of the block either.
 
         size_t first_level_index;
         size_t second_level_index;
 
-        std::lock_guard<std::mutex> lock(mutex_);
-
         // Start searching from the next class (the current free list may have blocks that are smaller than the requested size)
         GetFreeListIndex(size, first_level_index, second_level_index, true);
 
@@ -364,7 +678,29 @@ namespace syntropy
 
     TwoLevelSegregatedFitAllocator::BlockHeader* TwoLevelSegregatedFitAllocator::AllocateBlock(Bytes size)
     {
-        auto block = reinterpret_cast<BlockHeader*>(allocator_.Allocate(size));
+        auto memory_block = allocator_.Allocate(size);
+
+        if (!memory_block)
+        {
+            return nullptr;                                                     // The allocator is exhausted.
+        }
+
+        if (memory_block.End() > commit_head_)
+        {
+            // Commit the memory up to the new block: the underlying linear allocator returns new blocks at increasingly higher addresses.
+
+            auto commit_end = std::min(commit_head_ + Bytes(Ceil(std::size_t(memory_block.End() - commit_head_), std::size_t(kCommitGranularity))), memory_range_.End());
+
+            if (!VirtualMemory::Commit(MemoryRange(commit_head_, commit_end)))  // Kernel call.
+            {
+                allocator_.Deallocate(memory_block);                            // Roll back: the block is the last one allocated and was never touched.
+                return nullptr;
+            }
+
+            commit_head_ = commit_end;
+        }
+
+        auto block = memory_block.Begin().As<BlockHeader>();
 
         block->SetSize(size);
         block->SetBusy(true);
@@ -464,10 +800,10 @@ namespace syntropy
         if (roundup)
         {
             // Round up to the next class size.
-            size = size + Bytes(size_t(1u) << (Math::FloorLog2(std::size_t(size)) - second_level_count_)) - 1_Bytes;
+            size = size + Bytes(size_t(1u) << (FloorLog2(std::size_t(size)) - second_level_count_)) - 1_Bytes;
         }
 
-        first_level_index = Math::FloorLog2(std::size_t(size));
+        first_level_index = FloorLog2(std::size_t(size));
 
         second_level_index = (std::size_t(size) ^ (std::size_t(1u) << first_level_index)) >> (first_level_index - second_level_count_);
     }
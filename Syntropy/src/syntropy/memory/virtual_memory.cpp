@@ -6,8 +6,19 @@
 
 #include "syntropy/diagnostics/diagnostics.h"
 
+#include <atomic>
+
 namespace syntropy
 {
+    /************************************************************************/
+    /* VIRTUAL MEMORY :: LARGE PAGES                                        */
+    /************************************************************************/
+
+    /// \brief Number of large pages requested via VirtualMemory::ReserveLarge().
+    static std::atomic<std::size_t> requested_large_pages{ 0 };
+
+    /// \brief Number of large pages whose request the system accepted, whether or not it actually backs them with large pages.
+    static std::atomic<std::size_t> accepted_large_pages{ 0 };
 
     /************************************************************************/
     /* VIRTUAL MEMORY                                                       */
@@ -48,5 +59,55 @@ namespace syntropy
         return platform::PlatformMemory::Decommit(memory_range);
     }
 
+    Bytes VirtualMemory::GetLargePageSize()
+    {
+        return platform::PlatformMemory::GetLargePageSize();
+    }
+
+    MemoryRange VirtualMemory::ReserveLarge(Bytes size)
+    {
+        auto large_page_size = GetLargePageSize();
+
+        if (large_page_size == 0_Bytes)
+        {
+            return Reserve(size);                                                   // Large pages are not supported at all.
+        }
+
+        auto page_count = DivCeil(std::size_t(size), std::size_t(large_page_size));
+
+        size = large_page_size * page_count;
+
+        requested_large_pages.fetch_add(page_count, std::memory_order_relaxed);
+
+        if (auto memory_range = platform::PlatformMemory::ReserveLarge(size))
+        {
+            accepted_large_pages.fetch_add(page_count, std::memory_order_relaxed);
+
+            return memory_range;
+        }
+
+        return Reserve(size);                                                       // Fall back to regular pages.
+    }
+
+    MemoryRange VirtualMemory::Reserve(Bytes size, VirtualMemoryPageMode page_mode)
+    {
+        return (page_mode == VirtualMemoryPageMode::kLarge) ? ReserveLarge(size) : Reserve(size);
+    }
+
+    Bytes VirtualMemory::GetLargePageResidentSize(const MemoryRange& memory_range)
+    {
+        return platform::PlatformMemory::GetLargePageResidentSize(memory_range);
+    }
+
+    LargePageCounters VirtualMemory::GetLargePageCounters()
+    {
+        LargePageCounters counters;
+
+        counters.requested_pages_ = requested_large_pages.load(std::memory_order_relaxed);
+        counters.accepted_pages_ = accepted_large_pages.load(std::memory_order_relaxed);
+
+        return counters;
+    }
+
 }
 
@@ -0,0 +1,49 @@
+#define SYNTROPY_COMPILER_INCLUDE_GUARD
+
+#include "syntropy/platform/compiler/gcc.h"
+
+#undef SYNTROPY_COMPILER_INCLUDE_GUARD
+
+#if defined(__GNUC__) && !defined(_MSC_VER)
+
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+namespace syntropy::platform
+{
+    /************************************************************************/
+    /* PLATFORM BUILTIN                                                     */
+    /************************************************************************/
+
+    uint64_t PlatformBuiltIn::GetMostSignificantBit(uint64_t number)
+    {
+        return static_cast<uint64_t>(63 - __builtin_clzll(number));
+    }
+
+    uint64_t PlatformBuiltIn::GetLeastSignificantBit(uint64_t number)
+    {
+        return static_cast<uint64_t>(__builtin_ctzll(number));
+    }
+
+    float PlatformBuiltIn::GetFastInvSqrt(float number)
+    {
+#if defined(__SSE__)
+
+        __m128 mm_number = _mm_load_ss(&number);
+
+        _mm_store_ss(&number, _mm_rsqrt_ss(mm_number));
+
+        return number;
+
+#else
+
+        return 1.0f / std::sqrt(number);
+
+#endif
+    }
+}
+
+#endif
@@ -0,0 +1,816 @@
+#define SYNTROPY_OS_INCLUDE_GUARD
+
+#include "syntropy/platform/os/linux_os.h"
+
+#undef SYNTROPY_OS_INCLUDE_GUARD
+
+#ifdef __linux__
+
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <sys/statvfs.h>
+#include <sys/sysinfo.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <execinfo.h>
+#include <cxxabi.h>
+
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+
+namespace syntropy::platform
+{
+    /************************************************************************/
+    /* LINUX SYSFS                                                          */
+    /************************************************************************/
+
+    /// \brief Read the first line of a pseudo-file such as the ones exposed by /sys and /proc.
+    /// \return Returns the first line of the file. If the file couldn't be read returns an empty string.
+    static std::string ReadLine(const std::string& path)
+    {
+        std::ifstream file(path);
+
+        std::string line;
+
+        std::getline(file, line);
+
+        return line;
+    }
+
+    /// \brief Parse a CPU list in the format used by /sys (for example "0-3,8,10-11").
+    /// \return Returns the index of each CPU in the list.
+    static std::vector<size_t> ParseCPUList(const std::string& cpu_list)
+    {
+        std::vector<size_t> cpus;
+
+        std::istringstream stream(cpu_list);
+
+        for (std::string range; std::getline(stream, range, ',');)
+        {
+            if (range.empty())
+            {
+                continue;
+            }
+
+            auto separator = range.find('-');
+
+            auto first = std::stoul(range.substr(0, separator));
+            auto last = (separator != std::string::npos) ? std::stoul(range.substr(separator + 1)) : first;
+
+            for (auto cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.emplace_back(cpu);
+            }
+        }
+
+        return cpus;
+    }
+
+    /// \brief Get the online CPUs in the system.
+    static std::vector<size_t> GetOnlineCPUs()
+    {
+        return ParseCPUList(ReadLine("/sys/devices/system/cpu/online"));
+    }
+
+    /// \brief Get the path of the sysfs directory of a CPU.
+    static std::string GetCPUPath(size_t cpu)
+    {
+        return "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    }
+
+    /// \brief Get the lowest CPU index in a CPU list, used to identify the domain the list describes.
+    /// \return Returns the lowest CPU index in the list. If the list is empty returns fallback.
+    static size_t GetDomainKey(const std::string& cpu_list, size_t fallback)
+    {
+        auto cpus = ParseCPUList(cpu_list);
+
+        return cpus.empty() ? fallback : *std::min_element(std::begin(cpus), std::end(cpus));
+    }
+
+    /// \brief Get the NUMA node a CPU belongs to, by looking for the "nodeN" link in its sysfs directory.
+    static size_t GetCPUNode(size_t cpu)
+    {
+        auto node = size_t(0);
+
+        if (auto directory = opendir(GetCPUPath(cpu).c_str()))
+        {
+            while (auto entry = readdir(directory))
+            {
+                auto name = std::string(entry->d_name);
+
+                if (name.size() > 4 && name.compare(0, 4, "node") == 0 && std::all_of(std::begin(name) + 4, std::end(name), ::isdigit))
+                {
+                    node = std::stoul(name.substr(4));
+                    break;
+                }
+            }
+
+            closedir(directory);
+        }
+
+        return node;
+    }
+
+    /// \brief Get the list of CPUs sharing the L3 cache with a CPU.
+    /// \return Returns the list of CPUs sharing the L3 cache. If the CPU has no L3 cache returns an empty string.
+    static std::string GetCPUL3List(size_t cpu)
+    {
+        for (size_t index = 0;; ++index)
+        {
+            auto cache_path = GetCPUPath(cpu) + "/cache/index" + std::to_string(index);
+
+            auto level = ReadLine(cache_path + "/level");
+
+            if (level.empty())
+            {
+                return {};                                                                  // No more caches.
+            }
+
+            if (level == "3")
+            {
+                return ReadLine(cache_path + "/shared_cpu_list");
+            }
+        }
+    }
+
+    /// \brief Assigns dense indices to domains identified by arbitrary keys, in order of appearance.
+    struct DomainIndexer
+    {
+        /// \brief Get the dense index of a domain.
+        size_t operator()(size_t key)
+        {
+            return indices_.emplace(key, indices_.size()).first->second;
+        }
+
+        std::unordered_map<size_t, size_t> indices_;                                        ///< \brief Dense index associated to each key.
+    };
+
+    /// \brief Owns a dynamically-sized CPU set, able to address any number of CPUs.
+    class CPUSet
+    {
+    public:
+
+        /// \brief Create an empty CPU set large enough to address the CPUs in the system and the ones in the provided mask.
+        CPUSet(const AffinityMask& affinity_mask = {})
+            : count_(std::max({ affinity_mask.GetSize(), static_cast<size_t>(sysconf(_SC_NPROCESSORS_CONF)), size_t(CPU_SETSIZE) }))
+            , set_(CPU_ALLOC(count_), &CPUSet::Free)
+            , size_(CPU_ALLOC_SIZE(count_))
+        {
+            CPU_ZERO_S(size_, set_.get());
+
+            for (size_t cpu = 0; cpu < affinity_mask.GetSize(); ++cpu)
+            {
+                if (affinity_mask.Test(cpu))
+                {
+                    CPU_SET_S(cpu, size_, set_.get());
+                }
+            }
+        }
+
+        /// \brief Convert the set to an affinity mask.
+        AffinityMask ToAffinityMask() const
+        {
+            AffinityMask affinity_mask;
+
+            for (size_t cpu = 0; cpu < count_; ++cpu)
+            {
+                if (CPU_ISSET_S(cpu, size_, set_.get()))
+                {
+                    affinity_mask.Set(cpu);
+                }
+            }
+
+            return affinity_mask;
+        }
+
+        /// \brief Get the underlying set.
+        cpu_set_t* Get() const
+        {
+            return set_.get();
+        }
+
+        /// \brief Get the size of the underlying set, in bytes.
+        size_t GetSize() const
+        {
+            return size_;
+        }
+
+    private:
+
+        /// \brief Release a set.
+        static void Free(cpu_set_t* set)
+        {
+            CPU_FREE(set);
+        }
+
+        size_t count_;                                                                      ///< \brief Number of CPUs the set can address.
+
+        std::unique_ptr<cpu_set_t, void(*)(cpu_set_t*)> set_;                               ///< \brief Underlying set.
+
+        size_t size_;                                                                       ///< \brief Size of the set, in bytes.
+    };
+
+    /************************************************************************/
+    /* LINUX MEMORY                                                         */
+    /************************************************************************/
+
+    /// \brief Get the range of pages containing at least one byte in a memory range.
+    static MemoryRange GetPageRange(const MemoryRange& memory_range)
+    {
+        auto page_alignment = PlatformMemory::GetPageAlignment();
+
+        return { memory_range.Begin().GetAlignedDown(page_alignment), memory_range.End().GetAligned(page_alignment) };
+    }
+
+    /// \brief Get the size of transparent huge pages.
+    /// \return Returns the size of transparent huge pages. Returns 0 if transparent huge pages are disabled.
+    static Bytes GetTransparentHugePageSize()
+    {
+        auto enabled = ReadLine("/sys/kernel/mm/transparent_hugepage/enabled");                       // For example "always [madvise] never".
+
+        if (enabled.empty() || enabled.find("[never]") != std::string::npos)
+        {
+            return 0_Bytes;
+        }
+
+        auto page_size = ReadLine("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+
+        return Bytes(page_size.empty() ? std::size_t(0) : static_cast<std::size_t>(std::stoull(page_size)));
+    }
+
+    /************************************************************************/
+    /* LINUX DEBUGGER                                                       */
+    /************************************************************************/
+
+    /// \brief Get a stack trace element from a symbol returned by backtrace_symbols, in the format "module(function+offset) [address]".
+    static diagnostics::StackTraceElement GetStackTraceElement(const char* symbol)
+    {
+        diagnostics::StackTraceElement element;
+
+        std::string description(symbol);
+
+        auto function_begin = description.find('(');
+        auto function_end = description.find_first_of("+)", function_begin);
+
+        element.file_ = description.substr(0, function_begin);                                          // The module is the best approximation available without debug information.
+        element.line_ = 0;
+
+        if (function_begin != std::string::npos && function_end != std::string::npos && function_end > function_begin + 1)
+        {
+            auto mangled_name = description.substr(function_begin + 1, function_end - function_begin - 1);
+
+            auto status = 0;
+
+            auto demangled_name = std::unique_ptr<char, void(*)(void*)>(abi::__cxa_demangle(mangled_name.c_str(), nullptr, nullptr, &status), std::free);
+
+            element.function_ = (status == 0) ? demangled_name.get() : mangled_name;
+        }
+
+        return element;
+    }
+
+    /************************************************************************/
+    /* PLATFORM DEBUGGER                                                    */
+    /************************************************************************/
+
+    bool PlatformDebugger::IsDebuggerAttached()
+    {
+        static const std::string kTracerPid = "TracerPid:";
+
+        std::ifstream status("/proc/self/status");
+
+        for (std::string line; std::getline(status, line);)
+        {
+            if (line.compare(0, kTracerPid.size(), kTracerPid) == 0)
+            {
+                return std::stol(line.substr(kTracerPid.size())) != 0;                                 // Non-zero if a tracer is attached to the process.
+            }
+        }
+
+        return false;
+    }
+
+    diagnostics::StackTrace PlatformDebugger::GetStackTrace(diagnostics::StackTraceElement caller)
+    {
+        static const int kMaxFrames = 128;
+
+        static const int kFramesToDiscard = 2;                                                          // Discards this call and diagnostics::Debugger::GetStackTrace: we don't really want those frames to show up in the callstack.
+
+        void* frames[kMaxFrames];
+
+        auto frame_count = backtrace(frames, kMaxFrames);
+
+        diagnostics::StackTrace stacktrace;
+
+        auto symbols = std::unique_ptr<char*, void(*)(void*)>(backtrace_symbols(frames, frame_count), std::free);
+
+        if (symbols)
+        {
+            for (auto frame_index = kFramesToDiscard; frame_index < frame_count; ++frame_index)
+            {
+                stacktrace.elements_.emplace_back(GetStackTraceElement(symbols.get()[frame_index]));
+            }
+        }
+
+        // Preserve the caller symbols, since no debug information is available.
+
+        if (stacktrace.elements_.empty())
+        {
+            stacktrace.elements_.emplace_back(std::move(caller));
+        }
+        else
+        {
+            stacktrace.elements_.front() = std::move(caller);
+        }
+
+        return stacktrace;
+    }
+
+    /************************************************************************/
+    /* PLATFORM SYSTEM                                                      */
+    /************************************************************************/
+
+    CPUInfo PlatformSystem::GetCPUInfo()
+    {
+        CPUInfo cpu_info;
+
+        cpu_info.cores_ = static_cast<uint32_t>(sysconf(_SC_NPROCESSORS_ONLN));
+
+        auto max_frequency = ReadLine("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq");          // KHz.
+
+        cpu_info.frequency_ = max_frequency.empty() ? 0 : std::stoull(max_frequency) * 1000;
+
+#if defined(__x86_64__)
+        cpu_info.architecture_ = CPUArchitecture::kx64;
+#elif defined(__i386__)
+        cpu_info.architecture_ = CPUArchitecture::kx86;
+#elif defined(__arm__) || defined(__aarch64__)
+        cpu_info.architecture_ = CPUArchitecture::kARM;
+#else
+        cpu_info.architecture_ = CPUArchitecture::kUnknown;
+#endif
+
+        return cpu_info;
+    }
+
+    CPUTopology PlatformSystem::GetCPUTopology()
+    {
+        CPUTopology cpu_topology;
+
+        DomainIndexer cores;
+        DomainIndexer caches;
+        DomainIndexer nodes;
+        DomainIndexer packages;
+
+        for (auto cpu : GetOnlineCPUs())
+        {
+            auto topology_path = GetCPUPath(cpu) + "/topology";
+
+            auto package_id = ReadLine(topology_path + "/physical_package_id");
+
+            ProcessorInfo processor_info;
+
+            processor_info.index_ = cpu;
+            processor_info.core_ = cores(GetDomainKey(ReadLine(topology_path + "/thread_siblings_list"), cpu));
+            processor_info.node_ = nodes(GetCPUNode(cpu));
+            processor_info.package_ = packages(package_id.empty() ? 0 : std::stoul(package_id));
+
+            auto l3_list = GetCPUL3List(cpu);
+
+            processor_info.cache_ = l3_list.empty() ? processor_info.package_ : caches(GetDomainKey(l3_list, cpu));     // No L3: the package is the last-level cache domain.
+
+            cpu_topology.processors_.emplace_back(processor_info);
+        }
+
+        return cpu_topology;
+    }
+
+    StorageInfo PlatformSystem::GetStorageInfo()
+    {
+        StorageInfo storage_info;
+
+        struct statvfs file_system;
+
+        if (statvfs("/", &file_system) == 0)
+        {
+            DriveInfo drive_info;
+
+            drive_info.label_ = "/";
+            drive_info.total_space_ = static_cast<uint64_t>(file_system.f_blocks) * file_system.f_frsize;
+            drive_info.available_space_ = static_cast<uint64_t>(file_system.f_bavail) * file_system.f_frsize;
+
+            storage_info.drives_.emplace_back(std::move(drive_info));
+        }
+
+        return storage_info;
+    }
+
+    MemoryInfo PlatformSystem::GetMemoryInfo()
+    {
+        MemoryInfo memory_info{};
+
+        struct sysinfo system_info;
+
+        if (sysinfo(&system_info) == 0)
+        {
+            memory_info.total_physical_memory_ = static_cast<uint64_t>(system_info.totalram) * system_info.mem_unit;
+            memory_info.total_page_memory_ = static_cast<uint64_t>(system_info.totalswap) * system_info.mem_unit;
+            memory_info.available_physical_memory_ = static_cast<uint64_t>(system_info.freeram) * system_info.mem_unit;
+            memory_info.available_page_memory_ = static_cast<uint64_t>(system_info.freeswap) * system_info.mem_unit;
+        }
+
+        struct rlimit address_space;
+
+        if (getrlimit(RLIMIT_AS, &address_space) == 0)
+        {
+            memory_info.total_virtual_memory_ = static_cast<uint64_t>(address_space.rlim_cur);
+            memory_info.available_virtual_memory_ = static_cast<uint64_t>(address_space.rlim_cur);
+        }
+
+        return memory_info;
+    }
+
+    DisplayInfo PlatformSystem::GetDisplayInfo()
+    {
+        return {};                                                                          // Displays are owned by the display server, not by the kernel.
+    }
+
+    PlatformInfo PlatformSystem::GetPlatformInfo()
+    {
+        PlatformInfo platform_info;
+
+        platform_info.operating_system_ = OperatingSystem::kLinux;
+
+        return platform_info;
+    }
+
+    /************************************************************************/
+    /* PLATFORM THREADING                                                   */
+    /************************************************************************/
+
+    size_t PlatformThreading::GetCPUIndex()
+    {
+        return static_cast<size_t>(sched_getcpu());
+    }
+
+    AffinityMask PlatformThreading::GetSystemAffinity()
+    {
+        AffinityMask system_affinity;
+
+        for (auto cpu : GetOnlineCPUs())
+        {
+            system_affinity.Set(cpu);
+        }
+
+        return system_affinity;
+    }
+
+    bool PlatformThreading::SetProcessAffinity(const AffinityMask& affinity_mask)
+    {
+        // Linux affinity is per-thread: apply the new affinity to each thread in the process.
+
+        auto cpu_set = CPUSet(affinity_mask);
+
+        auto directory = opendir("/proc/self/task");
+
+        if (!directory)
+        {
+            return false;
+        }
+
+        auto result = true;
+
+        while (auto entry = readdir(directory))
+        {
+            if (entry->d_name[0] != '.')
+            {
+                auto thread_id = static_cast<pid_t>(std::stol(entry->d_name));
+
+                result &= (sched_setaffinity(thread_id, cpu_set.GetSize(), cpu_set.Get()) == 0);
+            }
+        }
+
+        closedir(directory);
+
+        return result;
+    }
+
+    AffinityMask PlatformThreading::GetProcessAffinity()
+    {
+        auto cpu_set = CPUSet();
+
+        if (sched_getaffinity(getpid(), cpu_set.GetSize(), cpu_set.Get()) != 0)              // Affinity of the main thread.
+        {
+            return {};
+        }
+
+        return cpu_set.ToAffinityMask();
+    }
+
+    bool PlatformThreading::SetThreadAffinity(const AffinityMask& affinity_mask, std::thread* thread)
+    {
+        auto thread_handle = thread ? thread->native_handle() : pthread_self();
+
+        auto cpu_set = CPUSet(affinity_mask);
+
+        return pthread_setaffinity_np(thread_handle, cpu_set.GetSize(), cpu_set.Get()) == 0;
+    }
+
+    AffinityMask PlatformThreading::GetThreadAffinity(std::thread* thread)
+    {
+        auto thread_handle = thread ? thread->native_handle() : pthread_self();
+
+        auto cpu_set = CPUSet();
+
+        if (pthread_getaffinity_np(thread_handle, cpu_set.GetSize(), cpu_set.Get()) != 0)
+        {
+            return {};
+        }
+
+        return cpu_set.ToAffinityMask();
+    }
+
+    bool PlatformThreading::SetThreadPriority(ThreadPriority priority, std::thread* thread)
+    {
+        static std::unordered_map<ThreadPriority, int> priority_table =
+        {
+            { ThreadPriority::kLowest, 19 },
+            { ThreadPriority::kLower, 10 },
+            { ThreadPriority::kLow, 5 },
+            { ThreadPriority::kNormal, 0 },
+            { ThreadPriority::kHigh, -5 },
+            { ThreadPriority::kHigher, -10 },
+            { ThreadPriority::kHighest, -20 }
+        };
+
+        if (thread && thread->get_id() != std::this_thread::get_id())
+        {
+            return false;
+        }
+
+        auto thread_id = static_cast<id_t>(syscall(SYS_gettid));
+
+        return setpriority(PRIO_PROCESS, thread_id, priority_table[priority]) == 0;        // Niceness is per-thread on Linux.
+    }
+
+    ThreadPriority PlatformThreading::GetThreadPriority(std::thread* thread)
+    {
+        if (thread && thread->get_id() != std::this_thread::get_id())
+        {
+            return ThreadPriority::kNormal;
+        }
+
+        auto niceness = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+
+        if (niceness >= 15) return ThreadPriority::kLowest;
+        if (niceness >= 8) return ThreadPriority::kLower;
+        if (niceness > 0) return ThreadPriority::kLow;
+        if (niceness == 0) return ThreadPriority::kNormal;
+        if (niceness > -8) return ThreadPriority::kHigh;
+        if (niceness > -15) return ThreadPriority::kHigher;
+
+        return ThreadPriority::kHighest;
+    }
+
+    /************************************************************************/
+    /* PLATFORM MEMORY                                                      */
+    /************************************************************************/
+
+    Bytes PlatformMemory::GetPageSize()
+    {
+        static const auto page_size = Bytes(static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+
+        return page_size;
+    }
+
+    Alignment PlatformMemory::GetPageAlignment()
+    {
+        return Alignment(GetPageSize());                                                    // Since each page can be committed at page size boundaries, the page size is also the alignment.
+    }
+
+    MemoryRange PlatformMemory::Allocate(Bytes size)
+    {
+        auto address = mmap(nullptr, std::size_t(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);                   // Will allocate up to the next page boundary.
+
+        if (address == MAP_FAILED)
+        {
+            return {};
+        }
+
+        return { MemoryAddress(address), MemoryAddress(address) + size };
+    }
+
+    MemoryRange PlatformMemory::Reserve(Bytes size)
+    {
+        auto address = mmap(nullptr, std::size_t(size), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);              // Will reserve up to the next page boundary.
+
+        if (address == MAP_FAILED)
+        {
+            return {};
+        }
+
+        return { MemoryAddress(address), MemoryAddress(address) + size };
+    }
+
+    bool PlatformMemory::Release(const MemoryRange& memory_range)
+    {
+        if (memory_range)
+        {
+            return munmap(memory_range.Begin(), std::size_t(memory_range.GetSize())) == 0;                                           // Will unmap each page containing at least one byte in the range.
+        }
+
+        return true;
+    }
+
+    bool PlatformMemory::Commit(const MemoryRange& memory_range)
+    {
+        auto page_range = GetPageRange(memory_range);
+
+        return mprotect(page_range.Begin(), std::size_t(page_range.GetSize()), PROT_READ | PROT_WRITE) == 0;                         // Physical pages are allocated upon first access.
+    }
+
+    bool PlatformMemory::Decommit(const MemoryRange& memory_range)
+    {
+        auto page_range = GetPageRange(memory_range);
+
+        // Release the physical pages first: private anonymous pages read back as zero afterwards, as with freshly committed memory.
+
+        return madvise(page_range.Begin(), std::size_t(page_range.GetSize()), MADV_DONTNEED) == 0
+            && mprotect(page_range.Begin(), std::size_t(page_range.GetSize()), PROT_NONE) == 0;
+    }
+
+    Bytes PlatformMemory::GetLargePageSize()
+    {
+        static const auto large_page_size = GetTransparentHugePageSize();
+
+        return large_page_size;
+    }
+
+    MemoryRange PlatformMemory::ReserveLarge(Bytes size)
+    {
+        auto large_page_size = GetLargePageSize();
+
+        if (large_page_size == 0_Bytes)
+        {
+            return {};
+        }
+
+        // Over-reserve by one large page and trim the excess, so that the range begins at a large page boundary: the kernel only backs fully-aligned large pages.
+
+        auto reservation = Reserve(size + large_page_size);
+
+        if (!reservation)
+        {
+            return {};
+        }
+
+        auto begin = reservation.Begin().GetAligned(Alignment(large_page_size));
+
+        auto memory_range = MemoryRange(begin, begin + size);
+
+        if (memory_range.Begin() > reservation.Begin())
+        {
+            munmap(reservation.Begin(), std::size_t(memory_range.Begin() - reservation.Begin()));
+        }
+
+        if (reservation.End() > memory_range.End())
+        {
+            munmap(memory_range.End(), std::size_t(reservation.End() - memory_range.End()));
+        }
+
+        if (madvise(memory_range.Begin(), std::size_t(size), MADV_HUGEPAGE) != 0)
+        {
+            Release(memory_range);                                                          // Transparent huge pages are not available for this process.
+
+            return {};
+        }
+
+        return memory_range;
+    }
+
+    Bytes PlatformMemory::GetLargePageResidentSize(const MemoryRange& memory_range)
+    {
+        // Each mapping in /proc/self/smaps starts with a line such as "7f0000000000-7f0000200000 rw-p ...", followed by its counters.
+
+        static const std::string kAnonHugePages = "AnonHugePages:";
+
+        std::ifstream smaps("/proc/self/smaps");
+
+        auto resident_size = 0_Bytes;
+        auto overlap_size = 0_Bytes;
+
+        for (std::string line; std::getline(smaps, line);)
+        {
+            auto separator = line.find('-');
+
+            if (separator != std::string::npos && separator < line.find(' '))
+            {
+                auto begin = MemoryAddress(reinterpret_cast<void*>(std::stoull(line.substr(0, separator), nullptr, 16)));
+                auto end = MemoryAddress(reinterpret_cast<void*>(std::stoull(line.substr(separator + 1), nullptr, 16)));
+
+                auto overlap_begin = std::max(begin, memory_range.Begin());
+                auto overlap_end = std::min(end, memory_range.End());
+
+                overlap_size = (overlap_begin < overlap_end) ? Bytes(std::size_t(overlap_end - overlap_begin)) : 0_Bytes;
+            }
+            else if (overlap_size > 0_Bytes && line.compare(0, kAnonHugePages.size(), kAnonHugePages) == 0)
+            {
+                auto huge_size = Bytes(static_cast<std::size_t>(std::stoull(line.substr(kAnonHugePages.size()))) * 1024u);      // Reported in kB.
+
+                resident_size += std::min(huge_size, overlap_size);                                                             // The mapping may extend past the range.
+            }
+        }
+
+        return resident_size;
+    }
+
+
+    MemoryRange PlatformMemory::MapFile(const std::string& path, MappedFileMode mode)
+    {
+        auto file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+        if (file < 0)
+        {
+            return {};
+        }
+
+        struct stat file_status;
+
+        auto address = MAP_FAILED;
+        auto size = 0_Bytes;
+
+        if (fstat(file, &file_status) == 0 && file_status.st_size > 0)
+        {
+            size = Bytes(static_cast<std::size_t>(file_status.st_size));
+
+            auto protection = (mode == MappedFileMode::kReadOnly) ? PROT_READ : (PROT_READ | PROT_WRITE);
+
+            address = mmap(nullptr, std::size_t(size), protection, MAP_PRIVATE, file, 0);                                             // Private mappings never write back to the file.
+        }
+
+        close(file);                                                                                                                    // The mapping keeps the file alive.
+
+        if (address == MAP_FAILED)
+        {
+            return {};
+        }
+
+        return { MemoryAddress(address), MemoryAddress(address) + size };
+    }
+
+    bool PlatformMemory::UnmapFile(const MemoryRange& memory_range)
+    {
+        return Release(memory_range);
+    }
+
+    bool PlatformMemory::Prefetch(const MemoryRange& memory_range)
+    {
+        auto page_range = GetPageRange(memory_range);
+
+        return madvise(page_range.Begin(), std::size_t(page_range.GetSize()), MADV_WILLNEED) == 0;                                  // Schedules the read-ahead without blocking.
+    }
+
+    bool PlatformMemory::Advise(const MemoryRange& memory_range, MappedFileAccess access)
+    {
+        static const int advice_table[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM };
+
+        auto page_range = GetPageRange(memory_range);
+
+        return madvise(page_range.Begin(), std::size_t(page_range.GetSize()), advice_table[static_cast<std::size_t>(access)]) == 0;
+    }
+
+    Bytes PlatformMemory::GetResidentSize(const MemoryRange& memory_range)
+    {
+        auto page_range = GetPageRange(memory_range);
+
+        auto page_size = GetPageSize();
+
+        auto residency = std::vector<unsigned char>(page_range.GetSize() / page_size);
+
+        if (residency.empty() || mincore(page_range.Begin(), std::size_t(page_range.GetSize()), residency.data()) != 0)
+        {
+            return 0_Bytes;
+        }
+
+        auto resident_pages = std::count_if(std::begin(residency), std::end(residency), [](unsigned char page_residency)
+        {
+            return (page_residency & 0x1) != 0;                                                                                         // Other bits are reserved.
+        });
+
+        return page_size * static_cast<std::size_t>(resident_pages);
+    }
+
+}
+
+#endif
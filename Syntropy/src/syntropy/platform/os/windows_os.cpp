@@ -7,22 +7,26 @@
 #ifdef _WIN64
 
 #pragma comment(lib, "DbgHelp.lib")
+#pragma comment(lib, "Psapi.lib")
 
 #pragma warning(push)
 #pragma warning(disable:4091)
 
 #include <Windows.h>
 #include <DbgHelp.h>
+#include <Psapi.h>
 
 #undef max
 
 #pragma warning(pop)
 
+#include <array>
 #include <string>
 #include <mutex>
 #include <thread>
 #include <algorithm>
 #include <memory>
+#include <map>
 #include <unordered_map>
 
 #include "syntropy/math/math.h"
@@ -232,6 +236,12 @@ namespace syntropy::platform
             return page_alignment_;
         }
 
+        /// \brief Get the size of each large memory page.
+        Bytes GetLargePageSize() const
+        {
+            return large_page_size_;
+        }
+
     private:
 
         WindowsMemory()
@@ -242,6 +252,7 @@ namespace syntropy::platform
             allocation_granularity_ = Bytes(system_info.dwAllocationGranularity);
             page_size_ = Bytes(system_info.dwPageSize);
             page_alignment_ = Alignment(page_size_);                        // Since each page can be committed at page size boundaries, the page size is also the alignment.
+            large_page_size_ = Bytes(GetLargePageMinimum());                // Zero if the processor doesn't support large pages.
         }
 
         Bytes allocation_granularity_;      ///< \brief Memory allocation granularity, in bytes.
@@ -249,6 +260,8 @@ namespace syntropy::platform
         Bytes page_size_;                   ///< \brief Memory page size, in bytes.
 
         Alignment page_alignment_;          ///< \brief Memory page alignment, in bytes.
+
+        Bytes large_page_size_;             ///< \brief Large memory page size, in bytes.
     };
 
     /************************************************************************/
@@ -309,6 +322,111 @@ namespace syntropy::platform
         return cpu_info;
     }
 
+    CPUTopology PlatformSystem::GetCPUTopology()
+    {
+        // Query cores, caches, NUMA nodes and packages at once.
+
+        DWORD length = 0;
+
+        GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+
+        auto buffer = std::make_unique<uint8_t[]>(length);
+
+        if (!GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.get()), &length))
+        {
+            return {};
+        }
+
+        // Processors are indexed as in AffinityMask: each processor group takes kWordSize indices.
+
+        auto for_each_processor = [](const GROUP_AFFINITY& affinity, auto&& function)
+        {
+            for (size_t bit = 0; bit < AffinityMask::kWordSize; ++bit)
+            {
+                if ((affinity.Mask >> bit) & 1u)
+                {
+                    function(affinity.Group * AffinityMask::kWordSize + bit);
+                }
+            }
+        };
+
+        std::map<size_t, ProcessorInfo> processors;
+
+        size_t core_count = 0;
+        size_t cache_count = 0;
+        size_t node_count = 0;
+        size_t package_count = 0;
+
+        for (DWORD offset = 0; offset < length;)
+        {
+            auto& information = *reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.get() + offset);
+
+            switch (information.Relationship)
+            {
+                case RelationProcessorCore:
+                {
+                    for (WORD group = 0; group < information.Processor.GroupCount; ++group)
+                    {
+                        for_each_processor(information.Processor.GroupMask[group], [&](size_t index) { processors[index].core_ = core_count; });
+                    }
+
+                    ++core_count;
+                    break;
+                }
+
+                case RelationProcessorPackage:
+                {
+                    for (WORD group = 0; group < information.Processor.GroupCount; ++group)
+                    {
+                        for_each_processor(information.Processor.GroupMask[group], [&](size_t index) { processors[index].package_ = package_count; });
+                    }
+
+                    ++package_count;
+                    break;
+                }
+
+                case RelationCache:
+                {
+                    if (information.Cache.Level == 3)
+                    {
+                        for_each_processor(information.Cache.GroupMask, [&](size_t index) { processors[index].cache_ = cache_count; });
+
+                        ++cache_count;
+                    }
+
+                    break;
+                }
+
+                case RelationNumaNode:
+                {
+                    for_each_processor(information.NumaNode.GroupMask, [&](size_t index) { processors[index].node_ = node_count; });
+
+                    ++node_count;
+                    break;
+                }
+
+                default:
+                {
+                    break;
+                }
+            }
+
+            offset += information.Size;
+        }
+
+        CPUTopology cpu_topology;
+
+        for (auto&& processor : processors)
+        {
+            processor.second.index_ = processor.first;
+            processor.second.cache_ = (cache_count > 0) ? processor.second.cache_ : processor.second.package_;      // No L3: the package is the last-level cache domain.
+
+            cpu_topology.processors_.emplace_back(processor.second);
+        }
+
+        return cpu_topology;
+    }
+
     StorageInfo PlatformSystem::GetStorageInfo()
     {
         StorageInfo storage_info;
@@ -417,63 +535,137 @@ namespace syntropy::platform
     /* PLATFORM THREADING                                                   */
     /************************************************************************/
 
-    size_t PlatformThreading::GetCPUIndex()
+    // Processor groups: https://msdn.microsoft.com/en-us/library/windows/desktop/dd405503(v=vs.85).aspx
+    // Each group contains up to 64 processors and maps to a single word of an AffinityMask.
+
+    /// \brief Get the only processor group an affinity mask refers to.
+    /// \return Returns the index of the group. If the mask is empty or spans multiple groups returns the number of active groups.
+    static WORD GetAffinityGroup(const AffinityMask& affinity_mask)
     {
-        // Group size based on: https://msdn.microsoft.com/en-us/library/windows/desktop/dd405503(v=vs.85).aspx
-        static constexpr size_t kGroupSize = 64;
+        auto group_count = GetActiveProcessorGroupCount();
+        auto affinity_group = group_count;
 
+        for (WORD group = 0; group < group_count; ++group)
+        {
+            if (affinity_mask.GetWord(group) != 0)
+            {
+                if (affinity_group != group_count)
+                {
+                    return group_count;                                                                 // Windows threads and processes can have affinity with a single group at a time.
+                }
+
+                affinity_group = group;
+            }
+        }
+
+        return affinity_group;
+    }
+
+    size_t PlatformThreading::GetCPUIndex()
+    {
         PROCESSOR_NUMBER processor_number;
 
         GetCurrentProcessorNumberEx(&processor_number);
 
-        return processor_number.Number + (processor_number.Group * kGroupSize);
+        return processor_number.Number + (processor_number.Group * AffinityMask::kWordSize);
     }
 
     AffinityMask PlatformThreading::GetSystemAffinity()
     {
-        size_t process_affinity;
-        size_t system_affinity;
+        AffinityMask system_affinity;
 
-        auto result = ::GetProcessAffinityMask(GetCurrentProcess(), &process_affinity, &system_affinity) != 0;
+        for (WORD group = 0, group_count = GetActiveProcessorGroupCount(); group < group_count; ++group)
+        {
+            auto processor_count = GetActiveProcessorCount(group);
+
+            system_affinity.SetWord(group, (processor_count < AffinityMask::kWordSize) ? ((uint64_t(1) << processor_count) - 1) : ~uint64_t(0));
+        }
 
-        return result ? system_affinity : size_t(0);
+        return system_affinity;
     }
 
     bool PlatformThreading::SetProcessAffinity(const AffinityMask& affinity_mask)
     {
-        HANDLE process_handle = GetCurrentProcess();
+        // The process affinity mask can only refer to the primary group of the process.
+
+        auto process_group = GetAffinityGroup(GetProcessAffinity());
+
+        if (GetAffinityGroup(affinity_mask) != process_group)
+        {
+            return false;
+        }
 
-        return SetProcessAffinityMask(process_handle, affinity_mask.to_ullong()) != 0;
+        return SetProcessAffinityMask(GetCurrentProcess(), static_cast<DWORD_PTR>(affinity_mask.GetWord(process_group))) != 0;
     }
 
     AffinityMask PlatformThreading::GetProcessAffinity()
     {
-        size_t process_affinity;
-        size_t system_affinity;
+        USHORT group_count = 0;
+
+        GetProcessGroupAffinity(GetCurrentProcess(), &group_count, nullptr);                            // Query the number of groups.
+
+        auto groups = std::make_unique<USHORT[]>(group_count);
 
-        auto result = GetProcessAffinityMask(GetCurrentProcess(), &process_affinity, &system_affinity) != 0;
+        if (!GetProcessGroupAffinity(GetCurrentProcess(), &group_count, groups.get()))
+        {
+            return {};
+        }
 
-        return result ? process_affinity : size_t(0);
+        if (group_count == 1)
+        {
+            DWORD_PTR process_affinity;
+            DWORD_PTR system_affinity;
+
+            auto result = GetProcessAffinityMask(GetCurrentProcess(), &process_affinity, &system_affinity) != 0;
+
+            return result ? AffinityMask().SetWord(groups[0], process_affinity) : AffinityMask();
+        }
+
+        // Processes spanning multiple groups have affinity with every processor in those groups.
+
+        auto system_affinity = GetSystemAffinity();
+
+        AffinityMask process_affinity;
+
+        for (USHORT index = 0; index < group_count; ++index)
+        {
+            process_affinity.SetWord(groups[index], system_affinity.GetWord(groups[index]));
+        }
+
+        return process_affinity;
     }
 
     bool PlatformThreading::SetThreadAffinity(const AffinityMask& affinity_mask, std::thread* thread)
     {
         HANDLE thread_handle = thread ? thread->native_handle() : GetCurrentThread();
 
-        return SetThreadAffinityMask(thread_handle, affinity_mask.to_ullong()) != 0;
+        auto group = GetAffinityGroup(affinity_mask);
+
+        if (group == GetActiveProcessorGroupCount())
+        {
+            return false;
+        }
+
+        GROUP_AFFINITY group_affinity{};
+
+        group_affinity.Group = group;
+        group_affinity.Mask = static_cast<KAFFINITY>(affinity_mask.GetWord(group));
+
+        return SetThreadGroupAffinity(thread_handle, &group_affinity, nullptr) != 0;
     }
 
     AffinityMask PlatformThreading::GetThreadAffinity(std::thread* thread)
     {
         HANDLE thread_handle = thread ? thread->native_handle() : GetCurrentThread();
 
-        auto process_affinity = GetProcessAffinity();
-
-        auto affinity_mask = SetThreadAffinityMask(thread_handle, process_affinity.to_ullong());        // Returns the old affinity mask.
+        GROUP_AFFINITY group_affinity;
 
-        SetThreadAffinityMask(thread_handle, affinity_mask);                                            // Restore the original affinity mask. That API, though.
+        if (!GetThreadGroupAffinity(thread_handle, &group_affinity))
+        {
+            return {};
+        }
 
-        return affinity_mask;
+        return AffinityMask().SetWord(group_affinity.Group, group_affinity.Mask);
     }
 
     bool PlatformThreading::SetThreadPriority(ThreadPriority priority, std::thread* thread)
@@ -566,6 +758,151 @@ namespace syntropy::platform
         return VirtualFree(memory_range.Begin(), size, MEM_DECOMMIT) != 0;                                          // Will decommit each page containing at least one byte in the range.
     }
 
+    Bytes PlatformMemory::GetLargePageSize()
+    {
+        return WindowsMemory::GetInstance().GetLargePageSize();
+    }
+
+    MemoryRange PlatformMemory::ReserveLarge(Bytes size)
+    {
+        // Large pages are locked in physical memory: they can only be reserved and committed at once. Fails unless the process holds the SeLockMemoryPrivilege.
+
+        MemoryAddress address = VirtualAlloc(0, std::size_t(size), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+
+        if (!address)
+        {
+            return {};
+        }
+
+        return { address, address + size };
+    }
+
+    Bytes PlatformMemory::GetLargePageResidentSize(const MemoryRange& memory_range)
+    {
+        auto large_page_size = GetLargePageSize();
+
+        if (large_page_size == 0_Bytes)
+        {
+            return 0_Bytes;
+        }
+
+        auto resident_size = 0_Bytes;
+
+        for (auto address = memory_range.Begin(); address < memory_range.End(); address += large_page_size)
+        {
+            PSAPI_WORKING_SET_EX_INFORMATION working_set_information;
+
+            working_set_information.VirtualAddress = address;
+
+            if (QueryWorkingSetEx(GetCurrentProcess(), &working_set_information, sizeof(working_set_information)) &&
+                working_set_information.VirtualAttributes.Valid &&
+                working_set_information.VirtualAttributes.LargePage)
+            {
+                resident_size += large_page_size;
+            }
+        }
+
+        return resident_size;
+    }
+
+
+    MemoryRange PlatformMemory::MapFile(const std::string& path, MappedFileMode mode)
+    {
+        auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return {};
+        }
+
+        LARGE_INTEGER file_size;
+
+        MemoryAddress address;
+        auto size = 0_Bytes;
+
+        if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        {
+            size = Bytes(static_cast<std::size_t>(file_size.QuadPart));
+
+            auto protection = (mode == MappedFileMode::kReadOnly) ? PAGE_READONLY : PAGE_WRITECOPY;
+            auto access = (mode == MappedFileMode::kReadOnly) ? FILE_MAP_READ : FILE_MAP_COPY;
+
+            if (auto mapping = CreateFileMappingA(file, nullptr, protection, 0, 0, nullptr))
+            {
+                address = MapViewOfFile(mapping, access, 0, 0, 0);                                                  // Copy-on-write views never write back to the file.
+
+                CloseHandle(mapping);                                                                               // The view keeps the mapping alive.
+            }
+        }
+
+        CloseHandle(file);
+
+        if (!address)
+        {
+            return {};
+        }
+
+        return { address, address + size };
+    }
+
+    bool PlatformMemory::UnmapFile(const MemoryRange& memory_range)
+    {
+        if (memory_range)
+        {
+            return UnmapViewOfFile(memory_range.Begin()) != 0;
+        }
+
+        return true;
+    }
+
+    bool PlatformMemory::Prefetch(const MemoryRange& memory_range)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range_entry;
+
+        range_entry.VirtualAddress = memory_range.Begin();
+        range_entry.NumberOfBytes = std::size_t(memory_range.GetSize());
+
+        return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range_entry, 0) != 0;                                 // Schedules the read without blocking.
+    }
+
+    bool PlatformMemory::Advise(const MemoryRange& /*memory_range*/, MappedFileAccess /*access*/)
+    {
+        return false;
+    }
+
+    Bytes PlatformMemory::GetResidentSize(const MemoryRange& memory_range)
+    {
+        static constexpr std::size_t kBatchSize = 512;                                                              // Pages queried by each call.
+
+        auto page_size = GetPageSize();
+
+        auto resident_size = 0_Bytes;
+
+        std::array<PSAPI_WORKING_SET_EX_INFORMATION, kBatchSize> working_set_information;
+
+        for (auto address = memory_range.Begin().GetAlignedDown(GetPageAlignment()); address < memory_range.End();)
+        {
+            auto count = std::size_t(0);
+
+            for (; count < kBatchSize && address < memory_range.End(); ++count, address += page_size)
+            {
+                working_set_information[count].VirtualAddress = address;
+            }
+
+            if (QueryWorkingSetEx(GetCurrentProcess(), working_set_information.data(), static_cast<DWORD>(count * sizeof(PSAPI_WORKING_SET_EX_INFORMATION))))
+            {
+                auto resident_pages = std::count_if(std::begin(working_set_information), std::begin(working_set_information) + count, [](const PSAPI_WORKING_SET_EX_INFORMATION& page_information)
+                {
+                    return page_information.VirtualAttributes.Valid != 0;
+                });
+
+                resident_size += page_size * static_cast<std::size_t>(resident_pages);
+            }
+        }
+
+        return resident_size;
+    }
+
 }
 
 #endif
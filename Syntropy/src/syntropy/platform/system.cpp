@@ -13,6 +13,11 @@ namespace syntropy::platform
         return PlatformSystem::GetCPUInfo();
     }
 
+    CPUTopology System::GetCPUTopology()
+    {
+        return PlatformSystem::GetCPUTopology();
+    }
+
     StorageInfo System::GetStorageInfo()
     {
         return PlatformSystem::GetStorageInfo();
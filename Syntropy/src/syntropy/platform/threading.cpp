@@ -1,9 +1,130 @@
 #include "syntropy/platform/threading.h"
 
+#include <algorithm>
+
 #include "syntropy/platform/os/os.h"
 
 namespace syntropy::platform
 {
+    /************************************************************************/
+    /* AFFINITY MASK                                                        */
+    /************************************************************************/
+
+    AffinityMask::AffinityMask(uint64_t word)
+    {
+        SetWord(0, word);
+    }
+
+    AffinityMask& AffinityMask::Set(size_t index, bool value)
+    {
+        auto word = GetWord(index / kWordSize);
+        auto bit = uint64_t(1) << (index % kWordSize);
+
+        return SetWord(index / kWordSize, value ? (word | bit) : (word & ~bit));
+    }
+
+    bool AffinityMask::Test(size_t index) const
+    {
+        return (GetWord(index / kWordSize) >> (index % kWordSize)) & 1u;
+    }
+
+    size_t AffinityMask::GetCount() const
+    {
+        size_t count = 0;
+
+        for (auto word : words_)
+        {
+            for (; word != 0; word &= (word - 1))
+            {
+                ++count;                                                                // Clear the lowest bit set at each iteration.
+            }
+        }
+
+        return count;
+    }
+
+    bool AffinityMask::IsEmpty() const
+    {
+        return std::all_of(std::begin(words_), std::end(words_), [](auto word) { return word == 0; });
+    }
+
+    size_t AffinityMask::GetSize() const
+    {
+        return words_.size() * kWordSize;
+    }
+
+    uint64_t AffinityMask::GetWord(size_t index) const
+    {
+        return (index < words_.size()) ? words_[index] : 0;
+    }
+
+    AffinityMask& AffinityMask::SetWord(size_t index, uint64_t word)
+    {
+        if (index >= words_.size())
+        {
+            if (word == 0)
+            {
+                return *this;                                                           // Processors outside the mask are not part of it already.
+            }
+
+            words_.resize(index + 1, 0);
+        }
+
+        words_[index] = word;
+
+        return *this;
+    }
+
+    AffinityMask& AffinityMask::operator&=(const AffinityMask& rhs)
+    {
+        for (size_t index = 0; index < words_.size(); ++index)
+        {
+            words_[index] &= rhs.GetWord(index);
+        }
+
+        return *this;
+    }
+
+    AffinityMask& AffinityMask::operator|=(const AffinityMask& rhs)
+    {
+        for (size_t index = 0; index < rhs.words_.size(); ++index)
+        {
+            SetWord(index, GetWord(index) | rhs.words_[index]);
+        }
+
+        return *this;
+    }
+
+    bool AffinityMask::operator==(const AffinityMask& rhs) const
+    {
+        auto size = std::max(words_.size(), rhs.words_.size());
+
+        for (size_t index = 0; index < size; ++index)
+        {
+            if (GetWord(index) != rhs.GetWord(index))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool AffinityMask::operator!=(const AffinityMask& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    AffinityMask operator&(AffinityMask lhs, const AffinityMask& rhs)
+    {
+        return lhs &= rhs;
+    }
+
+    AffinityMask operator|(AffinityMask lhs, const AffinityMask& rhs)
+    {
+        return lhs |= rhs;
+    }
+
     /************************************************************************/
     /* THREADING                                                            */
     /************************************************************************/
@@ -3,20 +3,30 @@
 #include "syntropy/reflection/class.h"
 #include "syntropy/reflection/types/fundamental_types.h"
 
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/alignment.h"
+#include "syntropy/memory/allocators/allocator.h"
+
+#include <atomic>
+#include <new>
+
 namespace syntropy::reflection
 {
     /************************************************************************/
     /* ANY                                                                  */
     /************************************************************************/
 
+    /// \brief Allocator used to allocate values that do not fit the inline buffer. nullptr for the global operator new.
+    static std::atomic<Allocator*> holder_allocator{ nullptr };
+
     Any::Any(const Any& other)
-        : holder_(other.HasValue() ? other.holder_->Clone() : nullptr)
+        : holder_(other.HasValue() ? other.holder_->Clone(storage_) : nullptr)
     {
 
     }
 
     Any::Any(Any&& other) noexcept
-        : holder_(std::move(other.holder_))
+        : holder_(other.HasValue() ? other.holder_->Move(storage_, other.storage_) : nullptr)
     {
         other.holder_ = nullptr;
     }
@@ -42,14 +52,21 @@ namespace syntropy::reflection
     {
         if (holder_)
         {
-            delete holder_;
+            holder_->Destroy(storage_);
             holder_ = nullptr;
         }
     }
 
     void Any::Swap(Any& other) noexcept
     {
-        std::swap(holder_, other.holder_);
+        // Inline values live inside each object, hence they must be moved rather than swapped.
+
+        auto temporary = Any(std::move(other));
+
+        other.holder_ = HasValue() ? holder_->Move(other.storage_, storage_) : nullptr;
+        holder_ = temporary.HasValue() ? temporary.holder_->Move(storage_, temporary.storage_) : nullptr;
+
+        temporary.holder_ = nullptr;
     }
 
     bool Any::HasValue() const noexcept
@@ -62,10 +79,35 @@ namespace syntropy::reflection
         return holder_ ? holder_->GetType() : TypeOf<void>();
     }
 
-    const type_info& Any::GetTypeInfo() const noexcept
+    const std::type_info& Any::GetTypeInfo() const noexcept
     {
         return holder_ ? holder_->GetTypeInfo() : typeid(void);
     }
+
+    void Any::SetAllocator(Allocator* allocator) noexcept
+    {
+        holder_allocator.store(allocator, std::memory_order_release);
+    }
+
+    Allocator* Any::GetAllocator() noexcept
+    {
+        return holder_allocator.load(std::memory_order_acquire);
+    }
+
+    void* Any::AllocateHolder(Allocator& allocator, std::size_t size, std::size_t alignment)
+    {
+        if (auto block = allocator.Allocate(Bytes(size), Alignment(Bytes(alignment))))
+        {
+            return block;
+        }
+
+        throw std::bad_alloc();
+    }
+
+    void Any::FreeHolder(Allocator& allocator, void* holder)
+    {
+        allocator.Free(holder);
+    }
 }
 
 namespace std
@@ -61,7 +61,7 @@ namespace syntropy
 
             result = std::max(result, test_result);
 
-            on_test_suite_finished_.Notify(*this, OnTestSuiteFinishedEventArgs{ test_suite, result });
+            on_test_suite_finished_.Notify(*this, OnTestSuiteFinishedEventArgs{ test_suite, test_result });
         }
 
         on_finished_.Notify(*this, OnFinishedEventArgs{ result });
@@ -0,0 +1,69 @@
+/// \file report.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/************************************************************************/
+/* BENCHMARK SAMPLE                                                     */
+/************************************************************************/
+
+/// \brief Measurement of a benchmark under a given configuration.
+struct BenchmarkSample
+{
+    std::string benchmark_;                                     ///< \brief Name of the benchmark.
+
+    std::string configuration_;                                 ///< \brief Configuration the benchmark ran with, such as the steal policy.
+
+    size_t threads_{ 0 };                                       ///< \brief Number of threads the benchmark ran on.
+
+    size_t runs_{ 0 };                                          ///< \brief Number of runs.
+
+    size_t items_{ 0 };                                         ///< \brief Number of items (tasks, elements or round-trips) processed by each run.
+
+    std::chrono::nanoseconds best_{ 0 };                        ///< \brief Duration of the fastest run.
+
+    std::chrono::nanoseconds mean_{ 0 };                        ///< \brief Mean duration of the runs.
+
+    std::optional<std::chrono::nanoseconds> latency_{};         ///< \brief Benchmark-specific latency, if any.
+};
+
+/************************************************************************/
+/* BENCHMARK REPORT                                                     */
+/************************************************************************/
+
+/// \brief Collects benchmark samples and exports them as CSV or JSON, so that different builds can be compared by numbers.
+class BenchmarkReport
+{
+public:
+
+    /// \brief Add a new sample to the report.
+    void Add(BenchmarkSample sample);
+
+    /// \brief Get the samples collected so far.
+    const std::vector<BenchmarkSample>& GetSamples() const;
+
+    /// \brief Export the samples as CSV, one row per sample after a header row.
+    void ExportCSV(std::ostream& stream) const;
+
+    /// \brief Export the samples as CSV to a file.
+    /// \return Returns true if the file could be written, returns false otherwise.
+    bool ExportCSV(const std::string& path) const;
+
+    /// \brief Export the samples as a JSON array of objects.
+    void ExportJSON(std::ostream& stream) const;
+
+    /// \brief Export the samples as a JSON array of objects to a file.
+    /// \return Returns true if the file could be written, returns false otherwise.
+    bool ExportJSON(const std::string& path) const;
+
+private:
+
+    std::vector<BenchmarkSample> samples_;                      ///< \brief Samples collected so far.
+};
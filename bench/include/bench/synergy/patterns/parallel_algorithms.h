@@ -0,0 +1,12 @@
+/// \file parallel_algorithms.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+/************************************************************************/
+/* BENCHMARK SYNERGY PARALLEL ALGORITHMS                                */
+/************************************************************************/
+
+/// \brief Measure the speedup of synergy parallel algorithms running on every available core against their serial std:: counterparts.
+void BenchmarkSynergyParallelAlgorithms();
@@ -0,0 +1,12 @@
+/// \file scheduler.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+/************************************************************************/
+/* BENCHMARK SYNERGY SCHEDULER                                          */
+/************************************************************************/
+
+/// \brief Measure the task throughput of the synergy scheduler from one up to every available core, for each steal policy.
+void BenchmarkSynergyScheduler();
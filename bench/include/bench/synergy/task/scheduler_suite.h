@@ -0,0 +1,17 @@
+/// \file scheduler_suite.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "bench/report.h"
+
+/************************************************************************/
+/* BENCHMARK SYNERGY SCHEDULER SUITE                                    */
+/************************************************************************/
+
+/// \brief Measure the synergy scheduler on a suite of workloads: spawn/join latency, recursive fib, parallel reduce, fan-out/fan-in, dependency chains and mixed priorities.
+/// Each workload runs for each steal policy, from one up to the provided number of worker threads.
+/// \param report Report the samples are added to.
+/// \param max_thread_count Maximum number of worker threads. Zero selects every core the process has affinity with.
+void BenchmarkSynergySchedulerSuite(BenchmarkReport& report, size_t max_thread_count = 0);
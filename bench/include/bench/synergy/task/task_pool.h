@@ -0,0 +1,12 @@
+/// \file task_pool.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+/************************************************************************/
+/* BENCHMARK SYNERGY TASK POOL                                          */
+/************************************************************************/
+
+/// \brief Measure the cost of spawning tasks and the number of global allocations performed for each task spawned.
+void BenchmarkSynergyTaskPool();
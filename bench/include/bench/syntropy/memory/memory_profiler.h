@@ -0,0 +1,17 @@
+/// \file memory_profiler.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "bench/report.h"
+
+/************************************************************************/
+/* BENCHMARK SYNTROPY MEMORY PROFILER                                   */
+/************************************************************************/
+
+/// \brief Measure the overhead of the syntropy::MemoryProfiler hooks called by SYNTROPY_ALLOC and SYNTROPY_FREE, without the logging performed by those macros.
+/// Each thread count runs without hooks, then with the profiler disabled and enabled: overheads are relative to the run without hooks.
+/// \param report Report the samples are added to.
+/// \param max_thread_count Maximum number of threads allocating concurrently. Zero uses every available core.
+void BenchmarkSyntropyMemoryProfiler(BenchmarkReport& report, size_t max_thread_count);
@@ -0,0 +1,17 @@
+/// \file pool_allocator.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "bench/report.h"
+
+/************************************************************************/
+/* BENCHMARK SYNTROPY POOL ALLOCATOR                                    */
+/************************************************************************/
+
+/// \brief Measure fixed-size messages allocated and deallocated by many threads at once, most messages being deallocated by a thread other than the one that allocated them.
+/// Compares a mutex-guarded syntropy::PoolAllocator against a lock-free one, from one up to the provided number of threads.
+/// \param report Report the samples are added to.
+/// \param max_thread_count Maximum number of threads. Zero selects every core the process has affinity with.
+void BenchmarkSyntropyPoolAllocator(BenchmarkReport& report, size_t max_thread_count = 0);
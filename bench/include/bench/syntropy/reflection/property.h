@@ -0,0 +1,16 @@
+/// \file property.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "bench/report.h"
+
+/************************************************************************/
+/* BENCHMARK SYNTROPY REFLECTION PROPERTY                               */
+/************************************************************************/
+
+/// \brief Measure the throughput of reflected properties read and written via syntropy::reflection::Readable and syntropy::reflection::Writeable.
+/// Each access hands the instance and the value through syntropy::reflection::Any, hence the benchmark tracks the cost of type erasure for small and large property types.
+/// \param report Report the samples are added to.
+void BenchmarkSyntropyReflectionProperty(BenchmarkReport& report);
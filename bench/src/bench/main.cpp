@@ -0,0 +1,91 @@
+#include <iostream>
+#include <string>
+#include <algorithm>
+
+#include "syntropy/application/command_line.h"
+
+#include "bench/report.h"
+#include "bench/synergy/patterns/parallel_algorithms.h"
+#include "bench/synergy/task/scheduler.h"
+#include "bench/synergy/task/scheduler_suite.h"
+#include "bench/synergy/task/task_pool.h"
+#include "bench/syntropy/memory/pool_allocator.h"
+#include "bench/syntropy/memory/memory_profiler.h"
+#include "bench/syntropy/reflection/property.h"
+
+/// Usage: bench [-run {benchmark} ...] [-threads {count}] [-csv {path}] [-json {path}]
+///
+/// -run        Benchmarks to run among "scheduler", "task_pool", "parallel_algorithms", "scheduler_suite", "pool_allocator", "memory_profiler" and "reflection_property". Every benchmark runs by default.
+/// -threads    Maximum number of worker threads of the scheduler suite, of the pool allocator and of the memory profiler benchmarks. Defaults to every available core.
+/// -csv        Export the samples of the scheduler suite, of the pool allocator, of the memory profiler and of the reflection property benchmarks as CSV.
+/// -json       Export the samples of the scheduler suite, of the pool allocator, of the memory profiler and of the reflection property benchmarks as JSON.
+int main(int argc, char **argv)
+{
+    syntropy::CommandLine command_line(argc, argv);
+
+    auto is_enabled = [&command_line](const std::string& benchmark)
+    {
+        auto run = command_line.GetArgument("run");
+
+        return !run || std::find(run->GetValues().begin(), run->GetValues().end(), benchmark) != run->GetValues().end();
+    };
+
+    auto threads = command_line.GetArgument("threads");
+
+    auto report = BenchmarkReport{};
+
+    std::cout << "\nRunning benchmarks:\n\n";
+
+    if (is_enabled("scheduler"))
+    {
+        BenchmarkSynergyScheduler();
+    }
+
+    if (is_enabled("task_pool"))
+    {
+        BenchmarkSynergyTaskPool();
+    }
+
+    if (is_enabled("parallel_algorithms"))
+    {
+        BenchmarkSynergyParallelAlgorithms();
+    }
+
+    auto max_thread_count = (threads && !threads->IsEmpty()) ? std::stoul(threads->GetValue()) : 0;
+
+    if (is_enabled("scheduler_suite"))
+    {
+        BenchmarkSynergySchedulerSuite(report, max_thread_count);
+    }
+
+    if (is_enabled("pool_allocator"))
+    {
+        BenchmarkSyntropyPoolAllocator(report, max_thread_count);
+    }
+
+    if (is_enabled("memory_profiler"))
+    {
+        BenchmarkSyntropyMemoryProfiler(report, max_thread_count);
+    }
+
+    if (is_enabled("reflection_property"))
+    {
+        BenchmarkSyntropyReflectionProperty(report);
+    }
+
+    // Export.
+
+    auto csv = command_line.GetArgument("csv");
+
+    if (csv && !csv->IsEmpty() && !report.ExportCSV(csv->GetValue()))
+    {
+        std::cerr << "Could not write " << csv->GetValue() << "\n";
+    }
+
+    auto json = command_line.GetArgument("json");
+
+    if (json && !json->IsEmpty() && !report.ExportJSON(json->GetValue()))
+    {
+        std::cerr << "Could not write " << json->GetValue() << "\n";
+    }
+}
@@ -0,0 +1,101 @@
+#include "bench/report.h"
+
+#include <cstdint>
+#include <fstream>
+
+namespace
+{
+    /// \brief Get the number of items processed per second by the fastest run of a sample.
+    double GetThroughput(const BenchmarkSample& sample)
+    {
+        return (sample.best_.count() > 0) ? (sample.items_ * 1e9 / sample.best_.count()) : 0.0;
+    }
+
+    /// \brief Export the samples of a report to a file.
+    template <typename TExport>
+    bool ExportToFile(const std::string& path, TExport&& export_function)
+    {
+        std::ofstream stream(path, std::ios::out | std::ios::trunc);
+
+        if (!stream)
+        {
+            return false;
+        }
+
+        export_function(stream);
+
+        return !!stream;
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK REPORT                                                     */
+/************************************************************************/
+
+void BenchmarkReport::Add(BenchmarkSample sample)
+{
+    samples_.emplace_back(std::move(sample));
+}
+
+const std::vector<BenchmarkSample>& BenchmarkReport::GetSamples() const
+{
+    return samples_;
+}
+
+void BenchmarkReport::ExportCSV(std::ostream& stream) const
+{
+    stream << "benchmark,configuration,threads,runs,items,best_ns,mean_ns,items_per_s,latency_ns\n";
+
+    for (auto&& sample : samples_)
+    {
+        stream << sample.benchmark_ << "," << sample.configuration_ << "," << sample.threads_ << "," << sample.runs_ << "," << sample.items_ << ","
+               << sample.best_.count() << "," << sample.mean_.count() << "," << static_cast<uint64_t>(GetThroughput(sample)) << ",";
+
+        if (sample.latency_)
+        {
+            stream << sample.latency_->count();                         // Left empty when not applicable.
+        }
+
+        stream << "\n";
+    }
+}
+
+bool BenchmarkReport::ExportCSV(const std::string& path) const
+{
+    return ExportToFile(path, [this](std::ostream& stream) { ExportCSV(stream); });
+}
+
+void BenchmarkReport::ExportJSON(std::ostream& stream) const
+{
+    auto separator = "\n";
+
+    stream << "[";
+
+    for (auto&& sample : samples_)
+    {
+        stream << separator << "{\"benchmark\":\"" << sample.benchmark_ << "\",\"configuration\":\"" << sample.configuration_
+               << "\",\"threads\":" << sample.threads_ << ",\"runs\":" << sample.runs_ << ",\"items\":" << sample.items_
+               << ",\"best_ns\":" << sample.best_.count() << ",\"mean_ns\":" << sample.mean_.count()
+               << ",\"items_per_s\":" << static_cast<uint64_t>(GetThroughput(sample)) << ",\"latency_ns\":";
+
+        if (sample.latency_)
+        {
+            stream << sample.latency_->count();
+        }
+        else
+        {
+            stream << "null";
+        }
+
+        stream << "}";
+
+        separator = ",\n";
+    }
+
+    stream << "\n]\n";
+}
+
+bool BenchmarkReport::ExportJSON(const std::string& path) const
+{
+    return ExportToFile(path, [this](std::ostream& stream) { ExportJSON(stream); });
+}
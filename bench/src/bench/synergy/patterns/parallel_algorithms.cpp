@@ -0,0 +1,190 @@
+#include "bench/synergy/patterns/parallel_algorithms.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <cmath>
+
+#include "syntropy/time/timer.h"
+
+#include "synergy/task/scheduler.h"
+#include "synergy/patterns/parallel_algorithms.h"
+
+namespace
+{
+    /// \brief Number of elements processed by each algorithm.
+    constexpr size_t kElementCount = 1 << 22;
+
+    /// \brief Number of runs for each algorithm. The fastest run is retained.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Some busy work to keep per-element functions from being trivial.
+    double Work(double value)
+    {
+        return std::sqrt(value) * std::log1p(value);
+    }
+
+    /// \brief Measure the fastest run of a serial algorithm.
+    /// \param setup Called before each run, not measured.
+    template <typename TSetup, typename TAlgorithm>
+    std::chrono::microseconds RunSerial(TSetup setup, TAlgorithm algorithm)
+    {
+        auto best = std::chrono::microseconds::max();
+
+        for (size_t run = 0; run < kRunCount; ++run)
+        {
+            setup();
+
+            auto timer = syntropy::Timer<std::chrono::microseconds>();
+
+            algorithm();
+
+            best = std::min(best, timer.Stop());
+        }
+
+        return best;
+    }
+
+    /// \brief Measure the fastest run of a parallel algorithm, launched from within a task.
+    /// \param setup Called before each run, not measured.
+    /// \param algorithm Launches the algorithm and returns the task it completes with.
+    template <typename TSetup, typename TAlgorithm>
+    std::chrono::microseconds RunParallel(TSetup setup, TAlgorithm algorithm)
+    {
+        auto best = std::chrono::microseconds::max();
+
+        for (size_t run = 0; run < kRunCount; ++run)
+        {
+            setup();
+
+            std::atomic_bool done{ false };
+
+            auto timer = syntropy::Timer<std::chrono::microseconds>();
+
+            syntropy::synergy::DetachTask([&algorithm, &done]()
+            {
+                syntropy::synergy::CreateTask({ algorithm() }, [&done]()
+                {
+                    done.store(true, std::memory_order_release);
+                });
+            });
+
+            while (!done.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            best = std::min(best, timer.Stop());
+        }
+
+        return best;
+    }
+
+    /// \brief Print the result of a benchmark.
+    void Print(const char* name, std::chrono::microseconds serial, std::chrono::microseconds parallel)
+    {
+        std::cout << "      " << std::setw(16) << name
+                  << std::setw(14) << serial.count()
+                  << std::setw(14) << parallel.count()
+                  << std::setw(10) << std::fixed << std::setprecision(2) << (double(serial.count()) / parallel.count()) << "\n";
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNERGY PARALLEL ALGORITHMS                                */
+/************************************************************************/
+
+void BenchmarkSynergyParallelAlgorithms()
+{
+    using namespace syntropy::synergy;
+
+    GetScheduler().Initialize();
+
+    std::cout << "   Benchmarking synergy parallel algorithms (" << kElementCount << " elements, " << GetScheduler().GetWorkerCount() << " workers)\n\n";
+
+    std::cout << "      " << std::setw(16) << "algorithm" << std::setw(14) << "std (us)" << std::setw(14) << "synergy (us)" << std::setw(10) << "speedup" << "\n";
+
+    auto input = std::vector<double>(kElementCount);
+    auto output = std::vector<double>(kElementCount);
+
+    auto random = std::mt19937_64();
+    auto distribution = std::uniform_real_distribution<double>(0.0, 1000.0);
+
+    auto reset_input = [&]() { std::generate(input.begin(), input.end(), [&]() { return distribution(random); }); };
+    auto no_setup = []() {};
+
+    reset_input();
+
+    // For.
+
+    {
+        auto function = [](double& value) { value = Work(value); };
+
+        auto serial = RunSerial(reset_input, [&]() { std::for_each(input.begin(), input.end(), function); });
+        auto parallel = RunParallel(reset_input, [&]() { return ParallelFor(input.begin(), input.end(), function); });
+
+        Print("for", serial, parallel);
+    }
+
+    // Lazy for.
+
+    {
+        auto function = [](double& value) { value = Work(value); };
+
+        auto serial = RunSerial(reset_input, [&]() { std::for_each(input.begin(), input.end(), function); });
+        auto parallel = RunParallel(reset_input, [&]() { return LazyParallelFor(input.begin(), input.end(), function); });
+
+        Print("lazy for", serial, parallel);
+    }
+
+    // Transform.
+
+    {
+        auto operation = [](double value) { return Work(value); };
+
+        auto serial = RunSerial(no_setup, [&]() { std::transform(input.begin(), input.end(), output.begin(), operation); });
+        auto parallel = RunParallel(no_setup, [&]() { return ParallelTransform(input.begin(), input.end(), output.begin(), operation); });
+
+        Print("transform", serial, parallel);
+    }
+
+    // Reduce.
+
+    {
+        auto sum = 0.0;
+
+        auto serial = RunSerial(no_setup, [&]() { sum = std::accumulate(input.begin(), input.end(), 0.0); });
+        auto parallel = RunParallel(no_setup, [&]() { return ParallelReduce(input.begin(), input.end(), 0.0, std::plus<>(), sum); });
+
+        Print("reduce", serial, parallel);
+    }
+
+    // Inclusive scan.
+
+    {
+        auto serial = RunSerial(no_setup, [&]() { std::partial_sum(input.begin(), input.end(), output.begin()); });
+        auto parallel = RunParallel(no_setup, [&]() { return ParallelInclusiveScan(input.begin(), input.end(), output.begin()); });
+
+        Print("inclusive scan", serial, parallel);
+    }
+
+    // Sort.
+
+    {
+        auto reset_output = [&]() { std::copy(input.begin(), input.end(), output.begin()); };
+
+        auto serial = RunSerial(reset_output, [&]() { std::sort(output.begin(), output.end()); });
+        auto parallel = RunParallel(reset_output, [&]() { return ParallelSort(output.begin(), output.end()); });
+
+        Print("sort", serial, parallel);
+    }
+
+    std::cout << "\n";
+
+    GetScheduler().Shutdown();
+}
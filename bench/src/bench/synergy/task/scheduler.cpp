@@ -0,0 +1,187 @@
+#include "bench/synergy/task/scheduler.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+#include "syntropy/time/timer.h"
+#include "syntropy/platform/threading.h"
+
+#include "synergy/task/scheduler.h"
+
+namespace
+{
+    /// \brief Number of leaf tasks spawned by each run.
+    constexpr size_t kLeafCount = 1 << 16;
+
+    /// \brief Number of runs for each configuration. The fastest run is retained.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Recursively split a range of leaves in two halves, joining the partial results via continuations.
+    /// Partial results are stored in an implicit binary tree, where the children of the node i are 2i+1 and 2i+2.
+    struct Splitter
+    {
+        Splitter(std::vector<uint64_t>& results, size_t node, size_t begin, size_t end, std::atomic_bool& done)
+            : results_(&results)
+            , node_(node)
+            , begin_(begin)
+            , end_(end)
+            , done_(&done)
+        {
+
+        }
+
+        void operator()()
+        {
+            if (end_ - begin_ < 2)
+            {
+                auto hash = uint64_t(14695981039346656037ull);          // Some busy work to keep the leaf from being empty (FNV-1a).
+
+                for (auto index = 0; index < 64; ++index)
+                {
+                    hash = (hash ^ (begin_ + index)) * 1099511628211ull;
+                }
+
+                (*results_)[node_] = hash;
+
+                return;
+            }
+
+            auto middle = (begin_ + end_) >> 1;
+
+            auto left = syntropy::synergy::EmplaceTask<Splitter>({}, *results_, 2 * node_ + 1, begin_, middle, *done_);
+            auto right = syntropy::synergy::EmplaceTask<Splitter>({}, *results_, 2 * node_ + 2, middle, end_, *done_);
+
+            syntropy::synergy::CreateTaskContinuation({ left, right }, [results = results_, node = node_, done = done_]()
+            {
+                (*results)[node] = (*results)[2 * node + 1] ^ (*results)[2 * node + 2];
+
+                if (node == 0)
+                {
+                    done->store(true, std::memory_order_release);
+                }
+            });
+        }
+
+        std::vector<uint64_t>* results_;
+        size_t node_;
+        size_t begin_;
+        size_t end_;
+        std::atomic_bool* done_;
+    };
+
+    /// \brief Get an affinity mask containing the first cores the process has affinity with.
+    syntropy::platform::AffinityMask GetCores(size_t count)
+    {
+        auto process_affinity = syntropy::platform::Threading::GetProcessAffinity();
+
+        auto cores = syntropy::platform::AffinityMask();
+
+        for (size_t core_index = 0; cores.GetCount() < count && core_index < process_affinity.GetSize(); ++core_index)
+        {
+            cores.Set(core_index, process_affinity.Test(core_index));
+        }
+
+        return cores;
+    }
+
+    /// \brief Result of a benchmark configuration.
+    struct RunResult
+    {
+        std::chrono::microseconds duration_;                    ///< \brief Duration of the fastest run.
+        syntropy::synergy::WorkerStatistics statistics_;        ///< \brief Idle statistics of every worker, summed over each run.
+    };
+
+    /// \brief Run the workload on a scheduler initialized with the provided configuration.
+    RunResult Run(size_t core_count, syntropy::synergy::StealPolicy steal_policy)
+    {
+        auto& scheduler = syntropy::synergy::GetScheduler();
+
+        scheduler.Initialize(GetCores(core_count), steal_policy);
+
+        auto results = std::vector<uint64_t>(2 * kLeafCount - 1);
+
+        auto best = std::chrono::microseconds::max();
+
+        for (size_t run = 0; run < kRunCount; ++run)
+        {
+            std::atomic_bool done{ false };
+
+            auto timer = syntropy::Timer<std::chrono::microseconds>();
+
+            syntropy::synergy::DetachTask([&results, &done]()
+            {
+                syntropy::synergy::EmplaceTask<Splitter>({}, results, 0, 0, kLeafCount, done);
+            });
+
+            while (!done.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            best = std::min(best, timer.Stop());
+        }
+
+        auto statistics = syntropy::synergy::WorkerStatistics{};
+
+        for (size_t index = 0; index < scheduler.GetWorkerCount(); ++index)
+        {
+            auto worker_statistics = scheduler.GetWorkerStatistics(index);
+
+            statistics.spins_ += worker_statistics.spins_;
+            statistics.yields_ += worker_statistics.yields_;
+            statistics.parks_ += worker_statistics.parks_;
+            statistics.wakeups_ += worker_statistics.wakeups_;
+        }
+
+        scheduler.Shutdown();
+
+        return { best, statistics };
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNERGY SCHEDULER                                          */
+/************************************************************************/
+
+void BenchmarkSynergyScheduler()
+{
+    using syntropy::synergy::StealPolicy;
+
+    static constexpr size_t kTaskCount = (2 * kLeafCount - 1) + (kLeafCount - 1);        // Splitters plus continuations.
+
+    auto max_core_count = syntropy::platform::Threading::GetProcessAffinity().GetCount();
+
+    std::cout << "   Benchmarking synergy scheduler (" << kTaskCount << " tasks per run)\n\n";
+
+    std::cout << "      " << std::setw(10) << "policy" << std::setw(8) << "cores" << std::setw(16) << "tasks/s" << std::setw(10) << "speedup"
+              << std::setw(10) << "spins" << std::setw(10) << "yields" << std::setw(10) << "parks" << std::setw(10) << "wakeups" << "\n";
+
+    for (auto steal_policy : { StealPolicy::kShared, StealPolicy::kRandom, StealPolicy::kTopology })
+    {
+        auto baseline = 0.0;
+
+        for (size_t core_count = 1; core_count <= max_core_count; ++core_count)
+        {
+            auto result = Run(core_count, steal_policy);
+
+            auto throughput = kTaskCount / std::chrono::duration<double>(result.duration_).count();
+
+            baseline = (core_count == 1) ? throughput : baseline;
+
+            std::cout << "      " << std::setw(10) << (steal_policy == StealPolicy::kShared ? "shared" : steal_policy == StealPolicy::kRandom ? "random" : "topology")
+                      << std::setw(8) << core_count
+                      << std::setw(16) << std::fixed << std::setprecision(0) << throughput
+                      << std::setw(10) << std::setprecision(2) << (throughput / baseline)
+                      << std::setw(10) << result.statistics_.spins_
+                      << std::setw(10) << result.statistics_.yields_
+                      << std::setw(10) << result.statistics_.parks_
+                      << std::setw(10) << result.statistics_.wakeups_ << "\n";
+        }
+
+        std::cout << "\n";
+    }
+}
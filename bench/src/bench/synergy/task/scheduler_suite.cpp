@@ -0,0 +1,398 @@
+#include "bench/synergy/task/scheduler_suite.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include "syntropy/diagnostics/assert.h"
+#include "syntropy/time/timer.h"
+#include "syntropy/platform/threading.h"
+
+#include "synergy/task/scheduler.h"
+#include "synergy/patterns/parallel_algorithms.h"
+
+namespace
+{
+    using syntropy::synergy::TaskHandle;
+    using syntropy::synergy::TaskList;
+    using syntropy::synergy::TaskPriority;
+    using syntropy::synergy::StealPolicy;
+
+    /// \brief Number of runs for each configuration.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Number of round-trips of the spawn/join benchmark.
+    constexpr size_t kRoundTripCount = 1 << 10;
+
+    /// \brief Argument of the fib benchmark.
+    constexpr size_t kFibArgument = 25;
+
+    /// \brief Number of elements reduced by the reduce benchmark.
+    constexpr size_t kReduceCount = 1 << 26;
+
+    /// \brief Number of tasks spawned by each layer of the fan-out/fan-in benchmark.
+    constexpr size_t kFanOutWidth = 1 << 12;
+
+    /// \brief Number of layers of the fan-out/fan-in benchmark.
+    constexpr size_t kFanOutLayers = 16;
+
+    /// \brief Number of independent chains of the chain benchmark.
+    constexpr size_t kChainCount = 16;
+
+    /// \brief Number of tasks in each chain of the chain benchmark.
+    constexpr size_t kChainLength = 1 << 12;
+
+    /// \brief Number of low priority tasks of the mixed priority benchmark.
+    constexpr size_t kLowPriorityCount = 1 << 14;
+
+    /// \brief Number of low priority tasks spawning a high priority task in the mixed priority benchmark.
+    constexpr size_t kHighPriorityStride = 16;
+
+    /// \brief Sink for busy work, so that it cannot be optimized away. Per-thread to avoid false sharing among workers.
+    thread_local uint64_t busy_sink;
+
+    /// \brief Some busy work to keep tasks from being empty (FNV-1a).
+    void Busy(size_t seed, size_t iterations)
+    {
+        auto hash = uint64_t(14695981039346656037ull);
+
+        for (size_t index = 0; index < iterations; ++index)
+        {
+            hash = (hash ^ (seed + index)) * 1099511628211ull;
+        }
+
+        busy_sink += hash;
+    }
+
+    /// \brief Get the name of a steal policy.
+    const char* GetPolicyName(StealPolicy steal_policy)
+    {
+        switch (steal_policy)
+        {
+            case StealPolicy::kShared: return "shared";
+            case StealPolicy::kRandom: return "random";
+            case StealPolicy::kTopology: return "topology";
+        }
+
+        return "unknown";
+    }
+
+    /// \brief Get an affinity mask containing the first cores the process has affinity with.
+    syntropy::platform::AffinityMask GetCores(size_t count)
+    {
+        auto process_affinity = syntropy::platform::Threading::GetProcessAffinity();
+
+        auto cores = syntropy::platform::AffinityMask();
+
+        for (size_t core_index = 0; cores.GetCount() < count && core_index < process_affinity.GetSize(); ++core_index)
+        {
+            cores.Set(core_index, process_affinity.Test(core_index));
+        }
+
+        return cores;
+    }
+
+    /// \brief Launch a workload from within a task and block the calling thread until the task it returns completes.
+    /// The calling thread yields instead of executing tasks, so that only worker threads take part in the workload.
+    void RunTask(const std::function<TaskHandle()>& launch)
+    {
+        std::atomic_bool done{ false };
+
+        syntropy::synergy::DetachTask([&launch, &done]()
+        {
+            syntropy::synergy::CreateTask({ launch() }, [&done]()
+            {
+                done.store(true, std::memory_order_release);
+            });
+        });
+
+        while (!done.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// \brief Spawn-join benchmark: a thread outside the scheduler detaches an empty task and waits for it, one round-trip after another.
+    std::chrono::nanoseconds RunSpawnJoin()
+    {
+        auto timer = syntropy::Timer<std::chrono::nanoseconds>();
+
+        for (size_t round_trip = 0; round_trip < kRoundTripCount; ++round_trip)
+        {
+            std::atomic_bool done{ false };
+
+            syntropy::synergy::DetachTask([&done]()
+            {
+                done.store(true, std::memory_order_release);
+            });
+
+            while (!done.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        return timer.Stop() / kRoundTripCount;
+    }
+
+    /// \brief Fib benchmark: compute fib(n) spawning one task per call and joining each pair of calls via a continuation.
+    /// Results are stored in pre-order: the node at "index" computing fib(n) has its children at "index + 1" and "index + 1 + calls[n - 1]".
+    struct Fib
+    {
+        void operator()()
+        {
+            if (n_ < 2)
+            {
+                (*results_)[index_] = n_;
+                return;
+            }
+
+            auto left_index = index_ + 1;
+            auto right_index = left_index + (*calls_)[n_ - 1];
+
+            auto left = syntropy::synergy::EmplaceTask<Fib>({}, Fib{ n_ - 1, left_index, results_, calls_ });
+            auto right = syntropy::synergy::EmplaceTask<Fib>({}, Fib{ n_ - 2, right_index, results_, calls_ });
+
+            syntropy::synergy::CreateTaskContinuation({ left, right }, [results = results_, index = index_, left_index, right_index]()
+            {
+                (*results)[index] = (*results)[left_index] + (*results)[right_index];
+            });
+        }
+
+        size_t n_;
+        size_t index_;
+        std::vector<uint64_t>* results_;
+        const std::array<size_t, kFibArgument + 1>* calls_;
+    };
+
+    /// \brief Fan-out/fan-in benchmark: each layer spawns many independent tasks and joins them via a continuation spawning the next layer.
+    struct FanOut
+    {
+        void operator()()
+        {
+            auto children = TaskList();
+
+            children.reserve(kFanOutWidth);
+
+            for (size_t index = 0; index < kFanOutWidth; ++index)
+            {
+                children.emplace_back(syntropy::synergy::CreateTask({}, [index]() { Busy(index, 64); }));
+            }
+
+            if (layer_ + 1 < kFanOutLayers)
+            {
+                syntropy::synergy::EmplaceTaskContinuation<FanOut>(children, FanOut{ layer_ + 1 });
+            }
+            else
+            {
+                syntropy::synergy::CreateTaskContinuation(children, []() {});
+            }
+        }
+
+        size_t layer_;
+    };
+
+    /// \brief Measure a workload and add the resulting sample to the report.
+    /// \param run Executes one run of the workload and returns its benchmark-specific latency, if any.
+    void Measure(BenchmarkReport& report, const char* benchmark, StealPolicy steal_policy, size_t threads, size_t items, const std::function<std::optional<std::chrono::nanoseconds>()>& run)
+    {
+        auto sample = BenchmarkSample{ benchmark, GetPolicyName(steal_policy), threads, kRunCount, items };
+
+        auto best = std::chrono::nanoseconds::max();
+        auto total = std::chrono::nanoseconds::zero();
+        auto latency = std::chrono::nanoseconds::zero();
+
+        for (size_t index = 0; index < kRunCount; ++index)
+        {
+            auto timer = syntropy::Timer<std::chrono::nanoseconds>();
+
+            auto run_latency = run();
+
+            auto duration = timer.Stop();
+
+            best = std::min(best, duration);
+            total += duration;
+
+            if (run_latency)
+            {
+                latency += *run_latency;
+                sample.latency_ = latency / (index + 1);
+            }
+        }
+
+        sample.best_ = best;
+        sample.mean_ = total / kRunCount;
+
+        std::cout << "      " << std::setw(16) << sample.benchmark_
+                  << std::setw(10) << sample.configuration_
+                  << std::setw(8) << sample.threads_
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (sample.best_.count() / 1000.0)
+                  << std::setw(16) << (sample.items_ * 1e9 / sample.best_.count());
+
+        if (sample.latency_)
+        {
+            std::cout << std::setw(14) << std::setprecision(2) << (sample.latency_->count() / 1000.0);
+        }
+
+        std::cout << "\n";
+
+        report.Add(std::move(sample));
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNERGY SCHEDULER SUITE                                    */
+/************************************************************************/
+
+void BenchmarkSynergySchedulerSuite(BenchmarkReport& report, size_t max_thread_count)
+{
+    using namespace syntropy::synergy;
+
+    auto core_count = syntropy::platform::Threading::GetProcessAffinity().GetCount();
+
+    max_thread_count = (max_thread_count > 0) ? std::min(max_thread_count, core_count) : core_count;
+
+    std::cout << "   Benchmarking synergy scheduler suite (1 to " << max_thread_count << " threads, " << kRunCount << " runs each)\n\n";
+
+    std::cout << "      " << std::setw(16) << "benchmark" << std::setw(10) << "policy" << std::setw(8) << "threads" << std::setw(14) << "best (us)"
+              << std::setw(16) << "items/s" << std::setw(14) << "latency (us)" << "\n";
+
+    // Workloads state, shared by every configuration.
+
+    auto fib_calls = std::array<size_t, kFibArgument + 1>{};
+
+    for (size_t n = 0; n <= kFibArgument; ++n)
+    {
+        fib_calls[n] = (n < 2) ? 1 : (1 + fib_calls[n - 1] + fib_calls[n - 2]);
+    }
+
+    auto fib_results = std::vector<uint64_t>(fib_calls[kFibArgument]);
+
+    auto reduce_input = std::vector<int32_t>(kReduceCount);
+
+    std::iota(reduce_input.begin(), reduce_input.end(), 0);
+
+    std::transform(reduce_input.begin(), reduce_input.end(), reduce_input.begin(), [](int32_t value) { return value & 0xFF; });
+
+    auto reduce_expected = std::accumulate(reduce_input.begin(), reduce_input.end(), int64_t(0));
+
+    for (auto steal_policy : { StealPolicy::kShared, StealPolicy::kRandom, StealPolicy::kTopology })
+    {
+        for (size_t threads = 1; threads <= max_thread_count; ++threads)
+        {
+            GetScheduler().Initialize(GetCores(threads), steal_policy);
+
+            // Spawn/join latency.
+
+            Measure(report, "spawn_join", steal_policy, threads, kRoundTripCount, []()
+            {
+                return std::optional<std::chrono::nanoseconds>(RunSpawnJoin());
+            });
+
+            // Recursive fib: one task per call plus one continuation per inner call.
+
+            Measure(report, "fib", steal_policy, threads, fib_calls[kFibArgument] + fib_calls[kFibArgument] / 2, [&]()
+            {
+                RunTask([&]() { return EmplaceTask<Fib>({}, Fib{ kFibArgument, 0, &fib_results, &fib_calls }); });
+
+                SYNTROPY_ASSERT(fib_results[0] == 75025);                                   // fib(25).
+
+                return std::optional<std::chrono::nanoseconds>();
+            });
+
+            // Parallel reduce.
+
+            Measure(report, "reduce", steal_policy, threads, kReduceCount, [&]()
+            {
+                auto sum = int64_t(0);
+
+                RunTask([&]() { return ParallelReduce(reduce_input.begin(), reduce_input.end(), int64_t(0), std::plus<>(), sum); });
+
+                SYNTROPY_ASSERT(sum == reduce_expected);
+
+                return std::optional<std::chrono::nanoseconds>();
+            });
+
+            // Wide fan-out/fan-in.
+
+            Measure(report, "fan_out_fan_in", steal_policy, threads, kFanOutLayers * (kFanOutWidth + 1) + 1, []()
+            {
+                RunTask([]() { return EmplaceTask<FanOut>({}, FanOut{ 0 }); });
+
+                return std::optional<std::chrono::nanoseconds>();
+            });
+
+            // Long dependency chains, built upfront by a single task.
+
+            Measure(report, "chains", steal_policy, threads, kChainCount * kChainLength + 1, []()
+            {
+                RunTask([]()
+                {
+                    auto tails = TaskList();
+
+                    for (size_t chain = 0; chain < kChainCount; ++chain)
+                    {
+                        auto link = TaskHandle();
+
+                        for (size_t index = 0; index < kChainLength; ++index)
+                        {
+                            link = CreateTask(link ? TaskList{ link } : TaskList{}, [index]() { Busy(index, 64); });
+                        }
+
+                        tails.emplace_back(std::move(link));
+                    }
+
+                    return CreateTask(tails, []() {});
+                });
+
+                return std::optional<std::chrono::nanoseconds>();
+            });
+
+            // Mixed priorities: latency of high priority tasks spawned while the workers are busy with low priority ones.
+
+            Measure(report, "mixed_priority", steal_policy, threads, kLowPriorityCount + kLowPriorityCount / kHighPriorityStride, []()
+            {
+                std::atomic<uint64_t> latency{ 0 };
+
+                RunTask([&latency]()
+                {
+                    auto tasks = TaskList();
+
+                    tasks.reserve(kLowPriorityCount);
+
+                    for (size_t index = 0; index < kLowPriorityCount; ++index)
+                    {
+                        tasks.emplace_back(CreateTask(TaskPriority::kLow, {}, [index, &latency]()
+                        {
+                            Busy(index, 256);
+
+                            if (index % kHighPriorityStride == 0)
+                            {
+                                auto high = CreateTask(TaskPriority::kHigh, {}, [&latency, timer = syntropy::Timer<std::chrono::nanoseconds>()]()
+                                {
+                                    latency.fetch_add(timer().count(), std::memory_order_relaxed);
+                                });
+
+                                CreateTaskContinuation({ high }, []() {});
+                            }
+                        }));
+                    }
+
+                    return CreateTask(tasks, []() {});
+                });
+
+                return std::optional<std::chrono::nanoseconds>(std::chrono::nanoseconds(latency.load() / (kLowPriorityCount / kHighPriorityStride)));
+            });
+
+            GetScheduler().Shutdown();
+        }
+
+        std::cout << "\n";
+    }
+}
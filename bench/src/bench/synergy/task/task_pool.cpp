@@ -0,0 +1,185 @@
+#include "bench/synergy/task/task_pool.h"
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "syntropy/time/timer.h"
+#include "syntropy/platform/threading.h"
+
+#include "synergy/task/scheduler.h"
+
+/************************************************************************/
+/* GLOBAL ALLOCATION TRACKING                                           */
+/************************************************************************/
+
+namespace
+{
+    /// \brief Number of allocations performed via the global operator new.
+    std::atomic<size_t> global_allocations{ 0 };
+}
+
+// The replacement is program-wide: every benchmark in this executable pays for an additional relaxed increment per allocation.
+
+void* operator new(std::size_t size)
+{
+    global_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (auto block = std::malloc(size > 0 ? size : 1))
+    {
+        return block;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    global_allocations.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef _MSC_VER
+    auto block = _aligned_malloc(size > 0 ? size : 1, static_cast<std::size_t>(alignment));
+#else
+    auto block = std::aligned_alloc(static_cast<std::size_t>(alignment), (std::max(size, std::size_t(1)) + static_cast<std::size_t>(alignment) - 1) & ~(static_cast<std::size_t>(alignment) - 1));
+#endif
+
+    if (block)
+    {
+        return block;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t /*size*/) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t /*alignment*/) noexcept
+{
+#ifdef _MSC_VER
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+
+void operator delete(void* block, std::size_t /*size*/, std::align_val_t alignment) noexcept
+{
+    operator delete(block, alignment);
+}
+
+namespace
+{
+    /// \brief Number of tasks spawned by each run.
+    constexpr size_t kTaskCount = 1 << 18;
+
+    /// \brief Number of runs for each configuration. The fastest run is retained.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Result of a benchmark run.
+    struct RunResult
+    {
+        std::chrono::microseconds duration_;            ///< \brief Duration of the fastest run.
+        size_t allocations_;                            ///< \brief Global allocations performed by the fastest run.
+    };
+
+    /// \brief Get an affinity mask containing the first cores the process has affinity with.
+    syntropy::platform::AffinityMask GetCores(size_t count)
+    {
+        auto process_affinity = syntropy::platform::Threading::GetProcessAffinity();
+
+        auto cores = syntropy::platform::AffinityMask();
+
+        for (size_t core_index = 0; cores.GetCount() < count && core_index < process_affinity.GetSize(); ++core_index)
+        {
+            cores.Set(core_index, process_affinity.Test(core_index));
+        }
+
+        return cores;
+    }
+
+    /// \brief Spawn a flat batch of empty tasks from a single task and wait for all of them to complete.
+    RunResult Run(size_t core_count)
+    {
+        auto& scheduler = syntropy::synergy::GetScheduler();
+
+        scheduler.Initialize(GetCores(core_count), syntropy::synergy::StealPolicy::kRandom);
+
+        auto best = RunResult{ std::chrono::microseconds::max(), 0 };
+
+        for (size_t run = 0; run < kRunCount; ++run)
+        {
+            std::atomic<size_t> pending{ kTaskCount };
+
+            auto allocations = global_allocations.load(std::memory_order_relaxed);
+
+            auto timer = syntropy::Timer<std::chrono::microseconds>();
+
+            syntropy::synergy::DetachTask([&pending]()
+            {
+                for (size_t index = 0; index < kTaskCount; ++index)
+                {
+                    syntropy::synergy::CreateTask({}, [&pending]()
+                    {
+                        pending.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+            });
+
+            while (pending.load(std::memory_order_acquire) > 0)
+            {
+                std::this_thread::yield();
+            }
+
+            auto duration = timer.Stop();
+
+            allocations = global_allocations.load(std::memory_order_relaxed) - allocations;
+
+            if (duration < best.duration_)
+            {
+                best = RunResult{ duration, allocations };
+            }
+        }
+
+        scheduler.Shutdown();
+
+        return best;
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNERGY TASK POOL                                          */
+/************************************************************************/
+
+void BenchmarkSynergyTaskPool()
+{
+    auto max_core_count = syntropy::platform::Threading::GetProcessAffinity().GetCount();
+
+    std::cout << "   Benchmarking synergy task spawn (" << kTaskCount << " tasks per run)\n\n";
+
+    std::cout << "      " << std::setw(8) << "cores" << std::setw(16) << "tasks/s" << std::setw(16) << "allocs/task" << "\n";
+
+    for (auto core_count : { size_t(1), max_core_count })
+    {
+        auto result = Run(core_count);
+
+        auto throughput = kTaskCount / std::chrono::duration<double>(result.duration_).count();
+
+        std::cout << "      " << std::setw(8) << core_count
+                  << std::setw(16) << std::fixed << std::setprecision(0) << throughput
+                  << std::setw(16) << std::setprecision(3) << (double(result.allocations_) / kTaskCount) << "\n";
+    }
+
+    std::cout << "\n";
+}
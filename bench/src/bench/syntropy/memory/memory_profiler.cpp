@@ -0,0 +1,155 @@
+#include "bench/syntropy/memory/memory_profiler.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/memory_profiler.h"
+#include "syntropy/memory/allocators/segregated_allocator.h"
+#include "syntropy/time/timer.h"
+#include "syntropy/platform/threading.h"
+
+namespace
+{
+    /// \brief Number of runs for each configuration.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Number of blocks each thread allocates before deallocating them.
+    constexpr size_t kBatchSize = 64;
+
+    /// \brief Number of batches allocated by each thread.
+    constexpr size_t kBatchCount = 1 << 11;
+
+    /// \brief Capacity of the allocator.
+    constexpr syntropy::Bytes kCapacity = syntropy::Bytes(64u << 20);
+
+    /// \brief Stack trace passed to the profiler hooks. Built once, as SYNTROPY_ALLOC would build it for its log anyway.
+    const syntropy::diagnostics::StackTrace kStackTrace = SYNTROPY_HERE;
+
+    /// \brief Each thread allocates one batch of blocks at a time and deallocates it afterwards. Block sizes vary within a batch, as they would in a real workload.
+    /// Blocks are allocated from the allocator directly rather than via SYNTROPY_ALLOC and SYNTROPY_FREE, whose logging would dominate the measure.
+    /// \param is_hooked Whether each allocation and deallocation goes through the profiler hooks, as SYNTROPY_ALLOC and SYNTROPY_FREE do.
+    /// \return Returns the duration of the run.
+    std::chrono::nanoseconds Run(syntropy::Allocator& allocator, size_t thread_count, bool is_hooked)
+    {
+        auto threads = std::vector<std::thread>();
+
+        auto timer = syntropy::Timer<std::chrono::nanoseconds>();
+
+        for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+        {
+            threads.emplace_back([&allocator, is_hooked]()
+            {
+                auto batch = std::vector<void*>(kBatchSize);
+
+                for (size_t batch_index = 0; batch_index < kBatchCount; ++batch_index)
+                {
+                    for (size_t block_index = 0; block_index < kBatchSize; ++block_index)
+                    {
+                        auto size = syntropy::Bytes(16 + 16 * (block_index % 16));
+
+                        batch[block_index] = allocator.Allocate(size);
+
+                        if (is_hooked)
+                        {
+                            syntropy::MemoryProfiler::TrackAllocation(allocator, batch[block_index], size, kStackTrace);
+                        }
+                    }
+
+                    for (auto&& block : batch)
+                    {
+                        if (is_hooked)
+                        {
+                            syntropy::MemoryProfiler::TrackDeallocation(block);
+                        }
+
+                        allocator.Free(block);
+                    }
+                }
+            });
+        }
+
+        for (auto&& thread : threads)
+        {
+            thread.join();
+        }
+
+        return timer.Stop();
+    }
+
+    /// \brief Measure the allocator with the profiler in its current state and add the resulting sample to the report.
+    /// \param baseline Best duration of the allocator without hooks, the overhead is relative to. Zero if this is the baseline.
+    /// \return Returns the best duration.
+    std::chrono::nanoseconds Measure(BenchmarkReport& report, syntropy::Allocator& allocator, const char* configuration, size_t thread_count, bool is_hooked, std::chrono::nanoseconds baseline)
+    {
+        auto sample = BenchmarkSample{ "memory_profiler", configuration, thread_count, kRunCount, thread_count * kBatchCount * kBatchSize };
+
+        auto best = std::chrono::nanoseconds::max();
+        auto total = std::chrono::nanoseconds::zero();
+
+        for (size_t index = 0; index < kRunCount; ++index)
+        {
+            auto duration = Run(allocator, thread_count, is_hooked);
+
+            best = std::min(best, duration);
+            total += duration;
+        }
+
+        sample.best_ = best;
+        sample.mean_ = total / kRunCount;
+
+        std::cout << "      " << std::setw(12) << sample.configuration_
+                  << std::setw(8) << sample.threads_
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (sample.best_.count() / 1000.0)
+                  << std::setw(16) << (sample.items_ * 1e9 / sample.best_.count());
+
+        if (baseline.count() > 0)
+        {
+            std::cout << std::setw(11) << std::setprecision(2) << ((best.count() - baseline.count()) * 100.0 / baseline.count()) << "%";
+        }
+
+        std::cout << "\n";
+
+        report.Add(std::move(sample));
+
+        return best;
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNTROPY MEMORY PROFILER                                   */
+/************************************************************************/
+
+void BenchmarkSyntropyMemoryProfiler(BenchmarkReport& report, size_t max_thread_count)
+{
+    auto core_count = syntropy::platform::Threading::GetProcessAffinity().GetCount();
+
+    max_thread_count = (max_thread_count > 0) ? std::min(max_thread_count, core_count) : core_count;
+
+    auto allocator = syntropy::TwoLevelSegregatedFitAllocator("BenchmarkSyntropyMemoryProfiler", kCapacity, 4);
+
+    auto& profiler = syntropy::GetMemoryProfiler();
+
+    std::cout << "   Benchmarking syntropy memory profiler (1 to " << max_thread_count << " threads, " << kBatchCount * kBatchSize << " allocations per thread)\n\n";
+
+    std::cout << "      " << std::setw(12) << "profiler" << std::setw(8) << "threads" << std::setw(14) << "best (us)" << std::setw(16) << "allocations/s" << std::setw(12) << "overhead" << "\n";
+
+    for (size_t thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        auto baseline = Measure(report, allocator, "none", thread_count, false, std::chrono::nanoseconds::zero());
+
+        Measure(report, allocator, "disabled", thread_count, true, baseline);
+
+        profiler.Enable();
+
+        Measure(report, allocator, "enabled", thread_count, true, baseline);
+
+        profiler.Disable();
+        profiler.Reset();
+    }
+
+    std::cout << "\n";
+}
@@ -0,0 +1,197 @@
+#include "bench/syntropy/memory/pool_allocator.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+
+#include "syntropy/memory/bytes.h"
+#include "syntropy/memory/memory_range.h"
+#include "syntropy/memory/allocators/linear_allocator.h"
+#include "syntropy/memory/allocators/pool_allocator.h"
+#include "syntropy/time/timer.h"
+#include "syntropy/platform/threading.h"
+
+namespace
+{
+    using syntropy::Bytes;
+    using syntropy::MemoryRange;
+
+    /// \brief Number of runs for each configuration.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Number of messages each thread allocates before handing them over to another thread.
+    constexpr size_t kBatchSize = 64;
+
+    /// \brief Number of batches allocated by each thread.
+    constexpr size_t kBatchCount = 1 << 12;
+
+    /// \brief Size of each message.
+    constexpr Bytes kMessageSize = Bytes(64);
+
+    /// \brief Memory backing each pool. Messages are recycled, hence only a few batches worth of messages are ever carved out of it.
+    constexpr Bytes kCapacity = Bytes(16u << 20);
+
+    /// \brief Batch of messages.
+    using Batch = std::vector<MemoryRange>;
+
+    /// \brief Pool allocator shared by many threads via a mutex.
+    class MutexPool
+    {
+    public:
+
+        MutexPool(const MemoryRange& memory_range)
+            : allocator_(kMessageSize, syntropy::Alignment(), memory_range)
+        {
+
+        }
+
+        MemoryRange Allocate()
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            return allocator_.Allocate(kMessageSize);
+        }
+
+        void Deallocate(const MemoryRange& block)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            allocator_.Deallocate(block);
+        }
+
+    private:
+
+        std::mutex mutex_;
+
+        syntropy::PoolAllocator<syntropy::LinearAllocator> allocator_;
+    };
+
+    /// \brief Pool allocator shared by many threads without locks.
+    class LockFreePool
+    {
+    public:
+
+        LockFreePool(const MemoryRange& memory_range)
+            : allocator_(kMessageSize, syntropy::Alignment(), memory_range)
+        {
+
+        }
+
+        MemoryRange Allocate()
+        {
+            return allocator_.Allocate(kMessageSize);
+        }
+
+        void Deallocate(const MemoryRange& block)
+        {
+            allocator_.Deallocate(block);
+        }
+
+    private:
+
+        syntropy::PoolAllocator<syntropy::ConcurrentLinearAllocator, syntropy::ConcurrentPoolAllocatorPolicy> allocator_;
+    };
+
+    /// \brief Each thread fills a batch with new messages and swaps it with the batch left by another thread in a shared slot, then deallocates the messages it received.
+    /// \return Returns the duration of the run.
+    template <typename TPool>
+    std::chrono::nanoseconds Run(size_t thread_count)
+    {
+        auto storage = std::vector<uint8_t>(std::size_t(kCapacity));
+
+        auto pool = TPool(MemoryRange(syntropy::MemoryAddress(storage.data()), syntropy::MemoryAddress(storage.data() + storage.size())));
+
+        auto batches = std::vector<Batch>(thread_count + 1, Batch(kBatchSize));
+
+        std::atomic<Batch*> exchange{ &batches.back() };
+
+        auto threads = std::vector<std::thread>();
+
+        auto timer = syntropy::Timer<std::chrono::nanoseconds>();
+
+        for (size_t thread_index = 0; thread_index < thread_count; ++thread_index)
+        {
+            threads.emplace_back([&pool, &exchange, batch = &batches[thread_index]]() mutable
+            {
+                for (size_t batch_index = 0; batch_index < kBatchCount; ++batch_index)
+                {
+                    for (auto&& message : *batch)
+                    {
+                        if (message)
+                        {
+                            pool.Deallocate(message);
+                        }
+
+                        message = pool.Allocate();
+
+                        *message.Begin().As<size_t>() = batch_index;                // Touch the message, as a producer would.
+                    }
+
+                    batch = exchange.exchange(batch, std::memory_order_acq_rel);
+                }
+            });
+        }
+
+        for (auto&& thread : threads)
+        {
+            thread.join();
+        }
+
+        return timer.Stop();
+    }
+
+    /// \brief Measure a pool and add the resulting sample to the report.
+    template <typename TPool>
+    void Measure(BenchmarkReport& report, const char* configuration, size_t thread_count)
+    {
+        auto sample = BenchmarkSample{ "pool_allocator", configuration, thread_count, kRunCount, thread_count * kBatchCount * kBatchSize };
+
+        auto best = std::chrono::nanoseconds::max();
+        auto total = std::chrono::nanoseconds::zero();
+
+        for (size_t index = 0; index < kRunCount; ++index)
+        {
+            auto duration = Run<TPool>(thread_count);
+
+            best = std::min(best, duration);
+            total += duration;
+        }
+
+        sample.best_ = best;
+        sample.mean_ = total / kRunCount;
+
+        std::cout << "      " << std::setw(12) << sample.configuration_
+                  << std::setw(8) << sample.threads_
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (sample.best_.count() / 1000.0)
+                  << std::setw(16) << (sample.items_ * 1e9 / sample.best_.count()) << "\n";
+
+        report.Add(std::move(sample));
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNTROPY POOL ALLOCATOR                                    */
+/************************************************************************/
+
+void BenchmarkSyntropyPoolAllocator(BenchmarkReport& report, size_t max_thread_count)
+{
+    auto core_count = syntropy::platform::Threading::GetProcessAffinity().GetCount();
+
+    max_thread_count = (max_thread_count > 0) ? std::min(max_thread_count, core_count) : core_count;
+
+    std::cout << "   Benchmarking syntropy pool allocator (1 to " << max_thread_count << " threads, " << kBatchCount * kBatchSize << " messages per thread)\n\n";
+
+    std::cout << "      " << std::setw(12) << "pool" << std::setw(8) << "threads" << std::setw(14) << "best (us)" << std::setw(16) << "messages/s" << "\n";
+
+    for (size_t thread_count = 1; thread_count <= max_thread_count; ++thread_count)
+    {
+        Measure<MutexPool>(report, "mutex", thread_count);
+        Measure<LockFreePool>(report, "lock_free", thread_count);
+    }
+
+    std::cout << "\n";
+}
@@ -0,0 +1,146 @@
+#include "bench/syntropy/reflection/property.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+
+#include "syntropy/reflection/class.h"
+#include "syntropy/reflection/property.h"
+#include "syntropy/reflection/any.h"
+#include "syntropy/reflection/interfaces/property_interfaces.h"
+#include "syntropy/reflection/types/fundamental_types.h"
+#include "syntropy/reflection/types/stl_types.h"
+#include "syntropy/time/timer.h"
+
+namespace
+{
+    /// \brief Number of runs for each configuration.
+    constexpr size_t kRunCount = 5;
+
+    /// \brief Number of property accesses in each run.
+    constexpr size_t kAccessCount = 1 << 20;
+
+    /// \brief Reflected class whose properties are accessed by the benchmark.
+    struct Payload
+    {
+        int count_{ 0 };                                        ///< \brief Small property, stored inline by reflection::Any.
+
+        float weight_{ 0.0f };                                  ///< \brief Small property, stored inline by reflection::Any.
+
+        std::string name_{ "a property name longer than the small string buffer" };     ///< \brief Large property, stored out of line by reflection::Any.
+    };
+}
+
+template <>
+struct syntropy::reflection::ClassDeclarationT<Payload>
+{
+    static constexpr const char* name_{ "BenchmarkSyntropyReflectionProperty::Payload" };
+
+    void operator()(ClassT<Payload>& class_t) const
+    {
+        class_t.AddProperty("Count", &Payload::count_);
+        class_t.AddProperty("Weight", &Payload::weight_);
+        class_t.AddProperty("Name", &Payload::name_);
+    }
+};
+
+namespace
+{
+    /// \brief Measure a property access and add the resulting sample to the report.
+    /// \param access Functor performing a single property access.
+    template <typename TAccess>
+    void Measure(BenchmarkReport& report, const char* configuration, TAccess&& access)
+    {
+        auto sample = BenchmarkSample{ "reflection_property", configuration, 1, kRunCount, kAccessCount };
+
+        auto best = std::chrono::nanoseconds::max();
+        auto total = std::chrono::nanoseconds::zero();
+
+        for (size_t index = 0; index < kRunCount; ++index)
+        {
+            auto timer = syntropy::Timer<std::chrono::nanoseconds>();
+
+            for (size_t access_index = 0; access_index < kAccessCount; ++access_index)
+            {
+                access(access_index);
+            }
+
+            auto duration = timer.Stop();
+
+            best = std::min(best, duration);
+            total += duration;
+        }
+
+        sample.best_ = best;
+        sample.mean_ = total / kRunCount;
+
+        std::cout << "      " << std::setw(16) << sample.configuration_
+                  << std::setw(14) << std::fixed << std::setprecision(0) << (sample.best_.count() / 1000.0)
+                  << std::setw(16) << (sample.items_ * 1e9 / sample.best_.count()) << "\n";
+
+        report.Add(std::move(sample));
+    }
+}
+
+/************************************************************************/
+/* BENCHMARK SYNTROPY REFLECTION PROPERTY                               */
+/************************************************************************/
+
+void BenchmarkSyntropyReflectionProperty(BenchmarkReport& report)
+{
+    using syntropy::reflection::Readable;
+    using syntropy::reflection::Writeable;
+    using syntropy::reflection::AnyCast;
+
+    auto& payload_class = syntropy::reflection::ClassOf<Payload>();
+
+    auto count_reader = payload_class.GetProperty("Count")->GetInterface<Readable>();
+    auto count_writer = payload_class.GetProperty("Count")->GetInterface<Writeable>();
+    auto weight_reader = payload_class.GetProperty("Weight")->GetInterface<Readable>();
+    auto weight_writer = payload_class.GetProperty("Weight")->GetInterface<Writeable>();
+    auto name_reader = payload_class.GetProperty("Name")->GetInterface<Readable>();
+    auto name_writer = payload_class.GetProperty("Name")->GetInterface<Writeable>();
+
+    auto payload = Payload{};
+
+    auto name = payload.name_;
+
+    auto checksum = size_t{ 0 };                                // Keeps the reads from being optimized away.
+
+    std::cout << "   Benchmarking syntropy reflection property (" << kAccessCount << " accesses per run, any inline size " << syntropy::reflection::Any::kInlineSize << " bytes)\n\n";
+
+    std::cout << "      " << std::setw(16) << "access" << std::setw(14) << "best (us)" << std::setw(16) << "accesses/s" << "\n";
+
+    Measure(report, "int_get", [&](size_t)
+    {
+        checksum += AnyCast<int>((*count_reader)(payload));
+    });
+
+    Measure(report, "int_set", [&](size_t index)
+    {
+        (*count_writer)(payload, static_cast<int>(index));
+    });
+
+    Measure(report, "float_get", [&](size_t)
+    {
+        checksum += static_cast<size_t>(AnyCast<float>((*weight_reader)(payload)));
+    });
+
+    Measure(report, "float_set", [&](size_t index)
+    {
+        (*weight_writer)(payload, static_cast<float>(index));
+    });
+
+    Measure(report, "string_get", [&](size_t)
+    {
+        checksum += AnyCast<const std::string&>((*name_reader)(payload)).size();
+    });
+
+    Measure(report, "string_set", [&](size_t)
+    {
+        (*name_writer)(payload, name);
+    });
+
+    std::cout << "\n      (checksum " << checksum << ")\n\n";
+}
@@ -0,0 +1,29 @@
+/// \file event_count.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "syntropy/unit_test/test_fixture.h"
+#include "syntropy/unit_test/test_case.h"
+
+#include <vector>
+
+/************************************************************************/
+/* TEST SYNERGY EVENT COUNT                                             */
+/************************************************************************/
+
+/// \brief Test suite used to test Synergy event counts.
+class TestSynergyEventCount : public syntropy::TestFixture
+{
+public:
+
+    static std::vector<syntropy::TestCase> GetTestCases();
+
+    /// \brief Test notifications issued with and without registered waiters, from a single thread.
+    void TestNotify();
+
+    /// \brief Test waiters parked by CommitWait() and woken up by Notify().
+    void TestParkedWaiters();
+
+};
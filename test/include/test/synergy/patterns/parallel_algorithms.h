@@ -0,0 +1,61 @@
+/// \file parallel_algorithms.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "syntropy/unit_test/test_fixture.h"
+#include "syntropy/unit_test/test_case.h"
+
+#include "synergy/task/scheduler.h"
+
+#include <vector>
+
+/************************************************************************/
+/* TEST SYNERGY PARALLEL ALGORITHMS                                     */
+/************************************************************************/
+
+/// \brief Test suite used to test Synergy parallel algorithms against their serial std:: counterparts.
+/// The suite is run once for each steal policy.
+class TestSynergyParallelAlgorithms : public syntropy::TestFixture
+{
+public:
+
+    static std::vector<syntropy::TestCase> GetTestCases();
+
+    /// \brief Create a new fixture.
+    /// \param steal_policy Steal policy the scheduler is initialized with.
+    TestSynergyParallelAlgorithms(syntropy::synergy::StealPolicy steal_policy);
+
+    /// \brief Initialize the scheduler.
+    virtual void Before() override;
+
+    /// \brief Shutdown the scheduler.
+    virtual void After() override;
+
+    /// \brief Test ParallelFor.
+    void TestFor();
+
+    /// \brief Test LazyParallelFor.
+    void TestLazyFor();
+
+    /// \brief Test ParallelTransform.
+    void TestTransform();
+
+    /// \brief Test ParallelReduce.
+    void TestReduce();
+
+    /// \brief Test ParallelInclusiveScan.
+    void TestInclusiveScan();
+
+    /// \brief Test ParallelSort.
+    void TestSort();
+
+private:
+
+    /// \brief Get a sequence of pseudo-random numbers.
+    static std::vector<int> GetNumbers(size_t count);
+
+    syntropy::synergy::StealPolicy steal_policy_;              ///< \brief Steal policy the scheduler is initialized with.
+
+};
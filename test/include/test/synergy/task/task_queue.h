@@ -0,0 +1,33 @@
+/// \file task_queue.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "syntropy/unit_test/test_fixture.h"
+#include "syntropy/unit_test/test_case.h"
+
+#include <vector>
+
+/************************************************************************/
+/* TEST SYNERGY TASK QUEUE                                              */
+/************************************************************************/
+
+/// \brief Test suite used to stress the lock-free work-stealing queues of Synergy task system.
+/// Every test checks that each task pushed on a queue is taken exactly once, either by the owner or by a thief.
+class TestSynergyTaskQueue : public syntropy::TestFixture
+{
+public:
+
+    static std::vector<syntropy::TestCase> GetTestCases();
+
+    /// \brief Test the owner pushing and popping tasks while many thieves steal them concurrently.
+    void TestOwnerAndThieves();
+
+    /// \brief Test a queue starting with a tiny buffer and growing while thieves steal from it, via both single and bulk pushes.
+    void TestGrowth();
+
+    /// \brief Test the owner popping the last task in the queue while thieves try to steal it.
+    void TestLastTaskRace();
+
+};
@@ -8,6 +8,8 @@
 #include "syntropy/unit_test/test_fixture.h"
 #include "syntropy/unit_test/test_case.h"
 
+#include "synergy/task/scheduler.h"
+
 #include <vector>
 
 /************************************************************************/
@@ -15,15 +17,52 @@
 /************************************************************************/
 
 /// \brief Test suite used to test Synergy task system.
+/// The suite is run once for each steal policy.
 class TestSynergyTaskSystem : public syntropy::TestFixture
 {
 public:
 
     static std::vector<syntropy::TestCase> GetTestCases();
 
+    /// \brief Create a new fixture.
+    /// \param steal_policy Steal policy the scheduler is initialized with.
+    TestSynergyTaskSystem(syntropy::synergy::StealPolicy steal_policy);
+
+    /// \brief Initialize the scheduler.
+    virtual void Before() override;
+
+    /// \brief Shutdown the scheduler.
+    virtual void After() override;
+
     /// \brief Test Synergy task graph.
     void TestTaskGraph();
 
+    /// \brief Test waiting for tasks from a thread outside the scheduler.
+    void TestWaitFor();
+
+    /// \brief Test launching a recorded task graph many times.
+    void TestTaskGraphReplay();
+
+    /// \brief Test external threads submitting tasks and exiting while workers still release their tasks.
+    void TestExternalThreads();
+
+    /// \brief Test workers parking when idle and being woken up by new tasks.
+    void TestIdleWorkers();
+
+    /// \brief Test tasks submitted while workers are spinning, backing off or parking: no task may be left behind by a lost wake-up.
+    void TestWakeUps();
+
+    /// \brief Test coroutines awaiting other tasks and releasing their frames to the task pool.
+    void TestCoroutines();
+
+    /// \brief Test urgent tasks served before a backlog of less urgent ones, and less urgent tasks aging until they are served anyway.
+    void TestPriorityAging();
+
+    /// \brief Test a list of tasks with mixed priorities pushed at once on the queues matching their priority class, in submission order.
+    void TestPriorityLanes();
+
 private:
 
+    syntropy::synergy::StealPolicy steal_policy_;              ///< \brief Steal policy the scheduler is initialized with.
+
 };
@@ -0,0 +1,27 @@
+/// \file task_trace.h
+///
+/// \author Raffaele D. Facendola - 2018
+
+#pragma once
+
+#include "syntropy/unit_test/test_fixture.h"
+#include "syntropy/unit_test/test_case.h"
+
+#include <vector>
+
+/************************************************************************/
+/* TEST SYNERGY TASK TRACE                                              */
+/************************************************************************/
+
+/// \brief Test suite used to test the timeline recorded by Synergy task system.
+/// Test cases are skipped unless the task system is built with SYNERGY_TRACE.
+class TestSynergyTaskTrace : public syntropy::TestFixture
+{
+public:
+
+    static std::vector<syntropy::TestCase> GetTestCases();
+
+    /// \brief Test a task graph exported as a Chrome trace: spans must be balanced and each dependency must be linked to its successor.
+    void TestChromeTrace();
+
+};
@@ -35,7 +35,44 @@ public:
     /// \brief Test Syntropy memory context.
     void TestMemoryContext();
 
+    /// \brief Test blocks allocated by the per-thread caches of a two-level segregated fit allocator and freed by other threads.
+    void TestThreadCache();
+
+    /// \brief Test blocks freed by other threads into the per-thread cache of a thread still running, and collected by that thread.
+    void TestThreadCacheRemoteFree();
+
+    /// \brief Test blocks packed inside the slabs of a slab allocator.
+    void TestSlabAllocator();
+
+    /// \brief Test statistics collected by the memory profiler.
+    void TestMemoryProfiler();
+
+    /// \brief Test memory recycled by an epoch arena once its epochs are signalled.
+    void TestEpochArena();
+
+    /// \brief Test threads allocating from an epoch arena while another thread advances it.
+    void TestEpochArenaConcurrency();
+
+    /// \brief Test memory committed and decommitted by a virtual linear allocator as it grows and rewinds.
+    void TestVirtualLinearAllocator();
+
+    /// \brief Test ranges inserted, looked up and erased from a page map.
+    void TestPageMap();
+
+    /// \brief Test blocks resolved to the allocator owning them by the memory manager, including blocks on chunks shared by two allocators.
+    void TestAllocatorLookup();
+
+    /// \brief Test files mapped to memory, either read-only or copy-on-write.
+    void TestMappedFile();
+
+    /// \brief Test blocks allocated from a lock-free pool allocator by many threads and deallocated by threads other than the allocating one.
+    void TestConcurrentPoolAllocator();
+
+    /// \brief Test ranges reserved with large pages, falling back to regular pages when the system cannot provide them.
+    void TestLargePages();
+
 private:
 
+    bool has_configuration_{ false };           ///< \brief Whether the memory configuration could be imported.
 
 };
@@ -11,6 +11,8 @@
 #include "syntropy/reflection/reflection.h"
 #include "syntropy/reflection/class.h"
 
+#include "syntropy/memory/allocators/allocator.h"
+
 #include <vector>
 #include <string>
 
@@ -68,6 +70,61 @@ public:
         Canary();
     };
 
+    /// \brief Value whose live instances are counted. Stored out of line by reflection::Any.
+    struct Crate
+    {
+        Crate(int value);
+
+        Crate(const Crate& other);
+
+        ~Crate();
+
+        int value_;
+
+        int padding_[8] = {};
+
+        static int instances_;          ///< \brief Number of live instances.
+    };
+
+    /// \brief Small value counting its copies and moves. Stored inline by reflection::Any.
+    struct Token
+    {
+        /// \brief Throws if value is negative.
+        Token(int value);
+
+        Token(const Token& other);
+
+        Token(Token&& other) noexcept;
+
+        int value_;
+
+        static int copies_;             ///< \brief Number of copy-constructions.
+
+        static int moves_;              ///< \brief Number of move-constructions.
+    };
+
+    /// \brief Allocator counting its live blocks, used to test reflection::Any custom allocations.
+    class TrackingAllocator : public syntropy::Allocator
+    {
+    public:
+
+        void* Allocate(syntropy::Bytes size) override;
+
+        void* Allocate(syntropy::Bytes size, syntropy::Alignment alignment) override;
+
+        void Free(void* block) override;
+
+        bool Owns(void* block) const override;
+
+        syntropy::Bytes GetMaxAllocationSize() const override;
+
+        static constexpr std::size_t kMaxAlignment = 64;        ///< \brief Alignment of each block.
+
+        int blocks_{ 0 };                                       ///< \brief Number of live blocks.
+
+        bool out_of_memory_{ false };                           ///< \brief Whether every allocation should fail.
+    };
+
     static std::vector<syntropy::TestCase> GetTestCases();
 
     TestSyntropyReflection();
@@ -99,6 +156,21 @@ public:
     /// \brief Test class properties move (outward).
     void TestPropertyMove();
 
+    /// \brief Test copies of reflection::Any, for both inline and out-of-line values.
+    void TestAnyCopy();
+
+    /// \brief Test moves of reflection::Any, for both inline and out-of-line values.
+    void TestAnyMove();
+
+    /// \brief Test swaps and self-swaps of reflection::Any, for both inline and out-of-line values.
+    void TestAnySwap();
+
+    /// \brief Test reflection::Any custom allocators, switching allocator while values are alive.
+    void TestAnyAllocator();
+
+    /// \brief Test values emplaced and assigned to reflection::Any in place, for both inline and out-of-line values.
+    void TestAnyEmplace();
+
 private:
 
     const syntropy::reflection::Class* pet_class_;
@@ -11,6 +11,8 @@
 #include "syntropy/reflection/reflection.h"
 #include "syntropy/reflection/class.h"
 
+#include "syntropy/serialization/json/deserialization.h"
+
 #include "nlohmann/json/src/json.hpp"
 
 /************************************************************************/
@@ -53,9 +53,12 @@
          std::cout << "Result: " << args.result_ << "\n";
      });
  
-     test_runner.Run("");
+     auto result = test_runner.Run("");
  
+ #ifdef _WIN64
      system("pause");
+ #endif
  
+     return (result == syntropy::TestResult::kSuccess) ? 0 : 1;
  }
  
\ No newline at end of file
@@ -50,7 +50,7 @@ float TestSynapseSearch::GraphNode::GetDistance(const GraphNode& destination) co
     auto diff_x = x_ - destination.x_;
     auto diff_y = y_ - destination.y_;
 
-    return std::sqrtf(float(diff_x * diff_x + diff_y * diff_y));
+    return std::sqrt(float(diff_x * diff_x + diff_y * diff_y));
 }
 
 /************************************************************************/
@@ -78,7 +78,7 @@ const TestSynapseSearch::GraphNode& TestSynapseSearch::Graph::GetNode(int32_t x,
 /* TEST SYNAPSE SEARCH                                                  */
 /************************************************************************/
 
-syntropy::AutoTestSuite<TestSynapseSearch> suite("synapse.search");
+static syntropy::AutoTestSuite<TestSynapseSearch> suite("synapse.search");
 
 std::vector<syntropy::TestCase> TestSynapseSearch::GetTestCases()
 {
@@ -0,0 +1,111 @@
+#include "test/synergy/patterns/event_count.h"
+
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "syntropy/unit_test/test_runner.h"
+
+#include "synergy/patterns/event_count.h"
+
+/************************************************************************/
+/* TEST SYNERGY EVENT COUNT                                             */
+/************************************************************************/
+
+static syntropy::AutoTestSuite<TestSynergyEventCount> suite("synergy.patterns.eventcount");
+
+std::vector<syntropy::TestCase> TestSynergyEventCount::GetTestCases()
+{
+    return
+    {
+        { "notify", &TestSynergyEventCount::TestNotify },
+        { "parked waiters", &TestSynergyEventCount::TestParkedWaiters }
+    };
+}
+
+void TestSynergyEventCount::TestNotify()
+{
+    syntropy::synergy::EventCount event_count;
+
+    // Notifications reach nobody unless a waiter is registered.
+
+    SYNTROPY_UNIT_ASSERT(!event_count.Notify());
+
+    event_count.PrepareWait();
+    event_count.CancelWait();
+
+    SYNTROPY_UNIT_ASSERT(!event_count.Notify());
+
+    // A notification issued after PrepareWait() lets the waiter through without parking.
+
+    auto key = event_count.PrepareWait();
+
+    SYNTROPY_UNIT_ASSERT(event_count.Notify());
+
+    event_count.CommitWait(key);
+
+    SYNTROPY_UNIT_ASSERT(!event_count.Notify());
+}
+
+void TestSynergyEventCount::TestParkedWaiters()
+{
+    using namespace std::literals::chrono_literals;
+
+    static constexpr size_t kWaiterCount = 4;
+
+    syntropy::synergy::EventCount event_count;
+
+    std::atomic<bool> condition{ false };
+    std::atomic<size_t> committed{ 0 };
+    std::atomic<size_t> woken{ 0 };
+
+    std::vector<std::thread> waiters;
+
+    for (size_t index = 0; index < kWaiterCount; ++index)
+    {
+        waiters.emplace_back([&]()
+        {
+            while (!condition.load())
+            {
+                auto key = event_count.PrepareWait();
+
+                if (condition.load())
+                {
+                    event_count.CancelWait();
+                }
+                else
+                {
+                    committed.fetch_add(1);
+
+                    event_count.CommitWait(key);
+
+                    woken.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    // Waiters that committed before the condition changed stay registered until notified.
+
+    while (committed.load() < kWaiterCount)
+    {
+        std::this_thread::yield();
+    }
+
+    std::this_thread::sleep_for(10ms);                          // Give the waiters the chance to actually park.
+
+    SYNTROPY_UNIT_ASSERT(woken == 0);
+
+    condition.store(true);
+
+    auto notified = event_count.Notify();
+
+    for (auto&& waiter : waiters)
+    {
+        waiter.join();                                          // A lost notification would never return.
+    }
+
+    SYNTROPY_UNIT_ASSERT(notified);
+    SYNTROPY_UNIT_ASSERT(woken == kWaiterCount);
+    SYNTROPY_UNIT_ASSERT(!event_count.Notify());
+}
@@ -0,0 +1,212 @@
+#include "test/synergy/patterns/parallel_algorithms.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cstdlib>
+#include <string>
+
+#include "syntropy/unit_test/test_runner.h"
+
+#include "synergy/task/scheduler.h"
+#include "synergy/patterns/sync_counter.h"
+#include "synergy/patterns/parallel_algorithms.h"
+
+namespace
+{
+    /// \brief Sizes of the ranges each algorithm is tested with: empty, smaller than the number of chunks, not a multiple of the grain size and large.
+    constexpr size_t kCounts[] = { 0, 1, 7, 1000, 1 << 16 };
+
+    /// \brief Launch an algorithm from within a task and wait for the task it returns to complete.
+    template <typename TAlgorithm>
+    void RunAndWait(TAlgorithm algorithm)
+    {
+        syntropy::synergy::SyncCounter done(1);
+
+        syntropy::synergy::DetachTask([&algorithm, &done]()
+        {
+            syntropy::synergy::CreateTask({ algorithm() }, [&done]()
+            {
+                done.Signal(false);
+            });
+        });
+
+        done.Wait();
+    }
+}
+
+/************************************************************************/
+/* TEST SYNERGY PARALLEL ALGORITHMS                                     */
+/************************************************************************/
+
+static syntropy::AutoTestSuite<TestSynergyParallelAlgorithms> shared_suite("synergy.patterns.parallelalgorithms.shared", syntropy::synergy::StealPolicy::kShared);
+static syntropy::AutoTestSuite<TestSynergyParallelAlgorithms> random_suite("synergy.patterns.parallelalgorithms.random", syntropy::synergy::StealPolicy::kRandom);
+static syntropy::AutoTestSuite<TestSynergyParallelAlgorithms> topology_suite("synergy.patterns.parallelalgorithms.topology", syntropy::synergy::StealPolicy::kTopology);
+
+std::vector<syntropy::TestCase> TestSynergyParallelAlgorithms::GetTestCases()
+{
+    return
+    {
+        { "for", &TestSynergyParallelAlgorithms::TestFor },
+        { "lazy for", &TestSynergyParallelAlgorithms::TestLazyFor },
+        { "transform", &TestSynergyParallelAlgorithms::TestTransform },
+        { "reduce", &TestSynergyParallelAlgorithms::TestReduce },
+        { "inclusive scan", &TestSynergyParallelAlgorithms::TestInclusiveScan },
+        { "sort", &TestSynergyParallelAlgorithms::TestSort }
+    };
+}
+
+TestSynergyParallelAlgorithms::TestSynergyParallelAlgorithms(syntropy::synergy::StealPolicy steal_policy)
+    : steal_policy_(steal_policy)
+{
+
+}
+
+void TestSynergyParallelAlgorithms::Before()
+{
+    syntropy::synergy::GetScheduler().Initialize(std::nullopt, steal_policy_);
+}
+
+void TestSynergyParallelAlgorithms::After()
+{
+    syntropy::synergy::GetScheduler().Shutdown();
+}
+
+void TestSynergyParallelAlgorithms::TestFor()
+{
+    for (auto count : kCounts)
+    {
+        auto numbers = GetNumbers(count);
+        auto expected = numbers;
+
+        std::for_each(expected.begin(), expected.end(), [](auto& number) { number *= 3; });
+
+        RunAndWait([&numbers]() { return syntropy::synergy::ParallelFor(numbers.begin(), numbers.end(), [](auto& number) { number *= 3; }); });
+
+        SYNTROPY_UNIT_ASSERT(numbers == expected);
+    }
+
+    {
+        auto numbers = GetNumbers(1000);
+        auto expected = numbers;
+
+        std::for_each(expected.begin(), expected.end(), [](auto& number) { ++number; });
+
+        RunAndWait([&numbers]() { return syntropy::synergy::ParallelFor(numbers.begin(), numbers.end(), [](auto& number) { ++number; }, 1); });
+
+        SYNTROPY_UNIT_ASSERT(numbers == expected);          // Explicit grain size: one task per element.
+    }
+}
+
+void TestSynergyParallelAlgorithms::TestLazyFor()
+{
+    for (auto count : kCounts)
+    {
+        auto numbers = GetNumbers(count);
+        auto expected = numbers;
+
+        std::for_each(expected.begin(), expected.end(), [](auto& number) { number *= 3; });
+
+        RunAndWait([&numbers]() { return syntropy::synergy::LazyParallelFor(numbers.begin(), numbers.end(), [](auto& number) { number *= 3; }); });
+
+        SYNTROPY_UNIT_ASSERT(numbers == expected);
+    }
+
+    {
+        auto numbers = GetNumbers(1000);
+        auto expected = numbers;
+
+        std::for_each(expected.begin(), expected.end(), [](auto& number) { ++number; });
+
+        RunAndWait([&numbers]() { return syntropy::synergy::LazyParallelFor(numbers.begin(), numbers.end(), [](auto& number) { ++number; }, 1); });
+
+        SYNTROPY_UNIT_ASSERT(numbers == expected);          // Explicit grain size: a split check after each element.
+    }
+}
+
+void TestSynergyParallelAlgorithms::TestTransform()
+{
+    for (auto count : kCounts)
+    {
+        auto numbers = GetNumbers(count);
+        auto expected = std::vector<int>(count);
+        auto actual = std::vector<int>(count);
+
+        std::transform(numbers.begin(), numbers.end(), expected.begin(), [](auto number) { return number - 7; });
+
+        RunAndWait([&]() { return syntropy::synergy::ParallelTransform(numbers.begin(), numbers.end(), actual.begin(), [](auto number) { return number - 7; }); });
+
+        SYNTROPY_UNIT_ASSERT(actual == expected);
+    }
+}
+
+void TestSynergyParallelAlgorithms::TestReduce()
+{
+    for (auto count : kCounts)
+    {
+        auto numbers = GetNumbers(count);
+        auto expected = std::accumulate(numbers.begin(), numbers.end(), int64_t(42));
+        auto actual = int64_t(0);
+
+        RunAndWait([&]() { return syntropy::synergy::ParallelReduce(numbers.begin(), numbers.end(), int64_t(42), std::plus<>(), actual); });
+
+        SYNTROPY_UNIT_ASSERT(actual == expected);
+    }
+
+    {
+        auto words = std::vector<std::string>{ "s", "y", "n", "e", "r", "g", "y" };
+        auto actual = std::string();
+
+        RunAndWait([&]() { return syntropy::synergy::ParallelReduce(words.begin(), words.end(), std::string(">"), std::plus<>(), actual, 1); });
+
+        SYNTROPY_UNIT_ASSERT(actual == ">synergy");         // Non-commutative operation: the order must be preserved.
+    }
+}
+
+void TestSynergyParallelAlgorithms::TestInclusiveScan()
+{
+    for (auto count : kCounts)
+    {
+        auto numbers = GetNumbers(count);
+        auto expected = std::vector<int>(count);
+        auto actual = std::vector<int>(count);
+
+        std::partial_sum(numbers.begin(), numbers.end(), expected.begin());
+
+        RunAndWait([&]() { return syntropy::synergy::ParallelInclusiveScan(numbers.begin(), numbers.end(), actual.begin()); });
+
+        SYNTROPY_UNIT_ASSERT(actual == expected);
+
+        RunAndWait([&]() { return syntropy::synergy::ParallelInclusiveScan(numbers.begin(), numbers.end(), numbers.begin()); });
+
+        SYNTROPY_UNIT_ASSERT(numbers == expected);          // In-place scan.
+    }
+}
+
+void TestSynergyParallelAlgorithms::TestSort()
+{
+    for (auto count : kCounts)
+    {
+        auto numbers = GetNumbers(count);
+        auto expected = numbers;
+
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+
+        RunAndWait([&numbers]() { return syntropy::synergy::ParallelSort(numbers.begin(), numbers.end(), std::greater<>()); });
+
+        SYNTROPY_UNIT_ASSERT(numbers == expected);
+    }
+}
+
+std::vector<int> TestSynergyParallelAlgorithms::GetNumbers(size_t count)
+{
+    auto numbers = std::vector<int>(count);
+
+    srand(0);       // Be sure the random sequence stays the same for different runs.
+
+    for (auto&& number : numbers)
+    {
+        number = rand() % 1024;
+    }
+
+    return numbers;
+}
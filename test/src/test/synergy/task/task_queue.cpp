@@ -0,0 +1,267 @@
+#include "test/synergy/task/task_queue.h"
+
+#include "syntropy/unit_test/test_runner.h"
+
+#include "synergy/task/task_queue.h"
+#include "synergy/task/task_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    using syntropy::synergy::Task;
+    using syntropy::synergy::TaskHandle;
+    using syntropy::synergy::TaskList;
+    using syntropy::synergy::TaskPool;
+    using syntropy::synergy::TaskPriority;
+    using syntropy::synergy::TaskQueue;
+
+    /// \brief Number of threads stealing from a queue concurrently.
+    static constexpr size_t kThiefCount = 3;
+
+    /// \brief Create an empty task and record it among the tasks pushed on a queue.
+    TaskHandle MakeTask(TaskPool& pool, std::vector<Task*>& pushed)
+    {
+        auto task = pool.CreateTask(TaskPriority::kNormal, {}, []() {});
+
+        pushed.emplace_back(task.Get());
+
+        return task;
+    }
+
+    /// \brief Run thieves stealing from a queue until the owner routine returns, then drain the queue from the owner thread.
+    /// \return Returns the tasks taken by each thread, the owner first. Tasks are kept alive so that their addresses stay unique.
+    template <typename TOwner>
+    std::vector<TaskList> StealWhile(TaskQueue& queue, TOwner&& owner)
+    {
+        auto taken = std::vector<TaskList>(kThiefCount + 1);
+
+        std::atomic<bool> done{ false };
+
+        std::vector<std::thread> thieves;
+
+        for (size_t thief_index = 1; thief_index <= kThiefCount; ++thief_index)
+        {
+            thieves.emplace_back([&queue, &done, &stolen = taken[thief_index]]()
+            {
+                while (!done.load(std::memory_order_acquire))
+                {
+                    if (auto task = queue.PopFront())
+                    {
+                        stolen.emplace_back(std::move(task));
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        owner(taken.front());
+
+        done.store(true, std::memory_order_release);
+
+        for (auto&& thief : thieves)
+        {
+            thief.join();
+        }
+
+        while (auto task = queue.PopBack())
+        {
+            taken.front().emplace_back(std::move(task));
+        }
+
+        return taken;
+    }
+
+    /// \brief Check whether the tasks taken from a queue are exactly the ones pushed on it, each one taken once.
+    bool IsTakenOnce(std::vector<Task*> pushed, const std::vector<TaskList>& taken)
+    {
+        auto tasks = std::vector<Task*>{};
+
+        for (auto&& list : taken)
+        {
+            for (auto&& task : list)
+            {
+                tasks.emplace_back(task.Get());
+            }
+        }
+
+        std::sort(pushed.begin(), pushed.end());
+        std::sort(tasks.begin(), tasks.end());
+
+        return tasks == pushed;
+    }
+}
+
+/************************************************************************/
+/* TEST SYNERGY TASK QUEUE                                              */
+/************************************************************************/
+
+static syntropy::AutoTestSuite<TestSynergyTaskQueue> suite("synergy.task.taskqueue");
+
+std::vector<syntropy::TestCase> TestSynergyTaskQueue::GetTestCases()
+{
+    return
+    {
+        { "owner and thieves", &TestSynergyTaskQueue::TestOwnerAndThieves },
+        { "growth", &TestSynergyTaskQueue::TestGrowth },
+        { "last task race", &TestSynergyTaskQueue::TestLastTaskRace }
+    };
+}
+
+void TestSynergyTaskQueue::TestOwnerAndThieves()
+{
+    static constexpr size_t kTaskCount = 0x8000;
+
+    TaskPool pool;
+    TaskQueue queue;
+
+    std::vector<Task*> pushed;
+
+    // The owner pops one task every third push, racing thieves whenever the queue is about to run dry.
+
+    auto taken = StealWhile(queue, [&](TaskList& popped)
+    {
+        for (size_t index = 0; index < kTaskCount; ++index)
+        {
+            queue.PushBack(MakeTask(pool, pushed));
+
+            if (index % 3 == 2)
+            {
+                if (auto task = queue.PopBack())
+                {
+                    popped.emplace_back(std::move(task));
+                }
+            }
+        }
+    });
+
+    SYNTROPY_UNIT_ASSERT(queue.IsEmpty());
+    SYNTROPY_UNIT_ASSERT(pushed.size() == kTaskCount);
+    SYNTROPY_UNIT_ASSERT(IsTakenOnce(pushed, taken));
+}
+
+void TestSynergyTaskQueue::TestGrowth()
+{
+    static constexpr size_t kBatchCount = 0x800;
+
+    TaskPool pool;
+    TaskQueue queue(2);
+
+    std::vector<Task*> pushed;
+
+    size_t skipped_count = 0;
+
+    // The owner never pops: the buffer must grow while thieves read from it. Tasks of other priority classes must be left out of bulk pushes.
+
+    auto taken = StealWhile(queue, [&](TaskList&)
+    {
+        for (size_t batch_index = 0; batch_index < kBatchCount; ++batch_index)
+        {
+            queue.PushBack(MakeTask(pool, pushed));
+
+            auto batch = TaskList{};
+
+            for (size_t index = 0; index <= batch_index % 7; ++index)
+            {
+                batch.emplace_back(MakeTask(pool, pushed));
+            }
+
+            batch.emplace_back(pool.CreateTask(TaskPriority::kLow, {}, []() {}));
+
+            queue.PushBack(batch.begin(), batch.end(), TaskPriority::kNormal);
+
+            skipped_count += static_cast<size_t>(std::count_if(batch.begin(), batch.end(), [](const TaskHandle& task)
+            {
+                return task && task->GetPriority() == TaskPriority::kLow;
+            }));
+        }
+    });
+
+    SYNTROPY_UNIT_ASSERT(skipped_count == kBatchCount);
+    SYNTROPY_UNIT_ASSERT(queue.IsEmpty());
+    SYNTROPY_UNIT_ASSERT(IsTakenOnce(pushed, taken));
+}
+
+void TestSynergyTaskQueue::TestLastTaskRace()
+{
+    static constexpr size_t kRoundCount = 0x800;
+
+    TaskPool pool;
+    TaskQueue queue;
+
+    std::vector<Task*> pushed;
+
+    auto taken = std::vector<TaskList>(kThiefCount + 1);
+
+    std::atomic<size_t> round{ 0 };
+    std::atomic<size_t> attempts{ 0 };
+
+    // Each round the owner pushes a single task, then every thread tries to take it at once.
+
+    std::vector<std::thread> thieves;
+
+    for (size_t thief_index = 1; thief_index <= kThiefCount; ++thief_index)
+    {
+        thieves.emplace_back([&queue, &round, &attempts, &stolen = taken[thief_index]]()
+        {
+            for (size_t thief_round = 1; thief_round <= kRoundCount; ++thief_round)
+            {
+                while (round.load(std::memory_order_acquire) < thief_round)
+                {
+                    std::this_thread::yield();
+                }
+
+                if (auto task = queue.PopFront())
+                {
+                    stolen.emplace_back(std::move(task));
+                }
+
+                attempts.fetch_add(1, std::memory_order_release);
+            }
+        });
+    }
+
+    size_t leftover_count = 0;
+
+    for (size_t owner_round = 1; owner_round <= kRoundCount; ++owner_round)
+    {
+        queue.PushBack(MakeTask(pool, pushed));
+
+        round.store(owner_round, std::memory_order_release);
+
+        if (owner_round % 2 == 0)
+        {
+            std::this_thread::yield();                                      // Give thieves a head start.
+        }
+
+        if (auto task = queue.PopBack())
+        {
+            taken.front().emplace_back(std::move(task));
+        }
+
+        while (attempts.load(std::memory_order_acquire) < owner_round * kThiefCount)
+        {
+            std::this_thread::yield();
+        }
+
+        if (!queue.IsEmpty())
+        {
+            ++leftover_count;                                               // Nobody took the task.
+
+            taken.front().emplace_back(queue.PopBack());
+        }
+    }
+
+    for (auto&& thief : thieves)
+    {
+        thief.join();
+    }
+
+    SYNTROPY_UNIT_ASSERT(leftover_count == 0);
+    SYNTROPY_UNIT_ASSERT(IsTakenOnce(pushed, taken));
+}
@@ -6,6 +6,16 @@
 #include "syntropy/platform/threading.h"
 
 #include "synergy/task/scheduler.h"
+#include "synergy/task/task_graph.h"
+#include "synergy/task/task_pool.h"
+#include "synergy/task/coroutine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <mutex>
 
 #define COUNT 1 << 16
 
@@ -57,20 +67,103 @@ struct Maxer
     int* max_ = 0;
 };
 
+/// \brief Records the order tasks are executed in.
+struct ExecutionLog
+{
+    void Record(size_t id)
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+
+        ids_.emplace_back(id);
+    }
+
+    /// \brief Wait until a given number of tasks were executed, without executing any task on the calling thread.
+    /// \return Returns the ids of the tasks executed so far.
+    std::vector<size_t> WaitFor(size_t count)
+    {
+        using namespace std::literals::chrono_literals;
+
+        for (size_t attempt = 0; attempt < 5000; ++attempt)
+        {
+            {
+                std::scoped_lock<std::mutex> lock(mutex_);
+
+                if (ids_.size() >= count)
+                {
+                    return ids_;
+                }
+            }
+
+            std::this_thread::sleep_for(1ms);
+        }
+
+        std::scoped_lock<std::mutex> lock(mutex_);
+
+        return ids_;
+    }
+
+    std::mutex mutex_;
+    std::vector<size_t> ids_;
+};
+
+/// \brief Restart the scheduler with a single worker, so that tasks are executed in a deterministic order.
+static void RestartWithSingleWorker(syntropy::synergy::StealPolicy steal_policy)
+{
+    auto& scheduler = syntropy::synergy::GetScheduler();
+
+    auto affinity = syntropy::platform::Threading::GetProcessAffinity();
+
+    auto core = size_t{ 0 };
+
+    while (!affinity.Test(core))
+    {
+        ++core;
+    }
+
+    scheduler.Shutdown();
+    scheduler.Initialize(syntropy::platform::AffinityMask().Set(core), steal_policy);
+}
+
 /************************************************************************/
 /* TEST SYNERGY TASK SYSTEM                                             */
 /************************************************************************/
 
-syntropy::AutoTestSuite<TestSynergyTaskSystem> suite("synergy.task.tasksystem");
+static syntropy::AutoTestSuite<TestSynergyTaskSystem> shared_suite("synergy.task.tasksystem.shared", syntropy::synergy::StealPolicy::kShared);
+static syntropy::AutoTestSuite<TestSynergyTaskSystem> random_suite("synergy.task.tasksystem.random", syntropy::synergy::StealPolicy::kRandom);
+static syntropy::AutoTestSuite<TestSynergyTaskSystem> topology_suite("synergy.task.tasksystem.topology", syntropy::synergy::StealPolicy::kTopology);
 
 std::vector<syntropy::TestCase> TestSynergyTaskSystem::GetTestCases()
 {
     return
     {
-        { "task graph", &TestSynergyTaskSystem::TestTaskGraph }
+        { "task graph", &TestSynergyTaskSystem::TestTaskGraph },
+        { "wait for", &TestSynergyTaskSystem::TestWaitFor },
+        { "task graph replay", &TestSynergyTaskSystem::TestTaskGraphReplay },
+        { "external threads", &TestSynergyTaskSystem::TestExternalThreads },
+        { "idle workers", &TestSynergyTaskSystem::TestIdleWorkers },
+        { "wake-ups", &TestSynergyTaskSystem::TestWakeUps },
+        { "coroutines", &TestSynergyTaskSystem::TestCoroutines },
+        { "priority aging", &TestSynergyTaskSystem::TestPriorityAging },
+        { "priority lanes", &TestSynergyTaskSystem::TestPriorityLanes }
     };
 }
 
+TestSynergyTaskSystem::TestSynergyTaskSystem(syntropy::synergy::StealPolicy steal_policy)
+    : steal_policy_(steal_policy)
+{
+
+}
+
+void TestSynergyTaskSystem::Before()
+{
+    syntropy::synergy::GetScheduler().Initialize(std::nullopt, steal_policy_);
+}
+
+void TestSynergyTaskSystem::After()
+{
+    syntropy::synergy::GetScheduler().Shutdown();
+}
+
 void TestSynergyTaskSystem::TestTaskGraph()
 {
     SYNTROPY_UNIT_SKIP("Work in progress");
@@ -90,8 +183,6 @@ void TestSynergyTaskSystem::TestTaskGraph()
 
     int max;
 
-    syntropy::synergy::GetScheduler().Initialize();
-
     syntropy::synergy::DetachTask(
         [&numbers, &max]()
     {
@@ -101,4 +192,393 @@ void TestSynergyTaskSystem::TestTaskGraph()
     });
 
     system("pause");
-}
\ No newline at end of file
+}
+
+void TestSynergyTaskSystem::TestWaitFor()
+{
+    std::vector<int> numbers(COUNT);
+
+    srand(0);
+
+    for (auto&& number : numbers)
+    {
+        number = rand() % 65536;
+    }
+
+    // Wait for a task tree, including its continuations.
+
+    int max = -1;
+
+    syntropy::synergy::WaitFor([&numbers, &max]()
+    {
+        return syntropy::synergy::EmplaceTask<Maxer>({}, numbers, 0, numbers.size(), &max);
+    });
+
+    SYNTROPY_UNIT_ASSERT(max == *std::max_element(numbers.begin(), numbers.end()));
+
+    // Run tasks submitted by the calling thread until they are done.
+
+    std::atomic<size_t> count{ 0 };
+
+    for (size_t index = 0; index < 100; ++index)
+    {
+        syntropy::synergy::DetachTask([&count]() { count.fetch_add(1, std::memory_order_relaxed); });
+    }
+
+    syntropy::synergy::RunUntil([&count]() { return count.load(std::memory_order_relaxed) == 100; });
+
+    SYNTROPY_UNIT_ASSERT(count == 100);
+}
+
+void TestSynergyTaskSystem::TestTaskGraphReplay()
+{
+    // Diamond-shaped graph: each task checks its dependencies ran during the same launch.
+
+    std::atomic<size_t> a{ 0 };
+    std::atomic<size_t> b{ 0 };
+    std::atomic<size_t> c{ 0 };
+    std::atomic<size_t> d{ 0 };
+    std::atomic<size_t> errors{ 0 };
+
+    syntropy::synergy::TaskGraph graph;
+
+    auto task_a = graph.CreateTask({}, [&]() { a.fetch_add(1, std::memory_order_relaxed); });
+
+    auto task_b = graph.CreateTask({ task_a }, [&]() { errors += (b.fetch_add(1, std::memory_order_relaxed) + 1 != a.load(std::memory_order_relaxed)); });
+
+    auto task_c = graph.CreateTask(syntropy::synergy::TaskPriority::kHigh, { task_a }, [&]() { errors += (c.fetch_add(1, std::memory_order_relaxed) + 1 != a.load(std::memory_order_relaxed)); });
+
+    graph.CreateTask({ task_b, task_c }, [&]() { errors += (d.fetch_add(1, std::memory_order_relaxed) + 1 != std::min(b.load(std::memory_order_relaxed), c.load(std::memory_order_relaxed))); });
+
+    SYNTROPY_UNIT_ASSERT(graph.GetTaskCount() == 4);
+
+    for (size_t launch = 0; launch < 100; ++launch)
+    {
+        syntropy::synergy::WaitFor([&graph]() { return graph.Launch(); });
+    }
+
+    SYNTROPY_UNIT_ASSERT(a == 100);
+    SYNTROPY_UNIT_ASSERT(b == 100);
+    SYNTROPY_UNIT_ASSERT(c == 100);
+    SYNTROPY_UNIT_ASSERT(d == 100);
+    SYNTROPY_UNIT_ASSERT(errors == 0);
+}
+
+void TestSynergyTaskSystem::TestExternalThreads()
+{
+    std::vector<int> numbers(COUNT);
+
+    srand(0);
+
+    for (auto&& number : numbers)
+    {
+        number = rand() % 65536;
+    }
+
+    auto expected_max = *std::max_element(numbers.begin(), numbers.end());
+
+    // Short-lived threads: the state of each thread is recycled by the next ones, while workers may still be releasing tasks allocated by the previous owner.
+
+    std::atomic<size_t> errors{ 0 };
+
+    for (size_t generation = 0; generation < 16; ++generation)
+    {
+        std::vector<std::thread> threads;
+
+        for (size_t index = 0; index < 4; ++index)
+        {
+            threads.emplace_back([&numbers, &errors, expected_max]()
+            {
+                int max = -1;
+
+                syntropy::synergy::WaitFor([&numbers, &max]()
+                {
+                    return syntropy::synergy::EmplaceTask<Maxer>({}, numbers, 0, numbers.size(), &max);
+                });
+
+                errors += (max != expected_max);
+            });
+        }
+
+        for (auto&& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    SYNTROPY_UNIT_ASSERT(errors == 0);
+}
+
+void TestSynergyTaskSystem::TestIdleWorkers()
+{
+    using namespace std::literals::chrono_literals;
+
+    auto& scheduler = syntropy::synergy::GetScheduler();
+
+    auto get_statistics = [&scheduler]()
+    {
+        auto total = syntropy::synergy::WorkerStatistics{};
+
+        for (size_t index = 0; index < scheduler.GetWorkerCount(); ++index)
+        {
+            auto statistics = scheduler.GetWorkerStatistics(index);
+
+            total.parks_ += statistics.parks_;
+            total.wakeups_ += statistics.wakeups_;
+        }
+
+        return total;
+    };
+
+    // Without any work, workers spin and yield for a bounded amount of time before parking.
+
+    for (size_t attempt = 0; attempt < 1000 && get_statistics().parks_ < scheduler.GetWorkerCount(); ++attempt)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    auto parked = get_statistics();
+
+    SYNTROPY_UNIT_ASSERT(parked.parks_ >= scheduler.GetWorkerCount());
+
+    // A task submitted by a thread outside the scheduler has to wake a parked worker up. The submitting thread doesn't run tasks by itself.
+
+    std::atomic<bool> is_done{ false };
+
+    syntropy::synergy::DetachTask([&is_done]() { is_done.store(true); });
+
+    for (size_t attempt = 0; attempt < 5000 && !is_done.load(); ++attempt)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    SYNTROPY_UNIT_ASSERT(is_done);
+    SYNTROPY_UNIT_ASSERT(get_statistics().wakeups_ > parked.wakeups_);
+}
+
+void TestSynergyTaskSystem::TestWakeUps()
+{
+    using namespace std::literals::chrono_literals;
+
+    // Each round submits a small tree of tasks after a different pause, so that workers are caught while spinning, backing off, sweeping their victims or parked.
+    // The submitting thread never runs tasks by itself: a lost wake-up would leave the round unfinished.
+
+    static constexpr size_t kRoundCount = 200;
+    static constexpr size_t kChildCount = 8;
+
+    auto count = std::make_shared<std::atomic<size_t>>(0);     // Shared with the tasks, which may outlive a failed test.
+
+    size_t unfinished_rounds = 0;
+
+    for (size_t round = 0; round < kRoundCount && unfinished_rounds == 0; ++round)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds((round % 7) * (round % 7) * 50));
+
+        syntropy::synergy::DetachTask([count]()
+        {
+            for (size_t index = 0; index < kChildCount; ++index)
+            {
+                syntropy::synergy::DetachTask([count]() { count->fetch_add(1, std::memory_order_relaxed); });      // Enqueued by a worker: idle workers are woken up to steal them.
+            }
+
+            count->fetch_add(1, std::memory_order_relaxed);
+        });
+
+        auto expected_count = (round + 1) * (kChildCount + 1);
+
+        for (size_t attempt = 0; attempt < 2000 && count->load(std::memory_order_relaxed) < expected_count; ++attempt)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+
+        unfinished_rounds += (count->load(std::memory_order_relaxed) < expected_count);
+    }
+
+    SYNTROPY_UNIT_ASSERT(unfinished_rounds == 0);
+}
+
+void TestSynergyTaskSystem::TestCoroutines()
+{
+    using namespace std::literals::chrono_literals;
+
+    using syntropy::synergy::Coroutine;
+    using syntropy::synergy::TaskPool;
+
+    static constexpr size_t kChildCount = 16;
+
+    auto frame_count = TaskPool::GetFrameCount();
+
+    std::atomic<size_t> steps{ 0 };
+    std::atomic<size_t> children{ 0 };
+    std::atomic<size_t> errors{ 0 };
+
+    // Each child coroutine awaits a single task and completes after it.
+
+    auto child = [&children, &errors]() -> Coroutine
+    {
+        std::atomic<bool> is_done{ false };
+
+        auto tasks = syntropy::synergy::TaskList{ syntropy::synergy::CreateTask({}, [&is_done]() { is_done.store(true); }) };     // Braced lists inside co_await expressions trip some compilers.
+
+        co_await syntropy::synergy::WhenAll(std::move(tasks));
+
+        errors += !is_done.load();
+
+        children.fetch_add(1);
+    };
+
+    // The parent coroutine awaits a chain of tasks, one at a time, and then all of its children at once. It may be resumed on any worker.
+
+    syntropy::synergy::WaitFor([&]()
+    {
+        return syntropy::synergy::CreateCoroutineTask({}, [&]() -> Coroutine
+        {
+            errors += (TaskPool::GetFrameCount() <= frame_count);               // The frame is allocated from the pool of the executing thread.
+
+            auto tasks_a = syntropy::synergy::TaskList{ syntropy::synergy::CreateTask({}, [&steps]() { steps.fetch_add(1); }) };
+
+            co_await syntropy::synergy::WhenAll(std::move(tasks_a));
+
+            errors += (steps.load() != 1);
+
+            auto tasks_b = syntropy::synergy::TaskList{ syntropy::synergy::CreateTask({}, [&steps]() { steps.fetch_add(1); }) };
+
+            co_await syntropy::synergy::WhenAll(std::move(tasks_b));
+
+            errors += (steps.load() != 2);
+
+            auto tasks = syntropy::synergy::TaskList{};
+
+            for (size_t index = 0; index < kChildCount; ++index)
+            {
+                tasks.emplace_back(syntropy::synergy::CreateCoroutineTask({}, child));
+            }
+
+            co_await syntropy::synergy::WhenAll(std::move(tasks));
+
+            errors += (children.load() != kChildCount);
+
+            steps.fetch_add(1);
+        });
+    });
+
+    // Tasks depending on the coroutine task run after the coroutine completed.
+
+    SYNTROPY_UNIT_ASSERT(steps == 3);
+    SYNTROPY_UNIT_ASSERT(children == kChildCount);
+    SYNTROPY_UNIT_ASSERT(errors == 0);
+
+    // Frames are released along with their tasks, possibly by a thread other than the one they were allocated by.
+
+    for (size_t attempt = 0; attempt < 2000 && TaskPool::GetFrameCount() != frame_count; ++attempt)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    SYNTROPY_UNIT_ASSERT(TaskPool::GetFrameCount() == frame_count);
+}
+
+void TestSynergyTaskSystem::TestPriorityAging()
+{
+    using syntropy::synergy::TaskPriority;
+
+    static constexpr size_t kLowCount = 4;
+    static constexpr size_t kHighCount = 256;                   // Way more than the aging threshold of the worker.
+
+    static constexpr size_t kChildId = 1000;                    // Tasks spawned by low-priority tasks.
+
+    RestartWithSingleWorker(steal_policy_);
+
+    SYNTROPY_UNIT_ASSERT(syntropy::synergy::GetScheduler().GetWorkerCount() == 1);
+
+    // High-priority tasks are submitted after a backlog of low-priority ones. Each low-priority task spawns a child, which would run right after it if the worker didn't yield to urgent tasks.
+
+    ExecutionLog log;
+
+    syntropy::synergy::DetachTask([&log]()
+    {
+        for (size_t index = 0; index < kLowCount; ++index)
+        {
+            syntropy::synergy::DetachTask(TaskPriority::kLow, [&log, index]()
+            {
+                log.Record(kHighCount + index);
+
+                syntropy::synergy::DetachTask(TaskPriority::kLow, [&log]() { log.Record(kChildId); });
+            });
+        }
+
+        for (size_t index = 0; index < kHighCount; ++index)
+        {
+            syntropy::synergy::DetachTask(TaskPriority::kHigh, [&log, index]() { log.Record(index); });
+        }
+    });
+
+    auto ids = log.WaitFor(kHighCount + 2 * kLowCount);
+
+    SYNTROPY_UNIT_ASSERT(ids.size() == kHighCount + 2 * kLowCount);
+
+    auto is_high = [](size_t id) { return id < kHighCount; };
+
+    auto first_low = std::find_if_not(ids.begin(), ids.end(), is_high);
+    auto last_high = std::find_if(ids.rbegin(), ids.rend(), is_high).base() - 1;
+
+    // Urgent tasks run first, yet low-priority tasks are not starved until every urgent task is done.
+
+    SYNTROPY_UNIT_ASSERT(is_high(ids.front()));
+    SYNTROPY_UNIT_ASSERT(first_low < last_high);
+
+    // The aged task yields to urgent tasks rather than running its child depth-first.
+
+    SYNTROPY_UNIT_ASSERT(*first_low != kChildId);
+    SYNTROPY_UNIT_ASSERT(is_high(*(first_low + 1)));
+}
+
+void TestSynergyTaskSystem::TestPriorityLanes()
+{
+    using syntropy::synergy::TaskPriority;
+
+    static constexpr size_t kTaskCount = 24;
+
+    RestartWithSingleWorker(steal_policy_);
+
+    SYNTROPY_UNIT_ASSERT(syntropy::synergy::GetScheduler().GetWorkerCount() == 1);
+
+    // Tasks created by a task are scheduled at once when it completes, with a single bulk push: high, normal and low priorities are interleaved.
+
+    auto get_priority = [](size_t id)
+    {
+        return static_cast<TaskPriority>(id % syntropy::synergy::kTaskPriorityCount);
+    };
+
+    ExecutionLog log;
+
+    syntropy::synergy::DetachTask([&log, get_priority]()
+    {
+        for (size_t index = 0; index < kTaskCount; ++index)
+        {
+            syntropy::synergy::CreateTask(get_priority(index), {}, [&log, index]() { log.Record(index); });
+        }
+    });
+
+    auto ids = log.WaitFor(kTaskCount);
+
+    SYNTROPY_UNIT_ASSERT(ids.size() == kTaskCount);
+
+    // The first urgent task is executed right away by the worker, while the others are pushed on their lanes in submission order.
+    // Lanes are served from the most urgent one and the owner pops each lane from the back, hence each lane is executed in reverse submission order.
+
+    auto expected = std::vector<size_t>{ 0 };
+
+    for (size_t priority = 0; priority < syntropy::synergy::kTaskPriorityCount; ++priority)
+    {
+        for (auto index = kTaskCount; index-- > 1;)
+        {
+            if (static_cast<size_t>(get_priority(index)) == priority)
+            {
+                expected.emplace_back(index);
+            }
+        }
+    }
+
+    SYNTROPY_UNIT_ASSERT(ids == expected);
+}
@@ -0,0 +1,174 @@
+#include "test/synergy/task/task_trace.h"
+
+#include "syntropy/unit_test/test_runner.h"
+
+#include "synergy/task/scheduler.h"
+#include "synergy/task/task_trace.h"
+
+#include "nlohmann/json/src/json.hpp"
+
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+
+/************************************************************************/
+/* TEST SYNERGY TASK TRACE                                              */
+/************************************************************************/
+
+static syntropy::AutoTestSuite<TestSynergyTaskTrace> suite("synergy.task.tasktrace");
+
+std::vector<syntropy::TestCase> TestSynergyTaskTrace::GetTestCases()
+{
+    return
+    {
+        { "chrome trace", &TestSynergyTaskTrace::TestChromeTrace }
+    };
+}
+
+void TestSynergyTaskTrace::TestChromeTrace()
+{
+#ifndef SYNERGY_TRACE
+
+    SYNTROPY_UNIT_SKIP("Tracing is disabled: build with SYNERGY_TRACE.");
+
+#else
+
+    using namespace syntropy::synergy;
+
+    auto& trace = GetTaskTrace();
+    auto& scheduler = GetScheduler();
+
+    trace.Clear();                                                      // No thread is recording: the scheduler is not running yet.
+
+    scheduler.Initialize();
+
+    // Diamond-shaped graph. Tasks must not outlive the scheduler, hence only their ids are kept around.
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    uint64_t c = 0;
+    uint64_t d = 0;
+
+    WaitFor([&]()
+    {
+        auto task_a = CreateTask({}, []() {});
+        auto task_b = CreateTask({ task_a }, []() {});
+        auto task_c = CreateTask({ task_a }, []() {});
+        auto task_d = CreateTask({ task_b, task_c }, []() {});
+
+        a = task_a->GetTraceId();
+        b = task_b->GetTraceId();
+        c = task_c->GetTraceId();
+        d = task_d->GetTraceId();
+
+        return task_d;
+    });
+
+    scheduler.Shutdown();
+
+    std::stringstream stream;
+
+    trace.ExportChromeTrace(stream);
+
+    auto json = nlohmann::json{};
+
+    auto is_valid = true;
+
+    try
+    {
+        json = nlohmann::json::parse(stream.str());
+    }
+    catch (const nlohmann::json::exception&)
+    {
+        is_valid = false;
+    }
+
+    SYNTROPY_UNIT_ASSERT(is_valid);
+
+    // Match each "B" event with the next "E" event on the same timeline.
+
+    using Point = std::pair<uint64_t, double>;                          // Timeline and timestamp of an event.
+
+    std::map<uint64_t, std::vector<nlohmann::json>> open_spans;         // Spans begun and not ended yet, for each timeline.
+
+    std::map<uint64_t, std::pair<Point, Point>> tasks;                  // Begin and end of each task execution.
+
+    std::map<uint64_t, Point> flow_starts;
+    std::map<uint64_t, Point> flow_ends;
+
+    size_t unmatched_spans = 0;
+
+    for (auto&& event : json["traceEvents"])
+    {
+        auto phase = event["ph"].get<std::string>();
+
+        auto point = Point{ event["tid"].get<uint64_t>(), event["ts"].get<double>() };
+
+        auto& spans = open_spans[point.first];
+
+        if (phase == "B")
+        {
+            spans.emplace_back(event);
+        }
+        else if (phase == "E" && (spans.empty() || spans.back()["name"] != event["name"]))
+        {
+            ++unmatched_spans;
+        }
+        else if (phase == "E")
+        {
+            auto& begin = spans.back();
+
+            if (begin.count("args") > 0)
+            {
+                tasks[begin["args"]["id"].get<uint64_t>()] = { Point{ point.first, begin["ts"].get<double>() }, point };
+            }
+
+            spans.pop_back();
+        }
+        else if (phase == "s")
+        {
+            flow_starts[event["id"].get<uint64_t>()] = point;
+        }
+        else if (phase == "f")
+        {
+            flow_ends[event["id"].get<uint64_t>()] = point;
+        }
+    }
+
+    for (auto&& spans : open_spans)
+    {
+        unmatched_spans += spans.second.size();
+    }
+
+    SYNTROPY_UNIT_ASSERT(unmatched_spans == 0);
+
+    SYNTROPY_UNIT_ASSERT(tasks.count(a) && tasks.count(b) && tasks.count(c) && tasks.count(d));
+
+    // Each flow goes from the end of a dependency to the beginning of its successor.
+
+    SYNTROPY_UNIT_ASSERT(flow_starts.size() == flow_ends.size());
+
+    auto is_linked = [&](uint64_t dependency, uint64_t successor)
+    {
+        for (auto&& flow_start : flow_starts)
+        {
+            auto flow_end = flow_ends.find(flow_start.first);
+
+            if (flow_end != flow_ends.end() && flow_start.second == tasks[dependency].second && flow_end->second == tasks[successor].first)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    SYNTROPY_UNIT_ASSERT(is_linked(a, b));
+    SYNTROPY_UNIT_ASSERT(is_linked(a, c));
+    SYNTROPY_UNIT_ASSERT(is_linked(b, d));
+    SYNTROPY_UNIT_ASSERT(is_linked(c, d));
+
+#endif
+}
@@ -8,7 +8,7 @@
 /* TEST SYNTROPY MATH VECTOR                                            */
 /************************************************************************/
 
-syntropy::AutoTestSuite<TestSyntropyMathVector> suite("syntropy.math.vector");
+static syntropy::AutoTestSuite<TestSyntropyMathVector> suite("syntropy.math.vector");
 
 std::vector<syntropy::TestCase> TestSyntropyMathVector::GetTestCases()
 {
@@ -2,24 +2,90 @@
 
 #include "syntropy/memory/bytes.h"
 #include "syntropy/memory/allocators/pool_allocator.h"
+#include "syntropy/memory/allocators/pool_allocator_policy.h"
+#include "syntropy/memory/allocators/linear_allocator.h"
 #include "syntropy/memory/allocators/page_allocator.h"
+#include "syntropy/memory/allocators/page_allocator_policy.h"
+#include "syntropy/memory/allocators/slab_allocator.h"
+#include "syntropy/memory/allocators/epoch_arena.h"
+#include "syntropy/memory/page_map.h"
+#include "syntropy/memory/virtual_memory.h"
+#include "syntropy/memory/memory_profiler.h"
+#include "syntropy/memory/mapped_file.h"
 #include "syntropy/macro.h"
 
 #include "syntropy/reflection/class.h"
 
 #include "syntropy/unit_test/test_runner.h"
 
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+
+namespace
+{
+    /// \brief File in the temporary directory, deleted upon destruction.
+    class TemporaryFile
+    {
+    public:
+
+        /// \brief Create a new file.
+        /// \param name Name of the file.
+        /// \param content Content of the file.
+        TemporaryFile(const std::string& name, const std::vector<uint8_t>& content)
+            : path_((std::filesystem::temp_directory_path() / name).string())
+        {
+            std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+
+            file.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+        }
+
+        /// \brief Delete the file.
+        ~TemporaryFile()
+        {
+            std::remove(path_.c_str());
+        }
+
+        /// \brief Get the file content, read without mapping the file.
+        std::vector<uint8_t> Read() const
+        {
+            std::ifstream file(path_, std::ios::binary);
+
+            return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        const std::string path_;                    ///< \brief Path of the file.
+    };
+}
+
 /************************************************************************/
 /* TEST SYNTROPY MEMORY ALLOCATORS                                      */
 /************************************************************************/
 
-syntropy::AutoTestSuite<TestSyntropyMemoryAllocators> suite("syntropy.memory.allocators");
+static syntropy::AutoTestSuite<TestSyntropyMemoryAllocators> suite("syntropy.memory.allocators");
 
 std::vector<syntropy::TestCase> TestSyntropyMemoryAllocators::GetTestCases()
 {
     return
     {
-        { "memory context", &TestSyntropyMemoryAllocators::TestMemoryContext }
+        { "memory context", &TestSyntropyMemoryAllocators::TestMemoryContext },
+        { "thread cache", &TestSyntropyMemoryAllocators::TestThreadCache },
+        { "thread cache remote free", &TestSyntropyMemoryAllocators::TestThreadCacheRemoteFree },
+        { "slab allocator", &TestSyntropyMemoryAllocators::TestSlabAllocator },
+        { "memory profiler", &TestSyntropyMemoryAllocators::TestMemoryProfiler },
+        { "epoch arena", &TestSyntropyMemoryAllocators::TestEpochArena },
+        { "epoch arena concurrency", &TestSyntropyMemoryAllocators::TestEpochArenaConcurrency },
+        { "virtual linear allocator", &TestSyntropyMemoryAllocators::TestVirtualLinearAllocator },
+        { "page map", &TestSyntropyMemoryAllocators::TestPageMap },
+        { "allocator lookup", &TestSyntropyMemoryAllocators::TestAllocatorLookup },
+        { "mapped file", &TestSyntropyMemoryAllocators::TestMappedFile },
+        { "concurrent pool allocator", &TestSyntropyMemoryAllocators::TestConcurrentPoolAllocator },
+        { "large pages", &TestSyntropyMemoryAllocators::TestLargePages }
     };
 }
 
@@ -28,7 +94,7 @@ TestSyntropyMemoryAllocators::TestSyntropyMemoryAllocators()
     // Initialization of the memory manager
 
     // #TODO This test should not rely on the reflection system and its configuration should not be provided by an external file (since it would most likely change the test result).
-    syntropy::ImportMemoryConfigurationFromJSON("memory.cfg");
+    has_configuration_ = syntropy::ImportMemoryConfigurationFromJSON("memory.cfg");
 }
 
 void TestSyntropyMemoryAllocators::TestMemoryContext()
@@ -37,6 +103,11 @@ void TestSyntropyMemoryAllocators::TestMemoryContext()
 
     // #TODO This is not a proper unit test: it resembles an integration test which cannot be verified (since the output is provided to the logging system).
 
+    if (!has_configuration_)
+    {
+        SYNTROPY_UNIT_SKIP("memory.cfg not found.");
+    }
+
     void* p;
     void* q;
     void* r;
@@ -57,4 +128,724 @@ void TestSyntropyMemoryAllocators::TestMemoryContext()
         SYNTROPY_MM_FREE(q);
         SYNTROPY_MM_FREE(r);
     }
-}
\ No newline at end of file
+}
+
+void TestSyntropyMemoryAllocators::TestThreadCache()
+{
+    using namespace syntropy;
+
+    TwoLevelSegregatedFitAllocator allocator("ThreadCache", 16_MiBytes, 4);
+
+    static constexpr size_t kCount = 1000;
+
+    std::vector<void*> blocks(kCount);
+
+    // Allocate small blocks from another thread's cache.
+
+    std::thread([&allocator, &blocks]()
+    {
+        for (size_t index = 0; index < kCount; ++index)
+        {
+            blocks[index] = allocator.Allocate(Bytes(1 + index % 256));
+        }
+    }).join();
+
+    SYNTROPY_UNIT_ASSERT(std::all_of(blocks.begin(), blocks.end(), [&allocator](void* block) { return block && allocator.Owns(block); }));
+
+    std::sort(blocks.begin(), blocks.end());
+
+    SYNTROPY_UNIT_ASSERT(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+    // Blocks of a cache whose thread exited are returned to the shared allocator, hence they are reused by other threads.
+
+    for (auto&& block : blocks)
+    {
+        allocator.Free(block);
+    }
+
+    auto block = allocator.Allocate(64_KiBytes);                   // Fits only if the freed blocks were coalesced.
+
+    SYNTROPY_UNIT_ASSERT(allocator.Owns(block));
+    SYNTROPY_UNIT_ASSERT(block <= blocks.back());
+
+    allocator.Free(block);
+
+    // A new thread is bound to the released cache and reuses the same memory.
+
+    std::vector<void*> reused_blocks(kCount);
+
+    std::thread([&allocator, &reused_blocks]()
+    {
+        for (size_t index = 0; index < kCount; ++index)
+        {
+            reused_blocks[index] = allocator.Allocate(Bytes(1 + index % 256));
+        }
+    }).join();
+
+    SYNTROPY_UNIT_ASSERT(std::all_of(reused_blocks.begin(), reused_blocks.end(), [&blocks](void* block) { return block && block <= blocks.back(); }));
+
+    for (auto&& reused_block : reused_blocks)
+    {
+        allocator.Free(reused_block);
+    }
+}
+
+void TestSyntropyMemoryAllocators::TestThreadCacheRemoteFree()
+{
+    using namespace syntropy;
+
+    TwoLevelSegregatedFitAllocator allocator("ThreadCacheRemoteFree", 16_MiBytes, 4);
+
+    static constexpr size_t kThreadCount = 4;
+    static constexpr size_t kCount = kThreadCount * TwoLevelSegregatedFitAllocator::kThreadCacheBatchSize;      // Whole batches: the owner cache is empty once every block was handed out.
+
+    std::vector<void*> blocks(kCount);
+    std::vector<void*> reused_blocks(kCount);
+
+    std::atomic<size_t> phase{ 0 };
+
+    auto wait_for = [&phase](size_t value)
+    {
+        while (phase.load(std::memory_order_acquire) < value)
+        {
+            std::this_thread::yield();
+        }
+    };
+
+    // The owner thread stays alive for the whole test, hence blocks freed by other threads go through its remote list.
+
+    std::thread owner([&]()
+    {
+        for (auto&& block : blocks)
+        {
+            block = allocator.Allocate(64_Bytes);
+        }
+
+        phase.store(1, std::memory_order_release);
+
+        wait_for(1 + kThreadCount);
+
+        for (auto&& block : reused_blocks)
+        {
+            block = allocator.Allocate(64_Bytes);
+        }
+    });
+
+    wait_for(1);
+
+    // Many threads push on the same remote list at once.
+
+    std::vector<std::thread> threads;
+
+    for (size_t thread_index = 0; thread_index < kThreadCount; ++thread_index)
+    {
+        threads.emplace_back([&, thread_index]()
+        {
+            for (auto index = thread_index; index < kCount; index += kThreadCount)
+            {
+                allocator.Free(blocks[index]);
+            }
+
+            phase.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    owner.join();
+
+    // The owner collected the blocks freed remotely before asking the shared allocator for more: every block came back exactly once.
+
+    std::sort(blocks.begin(), blocks.end());
+    std::sort(reused_blocks.begin(), reused_blocks.end());
+
+    SYNTROPY_UNIT_ASSERT(std::all_of(blocks.begin(), blocks.end(), [&allocator](void* block) { return block && allocator.Owns(block); }));
+    SYNTROPY_UNIT_ASSERT(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+    SYNTROPY_UNIT_ASSERT(reused_blocks == blocks);
+
+    for (auto&& reused_block : reused_blocks)
+    {
+        allocator.Free(reused_block);
+    }
+}
+
+void TestSyntropyMemoryAllocators::TestSlabAllocator()
+{
+    using namespace syntropy;
+
+    auto page_size = VirtualMemory::GetPageSize();
+
+    SlabAllocator<PageAllocator<>> allocator(page_size, 48_Bytes, Alignment(16_Bytes), 1_MiBytes, page_size);
+
+    static constexpr size_t kCount = 1000;
+
+    std::vector<MemoryRange> blocks(kCount);
+
+    for (auto&& block : blocks)
+    {
+        block = allocator.Allocate(40_Bytes);
+    }
+
+    SYNTROPY_UNIT_ASSERT(std::all_of(blocks.begin(), blocks.end(), [&allocator](const MemoryRange& block) { return block && allocator.Owns(block); }));
+
+    // Consecutive blocks are packed next to each other.
+
+    SYNTROPY_UNIT_ASSERT(blocks[1].Begin() - blocks[0].Begin() == 48);
+
+    // The lowest free slot is recycled first.
+
+    auto recycled = blocks[kCount / 2];
+
+    allocator.Deallocate(blocks[kCount / 2 + 1]);
+    allocator.Deallocate(recycled);
+
+    SYNTROPY_UNIT_ASSERT(allocator.Allocate(40_Bytes).Begin() == recycled.Begin());
+
+    allocator.Deallocate(recycled);
+
+    blocks.erase(blocks.begin() + kCount / 2, blocks.begin() + kCount / 2 + 2);
+
+    for (auto&& block : blocks)
+    {
+        allocator.Deallocate(block);
+    }
+
+    SYNTROPY_UNIT_ASSERT(!allocator.Allocate(64_Bytes));
+}
+
+void TestSyntropyMemoryAllocators::TestMemoryProfiler()
+{
+    using namespace syntropy;
+
+    TwoLevelSegregatedFitAllocator allocator("Profiled", 16_MiBytes, 4);
+
+    auto& profiler = GetMemoryProfiler();
+
+    profiler.Enable(0_Bytes);                                   // Sample every allocation.
+
+    auto baseline = profiler.GetSnapshot();
+
+    std::vector<void*> blocks(100);
+
+    for (auto&& block : blocks)
+    {
+        block = SYNTROPY_ALLOC(allocator, 100);
+    }
+
+    for (size_t index = 0; index < blocks.size() / 2; ++index)
+    {
+        SYNTROPY_FREE(allocator, blocks[index]);
+    }
+
+    auto snapshot = profiler.GetSnapshot().Diff(baseline);
+
+    profiler.Disable();
+
+    auto& statistics = snapshot.allocators_["Profiled"];
+
+    SYNTROPY_UNIT_ASSERT(statistics.allocation_count_ == 100);
+    SYNTROPY_UNIT_ASSERT(statistics.deallocation_count_ == 50);
+    SYNTROPY_UNIT_ASSERT(statistics.live_bytes_ == 5000);
+    SYNTROPY_UNIT_ASSERT(statistics.peak_live_bytes_ == 10000);
+    SYNTROPY_UNIT_ASSERT(statistics.size_histogram_[7] == 100);
+
+    // Contexts include the statistics of their sub-contexts.
+
+    SYNTROPY_UNIT_ASSERT(snapshot.contexts_[Context(allocator).GetName().GetString()].live_bytes_ == 5000);
+
+    SYNTROPY_UNIT_ASSERT(snapshot.call_sites_.size() == 1);
+    SYNTROPY_UNIT_ASSERT(snapshot.call_sites_[0].estimated_live_bytes_ == 5000);
+
+    // Blocks deallocated after the profiler was disabled are not reported as live anymore, lest their addresses be misattributed once recycled.
+
+    for (size_t index = blocks.size() / 2; index < blocks.size(); ++index)
+    {
+        SYNTROPY_FREE(allocator, blocks[index]);
+    }
+
+    auto released = profiler.GetSnapshot().Diff(baseline);
+
+    SYNTROPY_UNIT_ASSERT(released.allocators_["Profiled"].deallocation_count_ == 100);
+    SYNTROPY_UNIT_ASSERT(released.allocators_["Profiled"].live_bytes_ == 0);
+
+    profiler.Reset();
+}
+
+void TestSyntropyMemoryAllocators::TestEpochArena()
+{
+    using namespace syntropy;
+
+    EpochArena arena(1_MiBytes, 2, 1, 4);
+
+    auto first = arena.Allocate(256_Bytes, Alignment(64_Bytes));
+
+    SYNTROPY_UNIT_ASSERT(first && arena.Owns(first));
+    SYNTROPY_UNIT_ASSERT(first.Begin().IsAlignedTo(Alignment(64_Bytes)));
+
+    SYNTROPY_UNIT_ASSERT(!arena.Allocate(2_MiBytes));
+
+    // Memory of epoch 0 survives epoch 1 and is recycled by epoch 2, once signalled.
+
+    SYNTROPY_UNIT_ASSERT(arena.Advance());
+    SYNTROPY_UNIT_ASSERT(arena.Allocate(256_Bytes).Begin() != first.Begin());
+    SYNTROPY_UNIT_ASSERT(!arena.CanAdvance());
+
+    arena.Signal(0);
+
+    SYNTROPY_UNIT_ASSERT(arena.Advance());
+    SYNTROPY_UNIT_ASSERT(arena.GetEpoch() == 2);
+    SYNTROPY_UNIT_ASSERT(arena.Allocate(256_Bytes, Alignment(64_Bytes)).Begin() == first.Begin());
+
+    arena.Signal(1);
+
+    // Memory above the usage of the last recycles is decommitted.
+
+    for (std::size_t epoch = 2; epoch < 20; ++epoch)
+    {
+        arena.Signal(epoch);
+        arena.Advance();
+    }
+
+    SYNTROPY_UNIT_ASSERT(arena.GetCommittedSize() == 0_Bytes);
+}
+
+void TestSyntropyMemoryAllocators::TestEpochArenaConcurrency()
+{
+    using namespace syntropy;
+
+    static constexpr std::size_t kThreadCount = 4;
+    static constexpr std::size_t kBufferCount = 2;
+    static constexpr std::size_t kEpochCount = 2000;
+    static constexpr std::size_t kHistory = 64;
+
+    EpochArena arena(4_MiBytes, kBufferCount, 0);
+
+    std::atomic<bool> is_done{ false };
+    std::atomic<std::size_t> errors{ 0 };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t thread_index = 0; thread_index < kThreadCount; ++thread_index)
+    {
+        threads.emplace_back([&arena, &is_done, &errors, thread_index]()
+        {
+            // A block allocated between epochs e0 and e1 belongs to an epoch in [e0; e1] and survives at least until epoch e0 + buffer count.
+
+            struct Allocation
+            {
+                MemoryRange block_;
+                std::uint64_t stamp_;
+                std::size_t first_epoch_;
+            };
+
+            std::vector<Allocation> history(kHistory);
+
+            for (std::uint64_t count = 0; !is_done.load(std::memory_order_relaxed); ++count)
+            {
+                auto first_epoch = arena.GetEpoch();
+
+                auto block = arena.Allocate(64_Bytes);
+
+                auto last_epoch = arena.GetEpoch();
+
+                if (!block)
+                {
+                    std::this_thread::yield();                                  // The buffer is full: wait for the next epoch.
+                    continue;
+                }
+
+                auto stamp = (std::uint64_t(thread_index) << 48) | count;
+
+                *block.Begin().As<std::uint64_t>() = stamp;
+
+                for (auto&& allocation : history)
+                {
+                    if (allocation.block_ && last_epoch < allocation.first_epoch_ + kBufferCount)       // Both blocks are alive.
+                    {
+                        errors += (block.Contains(allocation.block_.Begin()) || allocation.block_.Contains(block.Begin()));
+                        errors += (*allocation.block_.Begin().As<std::uint64_t>() != allocation.stamp_);
+                    }
+                }
+
+                history[count % kHistory] = Allocation{ block, stamp, first_epoch };
+            }
+        });
+    }
+
+    for (std::size_t epoch = 0; epoch < kEpochCount; ++epoch)
+    {
+        arena.Advance();
+
+        std::this_thread::yield();
+    }
+
+    is_done = true;
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    SYNTROPY_UNIT_ASSERT(arena.GetEpoch() == kEpochCount);
+    SYNTROPY_UNIT_ASSERT(errors == 0);
+}
+
+void TestSyntropyMemoryAllocators::TestVirtualLinearAllocator()
+{
+    using namespace syntropy;
+
+    VirtualLinearAllocator allocator(16_MiBytes, 64_KiBytes, 128_KiBytes);
+
+    SYNTROPY_UNIT_ASSERT(allocator.GetCommittedSize() == 0_Bytes);
+
+    auto state = allocator.SaveState();
+
+    // Memory is committed in chunks as the allocator grows.
+
+    auto block = allocator.Allocate(100_KiBytes);
+
+    SYNTROPY_UNIT_ASSERT(block && allocator.Owns(block));
+    SYNTROPY_UNIT_ASSERT(allocator.GetCommittedSize() == 128_KiBytes);
+
+    auto chunk = allocator.SaveState();
+
+    allocator.Allocate(64_KiBytes);
+
+    SYNTROPY_UNIT_ASSERT(allocator.GetCommittedSize() == 192_KiBytes);
+
+    // Memory past the head pointer is decommitted only if it exceeds the threshold.
+
+    allocator.RestoreState(chunk);
+
+    SYNTROPY_UNIT_ASSERT(allocator.GetCommittedSize() == 192_KiBytes);
+
+    allocator.RestoreState(state);
+
+    SYNTROPY_UNIT_ASSERT(allocator.GetCommittedSize() == 0_Bytes);
+
+    SYNTROPY_UNIT_ASSERT(!allocator.Allocate(32_MiBytes));
+}
+
+void TestSyntropyMemoryAllocators::TestPageMap()
+{
+    using namespace syntropy;
+
+    using TPageMap = PageMap<int>;
+
+    auto page_map = std::make_unique<TPageMap>();
+
+    int first = 1;
+    int second = 2;
+
+    auto chunk = [](std::size_t index) { return MemoryAddress(uintptr_t(index) << TPageMap::kChunkBits); };
+
+    // Ranges spanning several leaves and interior nodes.
+
+    auto first_range = MemoryRange(chunk(0x3FF), chunk(0x100401));
+    auto second_range = MemoryRange(chunk(0x7FFFFFF0), chunk(0x7FFFFFFF));
+
+    page_map->Insert(first_range, &first);
+    page_map->Insert(second_range, &second);
+
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x3FE)) == nullptr);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x3FF)) == &first);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x400) + 1_Bytes) == &first);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x100400) + (TPageMap::kChunkSize - 1_Bytes)) == &first);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x100401)) == nullptr);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x7FFFFFF8)) == &second);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x7FFFFFFF)) == nullptr);
+
+    SYNTROPY_UNIT_ASSERT(page_map->Get(MemoryAddress(uintptr_t(1) << TPageMap::kAddressBits)) == nullptr);        // Past the mapped address space.
+
+    // Chunks shared by two ranges are not mapped.
+
+    auto shared_begin = chunk(0x200000) + (TPageMap::kChunkSize / 2);
+
+    page_map->Insert(MemoryRange(chunk(0x1FFFFF), shared_begin), &first);
+    page_map->Insert(MemoryRange(shared_begin, chunk(0x200002)), &second);
+
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x1FFFFF)) == &first);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(shared_begin) == nullptr);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x200001)) == &second);
+
+    // Erased ranges are no longer mapped, ranges that were never mapped are ignored.
+
+    page_map->Erase(first_range);
+    page_map->Erase(MemoryRange(chunk(0x40000000), chunk(0x40100000)));
+
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x3FF)) == nullptr);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x100400)) == nullptr);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x7FFFFFF8)) == &second);
+    SYNTROPY_UNIT_ASSERT(page_map->Get(chunk(0x1FFFFF)) == &first);
+}
+
+void TestSyntropyMemoryAllocators::TestAllocatorLookup()
+{
+    using namespace syntropy;
+
+    // Two allocators sharing the chunk in the middle of a range. The memory manager never releases its allocators, hence neither is the range.
+
+    auto memory_range = VirtualMemory::Allocate(256_KiBytes);
+
+    SYNTROPY_UNIT_ASSERT(memory_range);
+
+    auto split = memory_range.Begin() + 96_KiBytes;
+
+    auto& memory_manager = GetMemoryManager();
+
+    auto& first = memory_manager.AcquireAllocator(std::make_unique<TwoLevelSegregatedFitAllocator>("TestAllocatorLookup::First", MemoryRange(memory_range.Begin(), split), 4));
+    auto& second = memory_manager.AcquireAllocator(std::make_unique<TwoLevelSegregatedFitAllocator>("TestAllocatorLookup::Second", MemoryRange(split, memory_range.End()), 4));
+
+    std::vector<void*> first_blocks;
+    std::vector<void*> second_blocks;
+
+    for (std::size_t index = 0; index < 64; ++index)
+    {
+        first_blocks.push_back(first.Allocate(1_KiBytes));
+        second_blocks.push_back(second.Allocate(1_KiBytes));
+    }
+
+    // Blocks on the shared chunk fall back to the linear search, any other block is resolved via the page map.
+
+    SYNTROPY_UNIT_ASSERT(std::all_of(first_blocks.begin(), first_blocks.end(), [&](void* block) { return block && memory_manager.GetAllocator(block) == &first; }));
+    SYNTROPY_UNIT_ASSERT(std::all_of(second_blocks.begin(), second_blocks.end(), [&](void* block) { return block && memory_manager.GetAllocator(block) == &second; }));
+
+    SYNTROPY_UNIT_ASSERT(memory_manager.GetAllocator(memory_range.End().As<void>()) == nullptr);
+
+    for (std::size_t index = 0; index < first_blocks.size(); ++index)
+    {
+        first.Free(first_blocks[index]);
+        second.Free(second_blocks[index]);
+    }
+}
+
+void TestSyntropyMemoryAllocators::TestMappedFile()
+{
+    using namespace syntropy;
+
+    auto content = std::vector<uint8_t>(10000);                 // Spans more than one page, the last one partially.
+
+    for (size_t index = 0; index < content.size(); ++index)
+    {
+        content[index] = static_cast<uint8_t>(index * 7);
+    }
+
+    TemporaryFile file("syntropy_test_mapped_file.bin", content);
+    TemporaryFile empty_file("syntropy_test_mapped_file_empty.bin", {});
+
+    // Read-only mappings expose the file content.
+
+    {
+        MappedMemoryBuffer buffer(file.path_);
+
+        SYNTROPY_UNIT_ASSERT(buffer);
+        SYNTROPY_UNIT_ASSERT(buffer.GetMode() == MappedFileMode::kReadOnly);
+        SYNTROPY_UNIT_ASSERT(buffer.GetSize() == Bytes(content.size()));
+        SYNTROPY_UNIT_ASSERT(std::equal(std::begin(content), std::end(content), MemoryRange(buffer).Begin().As<uint8_t>()));
+        SYNTROPY_UNIT_ASSERT(buffer.GetResidentSize() > 0_Bytes);      // The pages were just read.
+
+        auto moved = std::move(buffer);
+
+        SYNTROPY_UNIT_ASSERT(!buffer);
+        SYNTROPY_UNIT_ASSERT(moved && moved.GetSize() == Bytes(content.size()));
+    }
+
+    // Copy-on-write mappings can be modified without affecting other mappings or the file itself.
+
+    {
+        MappedMemoryBuffer writable(file.path_, MappedFileMode::kCopyOnWrite);
+        MappedMemoryBuffer readable(file.path_);
+
+        SYNTROPY_UNIT_ASSERT(writable && readable);
+
+        auto written = MemoryRange(writable).Begin().As<uint8_t>();
+
+        written[0] = static_cast<uint8_t>(content[0] + 1);
+        written[content.size() - 1] = static_cast<uint8_t>(content.back() + 1);
+
+        SYNTROPY_UNIT_ASSERT(written[0] == static_cast<uint8_t>(content[0] + 1));
+        SYNTROPY_UNIT_ASSERT(written[content.size() - 1] == static_cast<uint8_t>(content.back() + 1));
+        SYNTROPY_UNIT_ASSERT(std::equal(std::begin(content), std::end(content), MemoryRange(readable).Begin().As<uint8_t>()));
+    }
+
+    SYNTROPY_UNIT_ASSERT(file.Read() == content);
+
+    // Empty and missing files cannot be mapped.
+
+    SYNTROPY_UNIT_ASSERT(!MappedMemoryBuffer(empty_file.path_));
+    SYNTROPY_UNIT_ASSERT(!MappedFile::Map(empty_file.path_, MappedFileMode::kCopyOnWrite));
+    SYNTROPY_UNIT_ASSERT(!MappedMemoryBuffer(file.path_ + ".missing"));
+    SYNTROPY_UNIT_ASSERT(!MappedFile::Map(file.path_ + ".missing", MappedFileMode::kReadOnly));
+}
+
+void TestSyntropyMemoryAllocators::TestConcurrentPoolAllocator()
+{
+    using namespace syntropy;
+
+    static constexpr std::size_t kThreadCount = 4;
+    static constexpr std::size_t kBatchSize = 32;
+    static constexpr std::size_t kBatchCount = 2000;
+    static constexpr std::size_t kBlockCount = (kThreadCount + 1) * kBatchSize;     // Just enough for every batch: blocks must be recycled to keep up.
+
+    struct alignas(64) Block
+    {
+        uint8_t bytes_[64];
+    };
+
+    using Batch = std::vector<MemoryRange>;
+
+    auto storage = std::vector<Block>(kBlockCount);
+
+    auto storage_range = MemoryRange(MemoryAddress(storage.data()), MemoryAddress(storage.data() + storage.size()));
+
+    PoolAllocator<ConcurrentLinearAllocator, ConcurrentPoolAllocatorPolicy> allocator(Bytes(sizeof(Block)), Alignment(Bytes(alignof(Block))), storage_range);
+
+    // Each block records the thread it was handed out to: a block handed out twice would find another owner.
+
+    auto owners = std::vector<std::atomic<std::size_t>>(kBlockCount);
+
+    auto get_owner = [&owners, &storage_range](const MemoryRange& block) -> std::atomic<std::size_t>&
+    {
+        return owners[static_cast<std::size_t>(block.Begin() - storage_range.Begin()) / sizeof(Block)];
+    };
+
+    auto batches = std::vector<Batch>(kThreadCount + 1, Batch(kBatchSize));
+
+    std::atomic<Batch*> exchange{ &batches.back() };
+    std::atomic<std::size_t> errors{ 0 };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t thread_index = 0; thread_index < kThreadCount; ++thread_index)
+    {
+        threads.emplace_back([&, thread_index, batch = &batches[thread_index]]() mutable
+        {
+            // Refill a batch, then swap it with the batch left by another thread: blocks are mostly deallocated by threads other than the allocating one.
+
+            for (std::size_t batch_index = 0; batch_index < kBatchCount; ++batch_index)
+            {
+                for (auto&& block : *batch)
+                {
+                    if (block)
+                    {
+                        errors += (get_owner(block).exchange(0, std::memory_order_relaxed) == 0);
+
+                        allocator.Deallocate(block);
+                    }
+
+                    block = allocator.Allocate(Bytes(sizeof(Block)));
+
+                    if (!block)
+                    {
+                        ++errors;                                       // Some block was lost.
+                        continue;
+                    }
+
+                    errors += (get_owner(block).exchange(thread_index + 1, std::memory_order_relaxed) != 0);
+
+                    *block.Begin().As<std::size_t>() = batch_index;
+                }
+
+                batch = exchange.exchange(batch, std::memory_order_acq_rel);
+            }
+        });
+    }
+
+    for (auto&& thread : threads)
+    {
+        thread.join();
+    }
+
+    SYNTROPY_UNIT_ASSERT(errors == 0);
+
+    for (auto&& batch : batches)
+    {
+        for (auto&& block : batch)
+        {
+            if (block)
+            {
+                get_owner(block).store(0, std::memory_order_relaxed);
+
+                allocator.Deallocate(block);
+            }
+        }
+    }
+
+    // Every block came back: the whole storage can be allocated again, one distinct block at a time.
+
+    for (std::size_t index = 0; index < kBlockCount; ++index)
+    {
+        auto block = allocator.Allocate(Bytes(sizeof(Block)));
+
+        SYNTROPY_UNIT_ASSERT(block);
+        SYNTROPY_UNIT_ASSERT(get_owner(block).exchange(1, std::memory_order_relaxed) == 0);
+    }
+
+    SYNTROPY_UNIT_ASSERT(!allocator.Allocate(Bytes(sizeof(Block))));
+}
+
+void TestSyntropyMemoryAllocators::TestLargePages()
+{
+    using namespace syntropy;
+
+    auto large_page_size = VirtualMemory::GetLargePageSize();
+
+    auto counters = VirtualMemory::GetLargePageCounters();
+
+    auto memory_range = VirtualMemory::ReserveLarge(1_Bytes);
+
+    auto reserved = VirtualMemory::GetLargePageCounters();
+
+    SYNTROPY_UNIT_ASSERT(memory_range);
+
+    if (large_page_size == 0_Bytes)
+    {
+        // Large pages are not supported at all: the range falls back to regular pages without being accounted for.
+
+        SYNTROPY_UNIT_ASSERT(memory_range.GetSize() >= 1_Bytes);
+        SYNTROPY_UNIT_ASSERT(reserved.requested_pages_ == counters.requested_pages_);
+        SYNTROPY_UNIT_ASSERT(reserved.accepted_pages_ == counters.accepted_pages_);
+    }
+    else
+    {
+        // The size is rounded up to a whole large page. If the request is rejected, the range falls back to regular pages.
+
+        auto is_accepted = (reserved.accepted_pages_ == counters.accepted_pages_ + 1);
+
+        SYNTROPY_UNIT_ASSERT(memory_range.GetSize() == large_page_size);
+        SYNTROPY_UNIT_ASSERT(reserved.requested_pages_ == counters.requested_pages_ + 1);
+        SYNTROPY_UNIT_ASSERT(is_accepted || reserved.accepted_pages_ == counters.accepted_pages_);
+        SYNTROPY_UNIT_ASSERT(!is_accepted || memory_range.Begin().IsAlignedTo(Alignment(large_page_size)));
+    }
+
+    // Whether the range is actually backed by large pages is up to the system: accepted pages are only a hint on some of them, while others may back regular ranges with large pages as well.
+
+    SYNTROPY_UNIT_ASSERT(VirtualMemory::Commit(memory_range));
+
+    std::fill(memory_range.Begin().As<uint8_t>(), memory_range.End().As<uint8_t>(), uint8_t(0xAB));
+
+    SYNTROPY_UNIT_ASSERT(VirtualMemory::GetLargePageResidentSize(memory_range) <= memory_range.GetSize());
+
+    SYNTROPY_UNIT_ASSERT(VirtualMemory::Release(memory_range));
+
+    // Pages of an allocator backed by large pages are rounded up to the large page size, or to the regular page size if large pages are not supported.
+
+    auto page_size = (large_page_size > 0_Bytes) ? large_page_size : VirtualMemory::GetPageSize();
+
+    PageAllocator<LargePageAllocatorPolicy> allocator(page_size * 4, 1_KiBytes);
+
+    SYNTROPY_UNIT_ASSERT(allocator.GetMaxAllocationSize() == page_size);
+
+    auto block = allocator.Allocate(1_KiBytes);
+
+    SYNTROPY_UNIT_ASSERT(block && allocator.Owns(block));
+
+    std::fill(block.Begin().As<uint8_t>(), (block.Begin() + page_size).As<uint8_t>(), uint8_t(0xAB));
+
+    allocator.Deallocate(block);
+
+    SYNTROPY_UNIT_ASSERT(allocator.Allocate(1_KiBytes).Begin() == block.Begin());        // Pages stay committed and are recycled.
+}
@@ -11,6 +11,10 @@
 
 #include <sstream>
 #include <iomanip>
+#include <new>
+#include <limits>
+#include <cstddef>
+#include <stdexcept>
 
 /************************************************************************/
 /* TEST CLASSES                                                         */
@@ -98,11 +102,109 @@ TestSyntropyReflection::Canary::Canary()
 
 }
 
+// Crate
+
+template <>
+struct syntropy::reflection::ClassDeclarationT<TestSyntropyReflection::Crate>
+{
+    static constexpr const char* name_{ "TestSyntropyReflection::Crate" };
+};
+
+int TestSyntropyReflection::Crate::instances_ = 0;
+
+TestSyntropyReflection::Crate::Crate(int value)
+    : value_(value)
+{
+    ++instances_;
+}
+
+TestSyntropyReflection::Crate::Crate(const Crate& other)
+    : value_(other.value_)
+{
+    ++instances_;
+}
+
+TestSyntropyReflection::Crate::~Crate()
+{
+    --instances_;
+}
+
+// Token
+
+template <>
+struct syntropy::reflection::ClassDeclarationT<TestSyntropyReflection::Token>
+{
+    static constexpr const char* name_{ "TestSyntropyReflection::Token" };
+};
+
+int TestSyntropyReflection::Token::copies_ = 0;
+
+int TestSyntropyReflection::Token::moves_ = 0;
+
+TestSyntropyReflection::Token::Token(int value)
+    : value_(value)
+{
+    if (value < 0)
+    {
+        throw std::invalid_argument("value");
+    }
+}
+
+TestSyntropyReflection::Token::Token(const Token& other)
+    : value_(other.value_)
+{
+    ++copies_;
+}
+
+TestSyntropyReflection::Token::Token(Token&& other) noexcept
+    : value_(other.value_)
+{
+    ++moves_;
+}
+
+// TrackingAllocator
+
+void* TestSyntropyReflection::TrackingAllocator::Allocate(syntropy::Bytes size)
+{
+    return Allocate(size, syntropy::Alignment(syntropy::Bytes(alignof(std::max_align_t))));
+}
+
+void* TestSyntropyReflection::TrackingAllocator::Allocate(syntropy::Bytes size, syntropy::Alignment alignment)
+{
+    if (out_of_memory_)
+    {
+        return nullptr;
+    }
+
+    ++blocks_;
+
+    SYNTROPY_ASSERT(std::size_t(alignment) <= kMaxAlignment);
+
+    return ::operator new(std::size_t(size), std::align_val_t(kMaxAlignment));
+}
+
+void TestSyntropyReflection::TrackingAllocator::Free(void* block)
+{
+    --blocks_;
+
+    ::operator delete(block, std::align_val_t(kMaxAlignment));
+}
+
+bool TestSyntropyReflection::TrackingAllocator::Owns(void* /*block*/) const
+{
+    return blocks_ > 0;
+}
+
+syntropy::Bytes TestSyntropyReflection::TrackingAllocator::GetMaxAllocationSize() const
+{
+    return syntropy::Bytes(std::numeric_limits<std::size_t>::max());
+}
+
 /************************************************************************/
 /* TEST SYNTROPY REFLECTION                                             */
 /************************************************************************/
 
-syntropy::AutoTestSuite<TestSyntropyReflection> suite("syntropy.reflection.reflection");
+static syntropy::AutoTestSuite<TestSyntropyReflection> suite("syntropy.reflection.reflection");
 
 std::vector<syntropy::TestCase> TestSyntropyReflection::GetTestCases()
 {
@@ -116,7 +218,12 @@ std::vector<syntropy::TestCase> TestSyntropyReflection::GetTestCases()
         { "class instancing", &TestSyntropyReflection::TestClassInstancing },
         { "property read", &TestSyntropyReflection::TestPropertyRead },
         { "property write", &TestSyntropyReflection::TestPropertyWrite },
-        { "property move", &TestSyntropyReflection::TestPropertyMove }
+        { "property move", &TestSyntropyReflection::TestPropertyMove },
+        { "any copy", &TestSyntropyReflection::TestAnyCopy },
+        { "any move", &TestSyntropyReflection::TestAnyMove },
+        { "any swap", &TestSyntropyReflection::TestAnySwap },
+        { "any allocator", &TestSyntropyReflection::TestAnyAllocator },
+        { "any emplace", &TestSyntropyReflection::TestAnyEmplace }
     };
 }
 
@@ -269,3 +376,252 @@ void TestSyntropyReflection::TestPropertyMove()
     // #TODO Make sure it works for reflection::Any as well.
 }
 
+
+void TestSyntropyReflection::TestAnyCopy()
+{
+    using syntropy::reflection::Any;
+    using syntropy::reflection::AnyCast;
+
+    static_assert(Any::IsInline<int>(), "int is expected to be stored inline.");
+    static_assert(!Any::IsInline<Crate>(), "Crate is expected to be stored out of line.");
+
+    {
+        Any small(42);
+        Any small_copy(small);
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(small) == 42);
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(small_copy) == 42);
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(&small) != AnyCast<int>(&small_copy));
+
+        Any large(Crate(7));
+        Any large_copy(large);
+
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 2);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large_copy)->value_ == 7);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large) != AnyCast<Crate>(&large_copy));
+
+        small_copy = large;             // Inline to out of line.
+        large_copy = small;             // Out of line to inline.
+
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 2);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&small_copy)->value_ == 7);
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(large_copy) == 42);
+
+        small_copy = Any();
+
+        SYNTROPY_UNIT_ASSERT(!small_copy.HasValue());
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+    }
+
+    SYNTROPY_UNIT_ASSERT(Crate::instances_ == 0);
+}
+
+void TestSyntropyReflection::TestAnyMove()
+{
+    using syntropy::reflection::Any;
+    using syntropy::reflection::AnyCast;
+
+    {
+        Any small(42);
+        Any small_moved(std::move(small));
+
+        SYNTROPY_UNIT_ASSERT(!small.HasValue());
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(small_moved) == 42);
+
+        Any large(Crate(7));
+
+        auto value = AnyCast<Crate>(&large);
+
+        Any large_moved(std::move(large));
+
+        SYNTROPY_UNIT_ASSERT(!large.HasValue());
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large_moved) == value);        // Out-of-line values are not moved at all.
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+
+        small = std::move(large_moved);
+        large = std::move(small_moved);
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&small) == value);
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(large) == 42);
+        SYNTROPY_UNIT_ASSERT(!small_moved.HasValue());
+        SYNTROPY_UNIT_ASSERT(!large_moved.HasValue());
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+    }
+
+    SYNTROPY_UNIT_ASSERT(Crate::instances_ == 0);
+}
+
+void TestSyntropyReflection::TestAnySwap()
+{
+    using syntropy::reflection::Any;
+    using syntropy::reflection::AnyCast;
+
+    {
+        Any small(42);
+        Any large(Crate(7));
+        Any empty;
+
+        small.Swap(small);
+        large.Swap(large);
+        empty.Swap(empty);
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(small) == 42);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large)->value_ == 7);
+        SYNTROPY_UNIT_ASSERT(!empty.HasValue());
+
+        small.Swap(large);
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&small)->value_ == 7);
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(large) == 42);
+
+        std::swap(large, empty);
+
+        SYNTROPY_UNIT_ASSERT(!large.HasValue());
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(empty) == 42);
+
+        Any other_small(3);
+
+        other_small.Swap(empty);
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(other_small) == 42);
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(empty) == 3);
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+    }
+
+    SYNTROPY_UNIT_ASSERT(Crate::instances_ == 0);
+}
+
+void TestSyntropyReflection::TestAnyAllocator()
+{
+    using syntropy::reflection::Any;
+    using syntropy::reflection::AnyCast;
+
+    auto previous_allocator = Any::GetAllocator();
+
+    TrackingAllocator first;
+    TrackingAllocator second;
+
+    {
+        Any::SetAllocator(&first);
+
+        Any small(42);
+        Any large(Crate(1));
+
+        SYNTROPY_UNIT_ASSERT(first.blocks_ == 1);                  // Inline values never allocate.
+
+        Any::SetAllocator(&second);
+
+        Any large_copy(large);                                      // Copies go through the current allocator.
+
+        SYNTROPY_UNIT_ASSERT(first.blocks_ == 1);
+        SYNTROPY_UNIT_ASSERT(second.blocks_ == 1);
+
+        Any::SetAllocator(nullptr);
+
+        Any global(Crate(2));
+
+        large.Swap(global);
+        large_copy = std::move(global);                             // Values are freed by the allocator they were allocated with.
+
+        SYNTROPY_UNIT_ASSERT(first.blocks_ == 1);
+        SYNTROPY_UNIT_ASSERT(second.blocks_ == 0);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large)->value_ == 2);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large_copy)->value_ == 1);
+
+        large_copy.Reset();
+
+        SYNTROPY_UNIT_ASSERT(first.blocks_ == 0);
+
+        Any::SetAllocator(&second);
+
+        second.out_of_memory_ = true;
+
+        auto out_of_memory = false;
+
+        try
+        {
+            large = Crate(3);
+        }
+        catch (const std::bad_alloc&)
+        {
+            out_of_memory = true;
+        }
+
+        SYNTROPY_UNIT_ASSERT(out_of_memory);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&large)->value_ == 2);  // Failed assignments leave the object unchanged.
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+
+        small = 3;                                                  // Inline values never allocate.
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<int>(small) == 3);
+    }
+
+    Any::SetAllocator(previous_allocator);
+
+    SYNTROPY_UNIT_ASSERT(first.blocks_ == 0);
+    SYNTROPY_UNIT_ASSERT(second.blocks_ == 0);
+    SYNTROPY_UNIT_ASSERT(Crate::instances_ == 0);
+}
+
+void TestSyntropyReflection::TestAnyEmplace()
+{
+    using syntropy::reflection::Any;
+    using syntropy::reflection::AnyCast;
+
+    static_assert(Any::IsInline<Token>(), "Token is expected to be stored inline.");
+
+    Token::copies_ = 0;
+    Token::moves_ = 0;
+
+    {
+        Any small(42);
+
+        // Values are constructed in place: no temporary is copied or moved around.
+
+        auto& token = small.Emplace<Token>(1);
+
+        SYNTROPY_UNIT_ASSERT(&token == AnyCast<Token>(&small));
+        SYNTROPY_UNIT_ASSERT(token.value_ == 1);
+        SYNTROPY_UNIT_ASSERT(Token::copies_ == 0);
+        SYNTROPY_UNIT_ASSERT(Token::moves_ == 0);
+
+        small = Token(2);
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<Token>(&small)->value_ == 2);
+        SYNTROPY_UNIT_ASSERT(Token::copies_ == 0);
+        SYNTROPY_UNIT_ASSERT(Token::moves_ == 1);
+
+        auto large = Any(Crate(7));
+
+        auto& crate = large.Emplace<Crate>(8);
+
+        SYNTROPY_UNIT_ASSERT(&crate == AnyCast<Crate>(&large));
+        SYNTROPY_UNIT_ASSERT(crate.value_ == 8);
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+
+        small = crate;                  // Inline to out of line.
+        large = Token(3);               // Out of line to inline.
+
+        SYNTROPY_UNIT_ASSERT(AnyCast<Crate>(&small)->value_ == 8);
+        SYNTROPY_UNIT_ASSERT(AnyCast<Token>(&large)->value_ == 3);
+        SYNTROPY_UNIT_ASSERT(Crate::instances_ == 1);
+
+        // Inline values are constructed after the current value is destroyed.
+
+        auto invalid_argument = false;
+
+        try
+        {
+            large.Emplace<Token>(-1);
+        }
+        catch (const std::invalid_argument&)
+        {
+            invalid_argument = true;
+        }
+
+        SYNTROPY_UNIT_ASSERT(invalid_argument);
+        SYNTROPY_UNIT_ASSERT(!large.HasValue());
+    }
+
+    SYNTROPY_UNIT_ASSERT(Crate::instances_ == 0);
+}
@@ -100,7 +100,7 @@ struct syntropy::reflection::ClassDeclarationT<TestSyntropySerialization::Cat>
 /* TEST SYNTROPY SERIALIZATION                                          */
 /************************************************************************/
 
-syntropy::AutoTestSuite<TestSyntropySerialization> suite("syntropy.serialization.serialization");
+static syntropy::AutoTestSuite<TestSyntropySerialization> suite("syntropy.serialization.serialization");
 
 std::vector<syntropy::TestCase> TestSyntropySerialization::GetTestCases()
 {